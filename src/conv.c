@@ -0,0 +1,121 @@
+/*
+ * conv.c - tables of names converted from numbers
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/*
+ * look up a name in a table indexed by number
+ */
+const char *conv_name(const char *const table[][2], unsigned size, unsigned num,
+    unsigned char debug, const char *unknown)
+{
+    if(num >= size || !table[num][0])
+        return(unknown);
+
+    return(table[num][debug ? 1 : 0]);
+}
+
+/*
+ * copy a string as much as a buffer allows
+ */
+static inline char *put_str(char *p, const char *end, const char *s)
+{
+    int len = strlen(s);
+
+    if(len > end - p)
+        len = end - p;
+    memcpy(p, s, len);
+
+    return(p + len);
+}
+
+/*
+ * build a fragment of flag names which are set in a byte of flags
+ */
+static const char *build_flag_frag(struct flag_table *ft, int byte, unsigned bits)
+{
+    char buf[MAX_STR_SIZE];
+    char *p = buf, *end = buf + sizeof(buf) - 1;
+    unsigned rest = bits << (byte * 8);
+    int i;
+
+    for(i = 0; i < ft->num; i++) {
+        if(!(rest & ft->names[i].flag))
+            continue;
+        rest &= ~ft->names[i].flag;
+        if(p != buf)
+            p = put_str(p, end, ft->sep);
+        p = put_str(p, end, ft->names[i].name);
+    }
+    *p = '\0';
+
+    ft->frag[byte][bits] = strdup(buf);
+    if(!ft->frag[byte][bits]) {
+        rec_log("error: %s: strdup(): %s", __func__, strerror(errno));
+        return("");
+    }
+
+    return(ft->frag[byte][bits]);
+}
+
+/*
+ * convert flags from number to string with fragments per byte
+ */
+int conv_flags(struct flag_table *ft, unsigned flags, char *list, int len)
+{
+    char *p = list, *end = list + len - 1;
+    const char *frag;
+    unsigned known, bits;
+    int i;
+
+    if(len < 1)
+        return(0);
+
+    if(!flags) {
+        p = put_str(p, end, "NONE");
+        *p = '\0';
+        return(p - list);
+    }
+
+    if(!ft->mask)
+        for(i = 0; i < ft->num; i++)
+            ft->mask |= ft->names[i].flag;
+
+    known = flags & ft->mask;
+    for(i = 0; known; i++, known >>= 8) {
+        bits = known & 0xff;
+        if(!bits)
+            continue;
+        frag = ft->frag[i][bits];
+        if(!frag)
+            frag = build_flag_frag(ft, i, bits);
+        if(p != list)
+            p = put_str(p, end, ft->sep);
+        p = put_str(p, end, frag);
+    }
+
+    /* unknown flags leave a separator after the last name */
+    if(p != list && (flags & ~ft->mask))
+        p = put_str(p, end, ft->sep);
+
+    if(p == list)
+        p = put_str(p, end, "UNKNOWN");
+    *p = '\0';
+
+    return(p - list);
+}
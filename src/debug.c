@@ -20,6 +20,9 @@
 
 static FILE *dbg_fd;
 
+/* date of a last formatted second for a debug file */
+static struct timestamp_cache dbg_ts_cache;
+
 /*
  * open a debug file
  */
@@ -41,9 +44,9 @@ int open_dbg(char *filename)
 void rec_dbg(int level, char *format, ...)
 {
     va_list ap;
-    struct timeval tv;
-    struct tm *tm;
-    char msg[MAX_MSG_SIZE] = "";
+    struct timestamp ts;
+    char stamp[TIMESTAMP_STRLEN];
+    char msg[MAX_MSG_SIZE];
     char indent[MAX_STR_SIZE] = "";
     int i;
 
@@ -54,18 +57,39 @@ void rec_dbg(int level, char *format, ...)
 
     vsnprintf(msg, sizeof(msg), format, ap);
 
-    gettimeofday(&tv, NULL);
-    tm = localtime(&tv.tv_sec);
+    get_timestamp(&ts);
+    format_timestamp(&dbg_ts_cache, &ts, stamp, sizeof(stamp));
 
-    fprintf(dbg_fd, "[%04d-%02d-%02d %02d:%02d:%02d.%06ld] %s%s\n",
-        tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
-        tm->tm_hour, tm->tm_min, tm->tm_sec, tv.tv_usec,
-        indent, msg);
+    fprintf(dbg_fd, "%s%s%s\n", stamp, indent, msg);
     fflush(dbg_fd);
 
     va_end(ap);
 }
 
+/*
+ * reopen a debug file
+ */
+int reopen_dbg(char *filename)
+{
+    int fd;
+
+    if(!dbg_fd)
+        return(0);
+
+    fd = open(filename, O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if(fd < 0) {
+        rec_log("error: %s: open(): %s", __func__, strerror(errno));
+        return(-1);
+    }
+
+    /* replace a descriptor under a stream */
+    fflush(dbg_fd);
+    dup2(fd, fileno(dbg_fd));
+    close(fd);
+
+    return(0);
+}
+
 /*
  * close a debug file
  */
@@ -0,0 +1,328 @@
+/*
+ * event.c - structured events and their sinks
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+static void write_event_text(const struct event *ev);
+
+/* classes of structured events with their text formatters */
+static const struct event_type {
+    const char *name;
+    int (*format)(const struct event *ev, char *msg);
+} event_types[EVENT_TYPE_MAX] = {
+    [EVENT_ADDR]  = { "addr",  format_ifa_event },
+    [EVENT_NEIGH] = { "neigh", format_nd_event },
+    [EVENT_ROUTE] = { "route", format_rt_event },
+};
+
+/* sinks which receive every structured event(a text sink writes a log) */
+static struct event_sink {
+    const char *name;
+    void (*write)(const struct event *ev);
+    unsigned long long events;
+} event_sinks[EVENT_SINK_MAX] = {
+    { "text", write_event_text, 0 },
+};
+static int event_sink_num = 1;
+
+/* flags added to every structured event */
+static unsigned event_flags;
+
+/* file of JSON lines sink */
+static FILE *json_fd;
+static unsigned long long json_errors;
+
+/* number of structured events per class */
+static unsigned long long event_counts[EVENT_TYPE_MAX];
+
+/*
+ * add a sink of structured events
+ */
+int add_event_sink(const char *name, void (*write)(const struct event *ev))
+{
+    if(event_sink_num >= EVENT_SINK_MAX) {
+        rec_log("error: %s: too many event sinks", __func__);
+        return(-1);
+    }
+
+    event_sinks[event_sink_num].name = name;
+    event_sinks[event_sink_num].write = write;
+    event_sink_num++;
+
+    return(0);
+}
+
+/*
+ * set flags added to every structured event
+ */
+void set_event_flags(unsigned flags)
+{
+    event_flags = flags;
+}
+
+/*
+ * pass a structured event to all sinks
+ */
+void emit_event(struct event *ev)
+{
+    int i;
+
+    if(!ev->type || ev->type >= EVENT_TYPE_MAX)
+        return;
+
+    ev->flags |= event_flags;
+    if(!ev->kind && ev->ifindex)
+        ev->kind = get_kind_from_iflist(ev->ifindex);
+    event_counts[ev->type]++;
+
+    for(i = 0; i < event_sink_num; i++) {
+        event_sinks[i].write(ev);
+        event_sinks[i].events++;
+    }
+}
+
+/*
+ * convert an action of a structured event from number to string
+ */
+const char *conv_event_action(int action)
+{
+#define _EVENT_ACTION(a, s) \
+    if(action == EVENT_##a) \
+        return(#s);
+    _EVENT_ACTION(ADDED, added);
+    _EVENT_ACTION(DELETED, deleted);
+    _EVENT_ACTION(CHANGED, changed);
+    _EVENT_ACTION(INVALIDATED, invalidated);
+    _EVENT_ACTION(UNRESOLVED, unresolved);
+#undef _EVENT_ACTION
+    return("unknown");
+}
+
+/*
+ * write a structured event to a log as text
+ */
+static void write_event_text(const struct event *ev)
+{
+    char msg[MAX_MSG_SIZE];
+
+    /* a change logged(or summarized) as differences by its producer is not logged again */
+    if(ev->flags & EVENT_F_DIFF)
+        return;
+
+    /* a burst of route events is logged as summaries */
+    if(summarize_event(ev))
+        return;
+
+    if(event_types[ev->type].format(ev, msg) < 0)
+        return;
+
+    rec_log("%s", msg);
+}
+
+/*
+ * write a JSON member of an address
+ */
+static void write_json_addr(const char *name, int family, const unsigned char *addr)
+{
+    char str[INET6_ADDRSTRLEN];
+
+    if(family == AF_INET6)
+        ntop_ipv6(addr, str);
+    else
+        ntop_ipv4(addr, str);
+    fprintf(json_fd, ",\"%s\":\"%s\"", name, str);
+}
+
+/*
+ * write a JSON member of an interface
+ */
+static void write_json_if(const char *name, const char *index_name, int index)
+{
+    char ifname[IFNAMSIZ] = "";
+
+    fprintf(json_fd, ",\"%s\":%d,\"%s\":", index_name, index, name);
+    write_json_str(json_fd, if_indextoname_from_lists(index, ifname));
+}
+
+/*
+ * write a JSON member of nexthops of multipath
+ */
+static void write_json_nexthops(const struct event *ev)
+{
+    int i;
+
+    fprintf(json_fd, ",\"nexthops\":[");
+    for(i = 0; i < ev->nh_num; i++) {
+        fprintf(json_fd, "%s{\"weight\":%d", i ? "," : "", ev->nh[i].weight);
+        if(ev->nh[i].flags & EVENT_F_GATEWAY)
+            write_json_addr("nexthop", ev->family, ev->nh[i].gateway);
+        write_json_if("interface", "ifindex", ev->nh[i].ifindex);
+        fprintf(json_fd, "}");
+    }
+    fprintf(json_fd, "]");
+}
+
+/*
+ * write a structured event as a JSON line
+ */
+static void write_event_json(const struct event *ev)
+{
+    struct timestamp ts;
+    char lladdr[HWADDR_STRLEN] = "";
+
+    get_timestamp(&ts);
+    fprintf(json_fd, "{\"time\":%ld.%06ld,\"class\":\"%s\",\"action\":\"%s\",\"family\":\"%s\"",
+        (long)ts.real.tv_sec, ts.real.tv_nsec / 1000, event_types[ev->type].name,
+        conv_event_action(ev->action), (ev->family == AF_INET6) ? "ipv6" : "ipv4");
+
+    if(ev->type != EVENT_ROUTE || ((ev->flags & EVENT_F_OIF) && !ev->nh_num))
+        write_json_if("interface", "ifindex", ev->ifindex);
+    if(ev->kind)
+        fprintf(json_fd, ",\"kind\":\"%s\"", conv_kind_id(ev->kind));
+
+    write_json_addr("address", ev->family, ev->addr);
+    if(ev->type != EVENT_NEIGH)
+        fprintf(json_fd, ",\"prefixlen\":%d", ev->prefixlen);
+
+    if(ev->type == EVENT_NEIGH) {
+        if(ev->lladdr_len) {
+            hwaddr_ntop(ARPHRD_ETHER, ev->lladdr, ev->lladdr_len, lladdr, sizeof(lladdr));
+            fprintf(json_fd, ",\"lladdr\":\"%s\"", lladdr);
+        } else
+            fprintf(json_fd, ",\"lladdr\":null");
+    }
+
+    if(ev->type == EVENT_ADDR)
+        fprintf(json_fd, ",\"scope\":\"%s\"", conv_ifa_scope(ev->scope, 0));
+    if(ev->flags & EVENT_F_PEER)
+        write_json_addr("peer", ev->family, ev->peer);
+    if(ev->flags & EVENT_F_LABEL) {
+        fprintf(json_fd, ",\"label\":");
+        write_json_str(json_fd, ev->label);
+    }
+
+    if(ev->flags & EVENT_F_SRC) {
+        write_json_addr("source", ev->family, ev->src);
+        fprintf(json_fd, ",\"source_len\":%d", ev->src_len);
+    }
+    if(ev->flags & EVENT_F_PREFSRC)
+        write_json_addr("preferred_source", ev->family, ev->prefsrc);
+    if(ev->flags & EVENT_F_NHID)
+        fprintf(json_fd, ",\"nexthop_id\":%u", ev->nhid);
+    if(ev->flags & EVENT_F_GATEWAY)
+        write_json_addr("nexthop", ev->family, ev->gateway);
+    if(ev->flags & EVENT_F_IIF)
+        write_json_if("in", "iifindex", ev->iifindex);
+    if(ev->flags & EVENT_F_METRIC)
+        fprintf(json_fd, ",\"metric\":%u", ev->metric);
+    if(ev->flags & EVENT_F_MULTIPATH)
+        write_json_nexthops(ev);
+
+    if(ev->type == EVENT_ROUTE)
+        fprintf(json_fd, ",\"tos\":%d,\"type\":\"%s\",\"protocol\":\"%s\",\"table\":%u",
+            ev->tos, conv_rtn_type(ev->rtn_type, 0), conv_rtprot(ev->protocol, 0),
+            ev->table);
+
+    if(ev->flags & EVENT_F_MISSED)
+        fprintf(json_fd, ",\"missed\":true");
+
+    fprintf(json_fd, "}\n");
+}
+
+/*
+ * open a file of JSON lines sink
+ */
+int open_event_json(char *filename)
+{
+    json_fd = fopen(filename, "a");
+    if(json_fd == NULL) {
+        fprintf(stderr, "[Error] %s: fopen(): %s\n", __func__, strerror(errno));
+        fprintf(stderr, "[Error] %s: can't open json file(%s)\n", __func__, filename);
+        return(-1);
+    }
+
+    return(add_event_sink("json", write_event_json));
+}
+
+/*
+ * reopen a file of JSON lines sink
+ */
+int reopen_event_json(char *filename)
+{
+    FILE *fp;
+
+    if(!json_fd)
+        return(0);
+
+    fp = fopen(filename, "a");
+    if(fp == NULL) {
+        rec_log("error: %s: fopen(): %s", __func__, strerror(errno));
+        return(-1);
+    }
+
+    flush_event_json();
+    fclose(json_fd);
+    json_fd = fp;
+
+    return(0);
+}
+
+/*
+ * flush lines buffered in a file of JSON lines sink
+ */
+void flush_event_json(void)
+{
+    if(!json_fd)
+        return;
+
+    if(fflush(json_fd) == EOF) {
+        json_errors++;
+        clearerr(json_fd);
+    }
+}
+
+/*
+ * close a file of JSON lines sink
+ */
+void close_event_json(void)
+{
+    if(!json_fd)
+        return;
+
+    flush_event_json();
+    fclose(json_fd);
+    json_fd = NULL;
+}
+
+/*
+ * print statistics of structured events
+ */
+void print_event_stats(FILE *stats)
+{
+    int i;
+
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ event statistics ]\n");
+    for(i = 1; i < EVENT_TYPE_MAX; i++)
+        fprintf(stats, "%s events: %llu\n", event_types[i].name, event_counts[i]);
+    for(i = 0; i < event_sink_num; i++)
+        fprintf(stats, "%s sink events: %llu\n", event_sinks[i].name, event_sinks[i].events);
+    if(json_fd)
+        fprintf(stats, "json sink write errors: %llu\n", json_errors);
+}
@@ -0,0 +1,126 @@
+/*
+ * filter.c - socket filter of uninteresting rtnetlink messages
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+#include <linux/filter.h>
+
+/* offsets of fields in a notification(a message per datagram) */
+#define NLMSG_OFF(field) offsetof(struct nlmsghdr, field)
+#define RTM_OFF(field)   (NLMSG_HDRLEN + offsetof(struct rtmsg, field))
+#define NDM_OFF(field)   (NLMSG_HDRLEN + offsetof(struct ndmsg, field))
+
+/* index of address families accepted in a neighbor part of a filter */
+#define FILTER_NDM_FAMILY1 14
+#define FILTER_NDM_FAMILY2 15
+
+/*
+ * filter program dropping what parse_rtmsg() and parse_ndmsg() discard
+ * (half word and word loads are in network byte order)
+ */
+static struct sock_filter event_filter[] = {
+    /* 0: dispatch by a message type */
+    BPF_STMT(BPF_LD | BPF_H | BPF_ABS, NLMSG_OFF(nlmsg_type)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 4, 0),   /* RTM_NEWROUTE -> 6 */
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 3, 0),   /* RTM_DELROUTE -> 6 */
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 9, 0),   /* RTM_NEWNEIGH -> 13 */
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 8, 0),   /* RTM_DELNEIGH -> 13 */
+    BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+
+    /* 6: route other than local table, unspec protocol and cloned */
+    BPF_STMT(BPF_LD | BPF_B | BPF_ABS, RTM_OFF(rtm_table)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, RT_TABLE_LOCAL, 13, 0),
+    BPF_STMT(BPF_LD | BPF_B | BPF_ABS, RTM_OFF(rtm_protocol)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, RTPROT_UNSPEC, 11, 0),
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, RTM_OFF(rtm_flags)),
+    BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0, 9, 0),  /* RTM_F_CLONED */
+    BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+
+    /* 13: unicast neighbor in accepted families other than noarp */
+    BPF_STMT(BPF_LD | BPF_B | BPF_ABS, NDM_OFF(ndm_family)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, AF_INET, 1, 0),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, AF_INET6, 0, 5),
+    BPF_STMT(BPF_LD | BPF_B | BPF_ABS, NDM_OFF(ndm_type)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, RTN_UNICAST, 0, 3),
+    BPF_STMT(BPF_LD | BPF_H | BPF_ABS, NDM_OFF(ndm_state)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 1, 0),   /* NUD_NOARP */
+    BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+
+    /* 21: drop */
+    BPF_STMT(BPF_RET | BPF_K, 0),
+};
+
+/* socket filter statistics */
+static struct {
+    int attached;
+    unsigned long long discarded;
+} filter_stats;
+
+/*
+ * attach a filter of uninteresting messages to an event socket
+ */
+int attach_event_filter(int sock)
+{
+    struct sock_fprog prog;
+    int msg_opts = get_msg_opts();
+
+    event_filter[1].k = htons(RTM_NEWROUTE);
+    event_filter[2].k = htons(RTM_DELROUTE);
+    event_filter[3].k = htons(RTM_NEWNEIGH);
+    event_filter[4].k = htons(RTM_DELNEIGH);
+    event_filter[11].k = htonl(RTM_F_CLONED);
+    event_filter[19].k = htons(NUD_NOARP);
+
+    /* same as address family options in parse_ndmsg() */
+    if(!((msg_opts & M_IPV4) || !(msg_opts & M_IPV6)))
+        event_filter[FILTER_NDM_FAMILY1].k = AF_INET6;
+    if(!((msg_opts & M_IPV6) || !(msg_opts & M_IPV4)))
+        event_filter[FILTER_NDM_FAMILY2].k = AF_INET;
+
+    prog.len = sizeof(event_filter) / sizeof(event_filter[0]);
+    prog.filter = event_filter;
+
+    if(setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0) {
+        rec_log("error: %s: setsockopt(): %s", __func__, strerror(errno));
+        return(-1);
+    }
+    filter_stats.attached = 1;
+
+    return(0);
+}
+
+/*
+ * count a message discarded after being copied to userspace
+ */
+void count_filter_discard(void)
+{
+    filter_stats.discarded++;
+}
+
+/*
+ * print statistics of a socket filter
+ */
+void print_filter_stats(FILE *stats)
+{
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ socket filter statistics ]\n");
+    fprintf(stats, "kernel filter: %s\n", filter_stats.attached ? "attached" : "none");
+    fprintf(stats, "instructions: %lu\n", filter_stats.attached ?
+        (unsigned long)(sizeof(event_filter) / sizeof(event_filter[0])) : 0);
+    fprintf(stats, "messages discarded in userspace: %llu\n", filter_stats.discarded);
+}
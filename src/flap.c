@@ -0,0 +1,356 @@
+/*
+ * flap.c - tracking of flapping routes in bounded memory
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+#include <math.h>
+
+/* a prefix tracked as a candidate of flapping routes */
+struct flap_entry {
+    unsigned hash;
+    /* members below are compared to find an entry */
+    unsigned char family;
+    unsigned char prefixlen;
+    unsigned table;
+    unsigned char prefix[16];
+    /* penalties scaled forward to a base time(never decayed in place) */
+    double score;
+    double error;
+    unsigned long long events;
+    int heap;
+};
+
+/* offset and size of members of an entry compared to find it */
+#define FLAP_KEY offsetof(struct flap_entry, family)
+#define FLAP_KEY_SIZE (offsetof(struct flap_entry, score) - FLAP_KEY)
+
+/* scores are rescaled before they are scaled by more than 2^FLAP_SCALE_MAX */
+#define FLAP_SCALE_MAX 32
+
+/* interval to log flapping routes in seconds(tracking is disabled with 0) */
+static int flap_interval;
+static int flap_top = FLAP_TOP_DEFAULT;
+static int flap_half_life = FLAP_HALF_LIFE_DEFAULT;
+
+/*
+ * entries in a min-heap of scores(space-saving replaces a least one)
+ */
+static struct flap_entry flap_entries[FLAP_TRACK_MAX];
+static struct flap_entry *flap_heap[FLAP_TRACK_MAX];
+static int flap_num;
+
+/* base time of scores and a weight of an event at a last time */
+static double flap_base;
+static double flap_last = -1;
+static double flap_weight;
+
+/* flap statistics */
+static struct {
+    unsigned long long events;
+    unsigned long long evictions;
+    unsigned long long rescales;
+} flap_stats;
+
+/*
+ * match an entry with a key entry
+ */
+static int match_flap_entry(const void *entry, const void *key)
+{
+    return(!memcmp((const char *)entry + FLAP_KEY,
+        (const char *)key + FLAP_KEY, FLAP_KEY_SIZE));
+}
+
+/* index of tracked prefixes */
+static struct hash_table flap_hash = HASH_TABLE_INIT(match_flap_entry);
+
+/*
+ * get a current time in seconds
+ */
+static double flap_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return(ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+/*
+ * set an interval, a number and a half-life of flapping routes logged
+ * ("interval[:top_n[:half_life]]")
+ */
+int set_flap_option(char *arg)
+{
+    char *p;
+
+    flap_interval = atoi(arg);
+    if(flap_interval < 1)
+        return(-1);
+
+    p = strchr(arg, ':');
+    if(!p)
+        return(0);
+    flap_top = atoi(p + 1);
+    if(flap_top < 1 || flap_top > FLAP_TRACK_MAX)
+        return(-1);
+
+    p = strchr(p + 1, ':');
+    if(!p)
+        return(0);
+    flap_half_life = atoi(p + 1);
+    if(flap_half_life < 1)
+        return(-1);
+
+    return(0);
+}
+
+/*
+ * start logging flapping routes every interval
+ */
+int start_flap(void)
+{
+    if(!flap_interval)
+        return(0);
+
+    flap_base = flap_now();
+
+    return(add_loop_timer(flap_interval, log_flap));
+}
+
+/*
+ * get a penalty of an entry decayed to a current time
+ */
+static double flap_penalty(const struct flap_entry *e, double now)
+{
+    return(e->score * exp2((flap_base - now) / flap_half_life));
+}
+
+/*
+ * move an entry whose score is less than its parent up a heap
+ */
+static int sift_up_flap_heap(int i)
+{
+    struct flap_entry *e = flap_heap[i];
+    int p;
+
+    while(i > 0) {
+        p = (i - 1) / 2;
+        if(flap_heap[p]->score <= e->score)
+            break;
+        flap_heap[i] = flap_heap[p];
+        flap_heap[i]->heap = i;
+        i = p;
+    }
+    flap_heap[i] = e;
+    e->heap = i;
+
+    return(i);
+}
+
+/*
+ * move an entry whose score increased down a heap
+ */
+static void sift_down_flap_heap(int i)
+{
+    struct flap_entry *e = flap_heap[i];
+    int c;
+
+    while((c = i * 2 + 1) < flap_num) {
+        if(c + 1 < flap_num && flap_heap[c + 1]->score < flap_heap[c]->score)
+            c++;
+        if(e->score <= flap_heap[c]->score)
+            break;
+        flap_heap[i] = flap_heap[c];
+        flap_heap[i]->heap = i;
+        i = c;
+    }
+    flap_heap[i] = e;
+    e->heap = i;
+}
+
+/*
+ * rescale scores to a current time(an order of a heap is kept)
+ */
+static void rescale_flap(double now)
+{
+    double scale = exp2((flap_base - now) / flap_half_life);
+    int i;
+
+    for(i = 0; i < flap_num; i++) {
+        flap_entries[i].score *= scale;
+        flap_entries[i].error *= scale;
+    }
+    flap_base = now;
+    flap_stats.rescales++;
+}
+
+/*
+ * add a penalty of a route event to a prefix
+ */
+void count_flap(const struct event *ev)
+{
+    struct flap_entry key, *e;
+    double now;
+
+    if(!flap_interval)
+        return;
+
+    /* a weight of an event grows over time instead of decaying penalties */
+    now = flap_now();
+    if(now != flap_last) {
+        if(now - flap_base > (double)FLAP_SCALE_MAX * flap_half_life)
+            rescale_flap(now);
+        flap_weight = exp2((now - flap_base) / flap_half_life);
+        flap_last = now;
+    }
+    flap_stats.events++;
+
+    memset(&key, 0, sizeof(key));
+    key.family = ev->family;
+    key.prefixlen = ev->prefixlen;
+    key.table = ev->table;
+    memcpy(key.prefix, ev->addr, sizeof(key.prefix));
+    key.hash = hash_bytes((char *)&key + FLAP_KEY, FLAP_KEY_SIZE, 0);
+
+    e = hash_search(&flap_hash, key.hash, &key);
+    if(!e) {
+        if(flap_num < FLAP_TRACK_MAX) {
+            e = &flap_entries[flap_num];
+            e->score = 0;
+            e->heap = flap_num;
+            flap_heap[flap_num++] = e;
+        } else {
+            /* a least entry is replaced and its score is an error of a new one */
+            e = flap_heap[0];
+            hash_delete(&flap_hash, e->hash, e);
+            flap_stats.evictions++;
+        }
+        memcpy(e, &key, FLAP_KEY + FLAP_KEY_SIZE);
+        e->error = e->score;
+        e->events = 0;
+        if(hash_insert(&flap_hash, e->hash, e) < 0)
+            return;
+    }
+
+    /* a new entry on a leaf may be less than its parent */
+    e->score += flap_weight;
+    e->events++;
+    sift_down_flap_heap(sift_up_flap_heap(e->heap));
+}
+
+/*
+ * compare entries in descending order of scores
+ */
+static int compare_flap_entry(const void *a, const void *b)
+{
+    const struct flap_entry *x = *(struct flap_entry *const *)a;
+    const struct flap_entry *y = *(struct flap_entry *const *)b;
+
+    return((x->score < y->score) - (x->score > y->score));
+}
+
+/*
+ * get top entries whose penalties are not less than a minimum
+ */
+static int get_flap_top(struct flap_entry **top, double now)
+{
+    int num;
+
+    memcpy(top, flap_heap, flap_num * sizeof(*top));
+    qsort(top, flap_num, sizeof(*top), compare_flap_entry);
+
+    for(num = 0; num < flap_num && num < flap_top; num++)
+        if(flap_penalty(top[num], now) < FLAP_PENALTY_MIN)
+            break;
+
+    return(num);
+}
+
+/*
+ * format a line of a flapping route
+ */
+static void format_flap(const struct flap_entry *e, double now, char *msg, int len)
+{
+    char addr[INET6_ADDRSTRLEN], id[16];
+    const char *table;
+    double penalty = flap_penalty(e, now);
+
+    if(e->family == AF_INET6)
+        ntop_ipv6(e->prefix, addr);
+    else
+        ntop_ipv4(e->prefix, addr);
+    table = conv_rt_table(e->table, 0);
+    if(!strcmp(table, "unknown")) {
+        snprintf(id, sizeof(id), "%u", e->table);
+        table = id;
+    }
+
+    /* a penalty of a steady rate r per second converges to r * half_life / ln2 */
+    snprintf(msg, len, "%s route flapping: destination=%s/%d table=%s "
+        "penalty=%.1f rate=%.2f/min events=%llu error=%.1f",
+        (e->family == AF_INET6) ? "ipv6" : "ipv4", addr, e->prefixlen, table,
+        penalty, penalty * M_LN2 / flap_half_life * 60, e->events,
+        e->error * exp2((flap_base - now) / flap_half_life));
+}
+
+/*
+ * log top flapping routes
+ */
+void log_flap(void)
+{
+    static struct flap_entry *top[FLAP_TRACK_MAX];
+    char msg[MAX_MSG_SIZE];
+    double now = flap_now();
+    int i, num;
+
+    num = get_flap_top(top, now);
+    for(i = 0; i < num; i++) {
+        format_flap(top[i], now, msg, sizeof(msg));
+        rec_log("%s", msg);
+    }
+}
+
+/*
+ * print statistics and top flapping routes
+ */
+void print_flap_stats(FILE *stats)
+{
+    static struct flap_entry *top[FLAP_TRACK_MAX];
+    char msg[MAX_MSG_SIZE];
+    double now = flap_now();
+    int i, num;
+
+    if(!flap_interval)
+        return;
+
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ route flap statistics ]\n");
+    fprintf(stats, "half-life: %d second\n", flap_half_life);
+    fprintf(stats, "tracked prefixes: %d/%d\n", flap_num, FLAP_TRACK_MAX);
+    fprintf(stats, "events: %llu\n", flap_stats.events);
+    fprintf(stats, "evictions: %llu\n", flap_stats.evictions);
+    fprintf(stats, "rescales: %llu\n", flap_stats.rescales);
+    fprintf(stats, "memory: %lu byte\n",
+        (unsigned long)(sizeof(flap_entries) + sizeof(flap_heap) + hash_mem_size(&flap_hash)));
+
+    num = get_flap_top(top, now);
+    for(i = 0; i < num; i++) {
+        format_flap(top[i], now, msg, sizeof(msg));
+        fprintf(stats, "%s\n", msg);
+    }
+}
@@ -28,7 +28,7 @@ int parse_frhdr(struct nlmsghdr *nlh)
     struct fib_rule_hdr *frh;
     int frh_len;
     struct rtattr *fra[__FRA_MAX];
-    char msg[148] = "", action[16] = "";
+    char msg[MAX_MSG_SIZE] = "", action[16] = "";
     char *mp = msg;
     int log_opts = get_log_opts();
     int res;
@@ -54,9 +54,9 @@ int parse_frhdr(struct nlmsghdr *nlh)
 
     /* check address family */
     if(frh->family == AF_INET)
-        mp = add_log(msg, mp, "ipv4 ");
+        mp = add_str(msg, mp, "ipv4 ");
     else if(frh->family == AF_INET6)
-        mp = add_log(msg, mp, "ipv6 ");
+        mp = add_str(msg, mp, "ipv6 ");
     else {
         rec_log("error: %s: unknown address family: %d",
             __func__, frh->family);
@@ -65,9 +65,9 @@ int parse_frhdr(struct nlmsghdr *nlh)
 
     /* check message type */
     if(nlh->nlmsg_type == RTM_NEWRULE)
-        mp = add_log(msg, mp, "rule added: ");
+        mp = add_str(msg, mp, "rule added: ");
     else if(nlh->nlmsg_type == RTM_DELRULE)
-        mp = add_log(msg, mp, "rule deleted: ");
+        mp = add_str(msg, mp, "rule deleted: ");
     else {
         rec_log("error: %s: unknown netlink message type: %d",
             __func__, nlh->nlmsg_type);
@@ -80,7 +80,7 @@ int parse_frhdr(struct nlmsghdr *nlh)
 
     /* check whether invert rule or not */
     if(frh->flags & FIB_RULE_INVERT)
-        mp = add_log(msg, mp, "not ");
+        mp = add_str(msg, mp, "not ");
 
         /* get source prefix */
     if(fra[FRA_SRC]) {
@@ -92,7 +92,11 @@ int parse_frhdr(struct nlmsghdr *nlh)
                 (res == 1) ? strerror(errno) : "payload too short");
             return(1);
         }
-        mp = add_log(msg, mp, "from=%s/%d ", src, frh->src_len);
+        mp = add_str(msg, mp, "from=");
+        mp = add_str(msg, mp, src);
+        mp = add_str(msg, mp, "/");
+        mp = add_u32(msg, mp, frh->src_len);
+        mp = add_str(msg, mp, " ");
     } 
 
     /* get egress interface index & name */
@@ -109,16 +113,23 @@ int parse_frhdr(struct nlmsghdr *nlh)
         memcpy(ifname, RTA_DATA(fra[FRA_IFNAME]), sizeof(ifname));
 #ifdef FIB_RULE_IIF_DETACHED
         if(frh->flags & FIB_RULE_IIF_DETACHED) {
-            mp = add_log(msg, mp, "in=%s(detached) ", ifname);
+            mp = add_str(msg, mp, "in=");
+            mp = add_str(msg, mp, ifname);
+            mp = add_str(msg, mp, "(detached) ");
             return(0);
         }
 #endif
-        mp = add_log(msg, mp, "in=%s ", ifname);
+        mp = add_str(msg, mp, "in=");
+        mp = add_str(msg, mp, ifname);
+        mp = add_str(msg, mp, " ");
     }
 
     /* get tos value */
-    if(frh->tos)
-        mp = add_log(msg, mp, "tos=0x%.2x ", frh->tos);
+    if(frh->tos) {
+        mp = add_str(msg, mp, "tos=0x");
+        mp = add_hex(msg, mp, frh->tos, 2);
+        mp = add_str(msg, mp, " ");
+    }
 
         /* get destination prefix */
     if(fra[FRA_DST]) {
@@ -130,7 +141,11 @@ int parse_frhdr(struct nlmsghdr *nlh)
                 (res == 1) ? strerror(errno) : "payload too short");
             return(1);
         }
-        mp = add_log(msg, mp, "to=%s/%d ", dst, frh->dst_len);
+        mp = add_str(msg, mp, "to=");
+        mp = add_str(msg, mp, dst);
+        mp = add_str(msg, mp, "/");
+        mp = add_u32(msg, mp, frh->dst_len);
+        mp = add_str(msg, mp, " ");
     }
 
 #if HAVE_DECL_FRA_OIFNAME
@@ -148,11 +163,15 @@ int parse_frhdr(struct nlmsghdr *nlh)
         memcpy(oifname, RTA_DATA(fra[FRA_OIFNAME]), sizeof(oifname));
 #ifdef FIB_RULE_OIF_DETACHED
         if(frh->flags & FIB_RULE_OIF_DETACHED) {
-            mp = add_log(msg, mp, "out=%s(detached) ", oifname);
+            mp = add_str(msg, mp, "out=");
+            mp = add_str(msg, mp, oifname);
+            mp = add_str(msg, mp, "(detached) ");
             return(0);
         }
 #endif
-        mp = add_log(msg, mp, "out=%s ", oifname);
+        mp = add_str(msg, mp, "out=");
+        mp = add_str(msg, mp, oifname);
+        mp = add_str(msg, mp, " ");
     }
 #endif
 
@@ -177,10 +196,13 @@ int parse_frhdr(struct nlmsghdr *nlh)
     }
 
     if(fwmark || fwmask) {
-        if(fwmask != 0xFFFFFFFF)
-            mp = add_log(msg, mp, "fwmark=0x%x/0x%x ", fwmark, fwmask);
-        else
-            mp = add_log(msg, mp, "fwmark=0x%x ", fwmark);
+        mp = add_str(msg, mp, "fwmark=0x");
+        mp = add_hex(msg, mp, fwmark, 0);
+        if(fwmask != 0xFFFFFFFF) {
+            mp = add_str(msg, mp, "/0x");
+            mp = add_hex(msg, mp, fwmask, 0);
+        }
+        mp = add_str(msg, mp, " ");
     }
 
     /* get source and destination realms */
@@ -194,10 +216,15 @@ int parse_frhdr(struct nlmsghdr *nlh)
         }
         srcrlm = *(unsigned *)RTA_DATA(fra[FRA_FLOW]);
         srcrlm &= 0xFFFF;
-        if(srcrlm)
-            mp = add_log(msg, mp, "source-realm=%u ", srcrlm);
+        if(srcrlm) {
+            mp = add_str(msg, mp, "source-realm=");
+            mp = add_u32(msg, mp, srcrlm);
+            mp = add_str(msg, mp, " ");
+        }
         dstrlm = srcrlm >> 16;
-        mp = add_log(msg, mp, "destination-realm=%u ", dstrlm);
+        mp = add_str(msg, mp, "destination-realm=");
+        mp = add_u32(msg, mp, dstrlm);
+        mp = add_str(msg, mp, " ");
     }
 
 #if HAVE_DECL_FRA_GOTO
@@ -207,7 +234,9 @@ int parse_frhdr(struct nlmsghdr *nlh)
             rec_log("error: %s: FRA_GOTO: payload too short", __func__);
             return(1);
         }
-        mp = add_log(msg, mp, "goto=%u ", *(unsigned *)RTA_DATA(fra[FRA_GOTO]));
+        mp = add_str(msg, mp, "goto=");
+        mp = add_u32(msg, mp, *(unsigned *)RTA_DATA(fra[FRA_GOTO]));
+        mp = add_str(msg, mp, " ");
     }
 #endif
 
@@ -221,10 +250,12 @@ int parse_frhdr(struct nlmsghdr *nlh)
             return(1);
         }
         snprintf(table, sizeof(table), "%s", conv_rt_table(table_id, 0));
+        mp = add_str(msg, mp, "table=");
         if(!strncmp(table, "unknown", sizeof(table)))
-            mp = add_log(msg, mp, "table=%u ", table_id);
+            mp = add_u32(msg, mp, table_id);
         else
-            mp = add_log(msg, mp, "table=%s ", table);
+            mp = add_str(msg, mp, table);
+        mp = add_str(msg, mp, " ");
     }
 
     /* get fib rule priority */
@@ -233,7 +264,9 @@ int parse_frhdr(struct nlmsghdr *nlh)
             rec_log("error: %s: FRA_PRIORITY: payload too short", __func__);
             return(1);
         }
-        mp = add_log(msg, mp, "priority=%u ", *(unsigned *)RTA_DATA(fra[FRA_PRIORITY]));
+        mp = add_str(msg, mp, "priority=");
+        mp = add_u32(msg, mp, *(unsigned *)RTA_DATA(fra[FRA_PRIORITY]));
+        mp = add_str(msg, mp, " ");
     }
 
     /* convert fib rule action */
@@ -339,30 +372,32 @@ void debug_frhdr(int lev, struct fib_rule_hdr *frh, struct rtattr *fra[], int fr
  */
 const char *conv_fr_act(int action, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _FR_ACT(s1, s2) \
-    if(action == FR_ACT_##s1) \
-        return(debug ? #s1 : #s2);
-    _FR_ACT(UNSPEC, none);
-    _FR_ACT(TO_TBL, to_tbl);
+        [FR_ACT_##s1] = { #s2, #s1 },
+        _FR_ACT(UNSPEC, none)
+        _FR_ACT(TO_TBL, to_tbl)
 #if HAVE_DECL_FR_ACT_GOTO
-    _FR_ACT(GOTO, goto);
+        _FR_ACT(GOTO, goto)
 #endif
 #if HAVE_DECL_FR_ACT_NOP
-    _FR_ACT(NOP, nop);
+        _FR_ACT(NOP, nop)
 #endif
 #if HAVE_DECL_FR_ACT_RES1
-    _FR_ACT(RES1, res1);
+        _FR_ACT(RES1, res1)
 #endif
 #if HAVE_DECL_FR_ACT_RES2
-    _FR_ACT(RES2, res2);
+        _FR_ACT(RES2, res2)
 #endif
-    _FR_ACT(RES3, res3);
-    _FR_ACT(RES4, res4);
-    _FR_ACT(BLACKHOLE, blackhole);
-    _FR_ACT(UNREACHABLE, unreachable);
-    _FR_ACT(PROHIBIT, prohibit);
+        _FR_ACT(RES3, res3)
+        _FR_ACT(RES4, res4)
+        _FR_ACT(BLACKHOLE, blackhole)
+        _FR_ACT(UNREACHABLE, unreachable)
+        _FR_ACT(PROHIBIT, prohibit)
 #undef _FR_ACT
-    return(debug ? "UNKNOWN" : "unknown");
+    };
+
+    return(CONV_NAME(names, action, debug, debug ? "UNKNOWN" : "unknown"));
 }
 
 /*
@@ -370,30 +405,26 @@ const char *conv_fr_act(int action, unsigned char debug)
  */
 void conv_fib_rule_flags(int flags, char *flags_list, int len)
 {
-    if(!flags) {
-        strncpy(flags_list, "NONE", len);
-        return;
-    }
+    static const struct flag_name names[] = {
 #define _FIB_RULE_FLAGS(s) \
-    if((flags & FIB_RULE_##s) && (len - strlen(flags_list) - 1 > 0)) \
-        (flags &= ~FIB_RULE_##s) ? \
-            strncat(flags_list, #s ",", len - strlen(flags_list) - 1) : \
-            strncat(flags_list, #s, len - strlen(flags_list) - 1); 
-    _FIB_RULE_FLAGS(PERMANENT);
+        { FIB_RULE_##s, #s },
+        _FIB_RULE_FLAGS(PERMANENT)
 #ifdef FIB_RULE_INVERT
-    _FIB_RULE_FLAGS(INVERT);
+        _FIB_RULE_FLAGS(INVERT)
 #endif
 #ifdef FIB_RULE_UNRESOLVED
-    _FIB_RULE_FLAGS(UNRESOLVED);
+        _FIB_RULE_FLAGS(UNRESOLVED)
 #endif
 #ifdef FIB_RULE_IIF_DETACHED
-    _FIB_RULE_FLAGS(IIF_DETACHED);
+        _FIB_RULE_FLAGS(IIF_DETACHED)
 #endif
 #ifdef FIB_RULE_OIF_DETACHED
-    _FIB_RULE_FLAGS(OIF_DETACHED);
+        _FIB_RULE_FLAGS(OIF_DETACHED)
 #endif
 #undef _FIB_RULE_FLAGS
-    if(!strlen(flags_list))
-        strncpy(flags_list, "UNKNOWN", len);
+    };
+    static struct flag_table ft = FLAG_TABLE(names, ",");
+
+    conv_flags(&ft, flags, flags_list, len);
 }
 #endif
@@ -0,0 +1,172 @@
+/*
+ * hash.c - hash table utility
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/*
+ * resize a hash table
+ */
+static int hash_resize(struct hash_table *t, unsigned size)
+{
+    struct hash_slot *slots;
+    unsigned i, j, mask = size - 1;
+
+    slots = calloc(size, sizeof(struct hash_slot));
+    if(!slots) {
+        rec_log("error: %s: calloc() failed", __func__);
+        return(-1);
+    }
+
+    /* rehash entries with stored hash values */
+    for(i = 0; i < t->size; i++) {
+        if(!t->slots[i].entry)
+            continue;
+
+        for(j = t->slots[i].hash & mask; slots[j].entry; j = (j + 1) & mask);
+        slots[j] = t->slots[i];
+    }
+
+    free(t->slots);
+    t->slots = slots;
+    t->size = size;
+
+    return(0);
+}
+
+/*
+ * search an entry in a hash table
+ */
+void *hash_search(struct hash_table *t, unsigned hash, const void *key)
+{
+    unsigned i, probe = 0, mask = t->size - 1;
+
+    if(!t->size)
+        return(NULL);
+
+    /* count slots examined including a matched or an empty one */
+    t->searches++;
+    for(i = hash & mask; ++probe && t->slots[i].entry; i = (i + 1) & mask)
+        if(t->slots[i].hash == hash && t->match(t->slots[i].entry, key))
+            break;
+
+    t->probes += probe;
+    if(probe > t->max_probe)
+        t->max_probe = probe;
+
+    return(t->slots[i].entry);
+}
+
+/*
+ * insert an entry into a hash table
+ */
+int hash_insert(struct hash_table *t, unsigned hash, void *entry)
+{
+    unsigned i, mask;
+
+    /* keep a load factor under 3/4 */
+    if((t->count + 1) * 4 > t->size * 3)
+        if(hash_resize(t, t->size ? t->size * 2 : HASH_SIZE_MIN) < 0)
+            return(-1);
+
+    mask = t->size - 1;
+    for(i = hash & mask; t->slots[i].entry; i = (i + 1) & mask);
+    t->slots[i].hash = hash;
+    t->slots[i].entry = entry;
+    t->count++;
+
+    return(0);
+}
+
+/*
+ * delete an entry from a hash table
+ */
+void *hash_delete(struct hash_table *t, unsigned hash, const void *key)
+{
+    unsigned i, j, k, mask = t->size - 1;
+    void *entry;
+
+    if(!t->size)
+        return(NULL);
+
+    for(i = hash & mask; t->slots[i].entry; i = (i + 1) & mask)
+        if(t->slots[i].hash == hash && t->match(t->slots[i].entry, key))
+            break;
+
+    entry = t->slots[i].entry;
+    if(!entry)
+        return(NULL);
+
+    /* shift following entries back instead of leaving a tombstone */
+    for(j = (i + 1) & mask; t->slots[j].entry; j = (j + 1) & mask) {
+        k = t->slots[j].hash & mask;
+
+        /* skip an entry whose home slot lies cyclically in (i, j] */
+        if((i < j) ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+
+        t->slots[i] = t->slots[j];
+        i = j;
+    }
+    t->slots[i].entry = NULL;
+    t->count--;
+
+    return(entry);
+}
+
+/*
+ * get a next entry at or after a position in a hash table
+ */
+void *hash_next(struct hash_table *t, unsigned *pos)
+{
+    unsigned i;
+
+    /* a caller deleting a returned entry must retry the same position */
+    for(i = *pos; i < t->size; i++)
+        if(t->slots[i].entry) {
+            *pos = i + 1;
+            return(t->slots[i].entry);
+        }
+    *pos = t->size;
+
+    return(NULL);
+}
+
+/*
+ * get a memory size of slots in a hash table
+ */
+size_t hash_mem_size(struct hash_table *t)
+{
+    return(t->size * sizeof(struct hash_slot));
+}
+
+/*
+ * print statistics of a hash table
+ */
+void print_hash_stats(FILE *stats, const char *title, struct hash_table *t)
+{
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ %s statistics ]\n", title);
+    fprintf(stats, "entries: %u\n", t->count);
+    fprintf(stats, "slots: %u\n", t->size);
+    fprintf(stats, "memory: %lu byte\n", (unsigned long)hash_mem_size(t));
+    fprintf(stats, "searches: %llu\n", t->searches);
+    fprintf(stats, "average probe length: %.3f\n", t->searches ?
+        (double)t->probes / t->searches : 0.0);
+    fprintf(stats, "max probe length: %u\n", t->max_probe);
+}
@@ -0,0 +1,92 @@
+/*
+ * hash.h - hash table utility
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#ifndef _HASH_H__
+#define _HASH_H__
+
+#include <stdio.h> /* FILE */
+#include <stddef.h> /* size_t */
+
+/* initial number of slots in a hash table */
+#define HASH_SIZE_MIN 64
+
+/* a slot of a hash table(an empty slot has no entry) */
+struct hash_slot {
+    unsigned hash;
+    void *entry;
+};
+
+/* an open addressing hash table with linear probing */
+struct hash_table {
+    struct hash_slot *slots;
+    unsigned size;
+    unsigned count;
+    int (*match)(const void *entry, const void *key);
+    /* statistics */
+    unsigned long long searches;
+    unsigned long long probes;
+    unsigned max_probe;
+};
+
+/*
+ * initialize a hash table
+ */
+#define HASH_TABLE_INIT(match) \
+    { NULL, 0, 0, match, 0, 0, 0 }
+
+/*
+ * hash an integer
+ */
+static inline unsigned hash_int(unsigned key)
+{
+    key ^= key >> 16;
+    key *= 0x7feb352d;
+    key ^= key >> 15;
+    key *= 0x846ca68b;
+    key ^= key >> 16;
+
+    return(key);
+}
+
+/*
+ * hash a byte string(FNV-1a)
+ */
+static inline unsigned hash_bytes(const void *data, size_t len, unsigned hash)
+{
+    const unsigned char *p = data;
+
+    if(!hash)
+        hash = 2166136261u;
+
+    while(len--) {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+
+    return(hash);
+}
+
+/* hash.c */
+void *hash_search(struct hash_table *t, unsigned hash, const void *key);
+int hash_insert(struct hash_table *t, unsigned hash, void *entry);
+void *hash_delete(struct hash_table *t, unsigned hash, const void *key);
+void *hash_next(struct hash_table *t, unsigned *pos);
+size_t hash_mem_size(struct hash_table *t);
+void print_hash_stats(FILE *stats, const char *title, struct hash_table *t);
+
+#endif
@@ -19,6 +19,304 @@
 #include "nield.h"
 #include "rtnetlink.h"
 
+/* pool of interface address table entries */
+static struct pool ifalist_pool = POOL_INIT("address list", struct ifalist_entry);
+
+/* whether an interface address table is being seeded or resynchronized */
+static int seeding;
+static int resyncing;
+
+/* interface address table statistics */
+static struct {
+    unsigned long long added;
+    unsigned long long changed;
+    unsigned long long refreshed;
+    unsigned long long deleted;
+} ifalist_stats;
+
+/*
+ * match an entry in an interface address table with a key entry
+ */
+static int match_ifalist(const void *entry, const void *key)
+{
+    const struct ifalist_entry *e = entry, *k = key;
+
+    return(e->ifindex == k->ifindex && e->family == k->family &&
+        e->prefixlen == k->prefixlen && !memcmp(e->addr, k->addr, sizeof(e->addr)));
+}
+
+/* index of interface address table by interface, family, address and prefix length */
+static struct hash_table ifa_hash = HASH_TABLE_INIT(match_ifalist);
+
+/*
+ * get a hash value of an interface address table entry
+ */
+static inline unsigned hash_ifalist(const struct ifalist_entry *e)
+{
+    return(hash_bytes(e->addr, sizeof(e->addr),
+        hash_int(e->ifindex) ^ (e->family << 8) ^ e->prefixlen));
+}
+
+/*
+ * set an entry of an interface address table from attributes
+ */
+static int set_ifalist_entry(struct ifalist_entry *e, struct ifaddrmsg *ifam, struct rtattr *ifa[])
+{
+    unsigned char paddr[16] = { 0 };
+    int len;
+
+    e->ifindex = ifam->ifa_index;
+    e->family = ifam->ifa_family;
+    e->prefixlen = ifam->ifa_prefixlen;
+    e->attr.scope = ifam->ifa_scope;
+    e->attr.ifa_flags = ifam->ifa_flags;
+
+    /* get prefix address */
+    if(ifa[IFA_ADDRESS]) {
+        if(get_rta_addr(ifam->ifa_family, ifa[IFA_ADDRESS], paddr)) {
+            rec_log("error: %s: IFA_ADDRESS(ifindex %d): payload too short",
+                __func__, ifam->ifa_index);
+            return(1);
+        }
+        memcpy(e->addr, paddr, sizeof(paddr));
+    }
+
+    /* get local interface address */
+    if(ifa[IFA_LOCAL]) {
+        if(get_rta_addr(ifam->ifa_family, ifa[IFA_LOCAL], e->addr)) {
+            rec_log("error: %s: IFA_LOCAL(ifindex %d): payload too short",
+                __func__, ifam->ifa_index);
+            return(1);
+        }
+
+        /* whether interface type is P2P */
+        if(ifa[IFA_ADDRESS] && memcmp(e->addr, paddr, sizeof(paddr))) {
+            memcpy(e->attr.peer, paddr, sizeof(paddr));
+            e->attr.flags |= EVENT_F_PEER;
+        }
+    }
+
+    /* get interface label */
+    if(ifa[IFA_LABEL]) {
+        len = RTA_PAYLOAD(ifa[IFA_LABEL]);
+        if(!len) {
+            rec_log("error: %s: IFA_LABEL(ifindex %d): no payload",
+                __func__, ifam->ifa_index);
+            return(1);
+        } else if(len > (int)sizeof(e->attr.label)) {
+            rec_log("error: %s: IFA_LABEL(ifindex %d): payload too long",
+                __func__, ifam->ifa_index);
+            return(1);
+        }
+        memcpy(e->attr.label, RTA_DATA(ifa[IFA_LABEL]), len);
+        e->attr.label[sizeof(e->attr.label) - 1] = '\0';
+        e->attr.flags |= EVENT_F_LABEL;
+    }
+
+#if HAVE_DECL_IFA_FLAGS
+    /* get extended address flags */
+    if(ifa[IFA_FLAGS]) {
+        if(RTA_PAYLOAD(ifa[IFA_FLAGS]) < sizeof(unsigned)) {
+            rec_log("error: %s: IFA_FLAGS(ifindex %d): payload too short",
+                __func__, ifam->ifa_index);
+            return(1);
+        }
+        e->attr.ifa_flags = *(unsigned *)RTA_DATA(ifa[IFA_FLAGS]);
+    }
+#endif
+
+    return(0);
+}
+
+/*
+ * pass an event of an entry of an interface address table to sinks
+ */
+static void emit_ifalist_entry(int action, const struct ifalist_entry *e)
+{
+    struct event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = EVENT_ADDR;
+    ev.action = action;
+    ev.family = e->family;
+    ev.ifindex = e->ifindex;
+    ev.prefixlen = e->prefixlen;
+    ev.scope = e->attr.scope;
+    ev.flags = e->attr.flags;
+    /* a change is logged as differences by log_ifalist_diff() */
+    if(action == EVENT_CHANGED)
+        ev.flags |= EVENT_F_DIFF;
+    memcpy(ev.addr, e->addr, sizeof(e->addr));
+    memcpy(ev.peer, e->attr.peer, sizeof(e->attr.peer));
+    memcpy(ev.label, e->attr.label, sizeof(e->attr.label));
+
+    emit_event(&ev);
+}
+
+/*
+ * format a peer address of an interface address table entry as text
+ */
+static char *format_ifalist_peer(const struct ifalist_entry *e, char *buf)
+{
+    if(!(e->attr.flags & EVENT_F_PEER))
+        strcpy(buf, "none");
+    else if(e->family == AF_INET6)
+        ntop_ipv6(e->attr.peer, buf);
+    else
+        ntop_ipv4(e->attr.peer, buf);
+
+    return(buf);
+}
+
+/*
+ * log differences between old and new attributes of an interface address
+ */
+static void log_ifalist_diff(const struct ifalist_entry *old, const struct ifalist_entry *new)
+{
+    char addr[INET6_ADDRSTRLEN + IFNAMSIZ + 24], ifname[IFNAMSIZ] = "";
+    char o[MAX_STR_SIZE], n[MAX_STR_SIZE];
+    char *p = addr;
+
+    p += sprintf(p, "%s address ", (new->family == AF_INET6) ? "ipv6" : "ipv4");
+    p += (new->family == AF_INET6) ? ntop_ipv6(new->addr, p) : ntop_ipv4(new->addr, p);
+    sprintf(p, "/%d on %s", new->prefixlen, if_indextoname_from_lists(new->ifindex, ifname));
+
+    if(old->attr.ifa_flags != new->attr.ifa_flags) {
+        conv_ifa_flags(old->attr.ifa_flags, o, sizeof(o));
+        conv_ifa_flags(new->attr.ifa_flags, n, sizeof(n));
+        rec_log("%s flags changed from %s to %s", addr, o, n);
+    }
+
+    if(old->attr.scope != new->attr.scope)
+        rec_log("%s scope changed from %s to %s", addr,
+            conv_ifa_scope(old->attr.scope, 0), conv_ifa_scope(new->attr.scope, 0));
+
+    if((old->attr.flags & EVENT_F_PEER) != (new->attr.flags & EVENT_F_PEER) ||
+        memcmp(old->attr.peer, new->attr.peer, sizeof(old->attr.peer)))
+        rec_log("%s peer changed from %s to %s", addr,
+            format_ifalist_peer(old, o), format_ifalist_peer(new, n));
+
+    if((old->attr.flags & EVENT_F_LABEL) != (new->attr.flags & EVENT_F_LABEL) ||
+        strcmp(old->attr.label, new->attr.label))
+        rec_log("%s label changed from %s to %s", addr,
+            (old->attr.flags & EVENT_F_LABEL) ? old->attr.label : "none",
+            (new->attr.flags & EVENT_F_LABEL) ? new->attr.label : "none");
+
+    return;
+}
+
+/*
+ * search an entry in an interface address table
+ */
+static inline struct ifalist_entry *search_ifalist(struct ifalist_entry *key)
+{
+    return(hash_search(&ifa_hash, hash_ifalist(key), key));
+}
+
+/*
+ * add a copy of a temporary entry to an interface address table
+ */
+static struct ifalist_entry *copy_ifalist_entry(struct ifalist_entry *ifale_tmp)
+{
+    struct ifalist_entry *e;
+
+    e = pool_alloc(&ifalist_pool);
+    if(!e)
+        return(NULL);
+    memcpy(e, ifale_tmp, sizeof(*e));
+
+    if(hash_insert(&ifa_hash, hash_ifalist(e), e) < 0) {
+        pool_free(&ifalist_pool, e);
+        return(NULL);
+    }
+
+    return(e);
+}
+
+/*
+ * delete an entry in an interface address table
+ */
+static inline void del_ifalist_entry(struct ifalist_entry *e)
+{
+    hash_delete(&ifa_hash, hash_ifalist(e), e);
+    pool_free(&ifalist_pool, e);
+}
+
+/*
+ * apply RTM_NEWADDR to an interface address table
+ */
+static int parse_rtm_newaddr(struct ifalist_entry *ifale_tmp)
+{
+    struct ifalist_entry *ifale;
+
+    ifale = search_ifalist(ifale_tmp);
+    if(!ifale) {
+        ifale_tmp->mark = resyncing;
+        if(!copy_ifalist_entry(ifale_tmp))
+            return(-1);
+        ifalist_stats.added++;
+        if(!seeding)
+            emit_ifalist_entry(EVENT_ADDED, ifale_tmp);
+        return(0);
+    }
+    if(resyncing)
+        ifale->mark = 1;
+
+    /* a lifetime refresh leaves attributes of a whole width unchanged */
+    if(!memcmp(&ifale->attr, &ifale_tmp->attr, sizeof(ifale->attr))) {
+        ifalist_stats.refreshed++;
+        return(1);
+    }
+    ifalist_stats.changed++;
+
+    log_ifalist_diff(ifale, ifale_tmp);
+    memcpy(&ifale->attr, &ifale_tmp->attr, sizeof(ifale->attr));
+    emit_ifalist_entry(EVENT_CHANGED, ifale);
+
+    return(0);
+}
+
+/*
+ * count addresses of a family on an interface
+ */
+static int count_ifalist_family(unsigned ifindex, int family)
+{
+    struct ifalist_entry *e;
+    unsigned pos;
+    int num = 0;
+
+    for(pos = 0; (e = hash_next(&ifa_hash, &pos)); )
+        if(e->ifindex == ifindex && e->family == family)
+            num++;
+
+    return(num);
+}
+
+/*
+ * apply RTM_DELADDR to an interface address table
+ */
+static int parse_rtm_deladdr(struct ifalist_entry *ifale_tmp)
+{
+    struct ifalist_entry *ifale;
+
+    ifale = search_ifalist(ifale_tmp);
+    if(ifale) {
+        del_ifalist_entry(ifale);
+        ifalist_stats.deleted++;
+    }
+
+    /* kernel flushes IPv4 routes using an address or a last address silently */
+    if(ifale_tmp->family == AF_INET) {
+        flush_rib_prefsrc(ifale_tmp->addr);
+        if(!count_ifalist_family(ifale_tmp->ifindex, AF_INET))
+            flush_rib_ifindex(ifale_tmp->ifindex);
+    }
+
+    emit_ifalist_entry(EVENT_DELETED, ifale_tmp);
+
+    return(0);
+}
+
 /*
  * parse interface address message
  */ 
@@ -27,15 +325,8 @@ int parse_ifamsg(struct nlmsghdr *nlh)
     struct ifaddrmsg *ifam;
     int ifam_len;
     struct rtattr *ifa[__IFA_MAX];
-    char paddr[INET6_ADDRSTRLEN+1] = "";
-    char laddr[INET6_ADDRSTRLEN+1] = "";
-    char ifname[IFNAMSIZ] = "";
-    char iflabel[IFNAMSIZ] = "";
-    char msg[MAX_MSG_SIZE] = "";
-    char *mp = msg;
-    unsigned short iftype = -1;
+    struct ifalist_entry ifale_tmp;
     int log_opts = get_log_opts();
-    int res;
 
     /* debug nlmsghdr */
     if(log_opts & L_DEBUG)
@@ -56,102 +347,171 @@ int parse_ifamsg(struct nlmsghdr *nlh)
     if(log_opts & L_DEBUG)
         debug_ifamsg(0, ifam, ifa, ifam_len);
 
-    /* check address family & set message type */
-    if(ifam->ifa_family == AF_INET) {
-        mp = add_log(msg, mp, "ipv4 ");
-    } else if(ifam->ifa_family == AF_INET6) {
-        mp = add_log(msg, mp, "ipv6 ");
-    } else {
+    /* check address family */
+    if(ifam->ifa_family != AF_INET && ifam->ifa_family != AF_INET6) {
         rec_log("error: %s: unknown address family: %d",
             __func__, ifam->ifa_family);
         return(1);
     }
 
-    /* get interface index & name */
-    if_indextoname_from_lists(ifam->ifa_index, ifname);
+    /* get key and attributes compared with an interface address table */
+    memset(&ifale_tmp, 0, sizeof(ifale_tmp));
+    if(set_ifalist_entry(&ifale_tmp, ifam, ifa))
+        return(1);
+
+    /* apply interface address message */
     if(nlh->nlmsg_type == RTM_NEWADDR)
-        mp = add_log(msg, mp, "address added: ");
+        return(parse_rtm_newaddr(&ifale_tmp));
     else if(nlh->nlmsg_type == RTM_DELADDR)
-        mp = add_log(msg, mp, "address deleted: ");
-    else {
-        rec_log("error: %s: unknown nlmsg_type: %d",
-            __func__, nlh->nlmsg_type);
-        return(1);
-    }
+        return(parse_rtm_deladdr(&ifale_tmp));
 
-    /* get interface type */
-    iftype = get_type_from_iflist(ifam->ifa_index);
-    if(!iftype)
-        iftype = get_type_from_ifhist(ifam->ifa_index);
+    rec_log("error: %s: unknown nlmsg_type: %d",
+        __func__, nlh->nlmsg_type);
 
-    /* get prefix address */
-    if(ifa[IFA_ADDRESS]) {
-        res = inet_ntop_ifa(ifam->ifa_family, ifa[IFA_ADDRESS], paddr, sizeof(paddr));
-        if(res) {
-            rec_log("error: %s: IFA_ADDRESS(ifindex %d): %s",
-                __func__, ifam->ifa_index,
-                (res == 1) ? strerror(errno) : "payload too short");
-            return(1);
-        }
-    }
+    return(1);
+}
 
-    /* get local interface address */
-    if(ifa[IFA_LOCAL]) {
-        res = inet_ntop_ifa(ifam->ifa_family, ifa[IFA_LOCAL], laddr, sizeof(laddr));
-        if(res) {
-            rec_log("error: %s: IFA_LOCAL(ifindex %d): %s",
-                __func__, ifam->ifa_index,
-                (res == 1) ? strerror(errno) : "payload too short");
+/*
+ * parse a dump of interface addresses
+ */
+static int parse_ifalist_dump(struct msghdr *msg, int len)
+{
+    struct nlmsghdr *nlh;
+    int nlh_len;
+
+    /* get netlink message header */
+    nlh = msg->msg_iov->iov_base;
+    nlh_len = len;
+
+    /* parse netlink message header */
+    for( ; NLMSG_OK(nlh, nlh_len); nlh = NLMSG_NEXT(nlh, nlh_len)) {
+        /* whether netlink message header ends or not */
+        if(nlh->nlmsg_type == NLMSG_DONE)
             return(1);
+
+        if(nlh->nlmsg_type == NLMSG_ERROR) {
+            rec_log("error: %s: nlmsg error", __func__);
+            return(-1);
         }
+
+        if(parse_ifamsg(nlh) < 0)
+            return(-1);
     }
 
-    /* whether interface type is P2P */
-    if(ifa[IFA_LOCAL] && strcmp(laddr, paddr))
-        mp = add_log(msg, mp, "interface=%s local=%s/%d peer=%s/%d ",
-            ifname, laddr, ifam->ifa_prefixlen, paddr, ifam->ifa_prefixlen);
-    else
-        mp = add_log(msg, mp, "interface=%s ip=%s/%d ",
-            ifname, paddr, ifam->ifa_prefixlen);
+    return(0);
+}
 
-    /* get scope of address */
-    mp = add_log(msg, mp, "socpe=%s ", conv_ifa_scope(ifam->ifa_scope, 0));
+/*
+ * create an interface address table
+ */
+int create_ifalist(struct msghdr *msg, int len)
+{
+    int ret;
 
-    /* get interface label */
-    if(ifa[IFA_LABEL]) {
-        if(RTA_PAYLOAD(ifa[IFA_LABEL]) > sizeof(iflabel)) {
-            rec_log("error: %s: IFA_LABEL(ifindex %d): no payload",
-                __func__, ifam->ifa_index);
-            return(1);
-        } else if(RTA_PAYLOAD(ifa[IFA_LABEL]) > sizeof(iflabel)) {
-            rec_log("error: %s: IFA_LABEL(ifindex %d): payload too long",
-                __func__, ifam->ifa_index);
-            return(1);
-        }
-        memcpy(iflabel, RTA_DATA(ifa[IFA_LABEL]), IFNAMSIZ);
-        if(strcmp(iflabel, ifname))
-            mp = add_log(msg, mp, "label=%s ", iflabel);
+    seeding = 1;
+    ret = parse_ifalist_dump(msg, len);
+    seeding = 0;
+
+    return(ret);
+}
+
+/*
+ * resynchronize an interface address table with kernel
+ */
+int resync_ifalist(struct msghdr *msg, int len)
+{
+    int ret;
+
+    /* entries found in a dump are marked */
+    resyncing = 1;
+    ret = parse_ifalist_dump(msg, len);
+    resyncing = 0;
+
+    return(ret);
+}
+
+/*
+ * delete entries not found in a dump from an interface address table
+ */
+void sweep_ifalist(void)
+{
+    struct ifalist_entry *e;
+    unsigned pos;
+
+    /* a deletion shifts a following entry back into the same slot */
+    for(pos = 0; (e = hash_next(&ifa_hash, &pos)); ) {
+        if(e->mark)
+            continue;
+
+        emit_ifalist_entry(EVENT_DELETED, e);
+        del_ifalist_entry(e);
+        ifalist_stats.deleted++;
+        pos--;
     }
 
-    if(ifa[IFA_CACHEINFO] && nlh->nlmsg_type == RTM_NEWADDR) {
-        struct ifa_cacheinfo *ifac;
+    for(pos = 0; (e = hash_next(&ifa_hash, &pos)); )
+        e->mark = 0;
 
-        if(RTA_PAYLOAD(ifa[IFA_CACHEINFO]) < sizeof(*ifac)) {
-            rec_log("error: %s: IFA_CACHEINFO(ifindex %d): payload too short",
-                __func__, ifam->ifa_index);
-            return(1);
-        }
+    return;
+}
 
-        ifac = (struct ifa_cacheinfo *)RTA_DATA(ifa[IFA_CACHEINFO]);
-        /* logging only when created not updated */
-        if(ifac->cstamp != ifac->tstamp)
-            return(1);
+/*
+ * print statistics of an interface address table
+ */
+void print_ifalist_stats(FILE *stats)
+{
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ interface address list statistics ]\n");
+    fprintf(stats, "addresses added: %llu\n", ifalist_stats.added);
+    fprintf(stats, "addresses changed: %llu\n", ifalist_stats.changed);
+    fprintf(stats, "refreshes suppressed: %llu\n", ifalist_stats.refreshed);
+    fprintf(stats, "addresses deleted: %llu\n", ifalist_stats.deleted);
+
+    print_hash_stats(stats, "interface address table", &ifa_hash);
+    print_pool_stats(stats, &ifalist_pool);
+}
+
+/*
+ * format interface address event as text
+ */
+int format_ifa_event(const struct event *ev, char *msg)
+{
+    char ifname[IFNAMSIZ] = "";
+    char *mp = msg;
+
+    if_indextoname_from_lists(ev->ifindex, ifname);
+
+    mp = add_str(msg, mp, (ev->family == AF_INET6) ? "ipv6 address " : "ipv4 address ");
+    mp = add_str(msg, mp, conv_event_action(ev->action));
+    mp = add_str(msg, mp, ": interface=");
+    mp = add_str(msg, mp, ifname);
+
+    if(ev->flags & EVENT_F_PEER) {
+        mp = add_str(msg, mp, " local=");
+        mp = add_inet(msg, mp, ev->family, ev->addr);
+        mp = add_str(msg, mp, "/");
+        mp = add_u32(msg, mp, ev->prefixlen);
+        mp = add_str(msg, mp, " peer=");
+        mp = add_inet(msg, mp, ev->family, ev->peer);
+    } else {
+        mp = add_str(msg, mp, " ip=");
+        mp = add_inet(msg, mp, ev->family, ev->addr);
     }
+    mp = add_str(msg, mp, "/");
+    mp = add_u32(msg, mp, ev->prefixlen);
 
-    /* logging interface address message */
-    rec_log("%s", msg);
+    mp = add_str(msg, mp, " socpe=");
+    mp = add_str(msg, mp, conv_ifa_scope(ev->scope, 0));
+    mp = add_str(msg, mp, " ");
 
-    return(0);
+    if((ev->flags & EVENT_F_LABEL) && strcmp(ev->label, ifname)) {
+        mp = add_str(msg, mp, "label=");
+        mp = add_str(msg, mp, ev->label);
+        mp = add_str(msg, mp, " ");
+    }
+
+    return(mp ? 0 : -1);
 }
 
 /*
@@ -215,6 +575,12 @@ void debug_ifamsg(int lev, struct ifaddrmsg *ifam, struct rtattr *ifa[], int ifa
         debug_rta_af(lev+1, ifa[IFA_MULTICAST],
             "IFA_MULTICAST", ifam->ifa_family);
 
+#if HAVE_DECL_IFA_FLAGS
+    if(ifa[IFA_FLAGS])
+        debug_rta_u32x(lev+1, ifa[IFA_FLAGS],
+            "IFA_FLAGS", NULL);
+#endif
+
     rec_dbg(lev, "");
 
     return;
@@ -250,33 +616,41 @@ void debug_ifa_cacheinfo(int lev, struct rtattr *ifa, const char *name)
  */
 void conv_ifa_flags(int flags, char *flags_list, int len)
 {
-    if(!flags) {
-        strncpy(flags_list, "NONE", len);
-        return;
-    }
+    static const struct flag_name names[] = {
 #define _IFA_FLAGS(f) \
-    if((flags & IFA_F_##f) && (len - strlen(flags_list) - 1 > 0)) \
-        (flags &= ~IFA_F_##f) ? \
-            strncat(flags_list, #f ",", len - strlen(flags_list) - 1) : \
-            strncat(flags_list, #f, len - strlen(flags_list) - 1);
-    _IFA_FLAGS(SECONDARY);
-    _IFA_FLAGS(TEMPORARY);
+        { IFA_F_##f, #f },
+        _IFA_FLAGS(SECONDARY)
+        _IFA_FLAGS(TEMPORARY)
 #ifdef IFA_F_NODAD
-    _IFA_FLAGS(NODAD);
+        _IFA_FLAGS(NODAD)
 #endif
-    _IFA_FLAGS(OPTIMISTIC);
+        _IFA_FLAGS(OPTIMISTIC)
 #ifdef IFA_F_DADFAILED
-    _IFA_FLAGS(DADFAILED);
+        _IFA_FLAGS(DADFAILED)
 #endif
 #ifdef IFA_F_HOMEADDRESS
-    _IFA_FLAGS(HOMEADDRESS);
+        _IFA_FLAGS(HOMEADDRESS)
+#endif
+        _IFA_FLAGS(DEPRECATED)
+        _IFA_FLAGS(TENTATIVE)
+        _IFA_FLAGS(PERMANENT)
+#ifdef IFA_F_MANAGETEMPADDR
+        _IFA_FLAGS(MANAGETEMPADDR)
+#endif
+#ifdef IFA_F_NOPREFIXROUTE
+        _IFA_FLAGS(NOPREFIXROUTE)
+#endif
+#ifdef IFA_F_MCAUTOJOIN
+        _IFA_FLAGS(MCAUTOJOIN)
+#endif
+#ifdef IFA_F_STABLE_PRIVACY
+        _IFA_FLAGS(STABLE_PRIVACY)
 #endif
-    _IFA_FLAGS(DEPRECATED);
-    _IFA_FLAGS(TENTATIVE);
-    _IFA_FLAGS(PERMANENT);
 #undef _IFA_FLAGS
-    if(!strlen(flags_list))
-        strncpy(flags_list, "UNKNOWN", len);
+    };
+    static struct flag_table ft = FLAG_TABLE(names, ",");
+
+    conv_flags(&ft, flags, flags_list, len);
 }
 
 /*
@@ -284,14 +658,16 @@ void conv_ifa_flags(int flags, char *flags_list, int len)
  */
 const char *conv_ifa_scope(int scope, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _IFA_SCOPE(s1, s2) \
-    if(scope == RT_SCOPE_##s1) \
-        return(debug ? #s1 : #s2);
-    _IFA_SCOPE(UNIVERSE, global);
-    _IFA_SCOPE(SITE, site);
-    _IFA_SCOPE(LINK, link);
-    _IFA_SCOPE(HOST, host);
-    _IFA_SCOPE(NOWHERE, none);
+        [RT_SCOPE_##s1] = { #s2, #s1 },
+        _IFA_SCOPE(UNIVERSE, global)
+        _IFA_SCOPE(SITE, site)
+        _IFA_SCOPE(LINK, link)
+        _IFA_SCOPE(HOST, host)
+        _IFA_SCOPE(NOWHERE, none)
 #undef _IFA_SCOPE
-    return(debug ? "UNKNOWN" : "unknown");
+    };
+
+    return(CONV_NAME(names, scope, debug, debug ? "UNKNOWN" : "unknown"));
 }
@@ -20,56 +20,144 @@
 #include "rtnetlink.h"
 
 #define HIST_MAX 64
+#define MISS_MAX 64 /* power of 2 */
 
 /* top of interface list and history */
 static struct list_head lhead = {&lhead, &lhead};
 static struct list_head hhead = {&hhead, &hhead};
 
+/* pool of interface list entries */
+static struct pool iflist_pool = POOL_INIT("interface list", struct iflist_entry);
+
+/* whether an interface list is being resynchronized */
+static int resyncing;
+
+/* whether an interface is being learned from a reply to a request */
+static int learning;
+
+/* whether interfaces may not be requested to kernel(in a snapshot child) */
+static int detached;
+
+/* interface indexes which kernel did not know at a last request */
+static int missed[MISS_MAX];
+
+/* interface name lookup statistics */
+static struct {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long learned;
+    unsigned long long missed;
+    unsigned long long unknown;
+} lookup_stats;
+
+/* names of interface kinds interned by id(id 0 is no kind) */
+static char kinds[KIND_MAX][MODULE_NAME_LEN];
+static int kind_num = 1;
+
+/* handlers of interface kinds resolved when a kind is interned */
+static const struct link_kind *kind_ops[KIND_MAX];
+
+/*
+ * match an entry in an interface list with an interface index
+ */
+static int match_ifindex(const void *entry, const void *key)
+{
+    return(((const struct iflist_entry *)entry)->index == *(const int *)key);
+}
+
+/*
+ * match an entry in an interface list with an interface name
+ */
+static int match_ifname(const void *entry, const void *key)
+{
+    return(!strncmp(((const struct iflist_entry *)entry)->name, key, IFNAMSIZ));
+}
+
+/* indexes of interface list by interface index and name */
+static struct hash_table index_hash = HASH_TABLE_INIT(match_ifindex);
+static struct hash_table name_hash = HASH_TABLE_INIT(match_ifname);
+
+/*
+ * get a hash value of an interface name
+ */
+static inline unsigned hash_ifname(const char *name)
+{
+    return(hash_bytes(name, strnlen(name, IFNAMSIZ), 0));
+}
+
 /*
  * search an entry in an interface list
  */
 static inline struct iflist_entry *search_iflist(int index)
 {
-    struct list_head *l;
+    return(hash_search(&index_hash, hash_int(index), &index));
+}
 
-    list_for_each(l, &lhead) {
-        struct iflist_entry *e;
+/*
+ * search an entry in an interface list by name
+ */
+static inline struct iflist_entry *search_iflist_by_name(const char *name)
+{
+    return(hash_search(&name_hash, hash_ifname(name), name));
+}
 
-        e = list_entry(l, struct iflist_entry, list);
-        if(e->index == index)
-            return(e);
-    }
+/*
+ * add an entry to a name index of an interface list
+ */
+static inline int hash_ifname_entry(struct iflist_entry *e)
+{
+    /* a stale entry with the same name loses its name */
+    hash_delete(&name_hash, hash_ifname(e->name), e->name);
 
-    return(NULL);
+    return(hash_insert(&name_hash, hash_ifname(e->name), e));
+}
+
+/*
+ * delete an entry from a name index of an interface list
+ */
+static inline void unhash_ifname_entry(struct iflist_entry *e)
+{
+    if(search_iflist_by_name(e->name) == e)
+        hash_delete(&name_hash, hash_ifname(e->name), e->name);
+
+    return;
 }
 
 /*
  * add an entry into an interface list
  */ 
-static inline void add_iflist_entry(struct list_head *l)
+static inline int add_iflist_entry(struct iflist_entry *e)
 {
-    list_init(l);
-    list_add(l, &lhead);
+    /* an interface index may be reused */
+    if(missed[e->index & (MISS_MAX - 1)] == e->index)
+        missed[e->index & (MISS_MAX - 1)] = 0;
 
-    return;
+    if(hash_insert(&index_hash, hash_int(e->index), e) < 0)
+        return(-1);
+
+    if(hash_ifname_entry(e) < 0) {
+        hash_delete(&index_hash, hash_int(e->index), &e->index);
+        return(-1);
+    }
+
+    list_init(&(e->list));
+    list_add(&(e->list), &lhead);
+
+    return(0);
 }
 
 /*
- * [not in use]
  * delete an entry in an interface list
  */ 
 static inline void del_iflist_entry(int index)
 {
-    struct list_head *l, *n;
-
-    list_for_each_safe(l, n, &lhead) {
-        struct iflist_entry *e;
+    struct iflist_entry *e;
 
-        e = list_entry(l, struct iflist_entry, list);
-        if(e->index == index) {
-            list_del(l);
-            free(e);
-        }
+    e = hash_delete(&index_hash, hash_int(index), &index);
+    if(e) {
+        unhash_ifname_entry(e);
+        list_del(&(e->list));
+        pool_free(&iflist_pool, e);
     }
 
     return;
@@ -80,16 +168,12 @@ static inline void del_iflist_entry(int index)
  */
 static inline void move_iflist_entry(int index)
 {
-    struct list_head *l, *n;
+    struct iflist_entry *e;
 
-    list_for_each_safe(l, n, &lhead) {
-        struct iflist_entry *e;
-
-        e = list_entry(l, struct iflist_entry, list);
-        if(e->index == index) {
-            list_move(l, &hhead);
-            break;
-        }
+    e = hash_delete(&index_hash, hash_int(index), &index);
+    if(e) {
+        unhash_ifname_entry(e);
+        list_move(&(e->list), &hhead);
     }
 
     return;
@@ -109,7 +193,7 @@ static inline void del_ifhist_entry(void)
         if(++i > HIST_MAX) {
             e = list_entry(l, struct iflist_entry, list);
             list_del(l);
-            free(e);
+            pool_free(&iflist_pool, e);
             break;
         }
     }
@@ -135,26 +219,110 @@ static inline struct iflist_entry *search_ifhist(int index)
     return(NULL);
 }
 
+/*
+ * get an id of an interface kind
+ */
+unsigned char get_kind_id(const char *kind)
+{
+    int i;
+
+    for(i = 1; i < kind_num; i++)
+        if(!strncmp(kinds[i], kind, MODULE_NAME_LEN))
+            return(i);
+
+    if(kind_num >= KIND_MAX) {
+        rec_log("error: %s: too many interface kinds", __func__);
+        return(0);
+    }
+    strncpy(kinds[kind_num], kind, MODULE_NAME_LEN - 1);
+    kind_ops[kind_num] = find_link_kind(kinds[kind_num], MODULE_NAME_LEN);
+
+    return(kind_num++);
+}
+
+/*
+ * conv an id of an interface kind to name
+ */
+const char *conv_kind_id(unsigned char id)
+{
+    return(kinds[id]);
+}
+
+/*
+ * conv an interface address to text
+ */
+static inline char *conv_ifaddr(unsigned short type, const unsigned char *addr,
+    int len, char *str, int strlen)
+{
+    if(hwaddr_ntop(type, addr, len, str, strlen))
+        strncpy(str, "", strlen);
+
+    return(str);
+}
+
 /*
  * conv an interface index to name in lists
  */
 char *if_indextoname_from_lists(int index, char *name)
 {
-    /* from kernel */
-    if(if_indextoname(index, name))
-        return(name);
-
     /* from interface list */
-    if(if_indextoname_from_iflist(index, name))
+    if(if_indextoname_from_iflist(index, name)) {
+        lookup_stats.hits++;
         return(name);
+    }
+    lookup_stats.misses++;
+
+    /* from kernel with a request for only the interface */
+    if(index > 0 && !learning && !detached) {
+        if(missed[index & (MISS_MAX - 1)] == index)
+            lookup_stats.missed++;
+        else {
+            if(!request_link(index) && if_indextoname_from_iflist(index, name)) {
+                lookup_stats.learned++;
+                return(name);
+            }
+
+            /* an interface already deleted is not requested again */
+            missed[index & (MISS_MAX - 1)] = index;
+        }
+    }
 
     /* from interface history */
-    if(if_indextoname_from_ifhist(index, name))
+    if(!if_indextoname_from_ifhist(index, name)) {
+        lookup_stats.unknown++;
         snprintf(name, IFNAMSIZ, "(unknown %d)", index);
+    }
 
     return(name);
 }
 
+/*
+ * resolve interface names only from lists without requests to kernel
+ */
+void detach_iflist_requests(void)
+{
+    /* a forked child shares a socket and sequence numbers with a parent */
+    detached = 1;
+}
+
+/*
+ * add an interface in a reply to a request to an interface list
+ */
+int learn_iflist(struct nlmsghdr *nlh)
+{
+    int mute = get_log_mute();
+    int ret;
+
+    /* an interface learned is logged when it is notified first */
+    learning = 1;
+    set_log_mute(1);
+    ret = parse_ifimsg(nlh);
+    set_log_mute(mute);
+    learning = 0;
+
+    return(ret);
+}
+
 /*
  * conv an interface index to name in an interface list
  */
@@ -170,6 +338,19 @@ char *if_indextoname_from_iflist(int index, char *name)
     return(name);
 }
 
+/*
+ * conv an interface name to index in an interface list
+ */
+int if_nametoindex_from_iflist(const char *name)
+{
+    struct iflist_entry *e = search_iflist_by_name(name);
+
+    if(!e)
+        return(0);
+
+    return(e->index);
+}
+
 /*
  * conv an interface index to name in an inetrface history
  */ 
@@ -198,6 +379,19 @@ unsigned short get_type_from_iflist(int index)
     return(e->type);
 }
 
+/*
+ * get an interned kind of an interface in an interface list
+ */
+unsigned char get_kind_from_iflist(int index)
+{
+    struct iflist_entry *e = search_iflist(index);
+
+    if(!e)
+        return(0);
+
+    return(e->kind);
+}
+
 /*
  * get an interface type in an interface history
  */
@@ -220,7 +414,10 @@ void print_iflist(int num)
     struct list_head *l;
     FILE *iflist;
     char fname[MAX_STR_SIZE] = "";
+    char tmp[MAX_STR_SIZE] = "";
     char title[MAX_STR_SIZE] = "";
+    char addr[HWADDR_STRLEN] = "";
+    char name[IFNAMSIZ] = "";
 
     switch(num) {
         case 1:
@@ -236,11 +433,9 @@ void print_iflist(int num)
         default:
             return;
     }
-    iflist = fopen(fname, "w");
-    if(iflist == NULL) {
-        rec_log("error: %s: can't open iflist file(%s)", __func__, fname);
+    iflist = open_snapshot(fname, tmp, sizeof(tmp));
+    if(iflist == NULL)
         return;
-    }
     fprintf(iflist, "\n");
     fprintf(iflist, "*********************************************************************\n");
     fprintf(iflist, "[ %s ]\n", title);
@@ -251,9 +446,9 @@ void print_iflist(int num)
         e = list_entry(l, struct iflist_entry, list);
 
         fprintf(iflist, "%s[%d]: address %s\n",
-            e->name, e->index, e->addr);
+            e->name, e->index, conv_ifaddr(e->type, e->addr, e->addr_len, addr, sizeof(addr)));
         fprintf(iflist, "%s[%d]: broadcast %s\n",
-            e->name, e->index, e->brd);
+            e->name, e->index, conv_ifaddr(e->type, e->brd, e->brd_len, addr, sizeof(addr)));
         fprintf(iflist, "%s[%d]: flags %s\n",
             e->name, e->index, conv_iff_flags(e->flags, 1));
         fprintf(iflist, "%s[%d]: type %s\n",
@@ -263,10 +458,11 @@ void print_iflist(int num)
         fprintf(iflist, "%s[%d]: mtu %hu\n",
             e->name, e->index, e->mtu);
         fprintf(iflist, "%s[%d]: kind %s\n",
-            e->name, e->index, strlen(e->kind) ? e->kind : "no");
+            e->name, e->index, e->kind ? conv_kind_id(e->kind) : "no");
         fprintf(iflist, "%s[%d]: master %s[%d]\n",
             e->name, e->index,
-            strlen(e->name_master) ? e->name_master : "none" , e->index_master);
+            e->index_master ? if_indextoname_from_lists(e->index_master, name) : "none",
+            e->index_master);
         fprintf(iflist, "%s[%d]: bridge-attached %s\n",
             e->name, e->index, e->br_attached ? "yes" : "no");
 #if HAVE_DECL_IFLA_BRPORT_UNSPEC
@@ -275,15 +471,94 @@ void print_iflist(int num)
 #endif
     }
 
-    fclose(iflist);
+    close_snapshot(iflist, tmp, fname);
+
+    return;
+}
+
+/*
+ * write a snapshot of an interface list or history in JSON lines
+ */
+void dump_iflist(int num)
+{
+    struct list_head *head = NULL;
+    struct list_head *l;
+    FILE *iflist;
+    char fname[MAX_STR_SIZE] = "";
+    char tmp[MAX_STR_SIZE] = "";
+    char title[MAX_STR_SIZE] = "";
+    char addr[HWADDR_STRLEN] = "";
+    unsigned entries = 0;
+
+    switch(num) {
+        case 1:
+            head = &lhead;
+            strncpy(fname, IFLIST_FILE SNAPSHOT_SUFFIX, sizeof(fname));
+            strncpy(title, "interface list", sizeof(title));
+            break;
+        case 2:
+            head = &hhead;
+            strncpy(fname, IFHIST_FILE SNAPSHOT_SUFFIX, sizeof(fname));
+            strncpy(title, "interface history", sizeof(title));
+            break;
+        default:
+            return;
+    }
+    iflist = open_snapshot(fname, tmp, sizeof(tmp));
+    if(iflist == NULL)
+        return;
+
+    list_for_each(l, head)
+        entries++;
+    write_snapshot_header(iflist, title, entries);
+
+    list_for_each(l, head) {
+        struct iflist_entry *e;
+
+        e = list_entry(l, struct iflist_entry, list);
+
+        fprintf(iflist, "{\"index\":%d,\"name\":", e->index);
+        write_json_str(iflist, e->name);
+        fprintf(iflist, ",\"address\":\"%s\"",
+            conv_ifaddr(e->type, e->addr, e->addr_len, addr, sizeof(addr)));
+        fprintf(iflist, ",\"broadcast\":\"%s\"",
+            conv_ifaddr(e->type, e->brd, e->brd_len, addr, sizeof(addr)));
+        fprintf(iflist, ",\"flags\":%u,\"type\":%hu,\"vlan\":%hu,\"mtu\":%d",
+            e->flags, e->type, e->vid, e->mtu);
+        fprintf(iflist, ",\"kind\":");
+        write_json_str(iflist, conv_kind_id(e->kind));
+        fprintf(iflist, ",\"master\":%d,\"bridge_attached\":%s,\"bridge_port_state\":%d}\n",
+            e->index_master, e->br_attached ? "true" : "false", e->br_state);
+    }
+
+    close_snapshot(iflist, tmp, fname);
 
     return;
 }
 
+/*
+ * print statistics of interface list indexes
+ */
+void print_iflist_stats(FILE *stats)
+{
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ interface name lookup statistics ]\n");
+    fprintf(stats, "hits: %llu\n", lookup_stats.hits);
+    fprintf(stats, "misses: %llu\n", lookup_stats.misses);
+    fprintf(stats, "learned from kernel: %llu\n", lookup_stats.learned);
+    fprintf(stats, "unknown to kernel before: %llu\n", lookup_stats.missed);
+    fprintf(stats, "unknown: %llu\n", lookup_stats.unknown);
+
+    print_hash_stats(stats, "interface index table", &index_hash);
+    print_hash_stats(stats, "interface name table", &name_hash);
+    print_pool_stats(stats, &iflist_pool);
+}
+
 /*
  * create an interface list
  */ 
-int create_iflist(struct msghdr *msg)
+int create_iflist(struct msghdr *msg, int len)
 {
     struct nlmsghdr *nlh;
     int nlh_len;
@@ -295,7 +570,7 @@ int create_iflist(struct msghdr *msg)
 
     /* get netlink message header */
     nlh = msg->msg_iov->iov_base;
-    nlh_len = msg->msg_iov->iov_len;
+    nlh_len = len;
 
     /* parse netlink message header */
     for( ; NLMSG_OK(nlh, nlh_len); nlh = NLMSG_NEXT(nlh, nlh_len)) {
@@ -334,12 +609,9 @@ int create_iflist(struct msghdr *msg)
             continue;
 
         /* create interface list */
-        ifle = (struct iflist_entry *)malloc(sizeof(struct iflist_entry));
-        if(ifle == NULL) {
-            rec_log("error: %s: malloc(): failed", __func__);
+        ifle = pool_alloc(&iflist_pool);
+        if(ifle == NULL)
             return(-1);
-        }
-        memset(ifle, 0, sizeof(struct iflist_entry));
         list_init(&(ifle->list));
 
         ifle->index = ifim->ifi_index;
@@ -350,21 +622,21 @@ int create_iflist(struct msghdr *msg)
         /* get interface name */
         if(ifla[IFLA_IFNAME])
             if(parse_ifla_ifname(NULL, NULL, ifla[IFLA_IFNAME], ifle)) {
-                free(ifle);
+                pool_free(&iflist_pool, ifle);
                 continue;
             }
 
         /* get interface address */
         if(ifla[IFLA_ADDRESS])
             if(parse_ifla_address(NULL, NULL, ifla[IFLA_ADDRESS], ifle)) {
-                free(ifle);
+                pool_free(&iflist_pool, ifle);
                 continue;
             }
 
         /* get broadcast address */
         if(ifla[IFLA_BROADCAST])
             if(parse_ifla_broadcast(NULL, NULL, ifla[IFLA_BROADCAST], ifle)) {
-                free(ifle);
+                pool_free(&iflist_pool, ifle);
                 continue;
             }
 
@@ -372,7 +644,7 @@ int create_iflist(struct msghdr *msg)
         /* get interface information */
         if(ifla[IFLA_LINKINFO])
             if(parse_ifla_linkinfo(NULL, NULL, ifla[IFLA_LINKINFO], ifle)) {
-                free(ifle);
+                pool_free(&iflist_pool, ifle);
                 continue;
             }
 #endif
@@ -380,31 +652,108 @@ int create_iflist(struct msghdr *msg)
         /* get interface MTU */
         if(ifla[IFLA_MTU])
             if(parse_ifla_mtu(NULL, NULL, ifla[IFLA_MTU], ifle)) {
-                free(ifle);
+                pool_free(&iflist_pool, ifle);
                 continue;
             }
 
         /* get master interface */
         if(ifla[IFLA_MASTER])
             if(parse_ifla_master(NULL, NULL, ifla[IFLA_MASTER], ifle)) {
-                free(ifle);
+                pool_free(&iflist_pool, ifle);
                 continue;
             }
 
         /* get interface protocol information */
         if(ifla[IFLA_PROTINFO])
             if(parse_ifla_protinfo(ifla[IFLA_PROTINFO], ifle, ifim->ifi_family)) {
-                free(ifle);
+                pool_free(&iflist_pool, ifle);
                 continue;
             }
 
+        /* replace an entry learned while creating interface list */
+        del_iflist_entry(ifle->index);
+
         /* add interface list */
-        list_add(&(ifle->list), &lhead);
+        if(add_iflist_entry(ifle) < 0) {
+            pool_free(&iflist_pool, ifle);
+            return(-1);
+        }
     }
 
     return(0);
 }
 
+/*
+ * resynchronize an interface list with kernel
+ */
+int resync_iflist(struct msghdr *msg, int len)
+{
+    struct nlmsghdr *nlh;
+    int nlh_len;
+
+    /* get netlink message header */
+    nlh = msg->msg_iov->iov_base;
+    nlh_len = len;
+
+    /* parse netlink message header */
+    resyncing = 1;
+    for( ; NLMSG_OK(nlh, nlh_len); nlh = NLMSG_NEXT(nlh, nlh_len)) {
+        /* whether netlink message header ends or not */
+        if(nlh->nlmsg_type == NLMSG_DONE) {
+            resyncing = 0;
+            return(1);
+        }
+
+        if(nlh->nlmsg_type == NLMSG_ERROR) {
+            rec_log("error: %s: nlmsg error", __func__);
+            resyncing = 0;
+            return(-1);
+        }
+
+        /* entries found in a dump are marked */
+        parse_ifimsg(nlh);
+    }
+    resyncing = 0;
+
+    return(0);
+}
+
+/*
+ * delete entries not found in a dump from an interface list
+ */
+void sweep_iflist(void)
+{
+    struct list_head *l, *n;
+
+    list_for_each_safe(l, n, &lhead) {
+        struct iflist_entry *e;
+        char state[MAX_STR_SIZE] = "";
+
+        e = list_entry(l, struct iflist_entry, list);
+        if(e->mark) {
+            e->mark = 0;
+            continue;
+        }
+
+        /* check administrative state */
+        (e->flags & IFF_UP) ?
+            strcpy(state, "enabled,") : strcpy(state, "disabled,");
+
+        /* check operational state */
+        (e->flags & IFF_RUNNING) ?
+            strcat(state, "linkup") : strcat(state, "linkdown");
+
+        rec_log("interface deleted: name=%s mtu=%d state=%s",
+            e->name, e->mtu, state);
+
+        /* move entry from interface list to interface history */
+        move_iflist_entry(e->index);
+        del_ifhist_entry();
+    }
+
+    return;
+}
+
 /*
  * parse interface information message
  */
@@ -413,8 +762,8 @@ int parse_ifimsg(struct nlmsghdr *nlh)
     struct ifinfomsg *ifim;
     int ifim_len;
     struct rtattr *ifla[__IFLA_MAX];
-    struct iflist_entry *ifle_tmp, *ifle;
-    char msg[MAX_MSG_SIZE] = "";
+    struct iflist_entry ifle_buf, *ifle_tmp = &ifle_buf, *ifle;
+    char msg[MAX_MSG_SIZE];
     char *mp = msg;
     int log_opts = get_log_opts();
 
@@ -437,12 +786,7 @@ int parse_ifimsg(struct nlmsghdr *nlh)
     if(log_opts & L_DEBUG)
         debug_ifimsg(0, ifim, ifla, ifim_len);
 
-    /* create new interface list entry */
-    ifle_tmp = malloc(sizeof(struct iflist_entry));
-    if(!ifle_tmp) {
-        rec_log("error: %s: malloc() failed", __func__);
-        return(1);
-    }
+    /* create temporary interface list entry */
     memset(ifle_tmp, 0, sizeof(struct iflist_entry));
     list_init(&(ifle_tmp->list));
 
@@ -451,74 +795,67 @@ int parse_ifimsg(struct nlmsghdr *nlh)
     ifle_tmp->type = ifim->ifi_type;
     ifle_tmp->br_state = 255;
 
+    /* terminate logging messages instead of clearing a whole buffer */
+    *msg = '\0';
+
     /* get interface name */
     if(ifla[IFLA_IFNAME])
-        if(parse_ifla_ifname(msg, &mp, ifla[IFLA_IFNAME], ifle_tmp)) {
-            free(ifle_tmp);
+        if(parse_ifla_ifname(msg, &mp, ifla[IFLA_IFNAME], ifle_tmp))
             return(1);
-        }
 
     /* get physical interface */
     if(ifla[IFLA_LINK])
-        if(parse_ifla_link(msg, &mp, ifla[IFLA_LINK], ifle_tmp)) {
-            free(ifle_tmp);
+        if(parse_ifla_link(msg, &mp, ifla[IFLA_LINK], ifle_tmp))
             return(1);
-        }
 
     /* get interface address */
     if(ifla[IFLA_ADDRESS])
-        if(parse_ifla_address(msg, &mp, ifla[IFLA_ADDRESS], ifle_tmp)) {
-            free(ifle_tmp);
+        if(parse_ifla_address(msg, &mp, ifla[IFLA_ADDRESS], ifle_tmp))
             return(1);
-        }
 
     /* get broadcast address */
     if(ifla[IFLA_BROADCAST])
-        if(parse_ifla_broadcast(msg, &mp, ifla[IFLA_BROADCAST], ifle_tmp)) {
-            free(ifle_tmp);
+        if(parse_ifla_broadcast(msg, &mp, ifla[IFLA_BROADCAST], ifle_tmp))
             return(1);
-        }
 
     /* get interface MTU */
     if(ifla[IFLA_MTU])
-        if(parse_ifla_mtu(msg, &mp, ifla[IFLA_MTU], ifle_tmp)) {
-            free(ifle_tmp);
+        if(parse_ifla_mtu(msg, &mp, ifla[IFLA_MTU], ifle_tmp))
             return(1);
-        }
 
 #if HAVE_DECL_IFLA_LINKINFO
     /* get interface information */
     if(ifla[IFLA_LINKINFO])
-        if(parse_ifla_linkinfo(msg, &mp, ifla[IFLA_LINKINFO], ifle_tmp)) {
-            free(ifle_tmp);
+        if(parse_ifla_linkinfo(msg, &mp, ifla[IFLA_LINKINFO], ifle_tmp))
             return(1);
-        }
 #endif
 
     /* get master interface */
     if(ifla[IFLA_MASTER])
-        if(parse_ifla_master(msg, &mp, ifla[IFLA_MASTER], ifle_tmp)) {
-            free(ifle_tmp);
+        if(parse_ifla_master(msg, &mp, ifla[IFLA_MASTER], ifle_tmp))
             return(1);
-        }
 
     /* get interface protocol information */
     if(ifla[IFLA_PROTINFO])
-        if(parse_ifla_protinfo(ifla[IFLA_PROTINFO], ifle_tmp, ifim->ifi_family)) {
-            free(ifle_tmp);
+        if(parse_ifla_protinfo(ifla[IFLA_PROTINFO], ifle_tmp, ifim->ifi_family))
             return(1);
-        }
 
     /* check RTM message(only RTM_NEWLINK or RTMDELLINK) */
     if((nlh->nlmsg_type != RTM_NEWLINK) && (nlh->nlmsg_type != RTM_DELLINK)) {
         rec_log("error: %s: unknown nlmsg_type: %d", __func__, nlh->nlmsg_type);
-        free(ifle_tmp);
         return(0);
     }
 
     /* search interface list entry */
     ifle = search_iflist(ifle_tmp->index);
 
+    /* an interface learned by a request is added when it is notified */
+    if(ifle && ifle->implicit && !learning &&
+        ifim->ifi_family == PF_UNSPEC && nlh->nlmsg_type == RTM_NEWLINK) {
+        del_iflist_entry(ifle->index);
+        ifle = NULL;
+    }
+
 #if HAVE_DECL_IFLA_BRPORT_UNSPEC
     /* check protocol family(PF_BRIDGE only) & nlmsg_type */
     if(ifim->ifi_family == PF_BRIDGE)
@@ -531,10 +868,8 @@ int parse_ifimsg(struct nlmsghdr *nlh)
 #endif
 
     /* check protocol family(PF_UNSPEC only) */
-    if(ifim->ifi_family != PF_UNSPEC) {
-        free(ifle_tmp);
+    if(ifim->ifi_family != PF_UNSPEC)
         return(0);
-    }
 
     /* check nlmsg_type */
     if(nlh->nlmsg_type == RTM_NEWLINK)
@@ -551,23 +886,31 @@ int parse_ifimsg(struct nlmsghdr *nlh)
 void parse_rtm_newlink(char *msg, struct iflist_entry *ifle,
     struct iflist_entry *ifle_tmp, struct rtattr *ifla[])
 {
+    char name[IFNAMSIZ] = "";
+    char old[HWADDR_STRLEN] = "", new[HWADDR_STRLEN] = "";
+    const struct link_kind *lk;
+
     if(ifle) {
         /* check bonding interface */
         if(!(ifle->flags & IFF_SLAVE) && (ifle_tmp->flags & IFF_SLAVE)) {
             rec_log("interface %s attached to bonding %s",
-                ifle_tmp->name, ifle_tmp->name_master);
-            strncpy(ifle->name_master, ifle_tmp->name_master, sizeof(ifle->name_master));
+                ifle_tmp->name, if_indextoname_from_lists(ifle_tmp->index_master, name));
+            ifle->index_attached = ifle_tmp->index_master;
         } else if((ifle->flags & IFF_SLAVE) && !(ifle_tmp->flags & IFF_SLAVE)) {
             rec_log("interface %s detached from bonding %s",
-                ifle_tmp->name, ifle->name_master);
-            strncpy(ifle->name_master, "", sizeof(ifle->name_master));
+                ifle_tmp->name, if_indextoname_from_lists(ifle->index_attached, name));
+            ifle->index_attached = 0;
         }
 
-        /* check administrative status */
-        if((ifle->flags & IFF_UP) && !(ifle_tmp->flags & IFF_UP))
+        /* check administrative status(kernel flushes IPv4 routes and nexthops silently) */
+        if((ifle->flags & IFF_UP) && !(ifle_tmp->flags & IFF_UP)) {
             rec_log("interface %s state changed to disabled",
                 ifle_tmp->name);
-        else if(!(ifle->flags & IFF_UP) && (ifle_tmp->flags & IFF_UP))
+#ifdef HAVE_LINUX_NEXTHOP_H
+            flush_nhlist_ifindex(ifle_tmp->index);
+#endif
+            flush_rib_ifindex(ifle_tmp->index);
+        } else if(!(ifle->flags & IFF_UP) && (ifle_tmp->flags & IFF_UP))
             rec_log("interface %s state changed to enabled",
                 ifle_tmp->name);
 
@@ -594,13 +937,18 @@ void parse_rtm_newlink(char *msg, struct iflist_entry *ifle,
             if(strncmp(ifle->name, ifle_tmp->name, IFNAMSIZ)) {
                 rec_log("interface name changed from %s to %s",
                     ifle->name, ifle_tmp->name);
+                unhash_ifname_entry(ifle);
                 strncpy(ifle->name, ifle_tmp->name, IFNAMSIZ);
+                hash_ifname_entry(ifle);
             }
         }
 
         /* check interface address */
         if(ifla[IFLA_ADDRESS]) {
-            if(memcmp(ifle->addr, ifle_tmp->addr, sizeof(ifle->addr))) {
+            if(ifle->addr_len != ifle_tmp->addr_len ||
+                memcmp(ifle->addr, ifle_tmp->addr, sizeof(ifle->addr))) {
+                conv_ifaddr(ifle->type, ifle->addr, ifle->addr_len, old, sizeof(old));
+                conv_ifaddr(ifle_tmp->type, ifle_tmp->addr, ifle_tmp->addr_len, new, sizeof(new));
                 switch(ifle_tmp->type) {
                     case ARPHRD_TUNNEL:
                     case ARPHRD_IPGRE:
@@ -610,19 +958,21 @@ void parse_rtm_newlink(char *msg, struct iflist_entry *ifle,
                     case ARPHRD_IP6GRE:
 #endif
                         rec_log("interface %s local address changed from %s to %s",
-                            ifle->name, ifle->addr, ifle_tmp->addr);
+                            ifle->name, old, new);
                         break;
                     default:
                         rec_log("interface %s link layer address changed from %s to %s",
-                            ifle->name, ifle->addr, ifle_tmp->addr);
+                            ifle->name, old, new);
                 }
                 memcpy(ifle->addr, ifle_tmp->addr, sizeof(ifle->addr));
+                ifle->addr_len = ifle_tmp->addr_len;
             }
         }
 
         /* check broadcast address */
         if(ifla[IFLA_BROADCAST]) {
-            if(memcmp(ifle->brd, ifle_tmp->brd, sizeof(ifle->brd))) {
+            if(ifle->brd_len != ifle_tmp->brd_len ||
+                memcmp(ifle->brd, ifle_tmp->brd, sizeof(ifle->brd))) {
                 switch(ifle_tmp->type) {
                     case ARPHRD_TUNNEL:
                     case ARPHRD_IPGRE:
@@ -632,10 +982,14 @@ void parse_rtm_newlink(char *msg, struct iflist_entry *ifle,
                     case ARPHRD_IP6GRE:
 #endif
                         rec_log("interface %s remote address changed from %s to %s",
-                            ifle->name, ifle->brd, ifle_tmp->brd);
+                            ifle->name,
+                            conv_ifaddr(ifle->type, ifle->brd, ifle->brd_len, old, sizeof(old)),
+                            conv_ifaddr(ifle_tmp->type, ifle_tmp->brd, ifle_tmp->brd_len,
+                                new, sizeof(new)));
                         break;
                 }
                 memcpy(ifle->brd, ifle_tmp->brd, sizeof(ifle->brd));
+                ifle->brd_len = ifle_tmp->brd_len;
             }
         }
 
@@ -650,22 +1004,30 @@ void parse_rtm_newlink(char *msg, struct iflist_entry *ifle,
             }
         } 
 
-        /* check interface vlan id */
-        if(ifle->vid != ifle_tmp->vid) {
-            rec_log("interface %s vlan id changed from %hu to %hu",
-                ifle->name, ifle->vid, ifle_tmp->vid);
-            ifle->vid = ifle_tmp->vid;
-        }
+        /* check attributes of an interface kind */
+        lk = kind_ops[ifle->kind];
+        if(lk && lk->diff)
+            lk->diff(ifle, ifle_tmp);
 
         /* check master interface */
         if(ifle->index_master != ifle_tmp->index_master) {
             ifle->index_master = ifle_tmp->index_master;
         }
 
-        free(ifle_tmp);
+        if(resyncing)
+            ifle->mark = 1;
     } else {
-        /* add interface list entry*/
-        add_iflist_entry(&(ifle_tmp->list));
+        /* add interface list entry copied from temporary one */
+        ifle = pool_alloc(&iflist_pool);
+        if(!ifle)
+            return;
+        *ifle = *ifle_tmp;
+        ifle->mark = resyncing;
+        ifle->implicit = learning;
+        if(add_iflist_entry(ifle) < 0) {
+            pool_free(&iflist_pool, ifle);
+            return;
+        }
 
         /* check interface state */
         char state[MAX_STR_SIZE] = "";
@@ -692,6 +1054,10 @@ void parse_rtm_dellink(char *msg, struct iflist_entry *ifle, struct iflist_entry
     /* move entry from interface list to interface history */
     move_iflist_entry(ifle_tmp->index);
     del_ifhist_entry();
+#ifdef HAVE_LINUX_NEXTHOP_H
+    flush_nhlist_ifindex(ifle_tmp->index);
+#endif
+    flush_rib_ifindex(ifle_tmp->index);
 
     /* check interface state */
     char state[MAX_STR_SIZE] = "";
@@ -705,7 +1071,6 @@ void parse_rtm_dellink(char *msg, struct iflist_entry *ifle, struct iflist_entry
         strcat(state, "linkup") : strcat(state, "linkdown");
 
     rec_log("interface deleted: %sstate=%s", msg, state);
-    free(ifle_tmp);
 
     return;
 }
@@ -726,8 +1091,11 @@ int parse_ifla_ifname(char *msg, char **mp, struct rtattr *ifla, struct iflist_e
     }
     strncpy(ifle->name, RTA_DATA(ifla), sizeof(ifle->name));
 
-    if(msg)
-        *mp = add_log(msg, *mp, "name=%s ", ifle->name);
+    if(msg) {
+        *mp = add_str(msg, *mp, "name=");
+        *mp = add_str(msg, *mp, ifle->name);
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -749,7 +1117,9 @@ int parse_ifla_link(char *msg, char **mp, struct rtattr *ifla, struct iflist_ent
     if(index && ifle->index != index) {
         if_indextoname_from_lists(index, name);
 
-        *mp = add_log(msg, *mp, "link=%s ", name);
+        *mp = add_str(msg, *mp, "link=");
+        *mp = add_str(msg, *mp, name);
+        *mp = add_str(msg, *mp, " ");
     }
 
     return(0);
@@ -760,17 +1130,22 @@ int parse_ifla_link(char *msg, char **mp, struct rtattr *ifla, struct iflist_ent
  */
 int parse_ifla_address(char *msg, char **mp, struct rtattr *ifla, struct iflist_entry *ifle)
 {
-    char addr[INET6_ADDRSTRLEN+1] = "";
+    char addr[HWADDR_STRLEN] = "";
     int res;
 
-    res = arphrd_ntop(ifle->type, ifla, addr, sizeof(addr));
+    ifle->addr_len = (RTA_PAYLOAD(ifla) < HWADDR_MAX) ? RTA_PAYLOAD(ifla) : HWADDR_MAX;
+    memcpy(ifle->addr, RTA_DATA(ifla), ifle->addr_len);
+
+    if(!msg)
+        return(0);
+
+    res = hwaddr_ntop(ifle->type, ifle->addr, ifle->addr_len, addr, sizeof(addr));
     if(res) {
         rec_log("error: %s: ifindex %d: %s",
             __func__, ifle->index,
             (res == 1) ? strerror(errno) : "payload too short");
         return(1);
     }
-    memcpy(ifle->addr, addr, sizeof(addr));
 
     if(msg)
         switch(ifle->type) {
@@ -781,10 +1156,14 @@ int parse_ifla_address(char *msg, char **mp, struct rtattr *ifla, struct iflist_
 #ifdef ARPHRD_IP6GRE
             case ARPHRD_IP6GRE:
 #endif
-                *mp = add_log(msg, *mp, "local=%s ", ifle->addr);
+                *mp = add_str(msg, *mp, "local=");
+                *mp = add_str(msg, *mp, addr);
+                *mp = add_str(msg, *mp, " ");
                 break;
             default:
-                *mp = add_log(msg, *mp, "mac=%s ", ifle->addr);
+                *mp = add_str(msg, *mp, "mac=");
+                *mp = add_str(msg, *mp, addr);
+                *mp = add_str(msg, *mp, " ");
         }
 
     return(0);
@@ -795,17 +1174,22 @@ int parse_ifla_address(char *msg, char **mp, struct rtattr *ifla, struct iflist_
  */
 int parse_ifla_broadcast(char *msg, char **mp, struct rtattr *ifla, struct iflist_entry *ifle)
 {
-    char brd[INET6_ADDRSTRLEN+1] = "";
+    char brd[HWADDR_STRLEN] = "";
     int res;
 
-    res = arphrd_ntop(ifle->type, ifla, brd, sizeof(brd));
+    ifle->brd_len = (RTA_PAYLOAD(ifla) < HWADDR_MAX) ? RTA_PAYLOAD(ifla) : HWADDR_MAX;
+    memcpy(ifle->brd, RTA_DATA(ifla), ifle->brd_len);
+
+    if(!msg)
+        return(0);
+
+    res = hwaddr_ntop(ifle->type, ifle->brd, ifle->brd_len, brd, sizeof(brd));
     if(res) {
         rec_log("error: %s: ifindex %d: %s",
             __func__, ifle->index,
             (res == 1) ? strerror(errno) : "pyaload too short");
         return(1);
     }
-    memcpy(ifle->brd, brd, sizeof(brd));
 
     if(msg)
         switch(ifle->type) {
@@ -816,7 +1200,9 @@ int parse_ifla_broadcast(char *msg, char **mp, struct rtattr *ifla, struct iflis
 #ifdef ARPHRD_IP6GRE
             case ARPHRD_IP6GRE:
 #endif
-                *mp = add_log(msg, *mp, "remote=%s ", ifle->brd);
+                *mp = add_str(msg, *mp, "remote=");
+                *mp = add_str(msg, *mp, brd);
+                *mp = add_str(msg, *mp, " ");
                 break;
         }
 
@@ -835,8 +1221,11 @@ int parse_ifla_mtu(char *msg, char **mp, struct rtattr *ifla, struct iflist_entr
     }
     ifle->mtu = *(int *)RTA_DATA(ifla);
 
-    if(msg)
-        *mp = add_log(msg, *mp, "mtu=%d ", ifle->mtu);
+    if(msg) {
+        *mp = add_str(msg, *mp, "mtu=");
+        *mp = add_u32(msg, *mp, ifle->mtu);
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -871,15 +1260,18 @@ int parse_ifla_info_kind(char *msg, char **mp, struct rtattr *info, struct iflis
         rec_log("error: %s: ifindex %d: no payload",
             __func__, ifle->index);
         return(1);
-    } if(RTA_PAYLOAD(info) > sizeof(ifle->kind)) {
+    } if(RTA_PAYLOAD(info) > MODULE_NAME_LEN) {
         rec_log("error: %s: ifindex %d: payload too long",
             __func__, ifle->index);
         return(1);
     }
-    strncpy(ifle->kind, (char *)RTA_DATA(info), sizeof(ifle->kind));
+    ifle->kind = get_kind_id((char *)RTA_DATA(info));
 
-    if(msg)
-        *mp = add_log(msg, *mp, "kind=%s ", ifle->kind);
+    if(msg) {
+        *mp = add_str(msg, *mp, "kind=");
+        *mp = add_str(msg, *mp, conv_kind_id(ifle->kind));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -889,32 +1281,11 @@ int parse_ifla_info_kind(char *msg, char **mp, struct rtattr *info, struct iflis
  */
 int parse_ifla_info_data(char *msg, char **mp, struct rtattr *info, struct iflist_entry *ifle)
 {
-#if HAVE_DECL_IFLA_VLAN_UNSPEC
-    if(!strncmp(ifle->kind, "vlan", sizeof(ifle->kind)))
-        parse_ifla_vlan(msg, mp, info, ifle);
-#endif
-#if HAVE_DECL_IFLA_GRE_UNSPEC
-    if(!strncmp(ifle->kind, "gre", sizeof(ifle->kind)))
-        parse_ifla_gre(msg, mp, info, ifle);
+    const struct link_kind *lk = kind_ops[ifle->kind];
 
-    if(!strncmp(ifle->kind, "gretap", sizeof(ifle->kind)))
-        parse_ifla_gre(msg, mp, info, ifle);
-#endif
-#if HAVE_DECL_IFLA_MACVLAN_UNSPEC
-    if(!strncmp(ifle->kind, "macvlan", sizeof(ifle->kind)))
-        parse_ifla_macvlan(msg, mp, info, ifle);
+    if(lk && lk->parse)
+        lk->parse(msg, mp, info, ifle);
 
-    if(!strncmp(ifle->kind, "macvtap", sizeof(ifle->kind)))
-        parse_ifla_macvlan(msg, mp, info, ifle);
-#endif
-#if HAVE_DECL_IFLA_VXLAN_UNSPEC
-    if(!strncmp(ifle->kind, "vxlan", sizeof(ifle->kind)))
-        parse_ifla_vxlan(msg, mp, info, ifle);
-#endif
-#if HAVE_DECL_IFLA_BOND_UNSPEC
-    if(!strncmp(ifle->kind, "bond", sizeof(ifle->kind)))
-        parse_ifla_bond(msg, mp, info, ifle);
-#endif
     return(0);
 }
 #endif
@@ -924,16 +1295,20 @@ int parse_ifla_info_data(char *msg, char **mp, struct rtattr *info, struct iflis
  */
 int parse_ifla_master(char *msg, char **mp, struct rtattr *ifla, struct iflist_entry *ifle)
 {
+    char name[IFNAMSIZ] = "";
+
     if(RTA_PAYLOAD(ifla) < sizeof(ifle->index_master)) {
         rec_log("error: %s: IFLA_MASTER(ifindex %d): payload too short",
             __func__, ifle->index);
         return(1);
     }
     ifle->index_master = *(int *)RTA_DATA(ifla);
-    if_indextoname_from_lists(ifle->index_master, ifle->name_master);
 
-    if(msg)
-        *mp = add_log(msg, *mp, "master=%s ", ifle->name_master);
+    if(msg) {
+        *mp = add_str(msg, *mp, "master=");
+        *mp = add_str(msg, *mp, if_indextoname_from_lists(ifle->index_master, name));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -1299,48 +1674,15 @@ void debug_ifla_linkinfo(int lev, struct rtattr *ifla,
 void debug_ifla_info_data(int lev, struct rtattr *info,
     const char *name, struct ifinfomsg *ifim, char *kind, int len)
 {
-    rec_dbg(lev, "%s(%hu):", name, RTA_ALIGN(info->rta_len));
-
-#if HAVE_DECL_IFLA_VLAN_UNSPEC
-    if(!strncmp(kind, "vlan", len)) {
-        debug_ifla_vlan(lev, info);
-        return;
-    }
-#endif
-#if HAVE_DECL_IFLA_GRE_UNSPEC
-    if(!strncmp(kind, "gre", len)) {
-        debug_ifla_gre(lev, ifim, info);
-        return;
-    }
+    const struct link_kind *lk;
 
-    if(!strncmp(kind, "gretap", len)) {
-        debug_ifla_gre(lev, ifim, info);
-        return;
-    }
-#endif
-#if HAVE_DECL_IFLA_MACVLAN_UNSPEC
-    if(!strncmp(kind, "macvlan", len)) {
-        debug_ifla_macvlan(lev, info);
-        return;
-    }
+    rec_dbg(lev, "%s(%hu):", name, RTA_ALIGN(info->rta_len));
 
-    if(!strncmp(kind, "macvtap", len)) {
-        debug_ifla_macvlan(lev, info);
+    lk = find_link_kind(kind, len);
+    if(lk && lk->debug) {
+        lk->debug(lev, ifim, info);
         return;
     }
-#endif
-#if HAVE_DECL_IFLA_VXLAN_UNSPEC
-    if(!strncmp(kind, "vxlan", len)) { 
-        debug_ifla_vxlan(lev, info);
-        return;
-    }
-#endif
-#if HAVE_DECL_IFLA_BOND_UNSPEC
-    if(!strncmp(kind, "bond", len)) { 
-        debug_ifla_bond(lev, info);
-        return;
-    }
-#endif
 
     rec_dbg(lev, "%s(%hu): -- ignored --",
         name, RTA_ALIGN(info->rta_len));
@@ -1356,14 +1698,15 @@ void debug_ifla_info_data(int lev, struct rtattr *info,
 void debug_ifla_info_slave_data(int lev, struct rtattr *info,
     const char *name, struct ifinfomsg *ifim, char *kind, int len)
 {
+    const struct link_kind *lk;
+
     rec_dbg(lev, "%s(%hu):", name, RTA_ALIGN(info->rta_len));
 
-#if HAVE_DECL_IFLA_BOND_MIIMON
-    if(!strncmp(kind, "bond", len)) {
-        debug_ifla_bond_slave(lev, info);
+    lk = find_link_kind(kind, len);
+    if(lk && lk->debug_slave) {
+        lk->debug_slave(lev, info);
         return;
     }
-#endif
 
     rec_dbg(lev, "%s(%hu): -- ignored --",
         name, RTA_ALIGN(info->rta_len));
@@ -1442,74 +1785,73 @@ void debug_ifla_stats64(int lev, struct rtattr *ifla, const char *name)
  */
 const char *conv_af_type(unsigned char family, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _AF_TYPE(s) \
-    if(family == AF_##s) \
-        return #s;
-    _AF_TYPE(UNSPEC);
-    _AF_TYPE(LOCAL);
-    _AF_TYPE(UNIX);
-    _AF_TYPE(FILE);
-    _AF_TYPE(INET);
-    _AF_TYPE(AX25);
-    _AF_TYPE(IPX);
-    _AF_TYPE(APPLETALK);
-    _AF_TYPE(NETROM);
-    _AF_TYPE(BRIDGE);
-    _AF_TYPE(ATMPVC);
-    _AF_TYPE(X25);
-    _AF_TYPE(INET6);
-    _AF_TYPE(ROSE);
-    _AF_TYPE(DECnet);
-    _AF_TYPE(NETBEUI);
-    _AF_TYPE(SECURITY);
-    _AF_TYPE(KEY);
-    _AF_TYPE(NETLINK);
-    _AF_TYPE(ROUTE);
-    _AF_TYPE(PACKET);
-    _AF_TYPE(ASH);
-    _AF_TYPE(ECONET);
-    _AF_TYPE(ATMSVC);
+        [AF_##s] = { #s, #s },
+        _AF_TYPE(UNSPEC)
+        _AF_TYPE(LOCAL) /* also UNIX and FILE */
+        _AF_TYPE(INET)
+        _AF_TYPE(AX25)
+        _AF_TYPE(IPX)
+        _AF_TYPE(APPLETALK)
+        _AF_TYPE(NETROM)
+        _AF_TYPE(BRIDGE)
+        _AF_TYPE(ATMPVC)
+        _AF_TYPE(X25)
+        _AF_TYPE(INET6)
+        _AF_TYPE(ROSE)
+        _AF_TYPE(DECnet)
+        _AF_TYPE(NETBEUI)
+        _AF_TYPE(SECURITY)
+        _AF_TYPE(KEY)
+        _AF_TYPE(NETLINK) /* also ROUTE */
+        _AF_TYPE(PACKET)
+        _AF_TYPE(ASH)
+        _AF_TYPE(ECONET)
+        _AF_TYPE(ATMSVC)
 #ifdef AF_RDS
-    _AF_TYPE(RDS);
+        _AF_TYPE(RDS)
 #endif
-    _AF_TYPE(SNA);
-    _AF_TYPE(IRDA);
-    _AF_TYPE(PPPOX);
-    _AF_TYPE(WANPIPE);
+        _AF_TYPE(SNA)
+        _AF_TYPE(IRDA)
+        _AF_TYPE(PPPOX)
+        _AF_TYPE(WANPIPE)
 #ifdef AF_LLC
-    _AF_TYPE(LLC);
+        _AF_TYPE(LLC)
 #endif
 #ifdef AF_CAN
-    _AF_TYPE(CAN);
+        _AF_TYPE(CAN)
 #endif
 #ifdef AF_TIPC
-    _AF_TYPE(TIPC);
+        _AF_TYPE(TIPC)
 #endif
-    _AF_TYPE(BLUETOOTH);
+        _AF_TYPE(BLUETOOTH)
 #ifdef AF_IUCV
-    _AF_TYPE(IUCV);
+        _AF_TYPE(IUCV)
 #endif
 #ifdef AF_RXRPC
-    _AF_TYPE(RXRPC);
+        _AF_TYPE(RXRPC)
 #endif
 #ifdef AF_ISDN
-    _AF_TYPE(ISDN);
+        _AF_TYPE(ISDN)
 #endif
 #ifdef AF_PHONET
-    _AF_TYPE(PHONET);
+        _AF_TYPE(PHONET)
 #endif
 #ifdef AF_IEEE802154
-    _AF_TYPE(IEEE802154);
+        _AF_TYPE(IEEE802154)
 #endif
 #ifdef AF_CAIF
-    _AF_TYPE(CAIF);
+        _AF_TYPE(CAIF)
 #endif
 #ifdef AF_ALG
-    _AF_TYPE(ALG);
+        _AF_TYPE(ALG)
 #endif
-    _AF_TYPE(MAX);
+        _AF_TYPE(MAX)
 #undef _AF_TYPE
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, family, debug, "UNKNOWN"));
 }
 
 /*
@@ -1517,83 +1859,84 @@ const char *conv_af_type(unsigned char family, unsigned char debug)
  */ 
 const char *conv_arphrd_type(unsigned short type, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _ARPHRD_TYPE(s) \
-    if(type == ARPHRD_##s) \
-        return(#s);
-    _ARPHRD_TYPE(NETROM);
-    _ARPHRD_TYPE(ETHER);
-    _ARPHRD_TYPE(EETHER);
-    _ARPHRD_TYPE(AX25);
-    _ARPHRD_TYPE(PRONET);
-    _ARPHRD_TYPE(CHAOS);
-    _ARPHRD_TYPE(IEEE802);
-    _ARPHRD_TYPE(ARCNET);
-    _ARPHRD_TYPE(APPLETLK);
-    _ARPHRD_TYPE(DLCI);
-    _ARPHRD_TYPE(ATM);
-    _ARPHRD_TYPE(METRICOM);
-    _ARPHRD_TYPE(IEEE1394);
-    _ARPHRD_TYPE(EUI64);
-    _ARPHRD_TYPE(INFINIBAND);
-    _ARPHRD_TYPE(SLIP);
-    _ARPHRD_TYPE(CSLIP);
-    _ARPHRD_TYPE(SLIP6);
-    _ARPHRD_TYPE(CSLIP6);
-    _ARPHRD_TYPE(RSRVD);
-    _ARPHRD_TYPE(ADAPT);
-    _ARPHRD_TYPE(ROSE);
-    _ARPHRD_TYPE(X25);
-    _ARPHRD_TYPE(HWX25);
+        [ARPHRD_##s] = { #s, #s },
+        _ARPHRD_TYPE(NETROM)
+        _ARPHRD_TYPE(ETHER)
+        _ARPHRD_TYPE(EETHER)
+        _ARPHRD_TYPE(AX25)
+        _ARPHRD_TYPE(PRONET)
+        _ARPHRD_TYPE(CHAOS)
+        _ARPHRD_TYPE(IEEE802)
+        _ARPHRD_TYPE(ARCNET)
+        _ARPHRD_TYPE(APPLETLK)
+        _ARPHRD_TYPE(DLCI)
+        _ARPHRD_TYPE(ATM)
+        _ARPHRD_TYPE(METRICOM)
+        _ARPHRD_TYPE(IEEE1394)
+        _ARPHRD_TYPE(EUI64)
+        _ARPHRD_TYPE(INFINIBAND)
+        _ARPHRD_TYPE(SLIP)
+        _ARPHRD_TYPE(CSLIP)
+        _ARPHRD_TYPE(SLIP6)
+        _ARPHRD_TYPE(CSLIP6)
+        _ARPHRD_TYPE(RSRVD)
+        _ARPHRD_TYPE(ADAPT)
+        _ARPHRD_TYPE(ROSE)
+        _ARPHRD_TYPE(X25)
+        _ARPHRD_TYPE(HWX25)
 #ifdef ARPHRD_CAN
-    _ARPHRD_TYPE(CAN);
+        _ARPHRD_TYPE(CAN)
 #endif
-    _ARPHRD_TYPE(PPP);
-    _ARPHRD_TYPE(CISCO);
-    _ARPHRD_TYPE(HDLC);
-    _ARPHRD_TYPE(LAPB);
-    _ARPHRD_TYPE(DDCMP);
-    _ARPHRD_TYPE(RAWHDLC);
-    _ARPHRD_TYPE(TUNNEL);
-    _ARPHRD_TYPE(TUNNEL6);
-    _ARPHRD_TYPE(FRAD);
-    _ARPHRD_TYPE(SKIP);
-    _ARPHRD_TYPE(LOOPBACK);
-    _ARPHRD_TYPE(LOCALTLK);
-    _ARPHRD_TYPE(FDDI);
-    _ARPHRD_TYPE(BIF);
-    _ARPHRD_TYPE(SIT);
-    _ARPHRD_TYPE(IPDDP);
-    _ARPHRD_TYPE(IPGRE);
-    _ARPHRD_TYPE(PIMREG);
-    _ARPHRD_TYPE(HIPPI);
-    _ARPHRD_TYPE(ASH);
-    _ARPHRD_TYPE(ECONET);
-    _ARPHRD_TYPE(IRDA);
-    _ARPHRD_TYPE(FCPP);
-    _ARPHRD_TYPE(FCAL);
-    _ARPHRD_TYPE(FCPL);
-    _ARPHRD_TYPE(FCFABRIC);
-    _ARPHRD_TYPE(IEEE802_TR);
-    _ARPHRD_TYPE(IEEE80211);
-    _ARPHRD_TYPE(IEEE80211_PRISM);
-    _ARPHRD_TYPE(IEEE80211_RADIOTAP);
+        _ARPHRD_TYPE(PPP)
+        _ARPHRD_TYPE(CISCO) /* also HDLC */
+        _ARPHRD_TYPE(LAPB)
+        _ARPHRD_TYPE(DDCMP)
+        _ARPHRD_TYPE(RAWHDLC)
+        _ARPHRD_TYPE(TUNNEL)
+        _ARPHRD_TYPE(TUNNEL6)
+        _ARPHRD_TYPE(FRAD)
+        _ARPHRD_TYPE(SKIP)
+        _ARPHRD_TYPE(LOOPBACK)
+        _ARPHRD_TYPE(LOCALTLK)
+        _ARPHRD_TYPE(FDDI)
+        _ARPHRD_TYPE(BIF)
+        _ARPHRD_TYPE(SIT)
+        _ARPHRD_TYPE(IPDDP)
+        _ARPHRD_TYPE(IPGRE)
+        _ARPHRD_TYPE(PIMREG)
+        _ARPHRD_TYPE(HIPPI)
+        _ARPHRD_TYPE(ASH)
+        _ARPHRD_TYPE(ECONET)
+        _ARPHRD_TYPE(IRDA)
+        _ARPHRD_TYPE(FCPP)
+        _ARPHRD_TYPE(FCAL)
+        _ARPHRD_TYPE(FCPL)
+        _ARPHRD_TYPE(FCFABRIC)
+        _ARPHRD_TYPE(IEEE802_TR)
+        _ARPHRD_TYPE(IEEE80211)
+        _ARPHRD_TYPE(IEEE80211_PRISM)
+        _ARPHRD_TYPE(IEEE80211_RADIOTAP)
 #ifdef ARPHRD_IEEE802154
-    _ARPHRD_TYPE(IEEE802154);
+        _ARPHRD_TYPE(IEEE802154)
 #endif
 #ifdef ARPHRD_PHONET
-    _ARPHRD_TYPE(PHONET);
+        _ARPHRD_TYPE(PHONET)
 #endif
 #ifdef ARPHRD_PHONET_PIPE
-    _ARPHRD_TYPE(PHONET_PIPE);
+        _ARPHRD_TYPE(PHONET_PIPE)
 #endif
 #ifdef ARPHRD_CAIF
-    _ARPHRD_TYPE(CAIF);
+        _ARPHRD_TYPE(CAIF)
 #endif
 #ifdef ARPHRD_IP6GRE
-    _ARPHRD_TYPE(IP6GRE);
+        _ARPHRD_TYPE(IP6GRE)
 #endif
 #undef _ARPHRD_TYPE
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, type, debug, "UNKNOWN"));
 }
 
 /*
@@ -1601,43 +1944,36 @@ const char *conv_arphrd_type(unsigned short type, unsigned char debug)
  */
 const char *conv_iff_flags(unsigned flags, unsigned char debug)
 {
-    static char list[MAX_STR_SIZE];
-    unsigned len = sizeof(list);
-
-    strncpy(list, "", sizeof(list));
-    if(!flags) {
-        strncpy(list, "NONE", len);
-        return((const char *)list);
-    }
+    static const struct flag_name names[] = {
 #define _IFF_FLAGS(s) \
-    if((flags & IFF_##s) && (len - strlen(list) -1 > 0)) \
-        (flags &= ~IFF_##s) ? \
-            strncat(list, #s ",", len - strlen(list) - 1) : \
-            strncat(list, #s, len - strlen(list) - 1);
-    _IFF_FLAGS(UP);
-    _IFF_FLAGS(BROADCAST);
-    _IFF_FLAGS(DEBUG);
-    _IFF_FLAGS(LOOPBACK);
-    _IFF_FLAGS(POINTOPOINT);
-    _IFF_FLAGS(NOTRAILERS);
-    _IFF_FLAGS(RUNNING);
-    _IFF_FLAGS(NOARP);
-    _IFF_FLAGS(PROMISC);
-    _IFF_FLAGS(ALLMULTI);
-    _IFF_FLAGS(MASTER);
-    _IFF_FLAGS(SLAVE);
-    _IFF_FLAGS(MULTICAST);
-    _IFF_FLAGS(PORTSEL);
-    _IFF_FLAGS(AUTOMEDIA);
-    _IFF_FLAGS(DYNAMIC);
-    _IFF_FLAGS(LOWER_UP);
-    _IFF_FLAGS(DORMANT);
+        { IFF_##s, #s },
+        _IFF_FLAGS(UP)
+        _IFF_FLAGS(BROADCAST)
+        _IFF_FLAGS(DEBUG)
+        _IFF_FLAGS(LOOPBACK)
+        _IFF_FLAGS(POINTOPOINT)
+        _IFF_FLAGS(NOTRAILERS)
+        _IFF_FLAGS(RUNNING)
+        _IFF_FLAGS(NOARP)
+        _IFF_FLAGS(PROMISC)
+        _IFF_FLAGS(ALLMULTI)
+        _IFF_FLAGS(MASTER)
+        _IFF_FLAGS(SLAVE)
+        _IFF_FLAGS(MULTICAST)
+        _IFF_FLAGS(PORTSEL)
+        _IFF_FLAGS(AUTOMEDIA)
+        _IFF_FLAGS(DYNAMIC)
+        _IFF_FLAGS(LOWER_UP)
+        _IFF_FLAGS(DORMANT)
 #ifdef IFF_ECHO
-    _IFF_FLAGS(ECHO);
+        _IFF_FLAGS(ECHO)
 #endif
 #undef _IFF_FLAGS
-    if(!strlen(list))
-        strncpy(list, "UNKNOWN", len);
+    };
+    static struct flag_table ft = FLAG_TABLE(names, ",");
+    static char list[MAX_STR_SIZE];
+
+    conv_flags(&ft, flags, list, sizeof(list));
 
     return((const char *)list);
 }
@@ -1647,18 +1983,20 @@ const char *conv_iff_flags(unsigned flags, unsigned char debug)
  */
 const char *conv_if_oper_state(unsigned char state, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _IF_OPER_STATE(s) \
-    if(state == IF_OPER_##s) \
-        return(#s);
-    _IF_OPER_STATE(UNKNOWN);
-    _IF_OPER_STATE(NOTPRESENT);
-    _IF_OPER_STATE(DOWN);
-    _IF_OPER_STATE(LOWERLAYERDOWN);
-    _IF_OPER_STATE(TESTING);
-    _IF_OPER_STATE(DORMANT);
-    _IF_OPER_STATE(UP);
+        [IF_OPER_##s] = { #s, #s },
+        _IF_OPER_STATE(UNKNOWN)
+        _IF_OPER_STATE(NOTPRESENT)
+        _IF_OPER_STATE(DOWN)
+        _IF_OPER_STATE(LOWERLAYERDOWN)
+        _IF_OPER_STATE(TESTING)
+        _IF_OPER_STATE(DORMANT)
+        _IF_OPER_STATE(UP)
 #undef _IF_OPER_STATE
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, state, debug, "UNKNOWN"));
 }
 
 /*
@@ -1666,11 +2004,13 @@ const char *conv_if_oper_state(unsigned char state, unsigned char debug)
  */
 const char *conv_if_link_mode(unsigned char mode, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _IFLA_LINKMODE(s) \
-    if(mode == IF_LINK_MODE_##s) \
-        return(#s);
-    _IFLA_LINKMODE(DEFAULT);
-    _IFLA_LINKMODE(DORMANT);
+        [IF_LINK_MODE_##s] = { #s, #s },
+        _IFLA_LINKMODE(DEFAULT)
+        _IFLA_LINKMODE(DORMANT)
 #undef _IFLA_LINKMODE
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, mode, debug, "UNKNOWN"));
 }
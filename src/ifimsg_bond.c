@@ -56,9 +56,11 @@ int parse_ifla_bond_mode(char *msg, char **mp,
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "mode=%s ",
-            conv_bond_mode(*(unsigned char *)RTA_DATA(bond), 0));
+    if(msg) {
+        *mp = add_str(msg, *mp, "mode=");
+        *mp = add_str(msg, *mp, conv_bond_mode(*(unsigned char *)RTA_DATA(bond), 0));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -76,9 +78,11 @@ int parse_ifla_bond_xmit_hash_policy(char *msg, char **mp,
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "hash=%s ",
-            conv_bond_xmit_policy(*(unsigned char *)RTA_DATA(bond), 0));
+    if(msg) {
+        *mp = add_str(msg, *mp, "hash=");
+        *mp = add_str(msg, *mp, conv_bond_xmit_policy(*(unsigned char *)RTA_DATA(bond), 0));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -87,7 +91,7 @@ int parse_ifla_bond_xmit_hash_policy(char *msg, char **mp,
 /*
  * debug BOND interface information messages
  */
-void debug_ifla_bond(int lev, struct rtattr *info)
+void debug_ifla_bond(int lev, struct ifinfomsg *ifim, struct rtattr *info)
 {
     struct rtattr *bond[__IFLA_BOND_MAX];
 
@@ -295,18 +299,20 @@ void debug_ifla_bond_slave(int lev, struct rtattr *bond)
  */
 const char *conv_bond_mode(unsigned char mode, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _BOND_MODE(s1, s2) \
-    if(mode == BOND_MODE_##s1) \
-        return(debug ? #s1 : #s2);
-    _BOND_MODE(ROUNDROBIN, balance-rr);
-    _BOND_MODE(ACTIVEBACKUP, active-backup);
-    _BOND_MODE(XOR, balance-xor);
-    _BOND_MODE(BROADCAST, broadcast);
-    _BOND_MODE(8023AD, 802.3ad);
-    _BOND_MODE(TLB, balance-tlb);
-    _BOND_MODE(ALB, balance-alb);
+        [BOND_MODE_##s1] = { #s2, #s1 },
+        _BOND_MODE(ROUNDROBIN, balance-rr)
+        _BOND_MODE(ACTIVEBACKUP, active-backup)
+        _BOND_MODE(XOR, balance-xor)
+        _BOND_MODE(BROADCAST, broadcast)
+        _BOND_MODE(8023AD, 802.3ad)
+        _BOND_MODE(TLB, balance-tlb)
+        _BOND_MODE(ALB, balance-alb)
 #undef _BOND_MODE
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, mode, debug, "UNKNOWN"));
 }
 
 #if HAVE_DECL_IFLA_BOND_MIIMON
@@ -315,16 +321,18 @@ const char *conv_bond_mode(unsigned char mode, unsigned char debug)
  */
 const char *conv_bond_xmit_policy(unsigned char policy, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _BOND_XMIT_POLICY(s1, s2) \
-    if(policy == BOND_XMIT_POLICY_##s1) \
-        return(debug ? #s1 : #s2);
-    _BOND_XMIT_POLICY(LAYER2, layer2);
-    _BOND_XMIT_POLICY(LAYER34, layer3+4);
-    _BOND_XMIT_POLICY(LAYER23, layer2+3);
-    _BOND_XMIT_POLICY(ENCAP23, encap2+3);
-    _BOND_XMIT_POLICY(ENCAP34, encap3+4);
+        [BOND_XMIT_POLICY_##s1] = { #s2, #s1 },
+        _BOND_XMIT_POLICY(LAYER2, layer2)
+        _BOND_XMIT_POLICY(LAYER34, layer3+4)
+        _BOND_XMIT_POLICY(LAYER23, layer2+3)
+        _BOND_XMIT_POLICY(ENCAP23, encap2+3)
+        _BOND_XMIT_POLICY(ENCAP34, encap3+4)
 #undef _BOND_XMIT_POLICY
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, policy, debug, "UNKNOWN"));
 }
 
 /*
@@ -332,13 +340,15 @@ const char *conv_bond_xmit_policy(unsigned char policy, unsigned char debug)
  */
 const char *conv_bond_state(unsigned char state, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _BOND_STATE(s1, s2) \
-    if(state == BOND_STATE_##s1) \
-        return(debug ? #s1 : #s2);
-    _BOND_STATE(ACTIVE, active);
-    _BOND_STATE(BACKUP, backup);
+        [BOND_STATE_##s1] = { #s2, #s1 },
+        _BOND_STATE(ACTIVE, active)
+        _BOND_STATE(BACKUP, backup)
 #undef _BOND_STATE
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, state, debug, "UNKNOWN"));
 }
 
 /*
@@ -346,15 +356,17 @@ const char *conv_bond_state(unsigned char state, unsigned char debug)
  */
 const char *conv_bond_link(unsigned char link, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _BOND_LINK(s1, s2) \
-    if(link == BOND_LINK_##s1) \
-        return(debug ? #s1 : #s2);
-    _BOND_LINK(UP, up);
-    _BOND_LINK(FAIL, fail);
-    _BOND_LINK(DOWN, down);
-    _BOND_LINK(BACK, back);
+        [BOND_LINK_##s1] = { #s2, #s1 },
+        _BOND_LINK(UP, up)
+        _BOND_LINK(FAIL, fail)
+        _BOND_LINK(DOWN, down)
+        _BOND_LINK(BACK, back)
 #undef _BOND_LINK
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, link, debug, "UNKNOWN"));
 }
 #endif
 #endif
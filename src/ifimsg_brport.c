@@ -26,20 +26,22 @@
 void parse_rtm_newlink_bridge(struct iflist_entry *ifle,
     struct iflist_entry *ifle_tmp, struct rtattr *ifla[])
 {
+    char name[IFNAMSIZ] = "";
+
     if(!ifle)
         return;
 
     if(!ifle->br_attached) {
         ifle->br_attached = 1;
         ifle->index_master = ifle_tmp->index_master;
+        ifle->index_attached = ifle_tmp->index_master;
         rec_log("interface %s attached to bridge %s",
-            ifle->name, ifle_tmp->name_master);
-        strncpy(ifle->name_master, ifle_tmp->name_master, IFNAMSIZ);
+            ifle->name, if_indextoname_from_lists(ifle->index_attached, name));
     }
 
     if(ifle->br_state != ifle_tmp->br_state) {
         rec_log("bridge %s port %s stp state changed to %s",
-                ifle->name_master, ifle->name,
+                if_indextoname_from_lists(ifle->index_attached, name), ifle->name,
                 conv_br_state(ifle_tmp->br_state, 0));
         ifle->br_state = ifle_tmp->br_state;
     }
@@ -52,11 +54,13 @@ void parse_rtm_newlink_bridge(struct iflist_entry *ifle,
  */
 void parse_rtm_dellink_bridge(struct iflist_entry *ifle)
 {
+    char name[IFNAMSIZ] = "";
+
     if(ifle && ifle->br_attached) {
         ifle->br_attached = 0;
         rec_log("interface %s detached from bridge %s",
-            ifle->name, ifle->name_master);
-        strncpy(ifle->name_master, "", IFNAMSIZ);
+            ifle->name, if_indextoname_from_lists(ifle->index_attached, name));
+        ifle->index_attached = 0;
     }
 
     return;
@@ -60,8 +60,11 @@ int parse_ifla_gre_local(char *msg, char **mp, struct rtattr *gre, struct iflist
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "source-address=%s ", addr);
+    if(msg) {
+        *mp = add_str(msg, *mp, "source-address=");
+        *mp = add_str(msg, *mp, addr);
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -86,8 +89,11 @@ int parse_ifla_gre_remote(char *msg, char **mp, struct rtattr *gre, struct iflis
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "destination-address=%s ", addr);
+    if(msg) {
+        *mp = add_str(msg, *mp, "destination-address=");
+        *mp = add_str(msg, *mp, addr);
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -165,27 +171,20 @@ void debug_ifla_gre(int lev, struct ifinfomsg *ifim, struct rtattr *info)
  */
 const char *conv_gre_flags(unsigned short flags, unsigned char debug)
 {
-    static char list[MAX_STR_SIZE];
-    unsigned len = sizeof(list);
-
-    strncpy(list, "", sizeof(list));
-    if(!flags) {
-        strncpy(list, "NONE", sizeof(list));
-        return((const char *)list);
-    }
+    static const struct flag_name names[] = {
 #define _GRE_FLAGS(s) \
-    if((flags & GRE_##s) && (len - strlen(list) - 1 > 0)) \
-        (flags &= ~GRE_##s) ? \
-            strncat(list, #s ",", len - strlen(list) - 1) : \
-            strncat(list, #s, len - strlen(list) - 1);
-    _GRE_FLAGS(CSUM);
-    _GRE_FLAGS(ROUTING);
-    _GRE_FLAGS(KEY);
-    _GRE_FLAGS(SEQ);
-    _GRE_FLAGS(STRICT);
+        { GRE_##s, #s },
+        _GRE_FLAGS(CSUM)
+        _GRE_FLAGS(ROUTING)
+        _GRE_FLAGS(KEY)
+        _GRE_FLAGS(SEQ)
+        _GRE_FLAGS(STRICT)
 #undef _GRE_FLAGS
-    if(!strlen(list))
-        strncpy(list, "UNKNOWN", len);
+    };
+    static struct flag_table ft = FLAG_TABLE(names, ",");
+    static char list[MAX_STR_SIZE];
+
+    conv_flags(&ft, flags, list, sizeof(list));
 
     return((const char *)list);
 }
@@ -48,9 +48,11 @@ int parse_ifla_macvlan_mode(char *msg, char **mp, struct rtattr *macvlan,
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "mode=%s ",
-            conv_macvlan_mode(*(unsigned *)RTA_DATA(macvlan), 0));
+    if(msg) {
+        *mp = add_str(msg, *mp, "mode=");
+        *mp = add_str(msg, *mp, conv_macvlan_mode(*(unsigned *)RTA_DATA(macvlan), 0));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -58,7 +60,7 @@ int parse_ifla_macvlan_mode(char *msg, char **mp, struct rtattr *macvlan,
 /*
  * debug MACVLAN interface information messages
  */
-void debug_ifla_macvlan(int lev, struct rtattr *info)
+void debug_ifla_macvlan(int lev, struct ifinfomsg *ifim, struct rtattr *info)
 {
     struct rtattr *macvlan[__IFLA_MACVLAN_MAX];
 
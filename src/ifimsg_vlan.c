@@ -50,6 +50,19 @@ int parse_ifla_vlan(char *msg, char **mp, struct rtattr *info, struct iflist_ent
     return(0);
 }
 
+/*
+ * log changes of attributes IFLA_VLAN_* kept in an interface list entry
+ */
+void diff_ifla_vlan(struct iflist_entry *ifle, struct iflist_entry *ifle_tmp)
+{
+    /* check interface vlan id */
+    if(ifle->vid != ifle_tmp->vid) {
+        rec_log("interface %s vlan id changed from %hu to %hu",
+            ifle->name, ifle->vid, ifle_tmp->vid);
+        ifle->vid = ifle_tmp->vid;
+    }
+}
+
 /*
  * parse attribute IFLA_VLAN_ID
  */
@@ -62,8 +75,11 @@ int parse_ifla_vlan_id(char *msg, char **mp, struct rtattr *vlan, struct iflist_
     }
     ifle->vid = *(unsigned short *)RTA_DATA(vlan);
 
-    if(msg)
-        *mp = add_log(msg, *mp, "vid=%hu ", ifle->vid);
+    if(msg) {
+        *mp = add_str(msg, *mp, "vid=");
+        *mp = add_u32(msg, *mp, ifle->vid);
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -74,7 +90,7 @@ int parse_ifla_vlan_id(char *msg, char **mp, struct rtattr *vlan, struct iflist_
 int parse_ifla_vlan_egress_qos(char *msg, char **mp, struct rtattr *vlan, struct iflist_entry *ifle)
 {
     if(msg) {
-        *mp = add_log(msg, *mp, "egress-qos-map(from:to)=");
+        *mp = add_str(msg, *mp, "egress-qos-map(from:to)=");
 
         if(parse_vlan_qos_mapping(msg, mp, vlan, ifle))
             return(1);
@@ -89,7 +105,7 @@ int parse_ifla_vlan_egress_qos(char *msg, char **mp, struct rtattr *vlan, struct
 int parse_ifla_vlan_ingress_qos(char *msg, char **mp, struct rtattr *vlan, struct iflist_entry *ifle)
 {
     if(msg) {
-        *mp = add_log(msg, *mp, "ingress-qos-map(from:to)=");
+        *mp = add_str(msg, *mp, "ingress-qos-map(from:to)=");
 
         if(parse_vlan_qos_mapping(msg, mp, vlan, ifle))
             return(1);
@@ -107,7 +123,7 @@ int parse_vlan_qos_mapping(char *msg, char **mp, struct rtattr *qos, struct ifli
     struct ifla_vlan_qos_mapping *map;
     int len = RTA_PAYLOAD(qos);
 
-    *mp = add_log(msg, *mp, "(");
+    *mp = add_str(msg, *mp, "(");
 
     for(qos = RTA_DATA(qos); RTA_OK(qos, len); qos = RTA_NEXT(qos, len)) {
         if(RTA_PAYLOAD(qos) < sizeof(*map)) {
@@ -117,11 +133,14 @@ int parse_vlan_qos_mapping(char *msg, char **mp, struct rtattr *qos, struct ifli
         }
         map = (struct ifla_vlan_qos_mapping *)RTA_DATA(qos);
 
-        *mp = add_log(msg, *mp, "%u:%u ", map->from, map->to);
+        *mp = add_u32(msg, *mp, map->from);
+        *mp = add_str(msg, *mp, ":");
+        *mp = add_u32(msg, *mp, map->to);
+        *mp = add_str(msg, *mp, " ");
     }
 
     --(*mp);
-    *mp = add_log(msg, *mp, ") ");
+    *mp = add_str(msg, *mp, ") ");
 
     return(0);
 }
@@ -141,8 +160,11 @@ int parse_ifla_vlan_protocol(char *msg, char **mp, struct rtattr *vlan, struct i
     }
     proto = ntohs(*(unsigned short *)RTA_DATA(vlan));
 
-    if(msg)
-        *mp = add_log(msg, *mp, "protocol=%s ", conv_eth_p(proto, 0));
+    if(msg) {
+        *mp = add_str(msg, *mp, "protocol=");
+        *mp = add_str(msg, *mp, conv_eth_p(proto, 0));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 
@@ -152,7 +174,7 @@ int parse_ifla_vlan_protocol(char *msg, char **mp, struct rtattr *vlan, struct i
 /*
  * debug VLAN interface information messages
  */
-void debug_ifla_vlan(int lev, struct rtattr *info)
+void debug_ifla_vlan(int lev, struct ifinfomsg *ifim, struct rtattr *info)
 {
     struct rtattr *vlan[__IFLA_VLAN_MAX];
 
@@ -233,31 +255,24 @@ void debug_ifla_vlan_qos(int lev, struct rtattr *vlan, const char *name)
  */
 const char *conv_vlan_flags(int flags, unsigned char debug)
 {
-    static char list[MAX_STR_SIZE];
-    unsigned len = sizeof(list);
-
-    strncpy(list, "", len);
-    if(!flags) {
-        strncpy(list, "NONE", len);
-        return((const char *)list);
-    }
+    static const struct flag_name names[] = {
 #define _VLAN_FLAGS(s) \
-    if((flags & VLAN_FLAG_##s) && (len - strlen(list) - 1 > 0)) \
-        (flags &= ~VLAN_FLAG_##s) ? \
-            strncat(list, #s ",", len - strlen(list) - 1) : \
-            strncat(list, #s, len - strlen(list) - 1);
+        { VLAN_FLAG_##s, #s },
 #if HAVE_DECL_VLAN_FLAG_REORDER_HDR
-    _VLAN_FLAGS(REORDER_HDR);
+        _VLAN_FLAGS(REORDER_HDR)
 #endif
 #if HAVE_DECL_VLAN_FLAG_GVRP
-    _VLAN_FLAGS(GVRP);
+        _VLAN_FLAGS(GVRP)
 #endif
 #if HAVE_DECL_VLAN_FLAG_LOOSE_BINDING
-    _VLAN_FLAGS(LOOSE_BINDING);
+        _VLAN_FLAGS(LOOSE_BINDING)
 #endif
 #undef _VLAN_FLAGS
-    if(!strlen(list))
-        strncpy(list, "UNKNOWN", len);
+    };
+    static struct flag_table ft = FLAG_TABLE(names, ",");
+    static char list[MAX_STR_SIZE];
+
+    conv_flags(&ft, flags, list, sizeof(list));
 
     return((const char *)list);
 }
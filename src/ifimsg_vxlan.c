@@ -86,8 +86,11 @@ int parse_ifla_vxlan_id(char *msg, char **mp, struct rtattr *vxlan, struct iflis
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "vni=%u ", *(unsigned *)RTA_DATA(vxlan));
+    if(msg) {
+        *mp = add_str(msg, *mp, "vni=");
+        *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(vxlan));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -106,8 +109,11 @@ int parse_ifla_vxlan_link(char *msg, char **mp, struct rtattr *vxlan, struct ifl
     }
     if_indextoname_from_lists(*(int *)RTA_DATA(vxlan), name);
 
-    if(msg)
-        *mp = add_log(msg, *mp, "link=%s ", name);
+    if(msg) {
+        *mp = add_str(msg, *mp, "link=");
+        *mp = add_str(msg, *mp, name);
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -128,8 +134,11 @@ int parse_ifla_vxlan_local(char *msg, char **mp, struct rtattr *vxlan,
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "source-address=%s ", addr);
+    if(msg) {
+        *mp = add_str(msg, *mp, "source-address=");
+        *mp = add_str(msg, *mp, addr);
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -150,8 +159,13 @@ int parse_ifla_vxlan_port_range(char *msg, char **mp, struct rtattr *vxlan,
 
     range = (struct ifla_vxlan_port_range *)RTA_DATA(vxlan);
 
-    if(msg)
-        *mp = add_log(msg, *mp, "source-port=%hu-%hu ", ntohs(range->low), ntohs(range->high));
+    if(msg) {
+        *mp = add_str(msg, *mp, "source-port=");
+        *mp = add_u32(msg, *mp, ntohs(range->low));
+        *mp = add_str(msg, *mp, "-");
+        *mp = add_u32(msg, *mp, ntohs(range->high));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -168,8 +182,11 @@ int parse_ifla_vxlan_port(char *msg, char **mp, struct rtattr *vxlan,
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "destination-port=%hu ", ntohs(*(unsigned short *)RTA_DATA(vxlan)));
+    if(msg) {
+        *mp = add_str(msg, *mp, "destination-port=");
+        *mp = add_u32(msg, *mp, ntohs(*(unsigned short *)RTA_DATA(vxlan)));
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -190,8 +207,11 @@ int parse_ifla_vxlan_group(char *msg, char **mp, struct rtattr *vxlan,
         return(1);
     }
 
-    if(msg)
-        *mp = add_log(msg, *mp, "destination-address=%s ", addr);
+    if(msg) {
+        *mp = add_str(msg, *mp, "destination-address=");
+        *mp = add_str(msg, *mp, addr);
+        *mp = add_str(msg, *mp, " ");
+    }
 
     return(0);
 }
@@ -199,7 +219,7 @@ int parse_ifla_vxlan_group(char *msg, char **mp, struct rtattr *vxlan,
 /*
  * debug VXLAN interface information messages
  */
-void debug_ifla_vxlan(int lev, struct rtattr *info)
+void debug_ifla_vxlan(int lev, struct ifinfomsg *ifim, struct rtattr *info)
 {
     struct rtattr *vxlan[__IFLA_VXLAN_MAX];
 
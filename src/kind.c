@@ -0,0 +1,257 @@
+/*
+ * kind.c - registry of qdisc, filter, action and link kinds
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/*
+ * debug nothing for a kind without options or statistics
+ */
+static void debug_tca_options_none(int lev, struct tcmsg *tcm, struct rtattr *tca,
+    const char *name)
+{
+    return;
+}
+
+static void debug_tc_none_xstats(int lev, struct rtattr *tca, const char *name)
+{
+    return;
+}
+
+/*
+ * debug attribute TCA_ACT_OPTIONS of police action
+ */
+static void debug_tca_act_police(int lev, struct rtattr *act)
+{
+    debug_tca_act_options_police(lev, act, NULL);
+}
+
+/*
+ * kinds of qdisc and filter(sorted by name on a first lookup)
+ */
+static struct tc_kind tc_kinds[] = {
+    /* kinds of qdisc */
+    { "pfifo_fast", TC_KIND_QDISC, parse_tca_options_prio,
+        debug_tca_options_prio, NULL },
+    { "pfifo", TC_KIND_QDISC, parse_tca_options_pfifo,
+        debug_tca_options_fifo, NULL },
+    { "bfifo", TC_KIND_QDISC, parse_tca_options_bfifo,
+        debug_tca_options_fifo, NULL },
+    { "prio", TC_KIND_QDISC, parse_tca_options_prio,
+        debug_tca_options_prio, NULL },
+#ifdef HAVE_STRUCT_TC_MULTIQ_QOPT_BANDS
+    { "multiq", TC_KIND_QDISC, parse_tca_options_multiq,
+        debug_tca_options_multiq, NULL },
+#endif
+#ifdef HAVE_STRUCT_TC_PLUG_QOPT_ACTION
+    { "plug", TC_KIND_QDISC, parse_tca_options_plug,
+        debug_tca_options_plug, NULL },
+#endif
+    { "sfq", TC_KIND_QDISC, parse_tca_options_sfq,
+        debug_tca_options_sfq,
+#ifdef HAVE_STRUCT_TC_SFQ_XSTATS_ALLOT
+        debug_tc_sfq_xstats },
+#else
+        NULL },
+#endif
+    { "tbf", TC_KIND_QDISC, parse_tca_options_tbf,
+        debug_tca_options_tbf, NULL },
+    { "red", TC_KIND_QDISC, parse_tca_options_red,
+        debug_tca_options_red, debug_tc_red_xstats },
+    { "gred", TC_KIND_QDISC | TC_KIND_F_LOG, parse_tca_options_gred,
+        debug_tca_options_gred, NULL },
+#if HAVE_DECL_TCA_CHOKE_UNSPEC
+    { "choke", TC_KIND_QDISC, parse_tca_options_choke,
+        debug_tca_options_choke, debug_tc_choke_xstats },
+#endif
+    { "htb", TC_KIND_QDISC, parse_tca_options_htb,
+        debug_tca_options_htb, debug_tc_htb_xstats },
+    { "hfsc", TC_KIND_QDISC, parse_tca_options_hfsc,
+        debug_tca_options_hfsc, NULL },
+#if HAVE_DECL_TCA_CBQ_UNSPEC
+    { "cbq", TC_KIND_QDISC, parse_tca_options_cbq,
+        debug_tca_options_cbq, debug_tc_cbq_xstats },
+#endif
+#if HAVE_DECL_TCA_DSMARK_UNSPEC
+    { "dsmark", TC_KIND_QDISC, parse_tca_options_dsmark,
+        debug_tca_options_dsmark, NULL },
+#endif
+    { "netem", TC_KIND_QDISC, parse_tca_options_netem,
+        debug_tca_options_netem, NULL },
+#if HAVE_DECL_TCA_DRR_UNSPEC
+    { "drr", TC_KIND_QDISC, parse_tca_options_drr,
+        debug_tca_options_drr, debug_tc_drr_xstats },
+#endif
+#if HAVE_DECL_TCA_SFB_UNSPEC
+    { "sfb", TC_KIND_QDISC, parse_tca_options_sfb,
+        debug_tca_options_sfb, debug_tc_sfb_xstats },
+#endif
+#if HAVE_DECL_TCA_QFQ_UNSPEC
+    { "qfq", TC_KIND_QDISC, parse_tca_options_qfq,
+        debug_tca_options_qfq, debug_tc_qfq_xstats },
+#endif
+#if HAVE_DECL_TCA_CODEL_UNSPEC
+    { "codel", TC_KIND_QDISC, parse_tca_options_codel,
+        debug_tca_options_codel, debug_tc_codel_xstats },
+#endif
+#if HAVE_DECL_TCA_FQ_CODEL_UNSPEC
+    { "fq_codel", TC_KIND_QDISC, parse_tca_options_fq_codel,
+        debug_tca_options_fq_codel, debug_tc_fq_codel_xstats },
+#endif
+    { "ingress", TC_KIND_QDISC, NULL,
+        debug_tca_options_none, debug_tc_none_xstats },
+
+    /* kinds of filter */
+    { "u32", TC_KIND_FILTER | TC_KIND_F_LOG, parse_tca_options_u32,
+        debug_tca_options_u32, NULL },
+#if HAVE_DECL_TCA_RSVP_UNSPEC
+    { "rsvp", TC_KIND_FILTER | TC_KIND_F_LOG, parse_tca_options_rsvp,
+        debug_tca_options_rsvp, NULL },
+#endif
+    { "route", TC_KIND_FILTER | TC_KIND_F_LOG, parse_tca_options_route,
+        debug_tca_options_route, NULL },
+    { "fw", TC_KIND_FILTER | TC_KIND_F_LOG, parse_tca_options_fw,
+        debug_tca_options_fw, NULL },
+#if HAVE_DECL_TCA_TCINDEX_UNSPEC
+    { "tcindex", TC_KIND_FILTER | TC_KIND_F_LOG, parse_tca_options_tcindex,
+        debug_tca_options_tcindex, NULL },
+#endif
+#if HAVE_DECL_TCA_FLOW_UNSPEC
+    { "flow", TC_KIND_FILTER | TC_KIND_F_LOG, parse_tca_options_flow,
+        debug_tca_options_flow, NULL },
+#endif
+    { "basic", TC_KIND_FILTER | TC_KIND_F_LOG, parse_tca_options_basic,
+        debug_tca_options_basic, NULL },
+#if HAVE_DECL_TCA_CGROUP_UNSPEC
+    { "cgroup", TC_KIND_FILTER | TC_KIND_F_LOG, parse_tca_options_cgroup,
+        debug_tca_options_cgroup, NULL },
+#endif
+};
+static int tc_kinds_sorted;
+
+/*
+ * kinds of action(sorted by name on a first lookup)
+ */
+static struct act_kind act_kinds[] = {
+    { "police", parse_tca_act_options_police, debug_tca_act_police },
+    { "gact", parse_tca_act_options_gact, debug_tca_act_options_gact },
+    { "pedit", parse_tca_act_options_pedit, debug_tca_act_options_pedit },
+    { "mirred", parse_tca_act_options_mirred, debug_tca_act_options_mirred },
+#ifdef HAVE_LINUX_TC_ACT_TC_NAT_H
+    { "nat", parse_tca_act_options_nat, debug_tca_act_options_nat },
+#endif
+#ifdef HAVE_LINUX_TC_ACT_TC_SKBEDIT_H
+    { "skbedit", parse_tca_act_options_skbedit, debug_tca_act_options_skbedit },
+#endif
+#ifdef HAVE_LINUX_TC_ACT_TC_CSUM_H
+    { "csum", parse_tca_act_options_csum, debug_tca_act_options_csum },
+#endif
+};
+static int act_kinds_sorted;
+
+/*
+ * kinds of link(sorted by name on a first lookup)
+ */
+static struct link_kind link_kinds[] = {
+#if HAVE_DECL_IFLA_VLAN_UNSPEC
+    { "vlan", parse_ifla_vlan, debug_ifla_vlan, NULL, diff_ifla_vlan },
+#endif
+#if HAVE_DECL_IFLA_GRE_UNSPEC
+    { "gre", parse_ifla_gre, debug_ifla_gre, NULL, NULL },
+    { "gretap", parse_ifla_gre, debug_ifla_gre, NULL, NULL },
+#endif
+#if HAVE_DECL_IFLA_MACVLAN_UNSPEC
+    { "macvlan", parse_ifla_macvlan, debug_ifla_macvlan, NULL, NULL },
+    { "macvtap", parse_ifla_macvlan, debug_ifla_macvlan, NULL, NULL },
+#endif
+#if HAVE_DECL_IFLA_VXLAN_UNSPEC
+    { "vxlan", parse_ifla_vxlan, debug_ifla_vxlan, NULL, NULL },
+#endif
+#if HAVE_DECL_IFLA_BOND_UNSPEC
+    { "bond", parse_ifla_bond, debug_ifla_bond,
+#if HAVE_DECL_IFLA_BOND_MIIMON
+        debug_ifla_bond_slave, NULL },
+#else
+        NULL, NULL },
+#endif
+#endif
+};
+static int link_kinds_sorted;
+
+/*
+ * compare names of kinds(each entry begins with a name)
+ */
+static int cmp_kind(const void *a, const void *b)
+{
+    return(strcmp(*(const char *const *)a, *(const char *const *)b));
+}
+
+/*
+ * search a kind by name in a table sorted on a first lookup
+ */
+static void *find_kind(void *table, size_t num, size_t size, int *sorted,
+    const char *name, int len)
+{
+    char key[MODULE_NAME_LEN];
+    const char *kp = name;
+
+    if(!num || !name || len < 1)
+        return(NULL);
+
+    if(!*sorted) {
+        qsort(table, num, size, cmp_kind);
+        *sorted = 1;
+    }
+
+    /* a name copied from an attribute may not be terminated */
+    if(!memchr(name, '\0', len)) {
+        if(len > (int)sizeof(key) - 1)
+            len = sizeof(key) - 1;
+        memcpy(key, name, len);
+        key[len] = '\0';
+        kp = key;
+    }
+
+    return(bsearch(&kp, table, num, size, cmp_kind));
+}
+
+/*
+ * look up a kind of qdisc or filter
+ */
+const struct tc_kind *find_tc_kind(const char *name, int len)
+{
+    return(find_kind(tc_kinds, sizeof(tc_kinds) / sizeof(tc_kinds[0]),
+        sizeof(tc_kinds[0]), &tc_kinds_sorted, name, len));
+}
+
+/*
+ * look up a kind of action
+ */
+const struct act_kind *find_act_kind(const char *name, int len)
+{
+    return(find_kind(act_kinds, sizeof(act_kinds) / sizeof(act_kinds[0]),
+        sizeof(act_kinds[0]), &act_kinds_sorted, name, len));
+}
+
+/*
+ * look up a kind of link
+ */
+const struct link_kind *find_link_kind(const char *name, int len)
+{
+    return(find_kind(link_kinds, sizeof(link_kinds) / sizeof(link_kinds[0]),
+        sizeof(link_kinds[0]), &link_kinds_sorted, name, len));
+}
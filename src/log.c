@@ -19,6 +19,37 @@
 #include "nield.h"
 
 static FILE *log_fd;
+static const char *log_prefix = "";
+static int log_mute;
+
+/* a slot of a log ring(a line is ready when seq is one ahead of its position) */
+struct log_slot {
+    unsigned long seq;
+    struct timestamp ts;
+    int len;
+    char msg[MAX_MSG_SIZE];
+};
+
+/* lock-free ring of logging messages drained by a writer thread */
+static struct {
+    struct log_slot *slots;
+    unsigned long head;
+    unsigned long tail;
+    pthread_t thread;
+    int running;
+    int stop;
+    int idle;
+    int wake[2];
+    /* statistics */
+    unsigned long long lines;
+    unsigned long long dropped;
+    unsigned long long writes;
+    unsigned long long errors;
+    unsigned long high_water;
+} log_ring;
+
+/* date of a last formatted second for a log file */
+static struct timestamp_cache log_ts_cache;
 
 /*
  * open a log file
@@ -43,6 +74,291 @@ int open_log(char *filename)
     return(0);
 }
 
+/*
+ * wake up a log writer
+ */
+static void wake_log_writer(void)
+{
+    char c = 0;
+
+    /* a full pipe already has a pending wake up */
+    if(write(log_ring.wake[1], &c, 1) < 0 && errno != EAGAIN)
+        log_ring.errors++;
+}
+
+/*
+ * wait a wake up of a log writer
+ */
+static void wait_log_writer(int timeout)
+{
+    struct pollfd pfd = { log_ring.wake[0], POLLIN, 0 };
+    char buf[64];
+
+    if(poll(&pfd, 1, timeout) > 0)
+        while(read(log_ring.wake[0], buf, sizeof(buf)) > 0);
+}
+
+/*
+ * get a number of lines in a log ring
+ */
+static inline unsigned long log_ring_lines(void)
+{
+    return(__atomic_load_n(&log_ring.head, __ATOMIC_SEQ_CST) -
+        __atomic_load_n(&log_ring.tail, __ATOMIC_SEQ_CST));
+}
+
+/*
+ * put a line into a log ring
+ */
+static int put_log_ring(struct timestamp *ts, const char *msg)
+{
+    struct log_slot *slot;
+    unsigned long pos, seq, lines;
+    long dif;
+
+    /* reserve a slot(a signal handler may interrupt and reserve a next one) */
+    pos = __atomic_load_n(&log_ring.head, __ATOMIC_RELAXED);
+    for(;;) {
+        slot = &log_ring.slots[pos & (LOG_RING_SIZE - 1)];
+        seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        dif = (long)(seq - pos);
+
+        if(!dif) {
+            if(__atomic_compare_exchange_n(&log_ring.head, &pos, pos + 1,
+                0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+                break;
+        } else if(dif < 0) {
+            __atomic_add_fetch(&log_ring.dropped, 1, __ATOMIC_RELAXED);
+            return(-1);
+        } else {
+            pos = __atomic_load_n(&log_ring.head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->ts = *ts;
+    slot->len = snprintf(slot->msg, sizeof(slot->msg), "%s\n", msg);
+    if(slot->len >= sizeof(slot->msg)) {
+        slot->len = sizeof(slot->msg) - 1;
+        slot->msg[slot->len - 1] = '\n';
+    }
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&log_ring.lines, 1, __ATOMIC_RELAXED);
+
+    /* wake up a writer at a first line or when a batch is filled */
+    lines = log_ring_lines();
+    if(lines > log_ring.high_water)
+        log_ring.high_water = lines;
+    if(__atomic_exchange_n(&log_ring.idle, 0, __ATOMIC_SEQ_CST) || lines == LOG_BATCH_SIZE)
+        wake_log_writer();
+
+    return(0);
+}
+
+/*
+ * write lines in a log ring with writev()
+ */
+static void flush_log_ring(void)
+{
+    struct iovec iov[LOG_BATCH_SIZE * 2], *v;
+    char stamp[LOG_BATCH_SIZE][TIMESTAMP_STRLEN];
+    struct log_slot *slot[LOG_BATCH_SIZE];
+    unsigned long pos;
+    int log_opts = get_log_opts();
+    int i, n, cnt;
+    ssize_t len;
+
+    for(;;) {
+        /* collect ready lines in order */
+        pos = log_ring.tail;
+        for(n = 0; n < LOG_BATCH_SIZE; n++) {
+            slot[n] = &log_ring.slots[(pos + n) & (LOG_RING_SIZE - 1)];
+            if(__atomic_load_n(&slot[n]->seq, __ATOMIC_ACQUIRE) != pos + n + 1)
+                break;
+        }
+        if(!n)
+            return;
+
+        for(i = 0; i < n; i++) {
+            iov[i*2].iov_base = stamp[i];
+            iov[i*2].iov_len = format_timestamp(&log_ts_cache, &slot[i]->ts,
+                stamp[i], sizeof(stamp[i]));
+            iov[i*2+1].iov_base = slot[i]->msg;
+            iov[i*2+1].iov_len = slot[i]->len;
+
+            if(log_opts & L_SYSLOG)
+                syslog(LOG_INFO, "%.*s", slot[i]->len - 1, slot[i]->msg);
+        }
+
+        /* continue a short write from where it stopped */
+        for(v = iov, cnt = n * 2; (log_opts & L_LOCAL) && cnt > 0; ) {
+            len = writev(fileno(log_fd), v, cnt);
+            log_ring.writes++;
+            if(len < 0) {
+                if(errno == EINTR)
+                    continue;
+                log_ring.errors++;
+                break;
+            }
+            for( ; cnt > 0 && len >= v->iov_len; v++, cnt--)
+                len -= v->iov_len;
+            if(cnt > 0) {
+                v->iov_base = (char *)v->iov_base + len;
+                v->iov_len -= len;
+            }
+        }
+
+        /* release slots to producers */
+        for(i = 0; i < n; i++)
+            __atomic_store_n(&slot[i]->seq, pos + i + LOG_RING_SIZE, __ATOMIC_RELEASE);
+        __atomic_store_n(&log_ring.tail, pos + n, __ATOMIC_SEQ_CST);
+    }
+}
+
+/*
+ * log writer thread
+ */
+static void *log_writer(void *arg)
+{
+    unsigned long lines;
+
+    for(;;) {
+        lines = log_ring_lines();
+        if(!lines) {
+            if(__atomic_load_n(&log_ring.stop, __ATOMIC_SEQ_CST))
+                break;
+
+            /* sleep until a first line arrives */
+            __atomic_store_n(&log_ring.idle, 1, __ATOMIC_SEQ_CST);
+            if(!log_ring_lines() && !__atomic_load_n(&log_ring.stop, __ATOMIC_SEQ_CST))
+                wait_log_writer(-1);
+            __atomic_store_n(&log_ring.idle, 0, __ATOMIC_SEQ_CST);
+            continue;
+        }
+
+        /* wait more lines until a batch is filled or a latency bound */
+        if(lines < LOG_BATCH_SIZE && !__atomic_load_n(&log_ring.stop, __ATOMIC_SEQ_CST))
+            wait_log_writer(LOG_FLUSH_MSEC);
+
+        flush_log_ring();
+    }
+
+    return(NULL);
+}
+
+/*
+ * start a log writer thread
+ */
+int start_log_writer(void)
+{
+    sigset_t all, old;
+    int i, err;
+
+    log_ring.slots = calloc(LOG_RING_SIZE, sizeof(struct log_slot));
+    if(!log_ring.slots) {
+        rec_log("error: %s: calloc() failed", __func__);
+        return(-1);
+    }
+    for(i = 0; i < LOG_RING_SIZE; i++)
+        log_ring.slots[i].seq = i;
+
+    if(pipe(log_ring.wake) < 0) {
+        rec_log("error: %s: pipe(): %s", __func__, strerror(errno));
+        free(log_ring.slots);
+        return(-1);
+    }
+    fcntl(log_ring.wake[0], F_SETFL, O_NONBLOCK);
+    fcntl(log_ring.wake[1], F_SETFL, O_NONBLOCK);
+
+    /* signals are handled only in a main thread */
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    err = pthread_create(&log_ring.thread, NULL, log_writer, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if(err) {
+        rec_log("error: %s: pthread_create(): %s", __func__, strerror(err));
+        close(log_ring.wake[0]);
+        close(log_ring.wake[1]);
+        free(log_ring.slots);
+        return(-1);
+    }
+    log_ring.running = 1;
+
+    /* flush lines left in a ring even if exit() is called anywhere */
+    atexit(stop_log_writer);
+
+    return(0);
+}
+
+/*
+ * stop a log writer thread after flushing lines
+ */
+void stop_log_writer(void)
+{
+    if(!log_ring.running)
+        return;
+
+    __atomic_store_n(&log_ring.stop, 1, __ATOMIC_SEQ_CST);
+    wake_log_writer();
+    pthread_join(log_ring.thread, NULL);
+    log_ring.running = 0;
+
+    close(log_ring.wake[0]);
+    close(log_ring.wake[1]);
+    free(log_ring.slots);
+}
+
+/*
+ * write lines synchronously in a forked child where no writer thread runs
+ */
+void detach_log_writer(void)
+{
+    log_ring.running = 0;
+}
+
+/*
+ * print statistics of a log writer
+ */
+void print_log_stats(FILE *stats)
+{
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ log writer statistics ]\n");
+    fprintf(stats, "mode: %s\n", log_ring.running ? "asynchronous" : "synchronous");
+    fprintf(stats, "ring size: %d\n", LOG_RING_SIZE);
+    fprintf(stats, "ring occupancy: %lu\n", log_ring.running ? log_ring_lines() : 0);
+    fprintf(stats, "ring high water mark: %lu\n", log_ring.high_water);
+    fprintf(stats, "lines: %llu\n", log_ring.lines);
+    fprintf(stats, "dropped lines: %llu\n", log_ring.dropped);
+    fprintf(stats, "writes: %llu\n", log_ring.writes);
+    fprintf(stats, "lines per write: %.3f\n", log_ring.writes ?
+        (double)log_ring.lines / log_ring.writes : 0.0);
+    fprintf(stats, "write errors: %llu\n", log_ring.errors);
+}
+
+/*
+ * set a prefix of logging messages
+ */
+void set_log_prefix(const char *prefix)
+{
+    log_prefix = prefix ? prefix : "";
+}
+
+/*
+ * mute logging messages except errors
+ */
+void set_log_mute(int mute)
+{
+    log_mute = mute;
+}
+
+/*
+ * get whether logging messages are muted or not
+ */
+int get_log_mute(void)
+{
+    return(log_mute);
+}
+
 /*
  * concatnate logging messages
  */
@@ -71,28 +387,202 @@ char *add_log(char *msg, char *mp, char *format, ...)
     return(mp);
 }
 
+/*
+ * terminate logging messages truncated by an appender
+ */
+static char *add_truncated(char *msg)
+{
+    msg[MAX_MSG_SIZE - 1] = '\0';
+    rec_log("error: message truncated");
+
+    return(NULL);
+}
+
+/*
+ * concatenate bytes to logging messages
+ */
+static char *add_mem(char *msg, char *mp, const char *src, int len)
+{
+    if(!mp)
+        return(NULL);
+
+    /* keep a last byte for a terminator */
+    if(len > msg + MAX_MSG_SIZE - 1 - mp)
+        return(add_truncated(msg));
+
+    memcpy(mp, src, len);
+    mp += len;
+    *mp = '\0';
+
+    return(mp);
+}
+
+/*
+ * concatenate a string to logging messages
+ */
+char *add_str(char *msg, char *mp, const char *str)
+{
+    char *end = msg + MAX_MSG_SIZE - 1;
+
+    if(!mp)
+        return(NULL);
+
+    while(*str) {
+        if(mp >= end)
+            return(add_truncated(msg));
+        *mp++ = *str++;
+    }
+    *mp = '\0';
+
+    return(mp);
+}
+
+/*
+ * concatenate an unsigned decimal number to logging messages
+ */
+char *add_u32(char *msg, char *mp, unsigned num)
+{
+    char buf[16], *p = buf + sizeof(buf);
+
+    do {
+        *--p = '0' + num % 10;
+        num /= 10;
+    } while(num);
+
+    return(add_mem(msg, mp, p, buf + sizeof(buf) - p));
+}
+
+/*
+ * concatenate a signed decimal number to logging messages
+ */
+char *add_s32(char *msg, char *mp, int num)
+{
+    if(num >= 0)
+        return(add_u32(msg, mp, num));
+
+    /* a magnitude of INT_MIN fits in unsigned */
+    mp = add_str(msg, mp, "-");
+
+    return(add_u32(msg, mp, -(unsigned)num));
+}
+
+/*
+ * concatenate a hexadecimal number padded with zeros to width to logging messages
+ */
+char *add_hex(char *msg, char *mp, unsigned num, int width)
+{
+    static const char digits[] = "0123456789abcdef";
+    char buf[16], *p = buf + sizeof(buf);
+
+    do {
+        *--p = digits[num & 0xf];
+        num >>= 4;
+    } while(num || buf + sizeof(buf) - p < width);
+
+    return(add_mem(msg, mp, p, buf + sizeof(buf) - p));
+}
+
+/*
+ * concatenate an IPv4 address to logging messages
+ */
+char *add_ipv4(char *msg, char *mp, const unsigned char *addr)
+{
+    char buf[INET_ADDRSTRLEN];
+
+    return(add_mem(msg, mp, buf, ntop_ipv4(addr, buf)));
+}
+
+/*
+ * concatenate an IPv6 address to logging messages
+ */
+char *add_ipv6(char *msg, char *mp, const unsigned char *addr)
+{
+    char buf[INET6_ADDRSTRLEN];
+
+    return(add_mem(msg, mp, buf, ntop_ipv6(addr, buf)));
+}
+
+/*
+ * concatenate an IPv4 or IPv6 address to logging messages
+ */
+char *add_inet(char *msg, char *mp, int family, const unsigned char *addr)
+{
+    if(family == AF_INET6)
+        return(add_ipv6(msg, mp, addr));
+
+    return(add_ipv4(msg, mp, addr));
+}
+
+/*
+ * concatenate a hardware address of an interface type to logging messages
+ */
+char *add_hwaddr(char *msg, char *mp, unsigned short type,
+    const unsigned char *addr, int len)
+{
+    char buf[HWADDR_STRLEN];
+
+    if(hwaddr_ntop(type, addr, len, buf, sizeof(buf)))
+        buf[0] = '\0';
+
+    return(add_str(msg, mp, buf));
+}
+
+/*
+ * concatenate a tc handle to logging messages
+ */
+char *add_tc_handle(char *msg, char *mp, unsigned id)
+{
+    if(id == TC_H_ROOT)
+        return(add_str(msg, mp, "root"));
+    if(id == TC_H_INGRESS)
+        return(add_str(msg, mp, "ingress"));
+    if(id == TC_H_UNSPEC)
+        return(add_str(msg, mp, "none"));
+
+    if(TC_H_MAJ(id))
+        mp = add_hex(msg, mp, TC_H_MAJ(id) >> 16, 0);
+    mp = add_str(msg, mp, ":");
+    if(TC_H_MIN(id))
+        mp = add_hex(msg, mp, TC_H_MIN(id), 0);
+
+    return(mp);
+}
+
 /*
  * record logging messages
  */
 void rec_log(char *format, ...)
 {
     va_list ap_msg;
-    char msg[MAX_MSG_SIZE] = "";
+    char msg[MAX_MSG_SIZE];
     int log_opts = get_log_opts();
+    int len;
+
+    if(log_mute && strncmp(format, "error: ", 7))
+        return;
+
+    len = snprintf(msg, sizeof(msg), "%s", log_prefix);
 
     va_start(ap_msg, format);
-    vsnprintf(msg, sizeof(msg), format, ap_msg);
+    vsnprintf(msg + len, sizeof(msg) - len, format, ap_msg);
     va_end(ap_msg);
 
+    /* pass a line to a writer thread without blocking */
+    if(log_ring.running && (log_opts & (L_LOCAL | L_SYSLOG))) {
+        struct timestamp ts;
+
+        get_timestamp(&ts);
+        put_log_ring(&ts, msg);
+        return;
+    }
+
     if(log_opts & L_LOCAL) {
-        struct timeval tv;
-        struct tm *tm;
-
-        gettimeofday(&tv, NULL);
-        tm = localtime(&tv.tv_sec);
-        fprintf(log_fd, "[%04d-%02d-%02d %02d:%02d:%02d.%06ld] %s\n",
-            tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
-            tm->tm_hour, tm->tm_min, tm->tm_sec, tv.tv_usec, msg);
+        struct timestamp ts;
+        char stamp[TIMESTAMP_STRLEN];
+
+        get_timestamp(&ts);
+        format_timestamp(&log_ts_cache, &ts, stamp, sizeof(stamp));
+        fprintf(log_fd, "%s%s\n", stamp, msg);
         fflush(log_fd);
     }
 
@@ -100,6 +590,29 @@ void rec_log(char *format, ...)
         syslog(LOG_INFO, "%s", msg);
 }
 
+/*
+ * reopen a log file
+ */
+int reopen_log(char *filename)
+{
+    int fd;
+
+    if(!log_fd)
+        return(0);
+
+    fd = open(filename, O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if(fd < 0) {
+        rec_log("error: %s: open(): %s", __func__, strerror(errno));
+        return(-1);
+    }
+
+    /* a writer thread keeps writing to the same descriptor number */
+    dup2(fd, fileno(log_fd));
+    close(fd);
+
+    return(0);
+}
+
 /*
  * close a log file
  */
@@ -107,6 +620,8 @@ void close_log(void)
 {
     int log_opts = get_log_opts();
 
+    stop_log_writer();
+
     if(log_opts & L_LOCAL) {
         if(log_fd)
             fclose(log_fd);
@@ -19,13 +19,172 @@
 #include "nield.h"
 #include "rtnetlink.h"
 
-/* top of interface list */
-static struct list_head head = {&head, &head};
+/* pool of neighbor discovery cache list entries */
+static struct pool ndlist_pool = POOL_INIT("neighbor list", struct ndlist_entry);
+
+/* whether a neighbor discovery cache list is being resynchronized */
+static int resyncing;
+
+/*
+ * match an entry in a neighbor discovery cache list with a key entry
+ */
+static int match_ndlist(const void *entry, const void *key)
+{
+    const struct ndlist_entry *e = entry, *k = key;
+
+    return(e->ifindex == k->ifindex && e->family == k->family &&
+        !memcmp(e->addr, k->addr, sizeof(e->addr)));
+}
+
+/* index of neighbor discovery cache list by interface, family and address */
+static struct hash_table nd_hash = HASH_TABLE_INIT(match_ndlist);
+
+/*
+ * get a hash value of a neighbor discovery cache entry
+ */
+static inline unsigned hash_ndlist(const struct ndlist_entry *e)
+{
+    return(hash_bytes(e->addr, sizeof(e->addr), hash_int(e->ifindex) ^ e->family));
+}
+
+/*
+ * set a key of a neighbor discovery cache entry
+ */
+static inline void set_ndlist_key(struct ndlist_entry *e, struct ndmsg *ndm, struct rtattr *nda)
+{
+    int len;
+
+    e->ifindex = ndm->ndm_ifindex;
+    e->family = ndm->ndm_family;
+    memset(e->addr, 0, sizeof(e->addr));
+
+    if(nda) {
+        len = RTA_PAYLOAD(nda);
+        memcpy(e->addr, RTA_DATA(nda), (len < sizeof(e->addr)) ? len : sizeof(e->addr));
+    }
+
+    return;
+}
+
+/*
+ * set an entry of a neighbor discovery cache list from attributes
+ */
+static int set_ndlist_entry(struct ndlist_entry *e, struct ndmsg *ndm, struct rtattr *nda[])
+{
+    /* get interface index, family and binary address as a key */
+    set_ndlist_key(e, ndm, nda[NDA_DST]);
+
+    /* check ip address */
+    if(nda[NDA_DST] && get_rta_addr(ndm->ndm_family, nda[NDA_DST], e->addr)) {
+        rec_log("error: %s: NDA_DST(ifindex %d): payload too short",
+            __func__, e->ifindex);
+        return(1);
+    }
+
+    /* get link local address */
+    if(nda[NDA_LLADDR]) {
+        e->lladdr_len = (RTA_PAYLOAD(nda[NDA_LLADDR]) < HWADDR_MAX) ?
+            RTA_PAYLOAD(nda[NDA_LLADDR]) : HWADDR_MAX;
+        memcpy(e->lladdr, RTA_DATA(nda[NDA_LLADDR]), e->lladdr_len);
+    }
+
+    return(0);
+}
+
+/*
+ * pass an event of an entry of a neighbor discovery cache list to sinks
+ */
+static void emit_ndlist_entry(int action, struct ndlist_entry *e)
+{
+    struct event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = EVENT_NEIGH;
+    ev.action = action;
+    ev.family = e->family;
+    ev.ifindex = e->ifindex;
+    memcpy(ev.addr, e->addr, sizeof(e->addr));
+    memcpy(ev.lladdr, e->lladdr, sizeof(e->lladdr));
+    ev.lladdr_len = e->lladdr_len;
+
+    emit_event(&ev);
+}
+
+/*
+ * format neighbor discovery event as text
+ */
+int format_nd_event(const struct event *ev, char *msg)
+{
+    char ifname[IFNAMSIZ] = "";
+    char *mp = msg;
+
+    mp = add_str(msg, mp, (ev->family == AF_INET6) ? "ndp cache " : "arp cache ");
+    mp = add_str(msg, mp, conv_event_action(ev->action));
+    mp = add_str(msg, mp, ": ip=");
+    mp = add_inet(msg, mp, ev->family, ev->addr);
+    mp = add_str(msg, mp, " mac=");
+    if(ev->lladdr_len)
+        mp = add_hwaddr(msg, mp, ARPHRD_ETHER, ev->lladdr, ev->lladdr_len);
+    else
+        mp = add_str(msg, mp, "none");
+    mp = add_str(msg, mp, " interface=");
+    mp = add_str(msg, mp, if_indextoname_from_lists(ev->ifindex, ifname));
+
+    return(mp ? 0 : -1);
+}
+
+/*
+ * search an entry in a neighbor discovery cache list
+ */ 
+static inline struct ndlist_entry *search_ndlist(struct ndlist_entry *key)
+{
+    return(hash_search(&nd_hash, hash_ndlist(key), key));
+}
+
+/*
+ * add a neighbor discovery cache to a list
+ */
+static inline int add_ndlist_entry(struct ndlist_entry *e)
+{
+    if(hash_insert(&nd_hash, hash_ndlist(e), e) < 0)
+        return(-1);
+
+    return(0);
+}
+
+/*
+ * add a copy of a temporary entry to a neighbor discovery cache list
+ */
+static inline struct ndlist_entry *copy_ndlist_entry(struct ndlist_entry *ndle_tmp)
+{
+    struct ndlist_entry *e;
+
+    e = pool_alloc(&ndlist_pool);
+    if(!e)
+        return(NULL);
+    *e = *ndle_tmp;
+
+    if(add_ndlist_entry(e) < 0) {
+        pool_free(&ndlist_pool, e);
+        return(NULL);
+    }
+
+    return(e);
+}
+
+/*
+ * delete an entry in a neighbor discovery cache list
+ */
+static inline void del_ndlist_entry(struct ndlist_entry *e)
+{
+    hash_delete(&nd_hash, hash_ndlist(e), e);
+    pool_free(&ndlist_pool, e);
+}
 
 /*
  * create a neighbor discovery cache list
  */ 
-int create_ndlist(struct msghdr *msg)
+int create_ndlist(struct msghdr *msg, int len)
 {
     struct nlmsghdr *nlh;
     int nlh_len;
@@ -34,11 +193,10 @@ int create_ndlist(struct msghdr *msg)
     struct rtattr *nda[__NDA_MAX];
     struct ndlist_entry *ndle;
     int log_opts = get_log_opts();
-    int res;
 
     /* get netlink message header */
     nlh = msg->msg_iov->iov_base;
-    nlh_len = msg->msg_iov->iov_len;
+    nlh_len = len;
 
     /* parse netlink message header */
     for( ; NLMSG_OK(nlh, nlh_len); nlh = NLMSG_NEXT(nlh, nlh_len)) {
@@ -77,129 +235,160 @@ int create_ndlist(struct msghdr *msg)
             continue;
 
         /* create neighbor discovery list */
-        ndle = (struct ndlist_entry *)malloc(sizeof(struct ndlist_entry));
-        if(ndle == NULL) {
-            rec_log("error: %s: malloc: failed", __func__);
+        ndle = pool_alloc(&ndlist_pool);
+        if(ndle == NULL)
             return(-1);
-        }
-        memset(ndle, 0, sizeof(struct ndlist_entry));
-        strncpy(ndle->lladdr, "none", sizeof(ndle->lladdr));
-        list_init(&(ndle->list));
-
-        /* get interface index */
-        ndle->ifindex = ndm->ndm_ifindex;
-
-        /* convert interface index to name */
-        if_indextoname_from_lists(ndm->ndm_ifindex, ndle->ifname);
-
-        /* get ip address */
-        if(nda[NDA_DST]) {
-            res = inet_ntop_ifa(ndm->ndm_family, nda[NDA_DST], ndle->ipaddr,
-                sizeof(ndle->ipaddr));
-            if(res) {
-                rec_log("error: %s: NDA_DST(ifindex %d): %s",
-                    __func__, ndle->ifindex,
-                    (res == 1) ? strerror(errno) : "payload too short");
-                free(ndle);
-                continue;
-            }
-        }
-    
-        /* get link local address */
-        if(nda[NDA_LLADDR]) {
-            res = arphrd_ntop(ARPHRD_ETHER, nda[NDA_LLADDR], ndle->lladdr,
-                sizeof(ndle->lladdr));
-            if(res) {
-                rec_log("error: %s: NDA_LLADDR(ifindex %d): %s",
-                    __func__, ndle->ifindex,
-                    (res == 1) ? strerror(errno) : "payload too short");
-                free(ndle);
-                continue;
-            }
+
+        /* get interface index, addresses */
+        if(set_ndlist_entry(ndle, ndm, nda)) {
+            pool_free(&ndlist_pool, ndle);
+            continue;
         }
 
         /* add neighbor discovery cache list */
-        list_add(&(ndle->list), &head);
+        if(add_ndlist_entry(ndle) < 0) {
+            pool_free(&ndlist_pool, ndle);
+            return(-1);
+        }
     }
 
     return(0);
 }
 
 /*
- * print a neighbor discovery cache list
- */ 
-void print_ndlist(void)
+ * resynchronize a neighbor discovery cache list with kernel
+ */
+int resync_ndlist(struct msghdr *msg, int len)
 {
-    struct list_head *l;
-    FILE *ndlist;
+    struct nlmsghdr *nlh;
+    int nlh_len;
 
-    ndlist = fopen(NDLIST_FILE, "w");
-    if(ndlist == NULL) {
-        rec_log("error: %s: can't open ndlist file(%s)", __func__, NDLIST_FILE);
-        return;
-    }
-    fprintf(ndlist, "\n");
-    fprintf(ndlist, "*********************************************************************\n");
-    fprintf(ndlist, "[ neighbor list ]\n");
+    /* get netlink message header */
+    nlh = msg->msg_iov->iov_base;
+    nlh_len = len;
 
-    list_for_each(l, &head) {
-        struct ndlist_entry *e;
+    /* parse netlink message header */
+    resyncing = 1;
+    for( ; NLMSG_OK(nlh, nlh_len); nlh = NLMSG_NEXT(nlh, nlh_len)) {
+        /* whether netlink message header ends or not */
+        if(nlh->nlmsg_type == NLMSG_DONE) {
+            resyncing = 0;
+            return(1);
+        }
 
-        e = list_entry(l, struct ndlist_entry, list);
+        if(nlh->nlmsg_type == NLMSG_ERROR) {
+            rec_log("error: %s: nlmsg error", __func__);
+            resyncing = 0;
+            return(-1);
+        }
 
-        fprintf(ndlist, "ifindex: %d, ", e->ifindex);
-        fprintf(ndlist, "ifname: %s, ", e->ifname);
-        fprintf(ndlist, "ipaddr: %s, ", e->ipaddr);
-        fprintf(ndlist, "lladdr: %s\n", e->lladdr);
+        /* entries found in a dump are marked */
+        parse_ndmsg(nlh);
     }
+    resyncing = 0;
 
-    fclose(ndlist);
+    return(0);
 }
 
 /*
- * search an entry in a neighbor discovery cache list
- */ 
-static inline struct ndlist_entry *search_ndlist(char *ipa, unsigned ifi)
+ * delete entries not found in a dump from a neighbor discovery cache list
+ */
+void sweep_ndlist(void)
 {
-    struct list_head *l;
+    struct ndlist_entry *e;
+    unsigned pos;
 
-    list_for_each(l, &head) {
-        struct ndlist_entry *e;
+    /* a deletion shifts a following entry back into the same slot */
+    for(pos = 0; (e = hash_next(&nd_hash, &pos)); ) {
+        if(e->mark)
+            continue;
 
-        e = list_entry(l, struct ndlist_entry, list);
-        if(!memcmp(ipa, &(e->ipaddr), sizeof(e->ipaddr)) && ifi == e->ifindex)
-            return e;
+        emit_ndlist_entry(EVENT_DELETED, e);
+        del_ndlist_entry(e);
+        pos--;
     }
 
-    return(NULL);
+    for(pos = 0; (e = hash_next(&nd_hash, &pos)); )
+        e->mark = 0;
+
+    return;
 }
 
 /*
- * add a neighbor discovery cache to a list
+ * print statistics of a neighbor discovery cache list
  */
-static inline void add_ndlist_entry(struct list_head *l)
+void print_ndlist_stats(FILE *stats)
 {
-    list_init(l);
-    list_add(l, &head);
+    print_hash_stats(stats, "neighbor table", &nd_hash);
+    print_pool_stats(stats, &ndlist_pool);
 }
 
 /*
- * [not in use]
- * delete an entry in a interface list entry
- */
-static inline void del_iflist_entry(char *ipa)
+ * print a neighbor discovery cache list
+ */ 
+void print_ndlist(void)
 {
-    struct list_head *l, *n;
+    struct ndlist_entry *e;
+    unsigned pos;
+    char ipaddr[INET6_ADDRSTRLEN+1] = "";
+    char lladdr[HWADDR_STRLEN] = "";
+    char ifname[IFNAMSIZ] = "";
+    char tmp[MAX_STR_SIZE] = "";
+    FILE *ndlist;
 
-    list_for_each_safe(l, n, &head) {
-        struct ndlist_entry *e;
+    ndlist = open_snapshot(NDLIST_FILE, tmp, sizeof(tmp));
+    if(ndlist == NULL)
+        return;
+    fprintf(ndlist, "\n");
+    fprintf(ndlist, "*********************************************************************\n");
+    fprintf(ndlist, "[ neighbor list ]\n");
 
-        e = list_entry(l, struct ndlist_entry, list);
-        if(!memcmp(ipa, &(e->ipaddr), sizeof(e->ipaddr))) {
-            list_del(l);
-            free(e);
-        }
+    for(pos = 0; (e = hash_next(&nd_hash, &pos)); ) {
+        inet_ntop(e->family, e->addr, ipaddr, sizeof(ipaddr));
+        strncpy(lladdr, "none", sizeof(lladdr));
+        if(e->lladdr_len)
+            hwaddr_ntop(ARPHRD_ETHER, e->lladdr, e->lladdr_len, lladdr, sizeof(lladdr));
+
+        fprintf(ndlist, "ifindex: %d, ", e->ifindex);
+        fprintf(ndlist, "ifname: %s, ", if_indextoname_from_lists(e->ifindex, ifname));
+        fprintf(ndlist, "ipaddr: %s, ", ipaddr);
+        fprintf(ndlist, "lladdr: %s\n", lladdr);
     }
+
+    close_snapshot(ndlist, tmp, NDLIST_FILE);
+}
+
+/*
+ * write a snapshot of a neighbor discovery cache list in JSON lines
+ */
+void dump_ndlist(void)
+{
+    struct ndlist_entry *e;
+    unsigned pos;
+    char ipaddr[INET6_ADDRSTRLEN+1] = "";
+    char lladdr[HWADDR_STRLEN] = "";
+    char ifname[IFNAMSIZ] = "";
+    char tmp[MAX_STR_SIZE] = "";
+    FILE *ndlist;
+
+    ndlist = open_snapshot(NDLIST_FILE SNAPSHOT_SUFFIX, tmp, sizeof(tmp));
+    if(ndlist == NULL)
+        return;
+    write_snapshot_header(ndlist, "neighbor list", nd_hash.count);
+
+    for(pos = 0; (e = hash_next(&nd_hash, &pos)); ) {
+        inet_ntop(e->family, e->addr, ipaddr, sizeof(ipaddr));
+        strncpy(lladdr, "", sizeof(lladdr));
+        if(e->lladdr_len)
+            hwaddr_ntop(ARPHRD_ETHER, e->lladdr, e->lladdr_len, lladdr, sizeof(lladdr));
+
+        fprintf(ndlist, "{\"ifindex\":%u,\"ifname\":", e->ifindex);
+        write_json_str(ndlist, if_indextoname_from_lists(e->ifindex, ifname));
+        fprintf(ndlist, ",\"family\":%d,\"ipaddr\":\"%s\",\"lladdr\":\"%s\"}\n",
+            e->family, ipaddr, lladdr);
+    }
+
+    close_snapshot(ndlist, tmp, NDLIST_FILE SNAPSHOT_SUFFIX);
 }
 
 /*
@@ -210,11 +399,9 @@ int parse_ndmsg(struct nlmsghdr *nlh)
     struct ndmsg *ndm;
     int ndm_len;
     struct rtattr *nda[__NDA_MAX];
-    struct ndlist_entry *ndle_tmp;
-    char ndm_type[MAX_STR_SIZE] = "";
+    struct ndlist_entry ndle_buf, *ndle_tmp = &ndle_buf;
     int log_opts = get_log_opts();
     int msg_opts = get_msg_opts();
-    int res;
 
     /* debug nlmsghdr */
     if(log_opts & L_DEBUG)
@@ -237,72 +424,43 @@ int parse_ndmsg(struct nlmsghdr *nlh)
 
     /* check address family */
     if(ndm->ndm_family == AF_INET) {
-        if((msg_opts & M_IPV4) || !(msg_opts & M_IPV6))
-            strcpy(ndm_type, "arp cache");
-        else
+        if(!(msg_opts & M_IPV4) && (msg_opts & M_IPV6)) {
+            count_filter_discard();
             return(1);
+        }
     } else if(ndm->ndm_family == AF_INET6) {
-        if((msg_opts & M_IPV6) || !(msg_opts & M_IPV4))
-            strcpy(ndm_type, "ndp cache");
-        else
+        if(!(msg_opts & M_IPV6) && (msg_opts & M_IPV4)) {
+            count_filter_discard();
             return(1);
+        }
     } else {
+        count_filter_discard();
         return(1);
     }
 
     /* unicast only */
-    if(ndm->ndm_type != RTN_UNICAST)
+    if(ndm->ndm_type != RTN_UNICAST) {
+        count_filter_discard();
         return(1);
+    }
 
-    if(ndm->ndm_state == NUD_NOARP)
+    if(ndm->ndm_state == NUD_NOARP) {
+        count_filter_discard();
         return(1);
+    }
 
     /* create temporary neighbor discovery entry */
-    ndle_tmp = malloc(sizeof(struct ndlist_entry));
-    if(!ndle_tmp) {
-        rec_log("error: %s: malloc() failed", __func__);
-        return(1);
-    }
     memset(ndle_tmp, 0, sizeof(struct ndlist_entry));
-    strncpy(ndle_tmp->lladdr, "none", sizeof(ndle_tmp->lladdr));
-
-    /* get interface index */
-    ndle_tmp->ifindex = ndm->ndm_ifindex;
-
-    /* convert interface index to name */
-    if_indextoname_from_lists((unsigned)ndm->ndm_ifindex, ndle_tmp->ifname);
-
-    /* get ip address */
-    if(nda[NDA_DST]) {
-        res = inet_ntop_ifa(ndm->ndm_family, nda[NDA_DST], ndle_tmp->ipaddr,
-            sizeof(ndle_tmp->ipaddr));
-        if(res) {
-            rec_log("error: %s: NDA_DST(ifindex %d): %s",
-                __func__, ndle_tmp->ifindex,
-                (res == 1) ? strerror(errno) : "payload too short");
-            free(ndle_tmp);
-            return(1);
-        }
-    }
 
-    /* get link local address */
-    if(nda[NDA_LLADDR]) {
-        res = arphrd_ntop(ARPHRD_ETHER, nda[NDA_LLADDR], ndle_tmp->lladdr,
-            sizeof(ndle_tmp->lladdr));
-        if(res) {
-            rec_log("error: %s: NDA_LLADDR(ifindex %d): %s",
-                __func__, ndle_tmp->ifindex,
-                (res == 1) ? strerror(errno) : "payload too short");
-            free(ndle_tmp);
-            return(1);
-        }
-    }
+    /* get interface index, addresses */
+    if(set_ndlist_entry(ndle_tmp, ndm, nda))
+        return(1);
 
     /* logging neighbor discovery message */
     if(nlh->nlmsg_type == RTM_NEWNEIGH)
-        parse_rtm_newneigh(ndm_type, ndm, ndle_tmp);
+        parse_rtm_newneigh(ndm, ndle_tmp);
     else if(nlh->nlmsg_type == RTM_DELNEIGH)
-        parse_rtm_delneigh(ndm_type, ndm, ndle_tmp);
+        parse_rtm_delneigh(ndm, ndle_tmp);
 
     return(0);
 }
@@ -310,26 +468,30 @@ int parse_ndmsg(struct nlmsghdr *nlh)
 /*
  * parse RTM_NEWNEIGH
  */
-int parse_rtm_newneigh(char *ndm_type, struct ndmsg *ndm, struct ndlist_entry *ndle_tmp)
+int parse_rtm_newneigh(struct ndmsg *ndm, struct ndlist_entry *ndle_tmp)
 {
     struct ndlist_entry *ndle;
 
     /* search neighbor discovery entry by ip address */
-    ndle = search_ndlist(ndle_tmp->ipaddr, ndle_tmp->ifindex);
+    ndle = search_ndlist(ndle_tmp);
+    if(ndle && resyncing)
+        ndle->mark = 1;
+    ndle_tmp->mark = resyncing;
+
     switch(ndm->ndm_state) {
         case NUD_FAILED:
             /* change or add neighbor discovery list entry */
             if(ndle) {
-                if(memcmp(ndle->lladdr, ndle_tmp->lladdr, sizeof(ndle->lladdr))) {
+                if(ndle->lladdr_len != ndle_tmp->lladdr_len ||
+                    memcmp(ndle->lladdr, ndle_tmp->lladdr, sizeof(ndle->lladdr))) {
                     memcpy(ndle->lladdr, ndle_tmp->lladdr, sizeof(ndle->lladdr));
-                    rec_log("%s invalidated: ip=%s mac=%s interface=%s",
-                        ndm_type, ndle->ipaddr, ndle->lladdr, ndle->ifname);
+                    ndle->lladdr_len = ndle_tmp->lladdr_len;
+                    emit_ndlist_entry(EVENT_INVALIDATED, ndle);
                 }
-                free(ndle_tmp);
             } else {
-                add_ndlist_entry(&(ndle_tmp->list));
-                rec_log("%s unresolved: ip=%s mac=%s interface=%s",
-                    ndm_type, ndle_tmp->ipaddr, ndle_tmp->lladdr, ndle_tmp->ifname);
+                if(!copy_ndlist_entry(ndle_tmp))
+                    break;
+                emit_ndlist_entry(EVENT_UNRESOLVED, ndle_tmp);
             }
             break;
         case NUD_PERMANENT:
@@ -339,16 +501,16 @@ int parse_rtm_newneigh(char *ndm_type, struct ndmsg *ndm, struct ndlist_entry *n
         case NUD_REACHABLE:
             /* change or add neighbor discovery list entry */
             if(ndle) {
-                if(memcmp(ndle->lladdr, ndle_tmp->lladdr, sizeof(ndle->lladdr))) {
+                if(ndle->lladdr_len != ndle_tmp->lladdr_len ||
+                    memcmp(ndle->lladdr, ndle_tmp->lladdr, sizeof(ndle->lladdr))) {
                     memcpy(ndle->lladdr, ndle_tmp->lladdr, sizeof(ndle->lladdr));
-                    rec_log("%s changed: ip=%s mac=%s interface=%s",
-                        ndm_type, ndle->ipaddr, ndle->lladdr, ndle->ifname);
+                    ndle->lladdr_len = ndle_tmp->lladdr_len;
+                    emit_ndlist_entry(EVENT_CHANGED, ndle);
                 }
-                free(ndle_tmp);
             } else {
-                add_ndlist_entry(&(ndle_tmp->list));
-                rec_log("%s added: ip=%s mac=%s interface=%s",
-                    ndm_type, ndle_tmp->ipaddr, ndle_tmp->lladdr, ndle_tmp->ifname);
+                if(!copy_ndlist_entry(ndle_tmp))
+                    break;
+                emit_ndlist_entry(EVENT_ADDED, ndle_tmp);
             }
             break;
         case NUD_NOARP:
@@ -362,9 +524,8 @@ int parse_rtm_newneigh(char *ndm_type, struct ndmsg *ndm, struct ndlist_entry *n
 /*
  * parse RTM_DELNEIGH
  */
-int parse_rtm_delneigh(char *ndm_type, struct ndmsg *ndm, struct ndlist_entry *ndle_tmp)
+int parse_rtm_delneigh(struct ndmsg *ndm, struct ndlist_entry *ndle_tmp)
 {
-    struct list_head *l, *n;
     struct ndlist_entry *e;
 
     switch(ndm->ndm_state) {
@@ -376,21 +537,14 @@ int parse_rtm_delneigh(char *ndm_type, struct ndmsg *ndm, struct ndlist_entry *n
         case NUD_DELAY:
         case NUD_PROBE:
         case NUD_NOARP:
-            /* search & delete neighbor discovery entry */
-            list_for_each_safe(l, n, &head) {
-                e = list_entry(l, struct ndlist_entry, list);
-                if(!memcmp(e->ipaddr, ndle_tmp->ipaddr, sizeof(e->ipaddr))) {
-                    rec_log("%s deleted: ip=%s mac=%s interface=%s",
-                        ndm_type, ndle_tmp->ipaddr, ndle_tmp->lladdr, e->ifname);
-                    list_del(l);
-                    free(e);
-                    /* because entry matched is only one */
-                    break;
-                }
+            /* search & delete neighbor discovery entry on the interface */
+            e = search_ndlist(ndle_tmp);
+            if(e) {
+                emit_ndlist_entry(EVENT_DELETED, ndle_tmp);
+                del_ndlist_entry(e);
             }
         break;
     }
-    free(ndle_tmp);
 
     return(0);
 }
@@ -475,43 +629,39 @@ void debug_nda_cacheinfo(int lev, struct rtattr *nda, const char *name)
 
 const char *conv_nud_state(int state, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _NUD_STATE(s) \
-    if(state == NUD_##s) \
-        return(#s);
-    _NUD_STATE(INCOMPLETE);
-    _NUD_STATE(REACHABLE);
-    _NUD_STATE(STALE);
-    _NUD_STATE(DELAY);
-    _NUD_STATE(PROBE);
-    _NUD_STATE(FAILED);
-    _NUD_STATE(NOARP);
-    _NUD_STATE(PERMANENT);
+        [NUD_##s] = { #s, #s },
+        _NUD_STATE(INCOMPLETE)
+        _NUD_STATE(REACHABLE)
+        _NUD_STATE(STALE)
+        _NUD_STATE(DELAY)
+        _NUD_STATE(PROBE)
+        _NUD_STATE(FAILED)
+        _NUD_STATE(NOARP)
+        _NUD_STATE(PERMANENT)
 #undef _NUD_STATE
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, state, debug, "UNKNOWN"));
 }
 
 const char *conv_ntf_flags(int flags, unsigned char debug)
 {
-    static char list[MAX_STR_SIZE];
-    unsigned len = sizeof(list);
-
-    if(!flags) {
-        strncpy(list, "NONE", len);
-        return((const char *)list);
-    }
+    static const struct flag_name names[] = {
 #define _NTF_FLAGS(f) \
-    if((flags & NTF_##f) && (len - strlen(list) - 1 > 0)) \
-        (flags &= ~NTF_##f) ? \
-            strncat(list, #f ",", len - strlen(list) - 1) : \
-            strncat(list, #f, len - strlen(list) - 1);
+        { NTF_##f, #f },
 #ifdef NTF_USE
-    _NTF_FLAGS(USE);
+        _NTF_FLAGS(USE)
 #endif
-    _NTF_FLAGS(PROXY);
-    _NTF_FLAGS(ROUTER);
+        _NTF_FLAGS(PROXY)
+        _NTF_FLAGS(ROUTER)
 #undef _NTF_FLAGS
-    if(!strlen(list))
-        strncpy(list, "UNKNOWN", len);
+    };
+    static struct flag_table ft = FLAG_TABLE(names, ",");
+    static char list[MAX_STR_SIZE];
+
+    conv_flags(&ft, flags, list, sizeof(list));
 
     return((const char *)list);
 }
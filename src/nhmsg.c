@@ -0,0 +1,642 @@
+/*
+ * nhmsg.c - nexthop object message parser
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+#include "rtnetlink.h"
+
+#ifdef HAVE_LINUX_NEXTHOP_H
+
+/* nexthop attributes following a nhmsg */
+#define NHA_RTA(r) ((struct rtattr *)(((char *)(r)) + NLMSG_ALIGN(sizeof(struct nhmsg))))
+#define NHA_PAYLOAD(n) NLMSG_PAYLOAD(n, sizeof(struct nhmsg))
+
+/* pool of nexthop object list entries */
+static struct pool nhlist_pool = POOL_INIT("nexthop list", struct nhlist_entry);
+
+/* whether a nexthop object list is being created or resynchronized */
+static int seeding;
+static int resyncing;
+
+/* nexthop object list statistics */
+static struct {
+    unsigned long long added;
+    unsigned long long changed;
+    unsigned long long deleted;
+    unsigned long long flushed;
+} nhlist_stats;
+
+/*
+ * match an entry in a nexthop object list with a key entry
+ */
+static int match_nhlist(const void *entry, const void *key)
+{
+    return(((const struct nhlist_entry *)entry)->id == ((const struct nhlist_entry *)key)->id);
+}
+
+/* index of nexthop object list by id */
+static struct hash_table nh_hash = HASH_TABLE_INIT(match_nhlist);
+
+/*
+ * search an entry of a nexthop object list by id
+ */
+static inline struct nhlist_entry *search_nhlist(unsigned id)
+{
+    struct nhlist_entry key;
+
+    key.id = id;
+
+    return(hash_search(&nh_hash, hash_int(id), &key));
+}
+
+/*
+ * set an entry of a nexthop object list from attributes
+ */
+static int set_nhlist_entry(struct nhlist_entry *e, struct nhmsg *nhm, struct rtattr *nha[])
+{
+    struct nexthop_grp *grp;
+    int i;
+
+    memset(e, 0, sizeof(*e));
+    e->family = nhm->nh_family;
+    e->protocol = nhm->nh_protocol;
+
+    if(!nha[NHA_ID] || RTA_PAYLOAD(nha[NHA_ID]) < sizeof(unsigned)) {
+        rec_log("error: %s: NHA_ID: no id", __func__);
+        return(1);
+    }
+    e->id = *(unsigned *)RTA_DATA(nha[NHA_ID]);
+
+    if(nha[NHA_BLACKHOLE])
+        e->blackhole = 1;
+
+    if(nha[NHA_GATEWAY]) {
+        if(get_rta_addr(e->family, nha[NHA_GATEWAY], e->gateway)) {
+            rec_log("error: %s: NHA_GATEWAY(id %u): payload too short", __func__, e->id);
+            return(1);
+        }
+        e->flags |= EVENT_F_GATEWAY;
+    }
+
+    if(nha[NHA_OIF]) {
+        if(RTA_PAYLOAD(nha[NHA_OIF]) < sizeof(int)) {
+            rec_log("error: %s: NHA_OIF(id %u): payload too short", __func__, e->id);
+            return(1);
+        }
+        e->ifindex = *(int *)RTA_DATA(nha[NHA_OIF]);
+        e->flags |= EVENT_F_OIF;
+    }
+
+    /* members of a group are copied to be compared with a next change */
+    if(nha[NHA_GROUP] && RTA_PAYLOAD(nha[NHA_GROUP]) >= sizeof(*grp)) {
+        e->grp_num = RTA_PAYLOAD(nha[NHA_GROUP]) / sizeof(*grp);
+        e->grp = malloc(e->grp_num * sizeof(*e->grp));
+        if(!e->grp) {
+            rec_log("error: %s: malloc() failed", __func__);
+            return(-1);
+        }
+        grp = RTA_DATA(nha[NHA_GROUP]);
+        for(i = 0; i < e->grp_num; i++) {
+            e->grp[i].id = grp[i].id;
+            e->grp[i].weight = grp[i].weight + 1;
+        }
+    }
+
+    return(0);
+}
+
+/*
+ * compare what nexthop objects forward to
+ */
+static int equal_nhlist_entry(const struct nhlist_entry *a, const struct nhlist_entry *b)
+{
+    int i;
+
+    if(a->family != b->family || a->blackhole != b->blackhole ||
+        a->flags != b->flags || a->ifindex != b->ifindex ||
+        memcmp(a->gateway, b->gateway, sizeof(a->gateway)) ||
+        a->grp_num != b->grp_num)
+        return(0);
+
+    /* members are compared by fields because of padding between them */
+    for(i = 0; i < a->grp_num; i++)
+        if(a->grp[i].id != b->grp[i].id || a->grp[i].weight != b->grp[i].weight)
+            return(0);
+
+    return(1);
+}
+
+/*
+ * format what a nexthop object forwards to
+ */
+static char *format_nhlist_target(char *msg, char *mp, const struct nhlist_entry *e)
+{
+    char ifname[IFNAMSIZ] = "";
+    int i;
+
+    if(e->grp_num) {
+        for(i = 0; i < e->grp_num; i++) {
+            mp = add_str(msg, mp, i ? "," : "group=");
+            mp = add_u32(msg, mp, e->grp[i].id);
+            mp = add_str(msg, mp, "/");
+            mp = add_u32(msg, mp, e->grp[i].weight);
+        }
+        return(mp);
+    }
+
+    if(e->blackhole)
+        return(add_str(msg, mp, "type=blackhole"));
+
+    if(e->flags & EVENT_F_GATEWAY) {
+        mp = add_str(msg, mp, "nexthop=");
+        mp = add_inet(msg, mp, e->family, e->gateway);
+        if(e->flags & EVENT_F_OIF)
+            mp = add_str(msg, mp, " ");
+    }
+
+    if(e->flags & EVENT_F_OIF) {
+        mp = add_str(msg, mp, "interface=");
+        mp = add_str(msg, mp, if_indextoname_from_lists(e->ifindex, ifname));
+    }
+
+    return(mp);
+}
+
+/*
+ * check whether a nexthop object is logged with family options
+ */
+static int check_nhlist_family(const struct nhlist_entry *e)
+{
+    int msg_opts = get_msg_opts();
+
+    if(e->family == AF_INET)
+        return((msg_opts & M_IPV4) || !(msg_opts & M_IPV6));
+    if(e->family == AF_INET6)
+        return((msg_opts & M_IPV6) || !(msg_opts & M_IPV4));
+
+    return(1);
+}
+
+/*
+ * log an added or deleted nexthop object
+ */
+static void log_nhlist_entry(int action, const struct nhlist_entry *e, unsigned routes)
+{
+    char msg[MAX_MSG_SIZE];
+    char *mp = msg;
+
+    if(seeding || !check_nhlist_family(e))
+        return;
+
+    mp = add_str(msg, mp, "nexthop ");
+    mp = add_str(msg, mp, conv_event_action(action));
+    mp = add_str(msg, mp, ": id=");
+    mp = add_u32(msg, mp, e->id);
+    mp = add_str(msg, mp, " ");
+    mp = format_nhlist_target(msg, mp, e);
+    mp = add_str(msg, mp, " protocol=");
+    mp = add_str(msg, mp, conv_rtprot(e->protocol, 0));
+
+    /* routes using a deleted nexthop object are deleted without notifications */
+    if(routes) {
+        mp = add_str(msg, mp, " routes=");
+        mp = add_u32(msg, mp, routes);
+    }
+
+    if(mp)
+        rec_log("%s", msg);
+}
+
+/*
+ * log differences of a changed nexthop object(once for all routes using it)
+ */
+static void log_nhlist_diff(const struct nhlist_entry *old, const struct nhlist_entry *new)
+{
+    char o[MAX_MSG_SIZE], n[MAX_MSG_SIZE];
+
+    if(!check_nhlist_family(new))
+        return;
+
+    if(old->protocol != new->protocol)
+        rec_log("nexthop %u protocol changed from %s to %s", new->id,
+            conv_rtprot(old->protocol, 0), conv_rtprot(new->protocol, 0));
+
+    if(equal_nhlist_entry(old, new))
+        return;
+
+    o[0] = n[0] = '\0';
+    format_nhlist_target(o, o, old);
+    format_nhlist_target(n, n, new);
+    rec_log("nexthop %u changed from %s to %s", new->id, o, n);
+}
+
+/*
+ * delete an entry from a nexthop object list with routes using it
+ */
+static void del_nhlist_entry(struct nhlist_entry *e)
+{
+    unsigned routes;
+
+    routes = flush_rib_nexthop(e->id);
+    nhlist_stats.flushed += routes;
+    nhlist_stats.deleted++;
+    log_nhlist_entry(EVENT_DELETED, e, routes);
+
+    hash_delete(&nh_hash, hash_int(e->id), e);
+    free(e->grp);
+    pool_free(&nhlist_pool, e);
+}
+
+/*
+ * parse RTM_NEWNEXTHOP
+ */
+static int parse_rtm_newnexthop(struct nhlist_entry *tmp)
+{
+    struct nhlist_entry *e;
+
+    tmp->mark = resyncing;
+
+    e = search_nhlist(tmp->id);
+    if(e) {
+        if(e->protocol == tmp->protocol && equal_nhlist_entry(e, tmp)) {
+            e->mark = tmp->mark;
+            free(tmp->grp);
+            return(0);
+        }
+        log_nhlist_diff(e, tmp);
+        nhlist_stats.changed++;
+        free(e->grp);
+        *e = *tmp;
+        return(0);
+    }
+
+    e = pool_alloc(&nhlist_pool);
+    if(!e) {
+        free(tmp->grp);
+        return(-1);
+    }
+    *e = *tmp;
+
+    if(hash_insert(&nh_hash, hash_int(e->id), e) < 0) {
+        free(e->grp);
+        pool_free(&nhlist_pool, e);
+        return(-1);
+    }
+    nhlist_stats.added++;
+    log_nhlist_entry(EVENT_ADDED, e, 0);
+
+    return(0);
+}
+
+/*
+ * parse RTM_DELNEXTHOP
+ */
+static int parse_rtm_delnexthop(struct nhlist_entry *tmp)
+{
+    struct nhlist_entry *e;
+
+    e = search_nhlist(tmp->id);
+    if(!e) {
+        log_nhlist_entry(EVENT_DELETED, tmp, 0);
+        free(tmp->grp);
+        return(0);
+    }
+    free(tmp->grp);
+    del_nhlist_entry(e);
+
+    return(0);
+}
+
+/*
+ * parse nexthop object message
+ */
+int parse_nhmsg(struct nlmsghdr *nlh)
+{
+    struct nhmsg *nhm;
+    int nhm_len;
+    struct rtattr *nha[__NHA_MAX];
+    struct nhlist_entry nhle_tmp;
+    int log_opts = get_log_opts();
+
+    /* debug nlmsghdr */
+    if(log_opts & L_DEBUG)
+        debug_nlmsg(0, nlh);
+
+    /* get nhmsg */
+    nhm_len = NLMSG_PAYLOAD(nlh, 0);
+    if(nhm_len < sizeof(*nhm)) {
+        rec_log("error: %s: nhmsg: length too short", __func__);
+        return(1);
+    }
+    nhm = (struct nhmsg *)NLMSG_DATA(nlh);
+
+    /* parse nexthop attributes */
+    parse_rtattr(nha, NHA_MAX, NHA_RTA(nhm), NHA_PAYLOAD(nlh));
+
+    /* debug nhmsg */
+    if(log_opts & L_DEBUG)
+        debug_nhmsg(0, nhm, nha, nhm_len);
+
+    /* create temporary nexthop object entry */
+    if(set_nhlist_entry(&nhle_tmp, nhm, nha)) {
+        free(nhle_tmp.grp);
+        return(1);
+    }
+
+    /* logging nexthop object message */
+    if(nlh->nlmsg_type == RTM_NEWNEXTHOP)
+        return(parse_rtm_newnexthop(&nhle_tmp));
+
+    return(parse_rtm_delnexthop(&nhle_tmp));
+}
+
+/*
+ * parse messages of a dump of nexthop objects
+ */
+static int parse_nhlist_dump(struct msghdr *msg, int len)
+{
+    struct nlmsghdr *nlh;
+    int nlh_len;
+
+    /* get netlink message header */
+    nlh = msg->msg_iov->iov_base;
+    nlh_len = len;
+
+    /* parse netlink message header */
+    for( ; NLMSG_OK(nlh, nlh_len); nlh = NLMSG_NEXT(nlh, nlh_len)) {
+        /* whether netlink message header ends or not */
+        if(nlh->nlmsg_type == NLMSG_DONE)
+            return(1);
+
+        /* a kernel without nexthop objects refuses a dump */
+        if(nlh->nlmsg_type == NLMSG_ERROR) {
+            rec_log("info: nexthop objects are not supported by kernel");
+            return(1);
+        }
+
+        parse_nhmsg(nlh);
+    }
+
+    return(0);
+}
+
+/*
+ * create a nexthop object list without logging entries
+ */
+int create_nhlist(struct msghdr *msg, int len)
+{
+    int ret;
+
+    seeding = 1;
+    ret = parse_nhlist_dump(msg, len);
+    seeding = 0;
+
+    return(ret);
+}
+
+/*
+ * resynchronize a nexthop object list with kernel
+ */
+int resync_nhlist(struct msghdr *msg, int len)
+{
+    int ret;
+
+    /* entries found in a dump are marked */
+    resyncing = 1;
+    ret = parse_nhlist_dump(msg, len);
+    resyncing = 0;
+
+    return(ret);
+}
+
+/*
+ * delete entries not found in a dump from a nexthop object list
+ */
+void sweep_nhlist(void)
+{
+    struct nhlist_entry *e;
+    unsigned pos;
+
+    /* a deletion shifts a following entry back into the same slot */
+    for(pos = 0; (e = hash_next(&nh_hash, &pos)); ) {
+        if(e->mark)
+            continue;
+
+        del_nhlist_entry(e);
+        pos--;
+    }
+
+    for(pos = 0; (e = hash_next(&nh_hash, &pos)); )
+        e->mark = 0;
+
+    return;
+}
+
+/*
+ * remove deleted members from a nexthop group(0 for no member left)
+ */
+static int prune_nhlist_grp(struct nhlist_entry *e)
+{
+    struct nhlist_entry tmp = *e;
+    int i;
+
+    tmp.grp = malloc(e->grp_num * sizeof(*tmp.grp));
+    if(!tmp.grp) {
+        rec_log("error: %s: malloc() failed", __func__);
+        return(-1);
+    }
+
+    for(i = tmp.grp_num = 0; i < e->grp_num; i++)
+        if(search_nhlist(e->grp[i].id))
+            tmp.grp[tmp.grp_num++] = e->grp[i];
+
+    if(tmp.grp_num && tmp.grp_num != e->grp_num) {
+        log_nhlist_diff(e, &tmp);
+        nhlist_stats.changed++;
+        free(e->grp);
+        e->grp = tmp.grp;
+        e->grp_num = tmp.grp_num;
+        return(e->grp_num);
+    }
+    free(tmp.grp);
+
+    return(tmp.grp_num);
+}
+
+/*
+ * delete nexthop objects through an interface which went down or was deleted
+ * with routes using them(kernel notifies no deletion of them)
+ *
+ * Such members are removed from groups as kernel does, and a group left
+ * without a member is deleted.
+ */
+unsigned flush_nhlist_ifindex(int ifindex)
+{
+    struct nhlist_entry *e;
+    unsigned pos, num = 0;
+
+    /* a deletion shifts a following entry back into the same slot */
+    for(pos = 0; (e = hash_next(&nh_hash, &pos)); ) {
+        if(!(e->flags & EVENT_F_OIF) || e->ifindex != ifindex)
+            continue;
+
+        del_nhlist_entry(e);
+        pos--;
+        num++;
+    }
+    if(!num)
+        return(0);
+
+    for(pos = 0; (e = hash_next(&nh_hash, &pos)); ) {
+        if(!e->grp_num || prune_nhlist_grp(e))
+            continue;
+
+        del_nhlist_entry(e);
+        pos--;
+        num++;
+    }
+
+    return(num);
+}
+
+/*
+ * resolve a nexthop object which a route event refers to
+ */
+void resolve_nhlist(struct event *ev)
+{
+    struct nhlist_entry *e;
+
+    e = search_nhlist(ev->nhid);
+    if(!e || e->grp_num || e->blackhole)
+        return;
+
+    /* members of a group are logged with the group */
+    memcpy(ev->gateway, e->gateway, sizeof(ev->gateway));
+    ev->ifindex = e->ifindex;
+    ev->flags |= e->flags;
+}
+
+/*
+ * print statistics of a nexthop object list
+ */
+void print_nhlist_stats(FILE *stats)
+{
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ nexthop object list statistics ]\n");
+    fprintf(stats, "nexthop objects added: %llu\n", nhlist_stats.added);
+    fprintf(stats, "nexthop objects changed: %llu\n", nhlist_stats.changed);
+    fprintf(stats, "nexthop objects deleted: %llu\n", nhlist_stats.deleted);
+    fprintf(stats, "routes deleted with nexthop objects: %llu\n", nhlist_stats.flushed);
+    print_hash_stats(stats, "nexthop object table", &nh_hash);
+    print_pool_stats(stats, &nhlist_pool);
+}
+
+/*
+ * debug nexthop object message
+ */
+void debug_nhmsg(int lev, struct nhmsg *nhm, struct rtattr *nha[], int nhm_len)
+{
+    /* debug nhmsg */
+    char flags_list[MAX_STR_SIZE] = "";
+
+    conv_rtnh_flags(nhm->nh_flags, flags_list, sizeof(flags_list));
+
+    rec_dbg(lev, "*********************************************************************");
+    rec_dbg(lev, "[ nhmsg(%d) ]",
+        NLMSG_ALIGN(sizeof(struct nhmsg)));
+    rec_dbg(lev, "    nh_family(%d): %d(%s)",
+        sizeof(nhm->nh_family), nhm->nh_family,
+        conv_af_type(nhm->nh_family, 1));
+    rec_dbg(lev, "    nh_scope(%d): %d(%s)",
+        sizeof(nhm->nh_scope), nhm->nh_scope,
+        conv_rt_scope(nhm->nh_scope));
+    rec_dbg(lev, "    nh_protocol(%d): %d(%s)",
+        sizeof(nhm->nh_protocol), nhm->nh_protocol,
+        conv_rtprot(nhm->nh_protocol, 1));
+    rec_dbg(lev, "    resvd(%d): %d",
+        sizeof(nhm->resvd), nhm->resvd);
+    rec_dbg(lev, "    nh_flags(%d): %u(%s)",
+        sizeof(nhm->nh_flags), nhm->nh_flags, flags_list);
+
+    /* debug nexthop attributes */
+    rec_dbg(lev, "*********************************************************************");
+    rec_dbg(lev, "[ nhmsg attributes(%d) ]",
+        NLMSG_ALIGN(nhm_len - NLMSG_ALIGN(sizeof(struct nhmsg))));
+
+    if(nha[NHA_ID])
+        debug_rta_u32(lev+1, nha[NHA_ID],
+            "NHA_ID", NULL);
+
+    if(nha[NHA_GROUP])
+        debug_nha_group(lev+1, nha[NHA_GROUP],
+            "NHA_GROUP");
+
+    if(nha[NHA_GROUP_TYPE])
+        debug_rta_u16(lev+1, nha[NHA_GROUP_TYPE],
+            "NHA_GROUP_TYPE", NULL);
+
+    if(nha[NHA_BLACKHOLE])
+        debug_rta_none(lev+1, nha[NHA_BLACKHOLE],
+            "NHA_BLACKHOLE");
+
+    if(nha[NHA_OIF])
+        debug_rta_ifindex(lev+1, nha[NHA_OIF],
+            "NHA_OIF");
+
+    if(nha[NHA_GATEWAY])
+        debug_rta_af(lev+1, nha[NHA_GATEWAY],
+            "NHA_GATEWAY", nhm->nh_family);
+
+    if(nha[NHA_ENCAP_TYPE])
+        debug_rta_u16(lev+1, nha[NHA_ENCAP_TYPE],
+            "NHA_ENCAP_TYPE", NULL);
+
+    if(nha[NHA_ENCAP])
+        debug_rta_ignore(lev+1, nha[NHA_ENCAP],
+            "NHA_ENCAP");
+
+    rec_dbg(lev, "");
+
+    return;
+}
+
+/*
+ * debug attribute NHA_GROUP
+ */
+void debug_nha_group(int lev, struct rtattr *nha, const char *name)
+{
+    struct nexthop_grp *grp;
+    int i, num;
+
+    if(debug_rta_len_chk(lev, nha, name, sizeof(*grp)))
+        return;
+
+    grp = (struct nexthop_grp *)RTA_DATA(nha);
+    num = RTA_PAYLOAD(nha) / sizeof(*grp);
+
+    rec_dbg(lev, "%s(%hu):", name, RTA_ALIGN(nha->rta_len));
+    for(i = 0; i < num; i++) {
+        rec_dbg(lev, "    [ nexthop_grp(%d) ]", sizeof(*grp));
+        rec_dbg(lev, "        id(%d): %u",
+            sizeof(grp[i].id), grp[i].id);
+        rec_dbg(lev, "        weight(%d): %d",
+            sizeof(grp[i].weight), grp[i].weight);
+    }
+}
+
+#endif
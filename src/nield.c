@@ -16,6 +16,7 @@
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
+#define _GNU_SOURCE /* recvmmsg() */
 #define SYSLOG_NAMES
 #include "nield.h"
 #include "rtnetlink.h"
@@ -25,12 +26,70 @@ static int facility;
 static int msg_opts;
 static int lock_fd;
 static int rcv_buflen;
+static int recv_batch = RECV_BATCH_DEFAULT;
+static int resync_opt;
+static int separate_opt;
+static int link_muted;
 static char lock_file[MAX_STR_SIZE] = LOCK_FILE;
 static char log_file[MAX_STR_SIZE];
 static char dbg_file[MAX_STR_SIZE];
+static char json_file[MAX_STR_SIZE];
+static int stats_interval;
+static int text_opt = 1;
+static int epoll_fd = -1;
+static int signal_fd = -1;
 volatile int sigterm_received = 0;
 volatile int sigint_received = 0;
 
+/* receive statistics */
+static struct {
+    unsigned long long syscalls;
+    unsigned long long datagrams;
+    unsigned long long messages;
+    unsigned long long overruns;
+    unsigned long long truncations;
+    unsigned long long resyncs;
+    unsigned long long discarded;
+} recv_stats;
+
+/* classes of events in order of priority to receive */
+static struct event_class {
+    const char *name;
+    unsigned groups;
+    int buflen;
+} event_classes[] = {
+    { "link",  RTMGRP_NOTIFY | RTMGRP_LINK, 0 },
+    { "addr",  RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR, 0 },
+    { "neigh", RTMGRP_NEIGH, 0 },
+    { "route", RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE | RTMGRP_NEXTHOP, 0 },
+    { "rule",  RTMGRP_IPV4_RULE | (1 << (RTNLGRP_IPV6_RULE - 1)), 0 },
+    { "tc",    RTMGRP_TC, 0 },
+};
+#define EVENT_CLASS_MAX (sizeof(event_classes) / sizeof(event_classes[0]))
+
+/* sockets to receive events(a socket of all classes or a socket per class) */
+static struct event_sock {
+    const char *name;
+    unsigned groups;
+    int sock;
+    unsigned long long datagrams;
+    unsigned long long overruns;
+} event_socks[EVENT_CLASS_MAX];
+static int event_sock_num;
+
+/* ids of file descriptors in an event loop(sockets are in order of priority) */
+#define LOOP_ID_SIGNAL  EVENT_CLASS_MAX
+#define LOOP_ID_TIMER   (EVENT_CLASS_MAX + 1)
+#define LOOP_TIMER_MAX  4
+#define LOOP_EVENT_MAX  (EVENT_CLASS_MAX + 1 + LOOP_TIMER_MAX)
+
+/* periodic timers in an event loop */
+static struct loop_timer {
+    int fd;
+    void (*handler)(void);
+} loop_timers[LOOP_TIMER_MAX];
+static int loop_timer_num;
+
 /*
  * main function
  */
@@ -49,6 +108,13 @@ int main(int argc, char *argv[])
     if(ret < 0)
         close_exit(sock, 0, ret);
 
+    /* open file of JSON lines sink */
+    if(json_file[0]) {
+        ret = open_event_json(json_file);
+        if(ret < 0)
+            close_exit(sock, 0, ret);
+    }
+
     /* open debug file */
     if(log_opts & L_DEBUG) {
         ret = open_dbg(dbg_file);
@@ -71,6 +137,9 @@ int main(int argc, char *argv[])
     if(ret < 0)
         close_exit(sock, 0, ret);
 
+    /* start a log writer thread after detaching */
+    start_log_writer();
+
     rec_log("info: nield %s started(PID: %ld)", VERSION, (long)getpid());
 
     /* write pid to lock file */
@@ -78,9 +147,11 @@ int main(int argc, char *argv[])
     if(ret < 0)
         close_exit(sock, 0, ret);
 
+    /* set rtnetlink multicast groups */
+    groups = set_rtnetlink_groups();
+
     /* open netlink socket to create list */
-    groups = 0;
-    sock = open_netlink_socket(groups, NETLINK_ROUTE);
+    sock = open_netlink_socket(0, NETLINK_ROUTE);
     if(sock < 0)
         close_exit(sock, 1, ret);
 
@@ -90,7 +161,7 @@ int main(int argc, char *argv[])
         close_exit(sock, 1, ret);
 
     /* receive interface list */
-    ret = recv_reply(sock, RTM_GETLINK);
+    ret = recv_reply(sock, RTM_GETLINK, 0);
     if(ret != 0)
         close_exit(sock, 1, ret);
 
@@ -100,7 +171,7 @@ int main(int argc, char *argv[])
         close_exit(sock, 1, ret);
 
     /* receive bridge interface list */
-    ret = recv_reply(sock, RTM_GETLINK);
+    ret = recv_reply(sock, RTM_GETLINK, 0);
     if(ret != 0)
         close_exit(sock, 1, ret);
 
@@ -110,23 +181,76 @@ int main(int argc, char *argv[])
         close_exit(sock, 1, ret);
 
     /* receive & create interface list */
-    ret = recv_reply(sock, RTM_GETNEIGH);
+    ret = recv_reply(sock, RTM_GETNEIGH, 0);
     if(ret != 0)
         close_exit(sock, 1, ret);
 
+    /* request & create interface address table when addresses are logged */
+    if(groups & (RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR)) {
+        ret = send_request(sock, RTM_GETADDR, get_ifalist_family(groups));
+        if(ret < 0)
+            close_exit(sock, 1, ret);
+
+        ret = recv_reply(sock, RTM_GETADDR, 0);
+        if(ret != 0)
+            close_exit(sock, 1, ret);
+    }
+
+#ifdef HAVE_LINUX_NEXTHOP_H
+    /* request & create nexthop object list which routes refer to */
+    if(groups & RTMGRP_NEXTHOP) {
+        ret = send_request(sock, RTM_GETNEXTHOP, AF_UNSPEC);
+        if(ret < 0)
+            close_exit(sock, 1, ret);
+
+        ret = recv_reply(sock, RTM_GETNEXTHOP, 0);
+        if(ret != 0)
+            close_exit(sock, 1, ret);
+    }
+#endif
+
+    /* request & create routing table mirror when routes are logged */
+    if(groups & (RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE)) {
+        ret = send_request(sock, RTM_GETROUTE, get_rib_family(groups));
+        if(ret < 0)
+            close_exit(sock, 1, ret);
+
+        ret = recv_reply(sock, RTM_GETROUTE, 0);
+        if(ret != 0)
+            close_exit(sock, 1, ret);
+    }
+
     /* close socket */
     close(sock);
 
-    /* set rtnetlink multicast groups */
-    groups = set_rtnetlink_groups();
-    sock = open_netlink_socket(groups, NETLINK_ROUTE);
-    if(sock < 0)
-        close_exit(sock, 1, ret);
+    /* open sockets of rtnetlink multicast groups */
+    ret = open_event_sockets(groups);
+    if(ret < 0)
+        close_exit(-1, 1, ret);
+
+    /* write statistics periodically */
+    if(stats_interval)
+        add_loop_timer(stats_interval, print_stats);
+
+    /* flush lines of JSON lines sink every second */
+    if(json_file[0])
+        add_loop_timer(1, flush_event_json);
+
+    /* write summaries of bursts of route events every window */
+    ret = start_summary();
+    if(ret < 0)
+        close_exit(-1, 1, ret);
+
+    /* log top flapping routes every interval */
+    ret = start_flap();
+    if(ret < 0)
+        close_exit(-1, 1, ret);
 
     /* recevie events */
-    ret = recv_events(sock);
+    ret = recv_events();
 
-    close_exit(sock, 1, ret);
+    close_event_sockets();
+    close_exit(-1, 1, ret);
 
     return(0);
 }
@@ -144,8 +268,15 @@ void close_exit(int sock, int log_flag, int ret)
     if(log_opts & L_DEBUG)
         close_dbg();
     
-    if(log_flag)
+    if(log_flag) {
+        flush_summary();
+        rec_log("info: received %llu messages in %llu datagrams with %llu syscalls",
+            recv_stats.messages, recv_stats.datagrams, recv_stats.syscalls);
         rec_log("info: nield %s terminated(PID: %ld)", VERSION, getpid());
+    }
+
+    /* close file of JSON lines sink */
+    close_event_json();
 
     /* close log file */
     close_log();
@@ -168,7 +299,7 @@ int set_options(int argc, char *argv[])
     strcpy(dbg_file, DEBUG_FILE_DEFAULT);
 
     /* parse options */
-    while((opt = getopt(argc, argv, "vhp:l:s:L:d:46inarft")) != EOF) {
+    while((opt = getopt(argc, argv, "vhp:l:j:s:b:w:F:I:HRSTL:d:46inarft")) != EOF) {
         switch(opt) {
             case 'v':
                 fprintf(stderr, "version: %s\n", VERSION);
@@ -189,6 +320,15 @@ int set_options(int argc, char *argv[])
                 }
                 log_opts |= L_LOCAL;
                 break;
+            case 'j':
+                if(strlen(optarg) < MAX_STR_SIZE) {
+                    strcpy(json_file, optarg);
+                } else {
+                    fprintf(stderr, "error: %s: json file path is longer than %d byte\n",
+                        __func__, MAX_STR_SIZE);
+                    return(-1);
+                }
+                break;
             case 'L':
                 if(strlen(optarg) < MAX_STR_SIZE) {
                     facility = set_facility(optarg);
@@ -216,13 +356,59 @@ int set_options(int argc, char *argv[])
                 break;
             case 's':
                 if(strlen(optarg) < MAX_STR_SIZE) {
-                    rcv_buflen = atoi(optarg);
+                    if(set_rcvbuf_option(optarg) < 0) {
+                        fprintf(stderr, "error: %s: unknown event class \"%s\"\n",
+                            __func__, optarg);
+                        return(-1);
+                    }
                 } else {
                     fprintf(stderr, "error: %s: receive buffer size is longer than %d byte\n",
                         __func__, MAX_STR_SIZE);
                     return(-1);
                 }
                 break;
+            case 'b':
+                recv_batch = atoi(optarg);
+                if(recv_batch < 1 || recv_batch > RECV_BATCH_MAX) {
+                    fprintf(stderr, "error: %s: batch size must be between 1 and %d\n",
+                        __func__, RECV_BATCH_MAX);
+                    return(-1);
+                }
+                break;
+            case 'w':
+                if(set_summary_option(optarg) < 0) {
+                    fprintf(stderr, "error: %s: summary window must be positive and threshold must not be negative\n",
+                        __func__);
+                    return(-1);
+                }
+                break;
+            case 'F':
+                if(set_flap_option(optarg) < 0) {
+                    fprintf(stderr, "error: %s: invalid route flap tracking \"%s\"\n",
+                        __func__, optarg);
+                    return(-1);
+                }
+                break;
+            case 'I':
+                stats_interval = atoi(optarg);
+                if(stats_interval < 1) {
+                    fprintf(stderr, "error: %s: statistics interval must be positive\n",
+                        __func__);
+                    return(-1);
+                }
+                break;
+            case 'H':
+                text_opt = 0;
+                break;
+            case 'R':
+                resync_opt = 1;
+                break;
+            case 'S':
+                separate_opt = 1;
+                break;
+            case 'T':
+                log_opts |= L_MONO;
+                break;
             case '4':
                 msg_opts |= M_IPV4;
                 break;
@@ -261,6 +447,31 @@ int set_options(int argc, char *argv[])
     return(0);
 }
 
+/*
+ * set a receive buffer size of all sockets or a socket of an event class
+ */
+int set_rcvbuf_option(char *arg)
+{
+    char *p = strchr(arg, '=');
+    int i;
+
+    /* buffer_size or class=buffer_size */
+    if(!p) {
+        rcv_buflen = atoi(arg);
+        return(0);
+    }
+
+    for(i = 0; i < EVENT_CLASS_MAX; i++) {
+        if(strlen(event_classes[i].name) == p - arg &&
+            !strncmp(event_classes[i].name, arg, p - arg)) {
+            event_classes[i].buflen = atoi(p + 1);
+            return(0);
+        }
+    }
+
+    return(-1);
+}
+
 /*
  * get logging options
  */
@@ -398,61 +609,29 @@ int init_daemon(void)
 }
 
 /*
- * set signal handlers(SIGTERM, SIGINT)
+ * set signal handlers(SIGTERM, SIGINT, SIGUSR1, SIGUSR2, SIGHUP)
  */
 int set_signal_handlers(void)
 {
-    struct sigaction sigterm_act, sigint_act, sigusr1_act, sigusr2_act;
-
-    /* set SIGTERM handler */
-    sigterm_act.sa_handler = sigterm_handler;
-    if(sigfillset(&sigterm_act.sa_mask) < 0) {
-        fprintf(stderr, "error: %s: sigfillset(): %s\n", __func__, strerror(errno));
-        return(-1);
-    }
-    sigterm_act.sa_flags = 0;
-
-    if(sigaction(SIGTERM, &sigterm_act, 0) < 0) {
-        fprintf(stderr, "error: %s: sigaction(): %s\n", __func__, strerror(errno));
-        return(-1);
-    }
-
-    /* set SIGINT handler */
-    sigint_act.sa_handler = sigint_handler;
-    if(sigfillset(&sigint_act.sa_mask) < 0) {
-        fprintf(stderr, "error: %s: sigfillset(): %s\n", __func__, strerror(errno));
-        return(-1);
-    }
-    sigint_act.sa_flags = 0;
-
-    if(sigaction(SIGINT, &sigint_act, 0) < 0) {
-        fprintf(stderr, "error: %s: sigaction(): %s\n", __func__, strerror(errno));
-        return(-1);
-    }
-
-    /* set SIGUSR1 handler */
-    sigusr1_act.sa_handler = sigusr1_handler;
-    if(sigfillset(&sigusr1_act.sa_mask) < 0) {
-        fprintf(stderr, "error: %s: sigfillset(): %s\n", __func__, strerror(errno));
-        return(-1);
-    }
-    sigusr1_act.sa_flags = 0;
-
-    if(sigaction(SIGUSR1, &sigusr1_act, 0) < 0) {
-        fprintf(stderr, "error: %s: sigaction(): %s\n", __func__, strerror(errno));
-        return(-1);
-    }
-
-    /* set SIGUSR2 handler */
-    sigusr2_act.sa_handler = sigusr2_handler;
-    if(sigfillset(&sigusr2_act.sa_mask) < 0) {
-        fprintf(stderr, "error: %s: sigfillset(): %s\n", __func__, strerror(errno));
+    sigset_t mask;
+
+    /* signals are received through a signalfd in an event loop */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGUSR1);
+    sigaddset(&mask, SIGUSR2);
+    sigaddset(&mask, SIGHUP);
+    sigaddset(&mask, SIGCHLD);
+
+    if(sigprocmask(SIG_BLOCK, &mask, NULL) < 0) {
+        fprintf(stderr, "error: %s: sigprocmask(): %s\n", __func__, strerror(errno));
         return(-1);
     }
-    sigusr2_act.sa_flags = 0;
 
-    if(sigaction(SIGUSR2, &sigusr2_act, 0) < 0) {
-        fprintf(stderr, "error: %s: sigaction(): %s\n", __func__, strerror(errno));
+    signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if(signal_fd < 0) {
+        fprintf(stderr, "error: %s: signalfd(): %s\n", __func__, strerror(errno));
         return(-1);
     }
 
@@ -477,14 +656,39 @@ void sigint_handler(int sig)
     sigint_received = 1;
 }
 
+/*
+ * write snapshots of an interface list and history
+ */
+void snapshot_iflist(void)
+{
+    dump_iflist(1);
+    dump_iflist(2);
+
+    if(text_opt) {
+        print_iflist(1);
+        print_iflist(2);
+    }
+}
+
+/*
+ * write a snapshot of a neighbor discovery cache list
+ */
+void snapshot_ndlist(void)
+{
+    dump_ndlist();
+
+    if(text_opt)
+        print_ndlist();
+}
+
 /*
  * signal handler for SIGUSR1
  */
 void sigusr1_handler(int sig)
 {
     rec_log("info: SIGUSR1 called(PID: %ld)", (long)getpid());
-    print_iflist(1);
-    print_iflist(2);
+    fork_snapshot(snapshot_iflist);
+    print_stats();
 }
 
 /*
@@ -493,7 +697,23 @@ void sigusr1_handler(int sig)
 void sigusr2_handler(int sig)
 {
     rec_log("info: SIGUSR2 called(PID: %ld)", (long)getpid());
-    print_ndlist();
+    fork_snapshot(snapshot_ndlist);
+}
+
+/*
+ * signal handler for SIGHUP
+ */
+void sighup_handler(int sig)
+{
+    rec_log("info: SIGHUP called(PID: %ld)", (long)getpid());
+
+    /* reopen files rotated by other tools */
+    if(log_opts & L_LOCAL)
+        reopen_log(log_file);
+    if(log_opts & L_DEBUG)
+        reopen_dbg(dbg_file);
+    if(json_file[0])
+        reopen_event_json(json_file);
 }
 
 int set_rtnetlink_groups(void)
@@ -549,9 +769,45 @@ int set_rtnetlink_groups(void)
                       RTMGRP_TC;
     }
 
+    /* nexthop objects are kept up to date to resolve routes using them */
+    if(groups & (RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE))
+        groups |= RTMGRP_NEXTHOP;
+
+    /* interface list is always kept up to date to convert index to name */
+    if(!(groups & RTMGRP_LINK)) {
+        groups |= RTMGRP_LINK;
+        link_muted = 1;
+    }
+
     return(groups);
 }
 
+/*
+ * get an address family of routes dumped for groups
+ */
+int get_rib_family(unsigned groups)
+{
+    if(!(groups & RTMGRP_IPV6_ROUTE))
+        return(AF_INET);
+    if(!(groups & RTMGRP_IPV4_ROUTE))
+        return(AF_INET6);
+
+    return(AF_UNSPEC);
+}
+
+/*
+ * get an address family of interface addresses dumped for groups
+ */
+int get_ifalist_family(unsigned groups)
+{
+    if(!(groups & RTMGRP_IPV6_IFADDR))
+        return(AF_INET);
+    if(!(groups & RTMGRP_IPV4_IFADDR))
+        return(AF_INET6);
+
+    return(AF_UNSPEC);
+}
+
 /*
  * open a rtnetlink socket
  */
@@ -571,11 +827,14 @@ int open_netlink_socket(unsigned groups, int proto)
     /* initialization */
     memset(&nla, 0, sizeof(nla));
 
-    /* set & bind local address */
+    /* set & bind local address(kernel assigns a unique port id) */
     nla.nl_family = AF_NETLINK;
-    nla.nl_pid = getpid();
+    nla.nl_pid = 0;
     nla.nl_groups = groups;
-    bind(sock, (struct sockaddr *)&nla, sizeof(nla));
+    if(bind(sock, (struct sockaddr *)&nla, sizeof(nla)) < 0) {
+        rec_log("error: %s: bind(): %s", __func__, strerror(errno));
+        exit(1);
+    }
 
     /* set receive buffer size */
     if(rcv_buflen) {
@@ -599,7 +858,12 @@ int send_request(int sock, int type, int family)
     struct sockaddr_nl nla;
     struct {
         struct nlmsghdr nlm;
-        struct rtgenmsg rtgm;
+        union {
+            struct rtgenmsg rtgm;
+#ifdef HAVE_LINUX_NEXTHOP_H
+            struct nhmsg nhm;
+#endif
+        } u;
     } req;
     int err;
 
@@ -612,17 +876,21 @@ int send_request(int sock, int type, int family)
     /* set remote address */
     nla.nl_family = AF_NETLINK;
 
-    /* set netlink message header */
-    req.nlm.nlmsg_len = NLMSG_LENGTH(sizeof(req.rtgm));
+    /* set netlink message header(a dump of nexthop objects needs a whole nhmsg) */
+    req.nlm.nlmsg_len = NLMSG_LENGTH(sizeof(req.u.rtgm));
+#ifdef HAVE_LINUX_NEXTHOP_H
+    if(type == RTM_GETNEXTHOP)
+        req.nlm.nlmsg_len = NLMSG_LENGTH(sizeof(req.u.nhm));
+#endif
     req.nlm.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
     req.nlm.nlmsg_type = type;
 
     /* set routing message header */
-    req.rtgm.rtgen_family = family;
+    req.u.rtgm.rtgen_family = family;
 
     /* set message header */
     iov.iov_base = (void *)&req;
-    iov.iov_len = sizeof(req);
+    iov.iov_len = req.nlm.nlmsg_len;
 
     msg.msg_name = (void *)&nla;
     msg.msg_namelen = sizeof(nla);
@@ -642,19 +910,17 @@ int send_request(int sock, int type, int family)
 /*
  * receive a reply from kernel through rtnetlink socket
  */
-int recv_reply(int sock, int type)
+int recv_reply(int sock, int type, int resync)
 {
     struct msghdr msg;
     struct iovec iov;
     struct sockaddr_nl nla;
-    char buf[16384];
-    int err, len;
+    int err = 0, len, size = DUMP_BUF_SIZE;
 
     /* initialization */
     memset(&msg, 0, sizeof(msg));
     memset(&iov, 0, sizeof(iov));
     memset(&nla, 0, sizeof(nla));
-    memset(buf, 0, sizeof(buf));
 
     /* set message header */
     msg.msg_name = (void *)&nla;
@@ -662,21 +928,24 @@ int recv_reply(int sock, int type)
     msg.msg_iov = (void *)&iov;
     msg.msg_iovlen = 1;
 
-    iov.iov_base = buf;
-    iov.iov_len = sizeof(buf);
+    iov.iov_base = get_rcvbuf(&size);
+    iov.iov_len = size;
+    if(!iov.iov_base)
+        return(1);
 
     /* receive loop */
     while(1) {
-        memset(buf, 0, sizeof(buf));
-        len = recvmsg(sock, &msg, 0);
+        len = recvmsg_exact(sock, &msg);
         if(len < 0) {
             if(errno == EINTR || errno == EAGAIN)
                 continue;
             rec_log("error: %s: recvmsg(): %s", __func__, strerror(errno));
-            return(1);
+            err = -1;
+            break;
         } else if(len == 0) {
             rec_log("error: %s: recvmsg(): receive EOF", __func__);
-            return(1);
+            err = -1;
+            break;
         }
 
         /* verify whether a message originates from kernel */
@@ -687,104 +956,577 @@ int recv_reply(int sock, int type)
         }
 
         if(type == RTM_GETLINK) {
-            /* create interface list */
-            err = create_iflist(&msg);
-            if(err > 0)
-                break;
-            else if(err < 0)
-                return(1);
+            /* create or resynchronize interface list */
+            err = resync ? resync_iflist(&msg, len) : create_iflist(&msg, len);
         } else if(type == RTM_GETNEIGH) {
-            /* create neighbor discovery list */
-            err = create_ndlist(&msg);
-            if(err)
-                break;
-            else if(err < 0)
-                return(1);
+            /* create or resynchronize neighbor discovery list */
+            err = resync ? resync_ndlist(&msg, len) : create_ndlist(&msg, len);
+        } else if(type == RTM_GETADDR) {
+            /* create or resynchronize interface address table */
+            err = resync ? resync_ifalist(&msg, len) : create_ifalist(&msg, len);
+        } else if(type == RTM_GETROUTE) {
+            /* create or resynchronize routing table mirror */
+            err = resync ? resync_rib(&msg, len) : create_rib(&msg, len);
         }
+#ifdef HAVE_LINUX_NEXTHOP_H
+        else if(type == RTM_GETNEXTHOP) {
+            /* create or resynchronize nexthop object list */
+            err = resync ? resync_nhlist(&msg, len) : create_nhlist(&msg, len);
+        }
+#endif
+        if(err)
+            break;
     }
 
-    return(0);
+    put_rcvbuf(iov.iov_base, iov.iov_len);
+
+    return(err < 0);
 }
 
 /*
- * receive notifications from kernel through rtnetlink socket
+ * request an interface to kernel and add it to an interface list
  */
-int recv_events(int sock)
+int request_link(int index)
 {
+    static int sock = -1;
+    static unsigned seq;
     struct msghdr msg;
     struct iovec iov;
     struct sockaddr_nl nla;
-    char buf[8192];
-    int err, buflen;
-    int len = sizeof(buflen);
+    struct nlmsghdr *nlh;
+    struct nlmsgerr *nle;
+    struct {
+        struct nlmsghdr nlm;
+        struct ifinfomsg ifim;
+    } req;
+    int err = 1, len, size = EVENT_BUF_SIZE;
 
-    /* logging a receive buffer size */
-    err = getsockopt(sock, SOL_SOCKET, SO_RCVBUF, &buflen, (socklen_t *)&len);
-    if(err < 0) {
-        rec_log("error: %s: getsockopt(): %s", __func__, strerror(errno));
-        exit(1);
-    }
-    rec_log("info: socket receive buffer size: %d byte", buflen);
+    /* open a netlink socket only for requests */
+    if(sock < 0)
+        sock = open_netlink_socket(0, NETLINK_ROUTE);
 
     /* initialization */
     memset(&msg, 0, sizeof(msg));
     memset(&iov, 0, sizeof(iov));
     memset(&nla, 0, sizeof(nla));
-    memset(buf, 0, sizeof(buf));
+    memset(&req, 0, sizeof(req));
 
-    /* set message header */
-    iov.iov_base = buf;
-    iov.iov_len = sizeof(buf);
+    /* set netlink message header */
+    req.nlm.nlmsg_len = NLMSG_LENGTH(sizeof(req.ifim));
+    req.nlm.nlmsg_flags = NLM_F_REQUEST;
+    req.nlm.nlmsg_type = RTM_GETLINK;
+    req.nlm.nlmsg_seq = ++seq;
+
+    /* set interface information message */
+    req.ifim.ifi_family = AF_UNSPEC;
+    req.ifim.ifi_index = index;
+
+    /* send request message */
+    nla.nl_family = AF_NETLINK;
+    if(sendto(sock, &req, sizeof(req), 0, (struct sockaddr *)&nla, sizeof(nla)) < 0) {
+        rec_log("error: %s: sendto(): %s", __func__, strerror(errno));
+        return(1);
+    }
 
+    /* set message header */
     msg.msg_name = (void *)&nla;
     msg.msg_namelen = sizeof(nla);
-    msg.msg_iov = &iov;
+    msg.msg_iov = (void *)&iov;
     msg.msg_iovlen = 1;
 
-    /* loop of receive event */
+    iov.iov_base = get_rcvbuf(&size);
+    iov.iov_len = size;
+    if(!iov.iov_base)
+        return(1);
+
+    /* receive a reply to the request */
     while(1) {
-        /* detect signal received */
-        if(sigterm_received || sigint_received)
+        len = recvmsg_exact(sock, &msg);
+        if(len < 0) {
+            if(errno == EINTR || errno == EAGAIN)
+                continue;
+            rec_log("error: %s: recvmsg(): %s", __func__, strerror(errno));
             break;
+        } else if(len == 0) {
+            rec_log("error: %s: recvmsg(): receive EOF", __func__);
+            break;
+        }
 
-        /* clear buffer */
-        memset(buf, 0, sizeof(buf));
+        /* verify whether a message originates from kernel */
+        if(nla.nl_pid)
+            continue;
 
-        /* receive event */
-        len = recvmsg(sock, &msg, 0);
-        if(len < 0) {
-            rec_log("error: %s: recvmsg(): %s", __func__, strerror(errno));
+        nlh = iov.iov_base;
+        if(!NLMSG_OK(nlh, len) || nlh->nlmsg_seq != seq)
+            continue;
 
-            if(errno == EINTR || errno == EAGAIN ||
-                errno == ENOBUFS || errno == ENOMEM)
-                continue;
+        /* an interface doesn't exist any longer */
+        if(nlh->nlmsg_type == NLMSG_ERROR) {
+            nle = (struct nlmsgerr *)NLMSG_DATA(nlh);
+            if(nle->error != -ENODEV)
+                rec_log("error: %s: ifindex %d: %s",
+                    __func__, index, strerror(-nle->error));
+            break;
+        }
 
-            return(1);
-        } else if(!len) {
-            rec_log("error: %s: recvmsg(): receive EOF", __func__);
-            return(1);
+        if(nlh->nlmsg_type == RTM_NEWLINK)
+            err = learn_iflist(nlh);
+        break;
+    }
+
+    put_rcvbuf(iov.iov_base, iov.iov_len);
+
+    return(err);
+}
+
+/*
+ * replace receive buffers of a vector with buffers of a specified size
+ */
+static int set_event_bufs(struct mmsghdr *msgvec, int num, int size)
+{
+    struct iovec *iov;
+    int i, len;
+
+    for(i = 0; i < num; i++) {
+        iov = msgvec[i].msg_hdr.msg_iov;
+        put_rcvbuf(iov->iov_base, iov->iov_len);
+
+        len = size;
+        iov->iov_base = get_rcvbuf(&len);
+        iov->iov_len = iov->iov_base ? len : 0;
+        if(!iov->iov_base)
+            return(-1);
+    }
+
+    return(0);
+}
+
+/*
+ * add a file descriptor to an event loop
+ */
+static int add_loop_fd(int fd, unsigned id)
+{
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = id;
+
+    if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        rec_log("error: %s: epoll_ctl(): %s", __func__, strerror(errno));
+        return(-1);
+    }
+
+    return(0);
+}
+
+/*
+ * add a periodic timer to an event loop
+ */
+int add_loop_timer(int interval, void (*handler)(void))
+{
+    struct loop_timer *t;
+    struct itimerspec its;
+
+    if(loop_timer_num >= LOOP_TIMER_MAX) {
+        rec_log("error: %s: too many timers", __func__);
+        return(-1);
+    }
+    t = &loop_timers[loop_timer_num];
+
+    t->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if(t->fd < 0) {
+        rec_log("error: %s: timerfd_create(): %s", __func__, strerror(errno));
+        return(-1);
+    }
+
+    memset(&its, 0, sizeof(its));
+    its.it_interval.tv_sec = its.it_value.tv_sec = interval;
+    if(timerfd_settime(t->fd, 0, &its, NULL) < 0 ||
+        add_loop_fd(t->fd, LOOP_ID_TIMER + loop_timer_num) < 0) {
+        rec_log("error: %s: can't set a timer", __func__);
+        close(t->fd);
+        return(-1);
+    }
+    t->handler = handler;
+    loop_timer_num++;
+
+    return(0);
+}
+
+/*
+ * open sockets to receive events
+ */
+int open_event_sockets(unsigned groups)
+{
+    struct event_sock *es;
+    int i, buflen, len = sizeof(buflen);
+
+    /* an event loop multiplexes sockets, signals and timers */
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if(epoll_fd < 0) {
+        rec_log("error: %s: epoll_create1(): %s", __func__, strerror(errno));
+        return(-1);
+    }
+    if(add_loop_fd(signal_fd, LOOP_ID_SIGNAL) < 0)
+        return(-1);
+
+    for(i = 0; i < EVENT_CLASS_MAX; i++) {
+        if(separate_opt && !(groups & event_classes[i].groups))
+            continue;
+
+        es = &event_socks[event_sock_num++];
+        es->name = separate_opt ? event_classes[i].name : "all";
+        es->groups = separate_opt ? (groups & event_classes[i].groups) : groups;
+        es->sock = open_netlink_socket(es->groups, NETLINK_ROUTE);
+
+        /* a receive buffer size of a class overrides a size of all */
+        buflen = event_classes[i].buflen;
+        if(separate_opt && buflen &&
+            setsockopt(es->sock, SOL_SOCKET, SO_RCVBUF, &buflen, len) < 0) {
+            rec_log("error: %s: setsockopt(): %s", __func__, strerror(errno));
+            return(-1);
+        }
+
+        /* drop uninteresting messages in kernel(debug records every message) */
+        if(!(log_opts & L_DEBUG))
+            attach_event_filter(es->sock);
+
+        if(add_loop_fd(es->sock, es - event_socks) < 0)
+            return(-1);
+
+        /* logging a receive buffer size */
+        if(getsockopt(es->sock, SOL_SOCKET, SO_RCVBUF, &buflen, (socklen_t *)&len) < 0) {
+            rec_log("error: %s: getsockopt(): %s", __func__, strerror(errno));
+            return(-1);
+        }
+        if(separate_opt)
+            rec_log("info: socket receive buffer size of %s events: %d byte",
+                es->name, buflen);
+        else
+            rec_log("info: socket receive buffer size: %d byte", buflen);
+
+        if(!separate_opt)
+            break;
+    }
+
+    return(0);
+}
+
+/*
+ * close sockets to receive events
+ */
+void close_event_sockets(void)
+{
+    int i;
+
+    for(i = 0; i < event_sock_num; i++)
+        close(event_socks[i].sock);
+    event_sock_num = 0;
+
+    for(i = 0; i < loop_timer_num; i++)
+        close(loop_timers[i].fd);
+    loop_timer_num = 0;
+
+    if(epoll_fd >= 0)
+        close(epoll_fd);
+    epoll_fd = -1;
+}
+
+/*
+ * run handlers of signals received through a signalfd
+ */
+static void handle_loop_signals(void)
+{
+    struct signalfd_siginfo si;
+
+    while(read(signal_fd, &si, sizeof(si)) == sizeof(si)) {
+        switch(si.ssi_signo) {
+            case SIGTERM:
+                sigterm_handler(si.ssi_signo);
+                break;
+            case SIGINT:
+                sigint_handler(si.ssi_signo);
+                break;
+            case SIGUSR1:
+                sigusr1_handler(si.ssi_signo);
+                break;
+            case SIGUSR2:
+                sigusr2_handler(si.ssi_signo);
+                break;
+            case SIGHUP:
+                sighup_handler(si.ssi_signo);
+                break;
+            case SIGCHLD:
+                reap_snapshot();
+                break;
+        }
+    }
+}
+
+/*
+ * run a handler of an expired timer
+ */
+static void handle_loop_timer(struct loop_timer *t)
+{
+    uint64_t expired;
+
+    if(read(t->fd, &expired, sizeof(expired)) == sizeof(expired))
+        t->handler();
+}
+
+/*
+ * receive a batch of notifications from a socket
+ */
+static int recv_event_batch(struct event_sock *es, struct mmsghdr *msgvec)
+{
+    struct sockaddr_nl *nla;
+    int err, i, num, len;
+    int trunc_len = 0, lost = 0;
+
+    /* receive events as many as possible up to batch size */
+    num = recvmmsg(es->sock, msgvec, recv_batch, MSG_DONTWAIT | MSG_TRUNC, NULL);
+    recv_stats.syscalls++;
+    if(num < 0) {
+        if(errno == EAGAIN)
+            return(0);
+
+        rec_log("error: %s: recvmmsg(): %s", __func__, strerror(errno));
+
+        if(errno == ENOBUFS) {
+            recv_stats.overruns++;
+            es->overruns++;
+
+            /* notifications were dropped by kernel */
+            if(resync_opt)
+                resync_lists(es->sock, es->groups);
+
+            return(0);
+        }
+
+        if(errno == EINTR || errno == ENOMEM)
+            return(0);
+
+        return(-1);
+    }
+    recv_stats.datagrams += num;
+    es->datagrams += num;
+
+    for(i = 0; i < num; i++) {
+        len = msgvec[i].msg_len;
+        if(!len) {
+            rec_log("error: %s: recvmmsg(): receive EOF", __func__);
+            return(-1);
+        }
+
+        /* a length of a truncated message is a length of its datagram */
+        if(check_rcvbuf_trunc(&msgvec[i].msg_hdr, len)) {
+            recv_stats.truncations++;
+            if(len > trunc_len)
+                trunc_len = len;
+            len = msgvec[i].msg_hdr.msg_iov->iov_len;
+            lost = 1;
         }
 
         /* verify whether a message originates from kernel */
-        if(nla.nl_pid) {
+        nla = msgvec[i].msg_hdr.msg_name;
+        if(nla->nl_pid) {
             rec_log("error: %s: received a message from invalid sender(%d)",
-                __func__, nla.nl_pid);
+                __func__, nla->nl_pid);
             continue;
         }
 
         /* parse messages */
-        err = parse_events(&msg);
+        err = parse_events(&msgvec[i].msg_hdr, len);
         if(err < 0)
+            return(-1);
+    }
+
+    /* grow receive buffers not to truncate messages again */
+    if(trunc_len)
+        if(set_event_bufs(msgvec, recv_batch, trunc_len) < 0)
+            return(-1);
+
+    /* a part of truncated messages was lost */
+    if(lost && resync_opt)
+        resync_lists(es->sock, es->groups);
+
+    return(num);
+}
+
+/*
+ * receive notifications from kernel through rtnetlink sockets
+ */
+int recv_events(void)
+{
+    struct mmsghdr *msgvec;
+    struct iovec *iov;
+    struct sockaddr_nl *nla;
+    struct epoll_event evs[LOOP_EVENT_MAX];
+    struct event_sock *es;
+    unsigned id;
+    int i, nev, num = 0;
+
+    rec_log("info: receive batch size: %d", recv_batch);
+    if(resync_opt)
+        rec_log("info: resynchronization with kernel enabled");
+
+    /* allocate a vector of receive buffers */
+    msgvec = calloc(recv_batch, sizeof(*msgvec));
+    iov = calloc(recv_batch, sizeof(*iov));
+    nla = calloc(recv_batch, sizeof(*nla));
+    if(!msgvec || !iov || !nla) {
+        rec_log("error: %s: malloc() failed", __func__);
+        free(msgvec);
+        free(iov);
+        free(nla);
+        return(1);
+    }
+
+    /* set message headers */
+    for(i = 0; i < recv_batch; i++) {
+        msgvec[i].msg_hdr.msg_name = (void *)&nla[i];
+        msgvec[i].msg_hdr.msg_namelen = sizeof(nla[i]);
+        msgvec[i].msg_hdr.msg_iov = &iov[i];
+        msgvec[i].msg_hdr.msg_iovlen = 1;
+    }
+    if(set_event_bufs(msgvec, recv_batch, EVENT_BUF_SIZE) < 0)
+        num = -1;
+
+    /* loop of receive event */
+    while(num >= 0) {
+        /* detect signal received */
+        if(sigterm_received || sigint_received)
+            break;
+
+        nev = epoll_wait(epoll_fd, evs, LOOP_EVENT_MAX, -1);
+        if(nev < 0) {
+            if(errno == EINTR)
+                continue;
+            rec_log("error: %s: epoll_wait(): %s", __func__, strerror(errno));
+            num = -1;
             break;
+        }
+
+        /* receive a batch from a socket of the highest priority at a time */
+        for(es = NULL, i = 0; i < nev; i++) {
+            id = evs[i].data.u32;
+            if(id < event_sock_num && (!es || id < es - event_socks))
+                es = &event_socks[id];
+        }
+        if(es)
+            num = recv_event_batch(es, msgvec);
+
+        /* run signal and timer handlers in normal context */
+        for(i = 0; i < nev && num >= 0; i++) {
+            id = evs[i].data.u32;
+            if(id == LOOP_ID_SIGNAL)
+                handle_loop_signals();
+            else if(id >= LOOP_ID_TIMER)
+                handle_loop_timer(&loop_timers[id - LOOP_ID_TIMER]);
+        }
     }
 
-    return(0);
+    for(i = 0; i < recv_batch; i++)
+        put_rcvbuf(iov[i].iov_base, iov[i].iov_len);
+    free(msgvec);
+    free(iov);
+    free(nla);
+
+    return(num < 0);
+}
+
+/*
+ * resynchronize lists of groups with kernel after notifications were lost
+ */
+int resync_lists(int ev_sock, unsigned groups)
+{
+    int sock, ret = 0;
+
+    /* no list is kept for other groups */
+    if(!(groups & (RTMGRP_LINK | RTMGRP_NEIGH | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR |
+        RTMGRP_NEXTHOP | RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE)))
+        return(0);
+
+    rec_log("info: resynchronizing lists with kernel");
+    recv_stats.resyncs++;
+
+    /* discard stale notifications which a dump supersedes */
+    while(recv(ev_sock, NULL, 0, MSG_DONTWAIT | MSG_TRUNC) >= 0)
+        recv_stats.discarded++;
+
+    /* open another netlink socket to dump lists */
+    sock = open_netlink_socket(0, NETLINK_ROUTE);
+
+    /* logging changes missed while notifications were lost */
+    set_log_prefix("missed change: ");
+    set_event_flags(EVENT_F_MISSED);
+
+    /* resynchronize interface list */
+    if(groups & RTMGRP_LINK) {
+        set_log_mute(link_muted);
+        ret = send_request(sock, RTM_GETLINK, AF_UNSPEC);
+        if(!ret)
+            ret = recv_reply(sock, RTM_GETLINK, 1);
+        if(!ret)
+            sweep_iflist();
+        set_log_mute(0);
+    }
+
+    /* resynchronize neighbor discovery list */
+    if(!ret && (groups & RTMGRP_NEIGH)) {
+        ret = send_request(sock, RTM_GETNEIGH, AF_UNSPEC);
+        if(!ret)
+            ret = recv_reply(sock, RTM_GETNEIGH, 1);
+        if(!ret)
+            sweep_ndlist();
+    }
+
+    /* resynchronize interface address table */
+    if(!ret && (groups & (RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR))) {
+        ret = send_request(sock, RTM_GETADDR, get_ifalist_family(groups));
+        if(!ret)
+            ret = recv_reply(sock, RTM_GETADDR, 1);
+        if(!ret)
+            sweep_ifalist();
+    }
+
+#ifdef HAVE_LINUX_NEXTHOP_H
+    /* resynchronize nexthop object list */
+    if(!ret && (groups & RTMGRP_NEXTHOP)) {
+        ret = send_request(sock, RTM_GETNEXTHOP, AF_UNSPEC);
+        if(!ret)
+            ret = recv_reply(sock, RTM_GETNEXTHOP, 1);
+        if(!ret)
+            sweep_nhlist();
+    }
+#endif
+
+    /* resynchronize routing table mirror */
+    if(!ret && (groups & (RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE))) {
+        ret = send_request(sock, RTM_GETROUTE, get_rib_family(groups));
+        if(!ret)
+            ret = recv_reply(sock, RTM_GETROUTE, 1);
+        if(!ret)
+            sweep_rib();
+    }
+
+    set_log_prefix(NULL);
+    set_event_flags(0);
+    close(sock);
+
+    if(ret)
+        rec_log("error: %s: failed to resynchronize lists", __func__);
+    else
+        rec_log("info: resynchronized lists with kernel");
+
+    return(ret);
 }
 
 /*
  * parse messages in received notifications from kernel
  */
-int parse_events(struct msghdr *mhdr)
+int parse_events(struct msghdr *mhdr, int len)
 {
     struct nlmsghdr *nlh;
     struct nlmsgerr *nle;
@@ -792,15 +1534,19 @@ int parse_events(struct msghdr *mhdr)
 
     /* get netlink message header */
     nlh = mhdr->msg_iov->iov_base;
-    nlh_len = mhdr->msg_iov->iov_len;
+    nlh_len = len;
 
     /* parse netlink message type */
     for( ; NLMSG_OK(nlh, nlh_len); nlh = NLMSG_NEXT(nlh, nlh_len)) {
+        recv_stats.messages++;
+
         switch(nlh->nlmsg_type) {
             /* interface link message */
             case RTM_NEWLINK:
             case RTM_DELLINK:
+                set_log_mute(link_muted);
                 parse_ifimsg(nlh);
+                set_log_mute(0);
                 break;
             /* interface address message */
             case RTM_NEWADDR:
@@ -817,6 +1563,13 @@ int parse_events(struct msghdr *mhdr)
             case RTM_DELROUTE:
                 parse_rtmsg(nlh);
                 break;
+#ifdef HAVE_LINUX_NEXTHOP_H
+            /* nexthop object message */
+            case RTM_NEWNEXTHOP:
+            case RTM_DELNEXTHOP:
+                parse_nhmsg(nlh);
+                break;
+#endif
 #ifdef HAVE_LINUX_FIB_RULES_H
             /* fib rule header */
             case RTM_NEWRULE:
@@ -854,3 +1607,50 @@ int parse_events(struct msghdr *mhdr)
 
     return(0);
 }
+
+/*
+ * print statistics
+ */
+void print_stats(void)
+{
+    FILE *stats;
+    int i;
+
+    stats = fopen(STATS_FILE, "w");
+    if(stats == NULL) {
+        rec_log("error: %s: can't open stats file(%s)", __func__, STATS_FILE);
+        return;
+    }
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ receive statistics ]\n");
+    fprintf(stats, "batch size: %d\n", recv_batch);
+    fprintf(stats, "syscalls: %llu\n", recv_stats.syscalls);
+    fprintf(stats, "datagrams: %llu\n", recv_stats.datagrams);
+    fprintf(stats, "messages: %llu\n", recv_stats.messages);
+    fprintf(stats, "overruns: %llu\n", recv_stats.overruns);
+    fprintf(stats, "truncations: %llu\n", recv_stats.truncations);
+    fprintf(stats, "resynchronizations: %llu\n", recv_stats.resyncs);
+    fprintf(stats, "datagrams discarded by resynchronization: %llu\n", recv_stats.discarded);
+    fprintf(stats, "syscalls per message: %.3f\n", recv_stats.messages ?
+        (double)recv_stats.syscalls / recv_stats.messages : 0.0);
+    for(i = 0; i < event_sock_num; i++)
+        fprintf(stats, "socket of %s events: datagrams %llu, overruns %llu\n",
+            event_socks[i].name, event_socks[i].datagrams, event_socks[i].overruns);
+    print_rcvbuf_stats(stats);
+    print_log_stats(stats);
+    print_filter_stats(stats);
+    print_snapshot_stats(stats);
+    print_event_stats(stats);
+    print_iflist_stats(stats);
+    print_ndlist_stats(stats);
+    print_ifalist_stats(stats);
+#ifdef HAVE_LINUX_NEXTHOP_H
+    print_nhlist_stats(stats);
+#endif
+    print_rib_stats(stats);
+    print_summary_stats(stats);
+    print_flap_stats(stats);
+
+    fclose(stats);
+}
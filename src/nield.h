@@ -39,6 +39,13 @@
 #include <fcntl.h>
 #include <sys/time.h>
 #include <sys/syslog.h>
+#include <sys/uio.h> /* writev */
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
 #include <arpa/inet.h>
 #include <netinet/in.h> /* INET_ADDRSTRLEN, INET6_ADDRSTRLEN */
 #include <sys/types.h>
@@ -52,6 +59,9 @@
 #ifdef HAVE_LINUX_FIB_RULES_H
 # include <linux/fib_rules.h>
 #endif
+#ifdef HAVE_LINUX_NEXTHOP_H
+# include <linux/nexthop.h>
+#endif
 #include <linux/if.h> /* IFNAMSIZ */
 #include <linux/ip.h> /* struct iphdr */
 #include <linux/if_vlan.h> /* VLAN_FLAG_* */
@@ -90,24 +100,50 @@
 #endif
 
 #include "list.h"
+#include "hash.h"
+#include "pool.h"
 
 /* default value */
-#define NIELD_USAGE          "[-vh46inar] [-p lock_file] [-l log_file] [-s buffer_size] [-L syslog_facility] [-d debug_file]"
+#define NIELD_USAGE          "[-vhHRST46inar] [-p lock_file] [-I stats_interval] [-l log_file] [-j json_file] [-s [class=]buffer_size] [-b batch_size] [-w window[:threshold]] [-F interval[:top_n[:half_life]]] [-L syslog_facility] [-d debug_file]"
 #define LOG_FILE_DEFAULT     "/var/log/nield.log"
 #define DEBUG_FILE_DEFAULT   "/var/log/nield.dbg"
 #define LOCK_FILE            "/var/run/nield.pid"
 #define IFLIST_FILE          "/tmp/nield.iflist"
 #define IFHIST_FILE          "/tmp/nield.ifhist"
 #define NDLIST_FILE          "/tmp/nield.ndlist"
+#define STATS_FILE           "/tmp/nield.stats"
+#define SNAPSHOT_SUFFIX      ".jsonl"
+#define SNAPSHOT_VERSION     1
 #define MAX_STR_SIZE         128
 #define MAX_MSG_SIZE         2048
 #define MODULE_NAME_LEN      (64 - sizeof(unsigned long))
+#define HWADDR_MAX           20 /* INFINIBAND_ALEN */
+#define HWADDR_STRLEN        (HWADDR_MAX * 3)
+#define KIND_MAX             256
+#define LOG_RING_SIZE        1024 /* power of 2 */
+#define LOG_BATCH_SIZE       64
+#define LOG_FLUSH_MSEC       50
+#define TIMESTAMP_STRLEN     64
 #define BOND_MAX_ARP_TARGETS 32
+#define EVENT_BUF_SIZE       8192
+#define DUMP_BUF_SIZE        32768
+#define RECV_BATCH_DEFAULT   16
+#define RECV_BATCH_MAX       1024
+#define EVENT_SINK_MAX       4
+#define RIB_NEXTHOP_MAX      256
+#define EVENT_NEXTHOP_MAX    16 /* nexthops fitting in a log message */
+#define SUMMARY_THRESHOLD_DEFAULT 10
+#define SUMMARY_SAMPLE_MAX   3
+#define FLAP_TRACK_MAX       1024
+#define FLAP_TOP_DEFAULT     10
+#define FLAP_HALF_LIFE_DEFAULT 300
+#define FLAP_PENALTY_MIN     3.0
 
 /* logging option flag */
 #define L_LOCAL   0x0001
 #define L_SYSLOG  0x0002
 #define L_DEBUG   0x0004
+#define L_MONO    0x0008
 
 /* message option flag */
 #define M_IPV4    0x0001
@@ -120,6 +156,13 @@
 #define M_TC      0x0080
 #define M_XFRM    0x0100
 
+/* rtnetlink multicast group of nexthop objects(no RTMGRP_* is defined) */
+#ifdef HAVE_LINUX_NEXTHOP_H
+#define RTMGRP_NEXTHOP (1U << (RTNLGRP_NEXTHOP - 1))
+#else
+#define RTMGRP_NEXTHOP 0
+#endif
+
 /* interface message type flag */
 #define IF_ADD    0x0001
 #define IF_DEL    0x0002
@@ -129,29 +172,250 @@
 struct iflist_entry {
 	unsigned index;
 	char name[IFNAMSIZ];
-	unsigned char addr[INET6_ADDRSTRLEN+1];
-	unsigned char brd[INET6_ADDRSTRLEN+1];
+	unsigned char addr[HWADDR_MAX];
+	unsigned char brd[HWADDR_MAX];
+	unsigned char addr_len;
+	unsigned char brd_len;
 	unsigned short type;
 	unsigned flags;
 	unsigned short vid;
 	int mtu;
-	char kind[MODULE_NAME_LEN];
+	unsigned char kind;
 	int index_master;
-	char name_master[IFNAMSIZ];
+	int index_attached;
 	unsigned char br_attached;
 	unsigned char br_state;
+	unsigned char mark;
+	unsigned char implicit;
 	struct list_head list;
 };
 
 /* neighbor discovery cache format */
 struct ndlist_entry {
 	unsigned ifindex;
-	char ifname[IFNAMSIZ];
-	char ipaddr[INET6_ADDRSTRLEN+1];
-	char lladdr[INET6_ADDRSTRLEN+1];
+	unsigned char family;
+	unsigned char lladdr_len;
+	unsigned char mark;
+	unsigned char addr[16];
+	unsigned char lladdr[HWADDR_MAX];
+};
+
+/* attributes of an interface address compared to detect a change */
+struct ifalist_attr {
+	unsigned ifa_flags;
+	unsigned short flags;
+	unsigned char scope;
+	unsigned char peer[16];
+	char label[IFNAMSIZ];
+};
+
+/* interface address table entry */
+struct ifalist_entry {
+	unsigned ifindex;
+	unsigned char family;
+	unsigned char prefixlen;
+	unsigned char mark;
+	unsigned char addr[16];
+	struct ifalist_attr attr;
+};
+
+/* nexthop of a route in a routing table mirror */
+struct rib_nexthop {
+	unsigned char gateway[16];
+	int ifindex;
+	unsigned short weight;
+	unsigned short flags;
+};
+
+/* attributes of routes interned and shared across prefixes */
+struct rib_attr {
+	unsigned hash;
+	unsigned refcnt;
+	/* members below are compared to intern attributes */
+	unsigned flags;
+	unsigned nhid;
+	int iifindex;
+	unsigned short nh_num;
+	unsigned char protocol;
+	unsigned char rtn_type;
+	unsigned char src_len;
+	unsigned char src[16];
+	unsigned char prefsrc[16];
+	struct rib_nexthop nh[];
+};
+
+/* route in a node of a routing table mirror */
+struct rib_route {
+	struct rib_route *next;
+	struct rib_attr *attr;
+	unsigned metric;
+	unsigned char tos;
+	unsigned char mark;
+};
+
+/* node of a path-compressed prefix trie(a glue node has no route) */
+struct rib_node {
+	struct rib_node *child[2];
+	struct rib_route *routes;
+	unsigned char plen;
+	unsigned char prefix[];
+};
+
+/* nexthop object(a nexthop or a group of nexthop objects) */
+struct nhlist_entry {
+	unsigned id;
+	unsigned char family;
+	unsigned char protocol;
+	unsigned char blackhole;
+	unsigned char mark;
+	unsigned flags;
+	int ifindex;
+	unsigned char gateway[16];
+	unsigned short grp_num;
+	struct nhlist_grp *grp;
+};
+
+/* member of a nexthop group */
+struct nhlist_grp {
+	unsigned id;
+	unsigned short weight;
+};
+
+/* routing table mirror per address family and table id */
+struct rib_table {
+	unsigned char family;
+	unsigned id;
+	struct rib_node *root;
+	unsigned routes;
 	struct list_head list;
 };
 
+/* class of a structured event */
+#define EVENT_ADDR        1
+#define EVENT_NEIGH       2
+#define EVENT_ROUTE       3
+#define EVENT_TYPE_MAX    4
+
+/* action of a structured event */
+#define EVENT_ADDED       1
+#define EVENT_DELETED     2
+#define EVENT_CHANGED     3
+#define EVENT_INVALIDATED 4
+#define EVENT_UNRESOLVED  5
+
+/* optional fields of a structured event */
+#define EVENT_F_PEER      0x0001
+#define EVENT_F_LABEL     0x0002
+#define EVENT_F_SRC       0x0004
+#define EVENT_F_PREFSRC   0x0008
+#define EVENT_F_GATEWAY   0x0010
+#define EVENT_F_IIF       0x0020
+#define EVENT_F_OIF       0x0040
+#define EVENT_F_METRIC    0x0080
+#define EVENT_F_MULTIPATH 0x0100
+#define EVENT_F_MISSED    0x0200
+#define EVENT_F_NHID      0x0400
+#define EVENT_F_DIFF      0x0800 /* a change is logged as differences */
+
+/* structured event format(formatted only by a sink which needs text) */
+struct event {
+	unsigned char type;
+	unsigned char action;
+	unsigned char family;
+	unsigned char kind;
+	unsigned flags;
+	int ifindex;
+	int iifindex;
+	unsigned char prefixlen;
+	unsigned char src_len;
+	unsigned char scope;
+	unsigned char tos;
+	unsigned char rtn_type;
+	unsigned char protocol;
+	unsigned short nh_num;
+	unsigned table;
+	unsigned metric;
+	unsigned nhid;
+	const struct rib_nexthop *nh; /* nexthops of multipath(valid while emitted) */
+	unsigned char addr[16];
+	unsigned char peer[16];
+	unsigned char src[16];
+	unsigned char prefsrc[16];
+	unsigned char gateway[16];
+	unsigned char lladdr[HWADDR_MAX];
+	unsigned char lladdr_len;
+	char label[IFNAMSIZ];
+};
+
+/* timestamp of a log or debug record */
+struct timestamp {
+	struct timespec real;
+	struct timespec mono;
+};
+
+/* date of a last formatted second */
+struct timestamp_cache {
+	time_t sec;
+	int len;
+	char date[32];
+};
+
+/* name of a flag */
+struct flag_name {
+	unsigned flag;
+	const char *name;
+};
+
+/* names of flags with fragments of them rendered per byte of flags */
+struct flag_table {
+	const struct flag_name *names;
+	int num;
+	const char *sep;
+	unsigned mask;
+	const char *frag[sizeof(unsigned)][256];
+};
+
+#define FLAG_TABLE(table, separator) \
+	{ .names = (table), .num = sizeof(table) / sizeof((table)[0]), .sep = (separator) }
+
+/* name of a number looked up in a table of { text, debug } names */
+#define CONV_NAME(table, num, debug, unknown) \
+	conv_name((table), sizeof(table) / sizeof((table)[0]), (num), (debug), (unknown))
+
+/* flag of a kind of qdisc or filter */
+#define TC_KIND_QDISC  0x0001
+#define TC_KIND_FILTER 0x0002
+#define TC_KIND_F_LOG  0x0004 /* options parser writes a log by itself */
+
+/*
+ * handlers of a kind of qdisc or filter
+ * (qdiscs, filters and actions are not mirrored, so they have no diff handler
+ * until a list of them is kept as interfaces are)
+ */
+struct tc_kind {
+	const char *name;
+	int flags;
+	int (*parse)(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+	void (*debug)(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
+	void (*debug_xstats)(int lev, struct rtattr *tca, const char *name);
+};
+
+/* handlers of a kind of action */
+struct act_kind {
+	const char *name;
+	int (*parse)(char *msg, char *mp, struct rtattr *act);
+	void (*debug)(int lev, struct rtattr *act);
+};
+
+/* handlers of a kind of link */
+struct link_kind {
+	const char *name;
+	int (*parse)(char *msg, char **mp, struct rtattr *info, struct iflist_entry *ifle);
+	void (*debug)(int lev, struct ifinfomsg *ifim, struct rtattr *info);
+	void (*debug_slave)(int lev, struct rtattr *info);
+	void (*diff)(struct iflist_entry *ifle, struct iflist_entry *ifle_tmp);
+};
+
 /* defined in net/if.h but that conflicts with linux/if.h... */
 extern unsigned int if_nametoindex (const char *__ifname);
 extern char *if_indextoname (unsigned int __ifindex, char *__ifname);
@@ -159,6 +423,7 @@ extern char *if_indextoname (unsigned int __ifindex, char *__ifname);
 /* nield.c */
 void close_exit(int sock, int log_flag, int ret);
 int set_options(int argc, char *argv[]);
+int set_rcvbuf_option(char *arg);
 int get_log_opts(void);
 int get_msg_opts(void);
 int set_facility(char *facility_name);
@@ -172,22 +437,99 @@ void sigterm_handler(int sig);
 void sigint_handler(int sig);
 void sigusr1_handler(int sig);
 void sigusr2_handler(int sig);
+void sighup_handler(int sig);
+void snapshot_iflist(void);
+void snapshot_ndlist(void);
 int set_rtnetlink_groups(void);
+int get_rib_family(unsigned groups);
+int get_ifalist_family(unsigned groups);
 int open_netlink_socket(unsigned groups, int proto);
 int send_request(int sock, int type, int family);
-int recv_reply(int sock, int type);
-int recv_events(int sock);
-int parse_events(struct msghdr *mhdr);
+int recv_reply(int sock, int type, int resync);
+int open_event_sockets(unsigned groups);
+void close_event_sockets(void);
+int add_loop_timer(int interval, void (*handler)(void));
+int recv_events(void);
+int resync_lists(int ev_sock, unsigned groups);
+int request_link(int index);
+int parse_events(struct msghdr *mhdr, int len);
+void print_stats(void);
 
 /* log.c */
 int open_log(char *filename);
+void set_log_prefix(const char *prefix);
+void set_log_mute(int mute);
+int get_log_mute(void);
+int start_log_writer(void);
+void stop_log_writer(void);
+void detach_log_writer(void);
+void print_log_stats(FILE *stats);
 char *add_log(char *msg, char *mp, char *format, ...);
+char *add_str(char *msg, char *mp, const char *str);
+char *add_u32(char *msg, char *mp, unsigned num);
+char *add_s32(char *msg, char *mp, int num);
+char *add_hex(char *msg, char *mp, unsigned num, int width);
+char *add_ipv4(char *msg, char *mp, const unsigned char *addr);
+char *add_ipv6(char *msg, char *mp, const unsigned char *addr);
+char *add_inet(char *msg, char *mp, int family, const unsigned char *addr);
+char *add_hwaddr(char *msg, char *mp, unsigned short type,
+	const unsigned char *addr, int len);
+char *add_tc_handle(char *msg, char *mp, unsigned id);
 void rec_log(char *format, ...);
+int reopen_log(char *filename);
 void close_log(void);
 
+/* conv.c */
+const char *conv_name(const char *const table[][2], unsigned size, unsigned num,
+	unsigned char debug, const char *unknown);
+int conv_flags(struct flag_table *ft, unsigned flags, char *list, int len);
+
+/* kind.c */
+const struct tc_kind *find_tc_kind(const char *name, int len);
+const struct act_kind *find_act_kind(const char *name, int len);
+const struct link_kind *find_link_kind(const char *name, int len);
+
+/* timestamp.c */
+void get_timestamp(struct timestamp *ts);
+int format_timestamp(struct timestamp_cache *c, const struct timestamp *ts,
+	char *buf, int size);
+
+/* rcvbuf.c */
+char *get_rcvbuf(int *size);
+void put_rcvbuf(char *buf, int size);
+int recvmsg_exact(int sock, struct msghdr *msg);
+int check_rcvbuf_trunc(struct msghdr *msg, int len);
+void print_rcvbuf_stats(FILE *stats);
+
+/* filter.c */
+int attach_event_filter(int sock);
+void count_filter_discard(void);
+void print_filter_stats(FILE *stats);
+
+/* event.c */
+int add_event_sink(const char *name, void (*write)(const struct event *ev));
+void set_event_flags(unsigned flags);
+void emit_event(struct event *ev);
+const char *conv_event_action(int action);
+int open_event_json(char *filename);
+int reopen_event_json(char *filename);
+void flush_event_json(void);
+void close_event_json(void);
+void print_event_stats(FILE *stats);
+
+/* snapshot.c */
+int fork_snapshot(void (*dump)(void));
+void reap_snapshot(void);
+FILE *open_snapshot(const char *fname, char *tmp, int len);
+int close_snapshot(FILE *fp, const char *tmp, const char *fname);
+void write_snapshot_header(FILE *fp, const char *table, unsigned entries);
+void write_json_str(FILE *fp, const char *str);
+void print_snapshot_stats(FILE *stats);
+
 /* debug.c */
 int open_dbg(char *filename);
 void rec_dbg(int lev, char *format, ...);
+int reopen_dbg(char *filename);
 void close_dbg(void);
 
 /* nlmsg.c */
@@ -222,21 +564,39 @@ void debug_rta_str(int lev, struct rtattr *rta, const char *name, char *str, uns
 void debug_rta_ifindex(int lev, struct rtattr *rta, const char *name);
 void debug_rta_arphrd(int lev, struct rtattr *rta, const char *name, unsigned short type);
 int arphrd_ntop(unsigned short type, struct rtattr *ifla, char *addr, int addrlen);
+int hwaddr_ntop(unsigned short type, const unsigned char *src, int srclen,
+	char *dst, int dstlen);
 void debug_rta_af(int lev, struct rtattr *rta, const char *name, unsigned short family);
 int inet_ntop_ifa(int family, struct rtattr *ifa, char *saddr, int slen);
+int get_rta_addr(int family, struct rtattr *rta, unsigned char *addr);
 void debug_rta_tc_addr(int lev, struct tcmsg *tcm, struct rtattr *rta, const char *name);
 int inet_ntop_tc_addr(struct tcmsg *tcm, struct rtattr *tca, char *addrstr, int addrstrlen);
 void debug_tca_classid(int lev, struct rtattr *tca, const char *name);
 void parse_tc_handle(char *p, int len, unsigned id);
 
+/* ntop.c */
+int ntop_ipv4(const unsigned char *src, char *dst);
+int ntop_ipv6(const unsigned char *src, char *dst);
+int ntop_hwaddr(const unsigned char *src, int len, char *dst);
+
 /* ifimsg.c */
-int create_iflist(struct msghdr *msg);
+int create_iflist(struct msghdr *msg, int len);
+int resync_iflist(struct msghdr *msg, int len);
+void sweep_iflist(void);
+unsigned char get_kind_id(const char *kind);
+const char *conv_kind_id(unsigned char id);
 char *if_indextoname_from_lists(int index, char *name);
 char *if_indextoname_from_iflist(int index, char *name);
+int if_nametoindex_from_iflist(const char *name);
+void detach_iflist_requests(void);
+int learn_iflist(struct nlmsghdr *nlh);
 char *if_indextoname_from_ifhist(int index, char *name);
 unsigned short get_type_from_iflist(int index);
+unsigned char get_kind_from_iflist(int index);
 unsigned short get_type_from_ifhist(int index);
 void print_iflist(int num);
+void dump_iflist(int num);
+void print_iflist_stats(FILE *stats);
 int parse_ifimsg(struct nlmsghdr *nlh);
 void parse_rtm_newlink(char *msg, struct iflist_entry *ifle, struct iflist_entry *ifle_tmp,
 	struct rtattr *ifla[]);
@@ -302,7 +662,8 @@ int parse_ifla_vlan_egress_qos(char *msg, char **mp, struct rtattr *vlan, struct
 int parse_ifla_vlan_ingress_qos(char *msg, char **mp, struct rtattr *vlan, struct iflist_entry *ifle);
 int parse_vlan_qos_mapping(char *msg, char **mp, struct rtattr *qos, struct iflist_entry *ifle);
 int parse_ifla_vlan_protocol(char *msg, char **mp, struct rtattr *vlan, struct iflist_entry *ifle);
-void debug_ifla_vlan(int lev, struct rtattr *info);
+void diff_ifla_vlan(struct iflist_entry *ifle, struct iflist_entry *ifle_tmp);
+void debug_ifla_vlan(int lev, struct ifinfomsg *ifim, struct rtattr *info);
 void debug_ifla_vlan_flags(int lev, struct rtattr *vlan, const char *name);
 void debug_ifla_vlan_qos(int lev, struct rtattr *vlan, const char *name);
 const char *conv_vlan_flags(int flags, unsigned char debug);
@@ -313,7 +674,7 @@ const char *conv_vlan_flags(int flags, unsigned char debug);
 int parse_ifla_macvlan(char *msg, char **mp, struct rtattr *info, struct iflist_entry *ifle);
 int parse_ifla_macvlan_mode(char *msg, char **mp, struct rtattr *macvlan,
     struct iflist_entry *ifle);
-void debug_ifla_macvlan(int lev, struct rtattr *info);
+void debug_ifla_macvlan(int lev, struct ifinfomsg *ifim, struct rtattr *info);
 const char *conv_macvlan_mode(unsigned mode, unsigned char debug);
 #endif
 
@@ -328,7 +689,7 @@ int parse_ifla_vxlan_group(char *msg, char **mp, struct rtattr *vxlan, struct if
 #if HAVE_DECL_IFLA_VXLAN_PORT
 int parse_ifla_vxlan_port(char *msg, char **mp, struct rtattr *vxlan, struct iflist_entry *ifle);
 #endif
-void debug_ifla_vxlan(int lev, struct rtattr *info);
+void debug_ifla_vxlan(int lev, struct ifinfomsg *ifim, struct rtattr *info);
 void debug_ifla_vxlan_port_range(int lev, struct rtattr *vxlan, const char *name);
 #endif
 
@@ -339,7 +700,7 @@ int parse_ifla_bond_mode(char *msg, char **mp, struct rtattr *bond, struct iflis
 #if HAVE_DECL_IFLA_BOND_MIIMON
 int parse_ifla_bond_xmit_hash_policy(char *msg, char **mp, struct rtattr *bond, struct iflist_entry *ifle);
 #endif
-void debug_ifla_bond(int lev, struct rtattr *info);
+void debug_ifla_bond(int lev, struct ifinfomsg *ifim, struct rtattr *info);
 #if HAVE_DECL_IFLA_BOND_MIIMON
 void debug_ifla_bond_arp_ip_target(int lev, struct rtattr *bond, const char *name);
 void debug_ifla_bond_ad_info(int lev, struct rtattr *bond, const char *name);
@@ -354,18 +715,28 @@ const char *conv_bond_link(unsigned char state, unsigned char debug);
 #endif
 
 /* ifamsg.c */
+int create_ifalist(struct msghdr *msg, int len);
+int resync_ifalist(struct msghdr *msg, int len);
+void sweep_ifalist(void);
+void print_ifalist_stats(FILE *stats);
 int parse_ifamsg(struct nlmsghdr *nlh);
+int format_ifa_event(const struct event *ev, char *msg);
 void debug_ifamsg(int lev, struct ifaddrmsg *ifam, struct rtattr *ifa[], int ifam_len);
 void debug_ifa_cacheinfo(int lev, struct rtattr *ifa, const char *name);
 void conv_ifa_flags(int flags, char *flags_list, int len);
 const char *conv_ifa_scope(int scope, unsigned char debug);
 
 /* ndmsg.c */
-int create_ndlist(struct msghdr *msg);
+int create_ndlist(struct msghdr *msg, int len);
+int resync_ndlist(struct msghdr *msg, int len);
+void sweep_ndlist(void);
 void print_ndlist(void);
+void dump_ndlist(void);
+void print_ndlist_stats(FILE *stats);
 int parse_ndmsg(struct nlmsghdr *nlh);
-int parse_rtm_newneigh(char *ndm_type, struct ndmsg *ndm, struct ndlist_entry *ndle_tmp);
-int parse_rtm_delneigh(char *ndm_type, struct ndmsg *ndm, struct ndlist_entry *ndle_tmp);
+int parse_rtm_newneigh(struct ndmsg *ndm, struct ndlist_entry *ndle_tmp);
+int parse_rtm_delneigh(struct ndmsg *ndm, struct ndlist_entry *ndle_tmp);
+int format_nd_event(const struct event *ev, char *msg);
 void debug_ndmsg(int lev, struct ndmsg *ndm, struct rtattr *nda[], int ndm_len);
 void debug_nda_cacheinfo(int lev, struct rtattr *nda, const char *name);
 const char *conv_nud_state(int state, unsigned char debug);
@@ -373,6 +744,7 @@ const char *conv_ntf_flags(int flags, unsigned char debug);
 
 /* rtmsg.c */
 int parse_rtmsg(struct nlmsghdr *nlh);
+int format_rt_event(const struct event *ev, char *msg);
 void debug_rtmsg(int lev, struct rtmsg *rtm, struct rtattr *rta[], int rtm_len);
 void debug_rta_metrics(int lev, struct rtattr *rta, const char *name);
 void debug_rta_multipath(int lev, struct rtmsg *rtm, struct rtattr *rta, const char *name);
@@ -384,6 +756,45 @@ const char *conv_rtn_type(int type, unsigned char debug);
 void conv_rtm_flags(int flags, char *flags_list, int len);
 void conv_rtnh_flags(int flags, char *flags_list, int len);
 
+/* rib.c */
+int update_rib(struct event *ev, struct rib_nexthop *nh, int nh_num, int nlmsg_flags);
+int create_rib(struct msghdr *msg, int len);
+int resync_rib(struct msghdr *msg, int len);
+void sweep_rib(void);
+unsigned flush_rib_nexthop(unsigned nhid);
+unsigned flush_rib_ifindex(int ifindex);
+unsigned flush_rib_prefsrc(const unsigned char *prefsrc);
+void unmirror_rib(const struct event *ev);
+const struct rib_attr *lookup_rib(int family, unsigned table, const unsigned char *addr);
+void print_rib_stats(FILE *stats);
+
+/* nhmsg.c */
+#ifdef HAVE_LINUX_NEXTHOP_H
+int parse_nhmsg(struct nlmsghdr *nlh);
+int create_nhlist(struct msghdr *msg, int len);
+int resync_nhlist(struct msghdr *msg, int len);
+void sweep_nhlist(void);
+unsigned flush_nhlist_ifindex(int ifindex);
+void resolve_nhlist(struct event *ev);
+void print_nhlist_stats(FILE *stats);
+void debug_nhmsg(int lev, struct nhmsg *nhm, struct rtattr *nha[], int nhm_len);
+void debug_nha_group(int lev, struct rtattr *nha, const char *name);
+#endif
+
+/* summary.c */
+int set_summary_option(char *arg);
+int start_summary(void);
+int summarize_event(const struct event *ev);
+void flush_summary(void);
+void print_summary_stats(FILE *stats);
+
+/* flap.c */
+int set_flap_option(char *arg);
+int start_flap(void);
+void count_flap(const struct event *ev);
+void log_flap(void);
+void print_flap_stats(FILE *stats);
+
 /* frhdr.c */
 #ifdef HAVE_LINUX_FIB_RULES_H
 int parse_frhdr(struct nlmsghdr *nlh);
@@ -418,49 +829,49 @@ void debug_tca_stab_base(int lev, struct rtattr *stab, const char *name);
 void debug_tc_ratespec(int lev, struct tc_ratespec *rate, char *name);
 
 /* tcmsg_qdisc_prio.c */
-int parse_tca_options_prio(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_prio(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_prio(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_prio(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 
 /* tcmsg_qdisc_fifo.c */
-int parse_tca_options_pfifo(char *msg, char **mp, struct rtattr *tca);
-int parse_tca_options_bfifo(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_fifo(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_pfifo(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+int parse_tca_options_bfifo(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_fifo(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 
 /* tcmsg_qdisc_multiq.c */
 #ifdef HAVE_STRUCT_TC_MULTIQ_QOPT_BANDS
-int parse_tca_options_multiq(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_multiq(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_multiq(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_multiq(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 #endif
 
 /* tcmsg_qdisc_plug.c */
 #ifdef HAVE_STRUCT_TC_PLUG_QOPT_ACTION
-int parse_tca_options_plug(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_plug(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_plug(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_plug(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 const char *conv_tcq_plug_action(int action);
 #endif
 
 /* tcmsg_qdisc_tbf.c */
-int parse_tca_options_tbf(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_tbf(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_tbf(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_tbf(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_tbf_parms(int lev, struct rtattr *tbf, const char *name);
 
 /* tcmsg_qdisc_sfq.c */
-int parse_tca_options_sfq(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_sfq(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_sfq(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_sfq(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 #ifdef HAVE_STRUCT_TC_SFQ_XSTATS_ALLOT
 void debug_tc_sfq_xstats(int lev, struct rtattr *tca, const char *name);
 #endif
 
 /* tcmsg_qdisc_red.c */
-int parse_tca_options_red(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_red(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_red(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_red(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_red_parms(int lev, struct rtattr *red, const char *name);
 void debug_tc_red_xstats(int lev, struct rtattr *tca, const char *name);
 void conv_tc_red_flags(int flags, char *flags_list, int len, unsigned char debug);
 
 /* tcmsg_qdisc_gred.c */
-int parse_tca_options_gred(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_gred(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_gred(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_gred(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_gred_parms(int lev, struct rtattr *gred, const char *name);
 void debug_tca_gred_dps(int lev, struct rtattr *gred, const char *name);
 #if HAVE_DECL_TCA_GRED_MAX_P
@@ -469,29 +880,29 @@ void debug_tca_gred_max_p(int lev, struct rtattr *gred, const char *name);
 
 /* tcmsg_qdisc_choke.c */
 #if HAVE_DECL_TCA_CHOKE_UNSPEC
-int parse_tca_options_choke(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_choke(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_choke(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_choke(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_choke_parms(int lev, struct rtattr *choke, const char *name);
 void debug_tc_choke_xstats(int lev, struct rtattr *tca, const char *name);
 #endif
 
 /* tcmsg_qdisc_htb.c */
-int parse_tca_options_htb(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_htb(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_htb(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_htb(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_htb_parms(int lev, struct rtattr *htb, const char *name);
 void debug_tca_htb_init(int lev, struct rtattr *htb, const char *name);
 void debug_tc_htb_xstats(int lev, struct rtattr *tca, const char *name);
 
 /* tcmsg_qdisc_hfsc.c */
-int parse_tca_options_hfsc(char *msg, char **mp, struct rtattr *tca);
+int parse_tca_options_hfsc(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
 int print_hfsc_sc(char *msg, char **mp, char *name, struct tc_service_curve *sc);
-void debug_tca_options_hfsc(int lev, struct rtattr *tca, const char *name);
+void debug_tca_options_hfsc(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_hfsc_sc(int lev, struct rtattr *hfsc, const char *name);
 
 /* tcmsg_qdisc_cbq.c */
 #if HAVE_DECL_TCA_CBQ_UNSPEC
-int parse_tca_options_cbq(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_cbq(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_cbq(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_cbq(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_cbq_lssopt(int lev, struct rtattr *cbq, const char *name);
 void debug_tca_cbq_wrropt(int lev, struct rtattr *cbq, const char *name);
 void debug_tca_cbq_fopt(int lev, struct rtattr *cbq, const char *name);
@@ -506,13 +917,13 @@ void conv_tc_cbq_ovl_strategy(int strategy, char *strategy_list, int len);
 
 /* tcmsg_qdisc_dsmark.c */
 #if HAVE_DECL_TCA_DSMARK_UNSPEC
-int parse_tca_options_dsmark(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_dsmark(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_dsmark(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_dsmark(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 #endif
 
 /* tcmsg_qdisc_netem.c */
-int parse_tca_options_netem(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_netem(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_netem(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_netem(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_netem_corr(int lev, struct rtattr *netem, const char *name);
 void debug_tca_netem_reorder(int lev, struct rtattr *netem, const char *name);
 void debug_tca_netem_corrupt(int lev, struct rtattr *netem, const char *name);
@@ -527,37 +938,37 @@ void debug_tca_netem_rate(int lev, struct rtattr *netem, const char *name);
 
 /* tcmsg_qdisc_drr.c */
 #if HAVE_DECL_TCA_DRR_UNSPEC
-int parse_tca_options_drr(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_drr(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_drr(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_drr(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tc_drr_xstats(int lev, struct rtattr *tca, const char *name);
 #endif
 
 /* tcmsg_qdisc_sfb.c */
 #if HAVE_DECL_TCA_SFB_UNSPEC
-int parse_tca_options_sfb(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_sfb(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_sfb(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_sfb(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_sfb_parms(int lev, struct rtattr *sfb, const char *name);
 void debug_tc_sfb_xstats(int lev, struct rtattr *tca, const char *name);
 #endif
 
 /* tcmsg_qdisc_qfq.c */
 #if HAVE_DECL_TCA_QFQ_UNSPEC
-int parse_tca_options_qfq(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_qfq(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_qfq(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_qfq(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tc_qfq_xstats(int lev, struct rtattr *tca, const char *name);
 #endif
 
 /* tcmsg_qdisc_codel.c */
 #if HAVE_DECL_TCA_CODEL_UNSPEC
-int parse_tca_options_codel(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_codel(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_codel(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_codel(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tc_codel_xstats(int lev, struct rtattr *tca, const char *name);
 #endif
 
 /* tcmsg_qdisc_fq_codel.c */
 #if HAVE_DECL_TCA_FQ_CODEL_UNSPEC
-int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_fq_codel(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_fq_codel(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_fq_codel(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tc_fq_codel_xstats(int lev, struct rtattr *tca, const char *name);
 #endif
 
@@ -610,13 +1021,13 @@ const char *conv_tcf_meta_id(int id, unsigned char debug);
 #endif
 
 /* tcmsg_filter_u32.c */
-int parse_tca_options_u32(char *msg, char **mp, struct rtattr *tca);
+int parse_tca_options_u32(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
 int parse_tca_u32_hash(char *msg, char **mp, struct rtattr *u32);
 int parse_tca_u32_link(char *msg, char **mp, struct rtattr *u32);
 int parse_tca_u32_divisor(char *msg, char **mp, struct rtattr *u32);
 int parse_tca_u32_mark(char *msg, char **mp, struct rtattr *u32);
 int parse_tca_u32_sel(char *msg, char *mp, struct rtattr *u32);
-void debug_tca_options_u32(int lev, struct rtattr *tca, const char *name);
+void debug_tca_options_u32(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 void debug_tca_u32_link(int lev, struct rtattr *u32, const char *name);
 void debug_tca_u32_sel(int lev, struct rtattr *u32, const char *name);
 void debug_tca_u32_pcnt(int lev, struct rtattr *u32[], const char *name);
@@ -632,27 +1043,27 @@ void debug_tca_options_rsvp(int lev, struct tcmsg *tcm, struct rtattr *tca, cons
 void debug_tca_rsvp_pinfo(int lev, struct rtattr *rsvp, const char *name);
 
 /* tcmsg_filter_route.c */
-int parse_tca_options_route(char *msg, char **mp, struct rtattr *tca);
+int parse_tca_options_route(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
 int parse_tca_route4_from(char *msg, char **mp, struct rtattr *route);
 int parse_tca_route4_to(char *msg, char **mp, struct rtattr *route);
 int parse_tca_route4_iif(char *msg, char **mp, struct rtattr *route);
-void debug_tca_options_route(int lev, struct rtattr *tca, const char *name);
+void debug_tca_options_route(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 
 /* tcmsg_filter_fw.c */
-int parse_tca_options_fw(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_fw(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_fw(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_fw(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 
 /* tcmsg_filter_tcindex.c */
-int parse_tca_options_tcindex(char *msg, char **mp, struct rtattr *tca);
+int parse_tca_options_tcindex(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
 int parse_tca_tcindex_hash(char *msg, char **mp, struct rtattr *tcindex);
 int parse_tca_tcindex_mask(char *msg, char **mp, struct rtattr *tcindex);
 int parse_tca_tcindex_shift(char *msg, char **mp, struct rtattr *tcindex);
 int parse_tca_tcindex_fall_through(char *msg, char **mp, struct rtattr *tcindex);
-void debug_tca_options_tcindex(int lev, struct rtattr *tca, const char *name);
+void debug_tca_options_tcindex(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 
 /* tcmsg_filter_flow.c */
 #if HAVE_DECL_TCA_FLOW_UNSPEC
-int parse_tca_options_flow(char *msg, char **mp, struct rtattr *tca);
+int parse_tca_options_flow(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
 int parse_tca_flow_keys(char *msg, char **mp, struct rtattr *flow);
 int parse_tca_flow_mode(char *msg, char **mp, struct rtattr *flow);
 int parse_tca_flow_xor(char *msg, char **mp, struct rtattr *flow);
@@ -660,19 +1071,19 @@ int parse_tca_flow_rshift(char *msg, char **mp, struct rtattr *flow);
 int parse_tca_flow_addend(char *msg, char **mp, struct rtattr *flow);
 int parse_tca_flow_divisor(char *msg, char **mp, struct rtattr *flow);
 int parse_tca_flow_perturb(char *msg, char **mp, struct rtattr *flow);
-void debug_tca_options_flow(int lev, struct rtattr *tca, const char *name);
+void debug_tca_options_flow(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 const char *conv_flow_key(unsigned flags, unsigned char debug);
 const char *conv_flow_mode(unsigned mode, unsigned char debug);
 #endif
 
 /* tcmsg_filter_basic.c */
-int parse_tca_options_basic(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_basic(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_basic(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_basic(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 
 /* tcmsg_filter_cgroup.c */
 #if HAVE_DECL_TCA_CGROUP_UNSPEC
-int parse_tca_options_cgroup(char *msg, char **mp, struct rtattr *tca);
-void debug_tca_options_cgroup(int lev, struct rtattr *tca, const char *name);
+int parse_tca_options_cgroup(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca);
+void debug_tca_options_cgroup(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name);
 #endif
 
 /* tcamsg.c */
@@ -89,6 +89,11 @@ const char *debug_n2s_nlmsg_type(int type)
     _NLMSG_TYPE(NEWADDRLABEL);
     _NLMSG_TYPE(DELADDRLABEL);
     _NLMSG_TYPE(GETADDRLABEL);
+#ifdef HAVE_LINUX_NEXTHOP_H
+    _NLMSG_TYPE(NEWNEXTHOP);
+    _NLMSG_TYPE(DELNEXTHOP);
+    _NLMSG_TYPE(GETNEXTHOP);
+#endif
 #ifdef RTM_GETDCB
     _NLMSG_TYPE(GETDCB);
 #endif
@@ -0,0 +1,168 @@
+/*
+ * ntop.c - address formatters without libc
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/* lowercase hexadecimal digits */
+static const char hex_digits[] = "0123456789abcdef";
+
+/* pairs of decimal digits from 00 to 99 */
+static const char dec_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/*
+ * write an octet in decimal without leading zeros
+ */
+static inline char *put_octet(char *p, unsigned v)
+{
+    const char *d;
+
+    if(v >= 100) {
+        *p++ = (v >= 200) ? '2' : '1';
+        v %= 100;
+        d = dec_pairs + v * 2;
+        *p++ = d[0];
+        *p++ = d[1];
+    } else if(v >= 10) {
+        d = dec_pairs + v * 2;
+        *p++ = d[0];
+        *p++ = d[1];
+    } else
+        *p++ = '0' + v;
+
+    return(p);
+}
+
+/*
+ * write a 16-bit word in hexadecimal without leading zeros
+ */
+static inline char *put_word(char *p, unsigned w)
+{
+    if(w >= 0x1000)
+        *p++ = hex_digits[w >> 12];
+    if(w >= 0x100)
+        *p++ = hex_digits[(w >> 8) & 0xf];
+    if(w >= 0x10)
+        *p++ = hex_digits[(w >> 4) & 0xf];
+    *p++ = hex_digits[w & 0xf];
+
+    return(p);
+}
+
+/*
+ * convert an IPv4 address to dotted decimal(dst needs INET_ADDRSTRLEN)
+ */
+int ntop_ipv4(const unsigned char *src, char *dst)
+{
+    char *p = dst;
+
+    p = put_octet(p, src[0]);
+    *p++ = '.';
+    p = put_octet(p, src[1]);
+    *p++ = '.';
+    p = put_octet(p, src[2]);
+    *p++ = '.';
+    p = put_octet(p, src[3]);
+    *p = '\0';
+
+    return(p - dst);
+}
+
+/*
+ * convert an IPv6 address to text as glibc does(dst needs INET6_ADDRSTRLEN)
+ */
+int ntop_ipv6(const unsigned char *src, char *dst)
+{
+    unsigned words[8];
+    int i, base = -1, len = 0, cur = -1, cur_len = 0;
+    char *p = dst;
+
+    /* find a first longest run of zero words */
+    for(i = 0; i < 8; i++) {
+        words[i] = (src[i * 2] << 8) | src[i * 2 + 1];
+        if(!words[i]) {
+            if(cur < 0)
+                cur = i;
+            if(++cur_len > len) {
+                base = cur;
+                len = cur_len;
+            }
+        } else {
+            cur = -1;
+            cur_len = 0;
+        }
+    }
+
+    /* a single zero word is not compressed */
+    if(len < 2)
+        base = -1;
+
+    for(i = 0; i < 8; i++) {
+        if(i == base) {
+            *p++ = ':';
+            i += len - 1;
+            if(i == 7)
+                *p++ = ':';
+            continue;
+        }
+        if(i)
+            *p++ = ':';
+
+        /* IPv4 compatible or mapped address */
+        if(i == 6 && base == 0 &&
+            (len == 6 || (len == 5 && words[5] == 0xffff))) {
+            p += ntop_ipv4(src + 12, p);
+            return(p - dst);
+        }
+        p = put_word(p, words[i]);
+    }
+    *p = '\0';
+
+    return(p - dst);
+}
+
+/*
+ * convert a hardware address to colon separated hexadecimal(dst needs len * 3)
+ */
+int ntop_hwaddr(const unsigned char *src, int len, char *dst)
+{
+    char *p = dst;
+    int i;
+
+    for(i = 0; i < len; i++) {
+        *p++ = hex_digits[src[i] >> 4];
+        *p++ = hex_digits[src[i] & 0xf];
+        *p++ = ':';
+    }
+
+    /* replace a last separator with a terminator */
+    if(len)
+        p--;
+    *p = '\0';
+
+    return(p - dst);
+}
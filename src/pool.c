@@ -0,0 +1,100 @@
+/*
+ * pool.c - object pool utility
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/*
+ * carve a new slab into free objects
+ */
+static int pool_grow(struct pool *p)
+{
+    char *slab;
+    int i, num = POOL_SLAB_SIZE / p->size;
+
+    slab = malloc(POOL_SLAB_SIZE);
+    if(!slab) {
+        rec_log("error: %s: malloc() failed", __func__);
+        return(-1);
+    }
+    p->slabs++;
+
+    /* objects are handed out in address order */
+    for(i = num - 1; i >= 0; i--) {
+        struct pool_obj *obj = (struct pool_obj *)(slab + i * p->size);
+
+        obj->next = p->free;
+        p->free = obj;
+    }
+
+    return(0);
+}
+
+/*
+ * allocate a zeroed object from a pool
+ */
+void *pool_alloc(struct pool *p)
+{
+    struct pool_obj *obj;
+
+    if(!p->free && pool_grow(p) < 0)
+        return(NULL);
+
+    obj = p->free;
+    p->free = obj->next;
+    memset(obj, 0, p->size);
+
+    p->allocs++;
+    if(++p->used > p->high_water)
+        p->high_water = p->used;
+
+    return(obj);
+}
+
+/*
+ * return an object to a pool
+ */
+void pool_free(struct pool *p, void *obj)
+{
+    struct pool_obj *o = obj;
+
+    if(!obj)
+        return;
+
+    o->next = p->free;
+    p->free = o;
+    p->used--;
+}
+
+/*
+ * print statistics of a pool
+ */
+void print_pool_stats(FILE *stats, struct pool *p)
+{
+    unsigned num = POOL_SLAB_SIZE / p->size;
+
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ %s pool statistics ]\n", p->name);
+    fprintf(stats, "object size: %lu byte\n", (unsigned long)p->size);
+    fprintf(stats, "slabs: %u\n", p->slabs);
+    fprintf(stats, "memory: %lu byte\n", (unsigned long)p->slabs * POOL_SLAB_SIZE);
+    fprintf(stats, "objects in use: %u\n", p->used);
+    fprintf(stats, "objects free: %u\n", p->slabs * num - p->used);
+    fprintf(stats, "high water mark: %u\n", p->high_water);
+    fprintf(stats, "allocations: %llu\n", p->allocs);
+}
@@ -0,0 +1,62 @@
+/*
+ * pool.h - object pool utility
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#ifndef _POOL_H__
+#define _POOL_H__
+
+#include <stdio.h> /* FILE */
+#include <stddef.h> /* size_t */
+
+/* size of a slab carved into objects */
+#define POOL_SLAB_SIZE 65536
+
+/* a free object in a pool */
+struct pool_obj {
+    struct pool_obj *next;
+};
+
+/* a pool of fixed-size objects */
+struct pool {
+    const char *name;
+    size_t size;
+    struct pool_obj *free;
+    /* statistics */
+    unsigned slabs;
+    unsigned used;
+    unsigned high_water;
+    unsigned long long allocs;
+};
+
+/*
+ * initialize a pool of objects of a size
+ */
+#define POOL_INIT_SIZE(name, size) \
+    { name, ((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1), \
+      NULL, 0, 0, 0, 0 }
+
+/*
+ * initialize a pool of a type
+ */
+#define POOL_INIT(name, type) POOL_INIT_SIZE(name, sizeof(type))
+
+/* pool.c */
+void *pool_alloc(struct pool *p);
+void pool_free(struct pool *p, void *obj);
+void print_pool_stats(FILE *stats, struct pool *p);
+
+#endif
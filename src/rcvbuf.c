@@ -0,0 +1,188 @@
+/*
+ * rcvbuf.c - receive buffer manager
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/* size classes of pooled receive buffers(page << class) */
+#define RCVBUF_CLASS_MAX 8
+
+/* free list of pooled buffers */
+struct rcvbuf_free {
+    struct rcvbuf_free *next;
+};
+
+static struct rcvbuf_free *pool[RCVBUF_CLASS_MAX+1];
+static int page_size;
+
+/* receive buffer statistics */
+static struct {
+    unsigned long long allocated;
+    unsigned long long reused;
+    unsigned long long peeked;
+    unsigned long long grown;
+    unsigned long long oversize;
+    unsigned long long truncated;
+    unsigned max_len;
+} rcvbuf_stats;
+
+/*
+ * get a size class of a receive buffer(-1 if it is too large to be pooled)
+ */
+static inline int get_rcvbuf_class(int size)
+{
+    int class = 0;
+
+    if(!page_size)
+        page_size = sysconf(_SC_PAGESIZE);
+
+    while((page_size << class) < size) {
+        if(++class > RCVBUF_CLASS_MAX)
+            return(-1);
+    }
+
+    return(class);
+}
+
+/*
+ * get a page-aligned receive buffer from a pool
+ */
+char *get_rcvbuf(int *size)
+{
+    struct rcvbuf_free *f;
+    int class = get_rcvbuf_class(*size);
+    void *buf;
+
+    /* allocate a buffer larger than any class directly */
+    if(class < 0) {
+        *size = (*size + page_size - 1) & ~(page_size - 1);
+        if(posix_memalign(&buf, page_size, *size)) {
+            rec_log("error: %s: posix_memalign() failed", __func__);
+            return(NULL);
+        }
+        rcvbuf_stats.oversize++;
+        return((char *)buf);
+    }
+    *size = page_size << class;
+
+    /* reuse a pooled buffer */
+    if(pool[class]) {
+        f = pool[class];
+        pool[class] = f->next;
+        rcvbuf_stats.reused++;
+        return((char *)f);
+    }
+
+    if(posix_memalign(&buf, page_size, *size)) {
+        rec_log("error: %s: posix_memalign() failed", __func__);
+        return(NULL);
+    }
+    rcvbuf_stats.allocated++;
+
+    return((char *)buf);
+}
+
+/*
+ * put a receive buffer back to a pool
+ */
+void put_rcvbuf(char *buf, int size)
+{
+    struct rcvbuf_free *f = (struct rcvbuf_free *)buf;
+    int class;
+
+    if(!buf)
+        return;
+
+    /* a buffer larger than any class is not pooled */
+    class = get_rcvbuf_class(size);
+    if(class < 0) {
+        free(buf);
+        return;
+    }
+    f->next = pool[class];
+    pool[class] = f;
+}
+
+/*
+ * receive a message sized by MSG_PEEK|MSG_TRUNC, and grow a buffer if needed
+ */
+int recvmsg_exact(int sock, struct msghdr *msg)
+{
+    struct iovec *iov = msg->msg_iov;
+    char *buf;
+    int len, size;
+
+    /* get a length of a next datagram */
+    len = recvmsg(sock, msg, MSG_PEEK | MSG_TRUNC);
+    if(len <= 0)
+        return(len);
+    rcvbuf_stats.peeked++;
+
+    if(len > iov->iov_len) {
+        size = len;
+        buf = get_rcvbuf(&size);
+        if(!buf) {
+            errno = ENOMEM;
+            return(-1);
+        }
+        put_rcvbuf(iov->iov_base, iov->iov_len);
+        iov->iov_base = buf;
+        iov->iov_len = size;
+        rcvbuf_stats.grown++;
+    }
+
+    len = recvmsg(sock, msg, 0);
+    if(len > 0)
+        check_rcvbuf_trunc(msg, len);
+
+    return(len);
+}
+
+/*
+ * check whether a received message was truncated or not
+ */
+int check_rcvbuf_trunc(struct msghdr *msg, int len)
+{
+    if(len > rcvbuf_stats.max_len)
+        rcvbuf_stats.max_len = len;
+
+    if(!(msg->msg_flags & MSG_TRUNC))
+        return(0);
+
+    rcvbuf_stats.truncated++;
+    rec_log("error: %s: message truncated(%d byte received into %d byte buffer)",
+        __func__, len, (int)msg->msg_iov->iov_len);
+
+    return(1);
+}
+
+/*
+ * print receive buffer statistics
+ */
+void print_rcvbuf_stats(FILE *stats)
+{
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ receive buffer statistics ]\n");
+    fprintf(stats, "buffers allocated: %llu\n", rcvbuf_stats.allocated);
+    fprintf(stats, "buffers reused: %llu\n", rcvbuf_stats.reused);
+    fprintf(stats, "buffers grown: %llu\n", rcvbuf_stats.grown);
+    fprintf(stats, "oversize buffers allocated: %llu\n", rcvbuf_stats.oversize);
+    fprintf(stats, "datagrams peeked: %llu\n", rcvbuf_stats.peeked);
+    fprintf(stats, "datagrams truncated: %llu\n", rcvbuf_stats.truncated);
+    fprintf(stats, "max datagram size: %u\n", rcvbuf_stats.max_len);
+}
@@ -0,0 +1,1112 @@
+/*
+ * rib.c - routing table mirror in a path-compressed prefix trie
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/* offset of members of attributes compared to intern them */
+#define RIB_ATTR_KEY offsetof(struct rib_attr, flags)
+
+/* size of attributes with nexthops */
+#define RIB_ATTR_SIZE(nh_num) \
+    (sizeof(struct rib_attr) + (nh_num) * sizeof(struct rib_nexthop))
+
+/* top of routing tables */
+static struct list_head thead = {&thead, &thead};
+
+/* pools of trie nodes per address length and of routes */
+static struct pool node4_pool =
+    POOL_INIT_SIZE("ipv4 route node", offsetof(struct rib_node, prefix) + 4);
+static struct pool node6_pool =
+    POOL_INIT_SIZE("ipv6 route node", offsetof(struct rib_node, prefix) + 16);
+static struct pool route_pool = POOL_INIT("route", struct rib_route);
+
+/* buffers of attributes being interned or merged */
+static unsigned attr_buf[2][RIB_ATTR_SIZE(RIB_NEXTHOP_MAX) / sizeof(unsigned)];
+
+/* whether a routing table mirror is being seeded or resynchronized */
+static int seeding;
+static int resyncing;
+
+/* routing table mirror statistics */
+static struct {
+    unsigned long long added;
+    unsigned long long changed;
+    unsigned long long unchanged;
+    unsigned long long deleted;
+    unsigned long long unknown;
+    unsigned long long stale;
+    unsigned long long flushed;
+    unsigned long long unmirrored;
+    unsigned attrs;
+    unsigned long attr_mem;
+} rib_stats;
+
+/*
+ * match interned attributes with key attributes
+ */
+static int match_rib_attr(const void *entry, const void *key)
+{
+    const struct rib_attr *a = entry, *k = key;
+
+    return(a->nh_num == k->nh_num &&
+        !memcmp((const char *)a + RIB_ATTR_KEY, (const char *)k + RIB_ATTR_KEY,
+            RIB_ATTR_SIZE(a->nh_num) - RIB_ATTR_KEY));
+}
+
+/* index of interned attributes */
+static struct hash_table attr_hash = HASH_TABLE_INIT(match_rib_attr);
+
+/*
+ * get a length of an address in a family
+ */
+static inline int rib_addr_len(int family)
+{
+    return((family == AF_INET6) ? 16 : 4);
+}
+
+/*
+ * get a pool of trie nodes in a family
+ */
+static inline struct pool *rib_node_pool(int family)
+{
+    return((family == AF_INET6) ? &node6_pool : &node4_pool);
+}
+
+/*
+ * get a bit of a prefix
+ */
+static inline int prefix_bit(const unsigned char *prefix, int i)
+{
+    return((prefix[i >> 3] >> (7 - (i & 7))) & 1);
+}
+
+/*
+ * get a length of a common part of two prefixes up to a length
+ */
+static inline int prefix_common(const unsigned char *a, const unsigned char *b, int len)
+{
+    int i = 0;
+    unsigned char x;
+
+    while(i + 8 <= len && a[i >> 3] == b[i >> 3])
+        i += 8;
+    if(i >= len)
+        return(len);
+
+    x = a[i >> 3] ^ b[i >> 3];
+    while(i < len && !(x & (0x80 >> (i & 7))))
+        i++;
+
+    return(i);
+}
+
+/*
+ * intern attributes(a reference is taken)
+ */
+static struct rib_attr *intern_rib_attr(struct rib_attr *key)
+{
+    struct rib_attr *a;
+    size_t size = RIB_ATTR_SIZE(key->nh_num);
+
+    key->hash = hash_bytes((char *)key + RIB_ATTR_KEY, size - RIB_ATTR_KEY, 0);
+    a = hash_search(&attr_hash, key->hash, key);
+    if(a) {
+        a->refcnt++;
+        return(a);
+    }
+
+    a = malloc(size);
+    if(!a) {
+        rec_log("error: %s: malloc() failed", __func__);
+        return(NULL);
+    }
+    memcpy(a, key, size);
+    a->refcnt = 1;
+
+    if(hash_insert(&attr_hash, a->hash, a) < 0) {
+        free(a);
+        return(NULL);
+    }
+    rib_stats.attrs++;
+    rib_stats.attr_mem += size;
+
+    return(a);
+}
+
+/*
+ * release a reference of interned attributes
+ */
+static void release_rib_attr(struct rib_attr *a)
+{
+    if(--a->refcnt)
+        return;
+
+    hash_delete(&attr_hash, a->hash, a);
+    rib_stats.attrs--;
+    rib_stats.attr_mem -= RIB_ATTR_SIZE(a->nh_num);
+    free(a);
+}
+
+/*
+ * search a nexthop in attributes
+ */
+static int search_rib_nexthop(const struct rib_attr *a, const struct rib_nexthop *nh)
+{
+    int i;
+
+    for(i = 0; i < a->nh_num; i++)
+        if(a->nh[i].ifindex == nh->ifindex &&
+            (a->nh[i].flags & EVENT_F_GATEWAY) == (nh->flags & EVENT_F_GATEWAY) &&
+            !memcmp(a->nh[i].gateway, nh->gateway, sizeof(nh->gateway)))
+            return(i);
+
+    return(-1);
+}
+
+/*
+ * merge nexthops of attributes into a buffer(or subtract them)
+ */
+static struct rib_attr *merge_rib_nexthops(const struct rib_attr *base,
+    const struct rib_attr *diff, int subtract)
+{
+    struct rib_attr *a = (struct rib_attr *)attr_buf[1];
+    int i;
+
+    memcpy(a, base, RIB_ATTR_SIZE(0));
+    a->nh_num = 0;
+
+    for(i = 0; i < base->nh_num; i++)
+        if(!subtract || search_rib_nexthop(diff, &base->nh[i]) < 0)
+            a->nh[a->nh_num++] = base->nh[i];
+
+    for(i = 0; !subtract && i < diff->nh_num; i++)
+        if(search_rib_nexthop(base, &diff->nh[i]) < 0 && a->nh_num < RIB_NEXTHOP_MAX)
+            a->nh[a->nh_num++] = diff->nh[i];
+
+    return(a);
+}
+
+/*
+ * get a routing table
+ */
+static struct rib_table *get_rib_table(int family, unsigned id, int create)
+{
+    struct list_head *l;
+    struct rib_table *t;
+
+    list_for_each(l, &thead) {
+        t = list_entry(l, struct rib_table, list);
+        if(t->family == family && t->id == id)
+            return(t);
+    }
+
+    if(!create)
+        return(NULL);
+
+    t = calloc(1, sizeof(*t));
+    if(!t) {
+        rec_log("error: %s: calloc() failed", __func__);
+        return(NULL);
+    }
+    t->family = family;
+    t->id = id;
+    list_init(&(t->list));
+    list_add(&(t->list), &thead);
+
+    return(t);
+}
+
+/*
+ * create a trie node of a prefix
+ */
+static struct rib_node *new_rib_node(struct rib_table *t, const unsigned char *prefix, int plen)
+{
+    struct rib_node *n;
+    int len = rib_addr_len(t->family);
+
+    n = pool_alloc(rib_node_pool(t->family));
+    if(!n)
+        return(NULL);
+
+    /* bits beyond a prefix length are cleared */
+    memcpy(n->prefix, prefix, len);
+    if(plen < len * 8) {
+        n->prefix[plen >> 3] &= 0xff << (8 - (plen & 7));
+        memset(n->prefix + (plen >> 3) + 1, 0, len - (plen >> 3) - 1);
+    }
+    n->plen = plen;
+
+    return(n);
+}
+
+/*
+ * search a trie node of a prefix
+ */
+static struct rib_node *search_rib_node(struct rib_table *t, const unsigned char *prefix, int plen)
+{
+    struct rib_node *n = t->root;
+
+    while(n && n->plen <= plen) {
+        if(prefix_common(n->prefix, prefix, n->plen) < n->plen)
+            return(NULL);
+        if(n->plen == plen)
+            return(n);
+        n = n->child[prefix_bit(prefix, n->plen)];
+    }
+
+    return(NULL);
+}
+
+/*
+ * insert a trie node of a prefix(or get an existing one)
+ */
+static struct rib_node *insert_rib_node(struct rib_table *t, const unsigned char *prefix, int plen)
+{
+    struct rib_node **link = &t->root, *n, *new, *glue;
+    int common = 0;
+
+    while((n = *link)) {
+        common = prefix_common(n->prefix, prefix, (n->plen < plen) ? n->plen : plen);
+        if(common < n->plen)
+            break;
+        if(n->plen == plen)
+            return(n);
+        link = &n->child[prefix_bit(prefix, n->plen)];
+    }
+
+    new = new_rib_node(t, prefix, plen);
+    if(!new)
+        return(NULL);
+
+    if(!n) {
+        *link = new;
+        return(new);
+    }
+
+    /* a new prefix covers a node */
+    if(common == plen) {
+        new->child[prefix_bit(n->prefix, plen)] = n;
+        *link = new;
+        return(new);
+    }
+
+    /* a new prefix and a node diverge below a glue node */
+    glue = new_rib_node(t, prefix, common);
+    if(!glue) {
+        pool_free(rib_node_pool(t->family), new);
+        return(NULL);
+    }
+    glue->child[prefix_bit(prefix, common)] = new;
+    glue->child[prefix_bit(n->prefix, common)] = n;
+    *link = glue;
+
+    return(new);
+}
+
+/*
+ * remove a node without routes unless it joins two subtries
+ */
+static void prune_rib_node(struct rib_table *t, struct rib_node **link)
+{
+    struct rib_node *n = *link;
+
+    if(n->routes || (n->child[0] && n->child[1]))
+        return;
+
+    *link = n->child[0] ? n->child[0] : n->child[1];
+    pool_free(rib_node_pool(t->family), n);
+}
+
+/*
+ * remove nodes without routes on a path to a prefix
+ */
+static void prune_rib_path(struct rib_table *t, struct rib_node **link,
+    const unsigned char *prefix, int plen)
+{
+    struct rib_node *n = *link;
+
+    if(!n)
+        return;
+
+    if(n->plen < plen)
+        prune_rib_path(t, &n->child[prefix_bit(prefix, n->plen)], prefix, plen);
+    prune_rib_node(t, link);
+}
+
+/*
+ * search a route in a trie node
+ */
+static struct rib_route **search_rib_route(struct rib_node *n, const struct event *ev)
+{
+    struct rib_route **rp, *r;
+
+    for(rp = &n->routes; (r = *rp); rp = &r->next)
+        if(r->tos == ev->tos && r->metric == ev->metric &&
+            r->attr->src_len == ev->src_len &&
+            !memcmp(r->attr->src, ev->src, sizeof(ev->src)))
+            return(rp);
+
+    return(NULL);
+}
+
+/*
+ * delete a route from a trie node
+ */
+static void del_rib_route(struct rib_table *t, struct rib_route **rp)
+{
+    struct rib_route *r = *rp;
+
+    *rp = r->next;
+    release_rib_attr(r->attr);
+    pool_free(&route_pool, r);
+    t->routes--;
+}
+
+/*
+ * set a routing event of a route in a trie node
+ */
+static void set_rib_event(struct event *ev, struct rib_table *t, struct rib_node *n,
+    struct rib_route *r)
+{
+    memset(ev, 0, sizeof(*ev));
+    ev->type = EVENT_ROUTE;
+    ev->family = t->family;
+    ev->table = t->id;
+    memcpy(ev->addr, n->prefix, rib_addr_len(t->family));
+    ev->prefixlen = n->plen;
+    ev->tos = r->tos;
+    ev->metric = r->metric;
+}
+
+/*
+ * pass routing events of a route to sinks
+ * (multipath in an event per EVENT_NEXTHOP_MAX nexthops)
+ */
+static void emit_rib_event(int action, struct event *ev, const struct rib_attr *a)
+{
+    /* a change is logged as differences by log_rib_diff() */
+    unsigned diff = (action == EVENT_CHANGED) ? EVENT_F_DIFF : 0;
+    int i;
+
+    if(seeding)
+        return;
+
+    ev->action = action;
+    ev->protocol = a->protocol;
+    ev->rtn_type = a->rtn_type;
+    ev->iifindex = a->iifindex;
+    ev->src_len = a->src_len;
+    memcpy(ev->src, a->src, sizeof(ev->src));
+    memcpy(ev->prefsrc, a->prefsrc, sizeof(ev->prefsrc));
+    ev->nhid = a->nhid;
+    ev->nh = NULL;
+    ev->nh_num = 0;
+
+#ifdef HAVE_LINUX_NEXTHOP_H
+    /* a route using a nexthop object is logged once(not per nexthop) */
+    if(a->flags & EVENT_F_NHID) {
+        ev->flags = a->flags | diff;
+        memset(ev->gateway, 0, sizeof(ev->gateway));
+        ev->ifindex = 0;
+        ev->kind = 0;
+        resolve_nhlist(ev);
+        emit_event(ev);
+        return;
+    }
+#endif
+
+    /* nexthops of multipath are carried by an event, and not copied to it */
+    if(a->flags & EVENT_F_MULTIPATH) {
+        ev->flags = a->flags | diff;
+        memset(ev->gateway, 0, sizeof(ev->gateway));
+        ev->ifindex = 0;
+        ev->kind = 0;
+        for(i = 0; i < a->nh_num; i += EVENT_NEXTHOP_MAX) {
+            ev->nh = a->nh + i;
+            ev->nh_num = (a->nh_num - i < EVENT_NEXTHOP_MAX) ?
+                a->nh_num - i : EVENT_NEXTHOP_MAX;
+            emit_event(ev);
+        }
+        return;
+    }
+
+    for(i = 0; i < a->nh_num; i++) {
+        ev->flags = a->flags | a->nh[i].flags | diff;
+        memcpy(ev->gateway, a->nh[i].gateway, sizeof(ev->gateway));
+        ev->ifindex = a->nh[i].ifindex;
+        ev->kind = 0;
+        emit_event(ev);
+    }
+}
+
+/*
+ * format a prefix of a routing event as text
+ */
+static char *format_rib_prefix(const struct event *ev, char *buf)
+{
+    char *p = buf;
+    const char *table;
+
+    p += sprintf(p, "%s route ", (ev->family == AF_INET6) ? "ipv6" : "ipv4");
+    p += (ev->family == AF_INET6) ? ntop_ipv6(ev->addr, p) : ntop_ipv4(ev->addr, p);
+    p += sprintf(p, "/%d", ev->prefixlen);
+
+    if(ev->table != RT_TABLE_MAIN) {
+        table = conv_rt_table(ev->table, 0);
+        if(!strcmp(table, "unknown"))
+            sprintf(p, " in table %u", ev->table);
+        else
+            sprintf(p, " in table %s", table);
+    }
+
+    return(buf);
+}
+
+/*
+ * format an address of attributes as text
+ */
+static char *format_rib_addr(int family, const unsigned char *addr, int present, char *buf)
+{
+    if(!present)
+        strcpy(buf, "none");
+    else if(family == AF_INET6)
+        ntop_ipv6(addr, buf);
+    else
+        ntop_ipv4(addr, buf);
+
+    return(buf);
+}
+
+/*
+ * format a nexthop as text
+ */
+static char *format_rib_nexthop(int family, const struct rib_nexthop *nh, char *buf)
+{
+    char ifname[IFNAMSIZ] = "";
+    char *p = buf;
+
+    if(nh->flags & EVENT_F_GATEWAY) {
+        p += (family == AF_INET6) ? ntop_ipv6(nh->gateway, p) : ntop_ipv4(nh->gateway, p);
+        if(nh->flags & EVENT_F_OIF)
+            *p++ = ' ';
+    }
+
+    if(nh->flags & EVENT_F_OIF)
+        sprintf(p, "dev %s", if_indextoname_from_lists(nh->ifindex, ifname));
+    else if(p == buf)
+        strcpy(buf, "none");
+    else
+        *p = '\0';
+
+    return(buf);
+}
+
+/*
+ * format a nexthop object id as text
+ */
+static char *format_rib_nhid(unsigned nhid, char *buf)
+{
+    if(nhid)
+        sprintf(buf, "%u", nhid);
+    else
+        strcpy(buf, "none");
+
+    return(buf);
+}
+
+/*
+ * log differences between old and new attributes of a route
+ * (a routing event of a change is not logged again as text)
+ */
+static void log_rib_diff(const struct event *ev, const struct rib_attr *old,
+    const struct rib_attr *new)
+{
+    char route[MAX_STR_SIZE];
+    char o[INET6_ADDRSTRLEN + IFNAMSIZ + 8], n[INET6_ADDRSTRLEN + IFNAMSIZ + 8];
+    int i, j, lines = 0;
+
+    format_rib_prefix(ev, route);
+
+    if(old->protocol != new->protocol) {
+        rec_log("%s protocol changed from %s to %s", route,
+            conv_rtprot(old->protocol, 0), conv_rtprot(new->protocol, 0));
+        lines++;
+    }
+
+    if(old->rtn_type != new->rtn_type) {
+        rec_log("%s type changed from %s to %s", route,
+            conv_rtn_type(old->rtn_type, 0), conv_rtn_type(new->rtn_type, 0));
+        lines++;
+    }
+
+    if((old->flags & EVENT_F_PREFSRC) != (new->flags & EVENT_F_PREFSRC) ||
+        memcmp(old->prefsrc, new->prefsrc, sizeof(old->prefsrc))) {
+        rec_log("%s preferred source changed from %s to %s", route,
+            format_rib_addr(ev->family, old->prefsrc, old->flags & EVENT_F_PREFSRC, o),
+            format_rib_addr(ev->family, new->prefsrc, new->flags & EVENT_F_PREFSRC, n));
+        lines++;
+    }
+
+    if((old->flags & EVENT_F_IIF) != (new->flags & EVENT_F_IIF) ||
+        old->iifindex != new->iifindex) {
+        rec_log("%s ingress interface changed from %s to %s", route,
+            (old->flags & EVENT_F_IIF) ?
+                if_indextoname_from_lists(old->iifindex, o) : strcpy(o, "none"),
+            (new->flags & EVENT_F_IIF) ?
+                if_indextoname_from_lists(new->iifindex, n) : strcpy(n, "none"));
+        lines++;
+    }
+
+    if(old->nhid != new->nhid) {
+        /* a nexthop object is logged with its own changes */
+        rec_log("%s nexthop-id changed from %s to %s", route,
+            format_rib_nhid(old->nhid, o), format_rib_nhid(new->nhid, n));
+        lines++;
+    } else if(old->nh_num == 1 && new->nh_num == 1) {
+        /* a single nexthop is replaced */
+        if(search_rib_nexthop(old, &new->nh[0]) < 0) {
+            rec_log("%s nexthop changed from %s to %s", route,
+                format_rib_nexthop(ev->family, &old->nh[0], o),
+                format_rib_nexthop(ev->family, &new->nh[0], n));
+            lines++;
+        }
+    } else {
+        /* nexthops are removed, added or reweighted */
+        for(i = 0; i < old->nh_num; i++) {
+            if(search_rib_nexthop(new, &old->nh[i]) < 0) {
+                rec_log("%s nexthop %s removed", route,
+                    format_rib_nexthop(ev->family, &old->nh[i], o));
+                lines++;
+            }
+        }
+
+        for(i = 0; i < new->nh_num; i++) {
+            j = search_rib_nexthop(old, &new->nh[i]);
+            if(j < 0) {
+                rec_log("%s nexthop %s added", route,
+                    format_rib_nexthop(ev->family, &new->nh[i], n));
+                lines++;
+            } else if(old->nh[j].weight != new->nh[i].weight) {
+                rec_log("%s nexthop %s weight changed from %hu to %hu", route,
+                    format_rib_nexthop(ev->family, &new->nh[i], n),
+                    old->nh[j].weight, new->nh[i].weight);
+                lines++;
+            }
+        }
+    }
+
+    /* flags such as multipath changed without any attribute above */
+    if(!lines)
+        rec_log("%s attributes changed", route);
+}
+
+/*
+ * delete a route notified by RTM_DELROUTE from a routing table mirror
+ */
+static int delete_rib(struct event *ev, struct rib_attr *key)
+{
+    struct rib_table *t;
+    struct rib_node *n = NULL;
+    struct rib_route **rp = NULL, *r;
+    struct rib_attr *a;
+
+    t = get_rib_table(ev->family, ev->table, 0);
+    if(t)
+        n = search_rib_node(t, ev->addr, ev->prefixlen);
+    if(n)
+        rp = search_rib_route(n, ev);
+
+    /* nexthops left after deleting notified ones(none of a nexthop object) */
+    a = rp ? merge_rib_nexthops((*rp)->attr, key, 1) : NULL;
+    if(a && ((a->flags | key->flags) & EVENT_F_NHID))
+        a->nh_num = 0;
+
+    /* a route unknown to a mirror is logged as notified */
+    if(!a || (key->nh_num && a->nh_num == (*rp)->attr->nh_num)) {
+        rib_stats.unknown++;
+        emit_rib_event(EVENT_DELETED, ev, key);
+        return(0);
+    }
+    r = *rp;
+    rib_stats.deleted++;
+
+    /* a part of nexthops sharing a prefix is deleted */
+    if(a->nh_num) {
+        a = intern_rib_attr(a);
+        if(!a)
+            return(-1);
+        emit_rib_event(EVENT_DELETED, ev, key);
+        release_rib_attr(r->attr);
+        r->attr = a;
+        return(0);
+    }
+
+    /* a deleted route is logged as it used to be */
+    emit_rib_event(EVENT_DELETED, ev, r->attr);
+    del_rib_route(t, rp);
+    prune_rib_path(t, &t->root, ev->addr, ev->prefixlen);
+
+    return(0);
+}
+
+/*
+ * apply a route notified by RTM_NEWROUTE to a routing table mirror
+ */
+static int add_rib(struct event *ev, struct rib_attr *key, int nlmsg_flags)
+{
+    struct rib_table *t;
+    struct rib_node *n;
+    struct rib_route **rp, *r;
+    struct rib_attr *a, *old;
+
+    t = get_rib_table(ev->family, ev->table, 1);
+    if(!t)
+        return(-1);
+
+    n = insert_rib_node(t, ev->addr, ev->prefixlen);
+    if(!n)
+        return(-1);
+
+    rp = search_rib_route(n, ev);
+    if(!rp) {
+        r = pool_alloc(&route_pool);
+        if(!r) {
+            prune_rib_path(t, &t->root, ev->addr, ev->prefixlen);
+            return(-1);
+        }
+        r->attr = intern_rib_attr(key);
+        if(!r->attr) {
+            pool_free(&route_pool, r);
+            prune_rib_path(t, &t->root, ev->addr, ev->prefixlen);
+            return(-1);
+        }
+        r->metric = ev->metric;
+        r->tos = ev->tos;
+        r->mark = resyncing;
+        r->next = n->routes;
+        n->routes = r;
+        t->routes++;
+        rib_stats.added++;
+
+        emit_rib_event(EVENT_ADDED, ev, r->attr);
+        return(0);
+    }
+    r = *rp;
+
+    /*
+     * a route added without replacing one shares a prefix with it
+     * (a first route of a prefix in a dump replaces it not to leave stale nexthops)
+     */
+    if(!(nlmsg_flags & NLM_F_REPLACE) && !(resyncing && !r->mark) &&
+        !((key->flags | r->attr->flags) & EVENT_F_NHID)) {
+        r->mark = resyncing;
+        a = merge_rib_nexthops(key, r->attr, 1);
+        if(!a->nh_num) {
+            /* kernel refuses a duplicate, so a mirror missed a deletion */
+            rib_stats.stale++;
+            emit_rib_event(EVENT_ADDED, ev, key);
+            return(0);
+        }
+        emit_rib_event(EVENT_ADDED, ev, a);
+        rib_stats.added++;
+
+        a = intern_rib_attr(merge_rib_nexthops(r->attr, key, 0));
+        if(!a)
+            return(-1);
+        release_rib_attr(r->attr);
+        r->attr = a;
+        return(0);
+    }
+    r->mark = resyncing;
+
+    a = intern_rib_attr(key);
+    if(!a)
+        return(-1);
+
+    /* interned attributes are compared by address */
+    if(a == r->attr) {
+        release_rib_attr(a);
+        rib_stats.unchanged++;
+        return(0);
+    }
+    rib_stats.changed++;
+
+    old = r->attr;
+    r->attr = a;
+    if(!seeding) {
+        /* differences are logged unless a burst of changes is summarized */
+        emit_rib_event(EVENT_CHANGED, ev, a);
+        if(!summarize_event(ev))
+            log_rib_diff(ev, old, a);
+    }
+    release_rib_attr(old);
+
+    return(0);
+}
+
+/*
+ * apply a route to a routing table mirror and pass its events to sinks
+ */
+int update_rib(struct event *ev, struct rib_nexthop *nh, int nh_num, int nlmsg_flags)
+{
+    struct rib_attr *key = (struct rib_attr *)attr_buf[0];
+
+    /* attributes of a route are set in a zeroed buffer to be hashed */
+    memset(key, 0, RIB_ATTR_SIZE(nh_num));
+    key->flags = ev->flags & ~(EVENT_F_GATEWAY | EVENT_F_OIF);
+    key->nhid = ev->nhid;
+    key->iifindex = ev->iifindex;
+    key->nh_num = nh_num;
+    key->protocol = ev->protocol;
+    key->rtn_type = ev->rtn_type;
+    key->src_len = ev->src_len;
+    memcpy(key->src, ev->src, sizeof(key->src));
+    memcpy(key->prefsrc, ev->prefsrc, sizeof(key->prefsrc));
+    memcpy(key->nh, nh, nh_num * sizeof(*nh));
+
+    if(ev->action == EVENT_DELETED)
+        return(delete_rib(ev, key));
+
+    return(add_rib(ev, key, nlmsg_flags));
+}
+
+/*
+ * parse messages of a dump of routing tables
+ */
+static int parse_rib_dump(struct msghdr *msg, int len)
+{
+    struct nlmsghdr *nlh;
+    int nlh_len;
+
+    /* get netlink message header */
+    nlh = msg->msg_iov->iov_base;
+    nlh_len = len;
+
+    /* parse netlink message header */
+    for( ; NLMSG_OK(nlh, nlh_len); nlh = NLMSG_NEXT(nlh, nlh_len)) {
+        /* whether netlink message header ends or not */
+        if(nlh->nlmsg_type == NLMSG_DONE)
+            return(1);
+
+        if(nlh->nlmsg_type == NLMSG_ERROR) {
+            rec_log("error: %s: nlmsg error", __func__);
+            return(-1);
+        }
+
+        parse_rtmsg(nlh);
+    }
+
+    return(0);
+}
+
+/*
+ * create a routing table mirror without logging routes
+ */
+int create_rib(struct msghdr *msg, int len)
+{
+    int ret;
+
+    seeding = 1;
+    ret = parse_rib_dump(msg, len);
+    seeding = 0;
+
+    return(ret);
+}
+
+/*
+ * resynchronize a routing table mirror with kernel
+ */
+int resync_rib(struct msghdr *msg, int len)
+{
+    int ret;
+
+    /* routes found in a dump are marked */
+    resyncing = 1;
+    ret = parse_rib_dump(msg, len);
+    resyncing = 0;
+
+    return(ret);
+}
+
+/*
+ * delete routes not marked in a subtrie
+ */
+static void sweep_rib_node(struct rib_table *t, struct rib_node **link)
+{
+    struct rib_node *n = *link;
+    struct rib_route **rp, *r;
+    struct event ev;
+
+    if(!n)
+        return;
+
+    sweep_rib_node(t, &n->child[0]);
+    sweep_rib_node(t, &n->child[1]);
+
+    for(rp = &n->routes; (r = *rp); ) {
+        if(r->mark) {
+            r->mark = 0;
+            rp = &r->next;
+            continue;
+        }
+
+        set_rib_event(&ev, t, n, r);
+        emit_rib_event(EVENT_DELETED, &ev, r->attr);
+        rib_stats.deleted++;
+        del_rib_route(t, rp);
+    }
+
+    prune_rib_node(t, link);
+}
+
+/*
+ * delete routes not found in a dump from a routing table mirror
+ */
+void sweep_rib(void)
+{
+    struct list_head *l;
+    struct rib_table *t;
+
+    list_for_each(l, &thead) {
+        t = list_entry(l, struct rib_table, list);
+        sweep_rib_node(t, &t->root);
+    }
+
+    return;
+}
+
+/*
+ * delete routes of which attributes match a key under a trie node
+ */
+static unsigned flush_rib_node(struct rib_table *t, struct rib_node **link,
+    int (*match)(const struct rib_attr *a, const void *key), const void *key)
+{
+    struct rib_node *n = *link;
+    struct rib_route **rp, *r;
+    unsigned num;
+
+    if(!n)
+        return(0);
+
+    num = flush_rib_node(t, &n->child[0], match, key);
+    num += flush_rib_node(t, &n->child[1], match, key);
+
+    for(rp = &n->routes; (r = *rp); ) {
+        if(!match(r->attr, key)) {
+            rp = &r->next;
+            continue;
+        }
+        del_rib_route(t, rp);
+        num++;
+    }
+
+    prune_rib_node(t, link);
+
+    return(num);
+}
+
+/*
+ * delete routes of a family of which attributes match a key(0 for any family)
+ */
+static unsigned flush_rib(int family, int (*match)(const struct rib_attr *a,
+    const void *key), const void *key)
+{
+    struct list_head *l;
+    struct rib_table *t;
+    unsigned num = 0;
+
+    list_for_each(l, &thead) {
+        t = list_entry(l, struct rib_table, list);
+        if(!family || t->family == family)
+            num += flush_rib_node(t, &t->root, match, key);
+    }
+
+    return(num);
+}
+
+/*
+ * match attributes using a nexthop object
+ */
+static int match_rib_nhid(const struct rib_attr *a, const void *key)
+{
+    return((a->flags & EVENT_F_NHID) && a->nhid == *(const unsigned *)key);
+}
+
+/*
+ * match attributes of which every nexthop uses an interface
+ */
+static int match_rib_ifindex(const struct rib_attr *a, const void *key)
+{
+    int i;
+
+    if(!a->nh_num)
+        return(0);
+
+    for(i = 0; i < a->nh_num; i++)
+        if(!(a->nh[i].flags & EVENT_F_OIF) || a->nh[i].ifindex != *(const int *)key)
+            return(0);
+
+    return(1);
+}
+
+/*
+ * match attributes with a preferred source address
+ */
+static int match_rib_prefsrc(const struct rib_attr *a, const void *key)
+{
+    return((a->flags & EVENT_F_PREFSRC) && !memcmp(a->prefsrc, key, 4));
+}
+
+/*
+ * delete routes using a deleted nexthop object(kernel notifies no deletion of them)
+ */
+unsigned flush_rib_nexthop(unsigned nhid)
+{
+    unsigned num;
+
+    num = flush_rib(0, match_rib_nhid, &nhid);
+    rib_stats.deleted += num;
+
+    return(num);
+}
+
+/*
+ * delete IPv4 routes through an interface which went down, was deleted or lost
+ * its last IPv4 address(kernel notifies no deletion of them)
+ *
+ * A multipath route with another nexthop is kept as kernel keeps it with a
+ * dead nexthop.
+ */
+unsigned flush_rib_ifindex(int ifindex)
+{
+    unsigned num;
+
+    num = flush_rib(AF_INET, match_rib_ifindex, &ifindex);
+    rib_stats.flushed += num;
+
+    return(num);
+}
+
+/*
+ * delete IPv4 routes with a deleted preferred source address(kernel notifies
+ * no deletion of them)
+ */
+unsigned flush_rib_prefsrc(const unsigned char *prefsrc)
+{
+    unsigned num;
+
+    num = flush_rib(AF_INET, match_rib_prefsrc, prefsrc);
+    rib_stats.flushed += num;
+
+    return(num);
+}
+
+/*
+ * delete a route with too many nexthops to mirror, which is logged as notified
+ */
+void unmirror_rib(const struct event *ev)
+{
+    struct rib_table *t;
+    struct rib_node *n = NULL;
+    struct rib_route **rp = NULL;
+
+    rib_stats.unmirrored++;
+
+    t = get_rib_table(ev->family, ev->table, 0);
+    if(t)
+        n = search_rib_node(t, ev->addr, ev->prefixlen);
+    if(n)
+        rp = search_rib_route(n, ev);
+    if(!rp)
+        return;
+
+    del_rib_route(t, rp);
+    prune_rib_path(t, &t->root, ev->addr, ev->prefixlen);
+}
+
+/*
+ * look up attributes of a route to an address by longest prefix match
+ */
+const struct rib_attr *lookup_rib(int family, unsigned table, const unsigned char *addr)
+{
+    struct rib_table *t;
+    struct rib_node *n, *best = NULL;
+    struct rib_route *r, *found;
+    int bits = rib_addr_len(family) * 8;
+
+    t = get_rib_table(family, table, 0);
+    if(!t)
+        return(NULL);
+
+    for(n = t->root; n; n = n->child[prefix_bit(addr, n->plen)]) {
+        if(prefix_common(n->prefix, addr, n->plen) < n->plen)
+            break;
+        if(n->routes)
+            best = n;
+        if(n->plen == bits)
+            break;
+    }
+    if(!best)
+        return(NULL);
+
+    /* a route of the lowest metric is preferred */
+    for(found = r = best->routes; r; r = r->next)
+        if(r->metric < found->metric)
+            found = r;
+
+    return(found->attr);
+}
+
+/*
+ * print statistics of a routing table mirror
+ */
+void print_rib_stats(FILE *stats)
+{
+    struct list_head *l;
+    struct rib_table *t;
+    const char *table;
+
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ routing table mirror statistics ]\n");
+    list_for_each(l, &thead) {
+        t = list_entry(l, struct rib_table, list);
+        table = conv_rt_table(t->id, 0);
+        if(!strcmp(table, "unknown"))
+            fprintf(stats, "%s table %u: %u routes\n",
+                (t->family == AF_INET6) ? "ipv6" : "ipv4", t->id, t->routes);
+        else
+            fprintf(stats, "%s table %s: %u routes\n",
+                (t->family == AF_INET6) ? "ipv6" : "ipv4", table, t->routes);
+    }
+    fprintf(stats, "routes added: %llu\n", rib_stats.added);
+    fprintf(stats, "routes changed: %llu\n", rib_stats.changed);
+    fprintf(stats, "routes unchanged: %llu\n", rib_stats.unchanged);
+    fprintf(stats, "routes deleted: %llu\n", rib_stats.deleted);
+    fprintf(stats, "unknown routes deleted: %llu\n", rib_stats.unknown);
+    fprintf(stats, "stale routes added again: %llu\n", rib_stats.stale);
+    fprintf(stats, "routes flushed with interfaces: %llu\n", rib_stats.flushed);
+    fprintf(stats, "routes not mirrored: %llu\n", rib_stats.unmirrored);
+    fprintf(stats, "attribute sets: %u\n", rib_stats.attrs);
+    fprintf(stats, "attribute memory: %lu byte\n", rib_stats.attr_mem);
+
+    print_hash_stats(stats, "route attribute table", &attr_hash);
+    print_pool_stats(stats, &node4_pool);
+    print_pool_stats(stats, &node6_pool);
+    print_pool_stats(stats, &route_pool);
+}
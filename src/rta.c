@@ -321,17 +321,27 @@ void debug_rta_arphrd(int lev, struct rtattr *rta, const char *name,
  */ 
 int arphrd_ntop(unsigned short type, struct rtattr *ifla, char *dst, int dstlen)
 {
-    unsigned char *src = RTA_DATA(ifla);
-    int i, srclen = RTA_PAYLOAD(ifla);
-    char *p = dst;
+    return(hwaddr_ntop(type, RTA_DATA(ifla), RTA_PAYLOAD(ifla), dst, dstlen));
+}
 
+/*
+ * convert hardware address of an interface type from binary to text
+ *
+ * return 1 with errno set to ENOSPC as inet_ntop() does when dst can not
+ * hold all octets, instead of a truncated address
+ */
+int hwaddr_ntop(unsigned short type, const unsigned char *src, int srclen,
+    char *dst, int dstlen)
+{
     switch(type) {
         case ARPHRD_TUNNEL:
         case ARPHRD_IPGRE:
         case ARPHRD_SIT:
             if(srclen < 4)
                 return(2);
-            if(!inet_ntop(AF_INET, src, dst, dstlen))
+            if(dstlen >= INET_ADDRSTRLEN)
+                ntop_ipv4(src, dst);
+            else if(!inet_ntop(AF_INET, src, dst, dstlen))
                 return(1);
             return(0);
         case ARPHRD_TUNNEL6:
@@ -340,14 +350,19 @@ int arphrd_ntop(unsigned short type, struct rtattr *ifla, char *dst, int dstlen)
 #endif
             if(srclen < 16)
                 return(2);
-            if(!inet_ntop(AF_INET6, src, dst, dstlen))
+            if(dstlen >= INET6_ADDRSTRLEN)
+                ntop_ipv6(src, dst);
+            else if(!inet_ntop(AF_INET6, src, dst, dstlen))
                 return(1);
             return(0);
     }
 
-    for(i = 0; i < srclen; i++)
-        APPEND_SNPRINTF(rc, p, dstlen, "%02x%s",
-            src[i], (i + 1 == srclen) ? "" : ":");
+    /* each octet takes three characters including a separator */
+    if(dstlen < 1 || (srclen && srclen > dstlen / 3)) {
+        errno = ENOSPC;
+        return(1);
+    }
+    ntop_hwaddr(src, srclen, dst);
 
     return(0);
 }
@@ -394,12 +409,30 @@ int inet_ntop_ifa(int family, struct rtattr *ifa, char *saddr, int slen)
             break;
     }
 
-    if(!inet_ntop(family, addr, saddr, slen))
+    if(family == AF_INET && slen >= INET_ADDRSTRLEN)
+        ntop_ipv4(addr, saddr);
+    else if(family == AF_INET6 && slen >= INET6_ADDRSTRLEN)
+        ntop_ipv6(addr, saddr);
+    else if(!inet_ntop(family, addr, saddr, slen))
         return(1);
 
     return(0);
 }
 
+/*
+ * copy an address in binary without converting to text
+ */
+int get_rta_addr(int family, struct rtattr *rta, unsigned char *addr)
+{
+    int len = (family == AF_INET6) ? 16 : 4;
+
+    if(RTA_PAYLOAD(rta) < len)
+        return(-1);
+    memcpy(addr, RTA_DATA(rta), len);
+
+    return(0);
+}
+
 /*
  * debug attribute
  */
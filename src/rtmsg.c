@@ -19,6 +19,57 @@
 #include "nield.h"
 #include "rtnetlink.h"
 
+/*
+ * get a nexthop of RTA_MULTIPATH
+ */
+static int get_rtnh(int family, struct rtnexthop *rtnh, struct rib_nexthop *nh)
+{
+    struct rtattr *rtna[__RTA_MAX];
+
+    parse_rtattr(rtna, RTA_MAX, RTNH_DATA(rtnh), rtnh->rtnh_len - sizeof(*rtnh));
+
+    memset(nh, 0, sizeof(*nh));
+    if(rtna[RTA_GATEWAY]) {
+        if(get_rta_addr(family, rtna[RTA_GATEWAY], nh->gateway)) {
+            rec_log("error: %s: RTA_GATEWAY: payload too short", __func__);
+            return(1);
+        }
+        nh->flags |= EVENT_F_GATEWAY;
+    }
+    nh->ifindex = rtnh->rtnh_ifindex;
+    nh->weight = rtnh->rtnh_hops + 1;
+    nh->flags |= EVENT_F_OIF;
+
+    return(0);
+}
+
+/*
+ * pass routing events of RTA_MULTIPATH to sinks as notified
+ * (an event per EVENT_NEXTHOP_MAX nexthops)
+ */
+static int emit_rtnh_events(int family, struct event *ev, struct rtattr *multipath)
+{
+    struct rtnexthop *rtnh = RTA_DATA(multipath);
+    int rtnh_len = RTA_PAYLOAD(multipath);
+    struct rib_nexthop nh[EVENT_NEXTHOP_MAX];
+
+    ev->nh = nh;
+    ev->nh_num = 0;
+    for(; RTNH_OK(rtnh, rtnh_len);
+        rtnh = RTNH_NEXT(rtnh), rtnh_len -= RTNH_ALIGN(rtnh->rtnh_len)) {
+        if(get_rtnh(family, rtnh, &nh[ev->nh_num]))
+            return(1);
+        if(++ev->nh_num == EVENT_NEXTHOP_MAX) {
+            emit_event(ev);
+            ev->nh_num = 0;
+        }
+    }
+    if(ev->nh_num)
+        emit_event(ev);
+
+    return(0);
+}
+
 /*
  * parse route message
  */
@@ -27,11 +78,10 @@ int parse_rtmsg(struct nlmsghdr *nlh)
     struct rtmsg *rtm;
     int rtm_len;
     struct rtattr *rta[__RTA_MAX];
-    char ipv[MAX_STR_SIZE] = "";
-    char msg[MAX_MSG_SIZE] = "";
-    char *mp = msg;
+    struct event ev;
+    static struct rib_nexthop nh[RIB_NEXTHOP_MAX];
+    int nh_num = 1;
     int log_opts = get_log_opts();
-    int res;
 
     /* debug nlmsghdr */
     if(log_opts & L_DEBUG)
@@ -52,161 +102,144 @@ int parse_rtmsg(struct nlmsghdr *nlh)
     if(log_opts & L_DEBUG)
         debug_rtmsg(0, rtm, rta, rtm_len);
 
+    memset(&ev, 0, sizeof(ev));
+    ev.type = EVENT_ROUTE;
+
     /* check address family */
-    char dst[INET6_ADDRSTRLEN] = "";
-    if(rtm->rtm_family == AF_INET) {
-        strcpy(ipv, "ipv4");
-        strcpy(dst, "0.0.0.0");
-    } else if(rtm->rtm_family == AF_INET6) {
-        strcpy(ipv, "ipv6");
-        strcpy(dst, "::");
-    } else {
+    if(rtm->rtm_family != AF_INET && rtm->rtm_family != AF_INET6) {
         rec_log("error: %s: unknown address family: %d",
                 __func__, rtm->rtm_family);
         return(1);
     }
-
-    /* convert from table id to table name */
-    char table[MAX_STR_SIZE] = "";
-    snprintf(table, sizeof(table), "%s", conv_rt_table(rtm->rtm_table, 0));
-    if(!strncmp(table, "unknown", sizeof(table)))
-        snprintf(table, sizeof(table), "%d", rtm->rtm_table);
+    ev.family = rtm->rtm_family;
 
     /* check route table id(other than RT_TABLE_LOCAL) */
-    if(rtm->rtm_table == RT_TABLE_LOCAL)
+    if(rtm->rtm_table == RT_TABLE_LOCAL) {
+        count_filter_discard();
         return(1);
+    }
 
     /* check route protocol(other than RTPROT_UNSPEC) */
-    if(rtm->rtm_protocol == RTPROT_UNSPEC)
+    if(rtm->rtm_protocol == RTPROT_UNSPEC) {
+        count_filter_discard();
         return(1);
+    }
     
     /* check route flags(other then RTM_F_CLONED) */
-    if(rtm->rtm_flags & RTM_F_CLONED)
+    if(rtm->rtm_flags & RTM_F_CLONED) {
+        count_filter_discard();
         return(1);
+    }
 
-    /* get destination prefix */
-    if(rta[RTA_DST]) {
-        res = inet_ntop_ifa(rtm->rtm_family, rta[RTA_DST], dst, sizeof(dst));
-        if(res) {
-            rec_log("error: %s: RTA_DST: %s", __func__,
-                (res == 1) ? strerror(errno) : "payload too short");
-            return(1);
-        }
+    /* check message type */
+    if(nlh->nlmsg_type == RTM_NEWROUTE)
+        ev.action = EVENT_ADDED;
+    else if(nlh->nlmsg_type == RTM_DELROUTE)
+        ev.action = EVENT_DELETED;
+    else
+        return(0);
+
+    /* get destination prefix(no RTA_DST attribute if a default gateway) */
+    if(rta[RTA_DST] && get_rta_addr(rtm->rtm_family, rta[RTA_DST], ev.addr)) {
+        rec_log("error: %s: RTA_DST: payload too short", __func__);
+        return(1);
     }
-    /* no RTA_DST attribute if destination is a default gateway */
-    mp = add_log(msg, mp, "destination=%s/%d ", dst, rtm->rtm_dst_len);
+    ev.prefixlen = rtm->rtm_dst_len;
 
     /* get source prefix */
     if(rta[RTA_SRC]) {
-        char src[INET6_ADDRSTRLEN] = "";
-
-        res = inet_ntop_ifa(rtm->rtm_family, rta[RTA_SRC], src, sizeof(src));
-        if(res == 1) {
-            rec_log("error: %s: RTA_SRC: %s", __func__,
-                (res == 1) ? strerror(errno) : "payload too short");
+        if(get_rta_addr(rtm->rtm_family, rta[RTA_SRC], ev.src)) {
+            rec_log("error: %s: RTA_SRC: payload too short", __func__);
             return(1);
         }
-        mp = add_log(msg, mp, "source=%s/%d ", src, rtm->rtm_src_len);
+        ev.src_len = rtm->rtm_src_len;
+        ev.flags |= EVENT_F_SRC;
     }
 
     /* get preferred source address */
     if(rta[RTA_PREFSRC]) {
-        char prefsrc[INET6_ADDRSTRLEN] = "";
-
-        res = inet_ntop_ifa(rtm->rtm_family, rta[RTA_PREFSRC], prefsrc, sizeof(prefsrc));
-        if(res) {
-            rec_log("error: %s: RTA_PREFSRC: %s", __func__,
-                (res == 1) ? strerror(errno) : "payload too short");
+        if(get_rta_addr(rtm->rtm_family, rta[RTA_PREFSRC], ev.prefsrc)) {
+            rec_log("error: %s: RTA_PREFSRC: payload too short", __func__);
             return(1);
         }
-        mp = add_log(msg, mp, "preferred-source=%s ", prefsrc);
+        ev.flags |= EVENT_F_PREFSRC;
     }
 
     /* get tos */
-    if(rtm->rtm_tos)
-        mp = add_log(msg, mp, "tos=0x%.2x ", rtm->rtm_tos);
+    ev.tos = rtm->rtm_tos;
 
     /* get ingress interface */
     if(rta[RTA_IIF]) {
-        unsigned iifindex;
-        char iifname[IFNAMSIZ] = "";
-
-        if(RTA_PAYLOAD(rta[RTA_IIF]) < sizeof(iifindex)) {
+        if(RTA_PAYLOAD(rta[RTA_IIF]) < sizeof(unsigned)) {
             rec_log("error: %s: RTA_IIF: payload too short", __func__);
             return(1);
         }
-        iifindex = *((unsigned *)RTA_DATA(rta[RTA_IIF]));
-        if_indextoname_from_lists(iifindex, iifname);
+        ev.iifindex = *((unsigned *)RTA_DATA(rta[RTA_IIF]));
+        ev.flags |= EVENT_F_IIF;
+    }
 
-        mp = add_log(msg, mp, "in=%s ", iifname);
+#ifdef HAVE_LINUX_NEXTHOP_H
+    /* get nexthop object id(resolved from a nexthop object list) */
+    if(rta[RTA_NH_ID]) {
+        if(RTA_PAYLOAD(rta[RTA_NH_ID]) < sizeof(unsigned)) {
+            rec_log("error: %s: RTA_NH_ID: payload too short", __func__);
+            return(1);
+        }
+        ev.nhid = *((unsigned *)RTA_DATA(rta[RTA_NH_ID]));
+        ev.flags |= EVENT_F_NHID;
     }
+#endif
 
     /* get gateway address */
+    memset(nh, 0, sizeof(nh[0]));
     if(rta[RTA_GATEWAY]) {
-        char nexthop[INET6_ADDRSTRLEN] = "";
-
-        res = inet_ntop_ifa(rtm->rtm_family, rta[RTA_GATEWAY], nexthop, sizeof(nexthop));
-        if(res) {
-            rec_log("error: %s: RTA_GATEWAY: %s", __func__,
-                (res == 1) ? strerror(errno) : "payload too short");
+        if(get_rta_addr(rtm->rtm_family, rta[RTA_GATEWAY], nh[0].gateway)) {
+            rec_log("error: %s: RTA_GATEWAY: payload too short", __func__);
             return(1);
         }
-        mp = add_log(msg, mp, "nexthop=%s ", nexthop);
+        nh[0].flags |= EVENT_F_GATEWAY;
     }
 
     /* get egress interface */
     if(rta[RTA_OIF]) {
-        unsigned oifindex;
-        char oifname[IFNAMSIZ] = "";
-
-        if(RTA_PAYLOAD(rta[RTA_OIF]) < sizeof(oifindex)) {
+        if(RTA_PAYLOAD(rta[RTA_OIF]) < sizeof(unsigned)) {
             rec_log("error: %s: RTA_OIF: payload too short", __func__);
             return(1);
         }
-        oifindex = *((unsigned *)RTA_DATA(rta[RTA_OIF]));
-        if_indextoname_from_lists(oifindex, oifname);
-
-        mp = add_log(msg, mp, "interface=%s ", oifname);
+        nh[0].ifindex = *((unsigned *)RTA_DATA(rta[RTA_OIF]));
+        nh[0].flags |= EVENT_F_OIF;
     }
 
     /* get priority(but metric) */
-    char metric[MAX_STR_SIZE] = "";
     if(rta[RTA_PRIORITY]) {
         if(RTA_PAYLOAD(rta[RTA_PRIORITY]) < sizeof(int)) {
             rec_log("error: %s: RTA_PRIORITY: payload too short", __func__);
             return(1);
         }
-        snprintf(metric, sizeof(metric), "metric=%d ", *((int *)RTA_DATA(rta[RTA_PRIORITY])));
+        ev.metric = *((int *)RTA_DATA(rta[RTA_PRIORITY]));
+        ev.flags |= EVENT_F_METRIC;
     }
 
-    /* convert route message type */
-    char type[MAX_STR_SIZE] = "";
-    snprintf(type, sizeof(type), "%s", conv_rtn_type(rtm->rtm_type, 0));
-
-    /* convert route message protocol */
-    char proto[MAX_STR_SIZE] = "";
-    snprintf(proto, sizeof(proto), "%s", conv_rtprot(rtm->rtm_protocol, 0));
+    /* get route message type & protocol */
+    ev.rtn_type = rtm->rtm_type;
+    ev.protocol = rtm->rtm_protocol;
 
-    /* get table id & name */
+    /* get table id */
+    ev.table = rtm->rtm_table;
     if(rta[RTA_TABLE]) {
-        int table_id = *(int *)RTA_DATA(rta[RTA_TABLE]);
-
         if(RTA_PAYLOAD(rta[RTA_TABLE]) < sizeof(int)) {
             rec_log("error: %s: RTA_TABLE: payload too short", __func__);
             return(1);
         }
-        snprintf(table, sizeof(table), "%s", conv_rt_table(table_id, 0));
-        if(!strncmp(table, "unknown", sizeof(table)))
-            snprintf(table, sizeof(table), "%d", table_id);
+        ev.table = *(int *)RTA_DATA(rta[RTA_TABLE]);
     }
 
-    /* get multipath */
-    if(rta[RTA_MULTIPATH]) {
+    /* get multipath(nexthops of a nexthop object are not copied to a route) */
+    if(ev.flags & EVENT_F_NHID)
+        nh_num = 0;
+    else if(rta[RTA_MULTIPATH]) {
         struct rtnexthop *rtnh;
         int rtnh_len = RTA_PAYLOAD(rta[RTA_MULTIPATH]);
-        struct rtattr *rtna[__RTA_MAX];
-        char rtnh_ifname[IFNAMSIZ] = "";
-        char rtnh_nexthop[INET6_ADDRSTRLEN] = "";
 
         if(RTA_PAYLOAD(rta[RTA_MULTIPATH]) < sizeof(*rtnh)) {
             rec_log("error: %s: RTA_MULTIPATH: payload too short", __func__);
@@ -214,46 +247,139 @@ int parse_rtmsg(struct nlmsghdr *nlh)
         }
         rtnh = RTA_DATA(rta[RTA_MULTIPATH]);
 
-        for(; RTNH_OK(rtnh, rtnh_len);
+        /* a nexthop of multipath has an egress interface at least */
+        ev.flags |= EVENT_F_MULTIPATH | EVENT_F_OIF;
+        for(nh_num = 0; RTNH_OK(rtnh, rtnh_len);
             rtnh = RTNH_NEXT(rtnh), rtnh_len -= RTNH_ALIGN(rtnh->rtnh_len)) {
-            parse_rtattr(rtna, RTA_MAX, RTNH_DATA(rtnh), rtnh->rtnh_len - sizeof(*rtnh));
-
-            if(rtna[RTA_GATEWAY]) {
-                res = inet_ntop_ifa(rtm->rtm_family, rtna[RTA_GATEWAY],
-                    rtnh_nexthop, sizeof(rtnh_nexthop));
-                if(res) {
-                    rec_log("error: %s: RTA_GATEWAY: %s", __func__,
-                        (res == 1) ? strerror(errno) : "payload too short");
-                    return(1);
-                }
+            /* a route of too many nexthops is logged as notified without a mirror */
+            if(nh_num >= RIB_NEXTHOP_MAX) {
+                unmirror_rib(&ev);
+                if(nlh->nlmsg_flags & NLM_F_MULTI)
+                    return(0);
+                count_flap(&ev);
+                return(emit_rtnh_events(rtm->rtm_family, &ev, rta[RTA_MULTIPATH]));
             }
+            if(get_rtnh(rtm->rtm_family, rtnh, &nh[nh_num]))
+                return(1);
+            nh_num++;
+        }
+    }
+
+    /* count a route notified by an event(not by a dump) to track flapping */
+    if(!(nlh->nlmsg_flags & NLM_F_MULTI))
+        count_flap(&ev);
+
+    /* pass routing events to sinks through a routing table mirror */
+    return(update_rib(&ev, nh, nh_num, nlh->nlmsg_flags));
+}
+
+/*
+ * format a nexthop of routing event as text
+ */
+static char *add_rt_nexthop(char *msg, char *mp, int family, unsigned flags,
+    const unsigned char *gateway, int ifindex)
+{
+    char ifname[IFNAMSIZ] = "";
+
+    /* a nexthop of multipath is logged even without a gateway */
+    if(flags & (EVENT_F_GATEWAY | EVENT_F_MULTIPATH)) {
+        mp = add_str(msg, mp, "nexthop=");
+        if(flags & EVENT_F_GATEWAY)
+            mp = add_inet(msg, mp, family, gateway);
+        mp = add_str(msg, mp, " ");
+    }
 
-            /* get interface name & logging routing table message */
-            if_indextoname_from_lists(rtnh->rtnh_ifindex, rtnh_ifname);
-            if(nlh->nlmsg_type == RTM_NEWROUTE)
-                rec_log("%s route added: %snexthop=%s interface=%s "
-                    "%sweight=%d type=%s protocol=%s table=%s",
-                    ipv, msg, rtnh_nexthop, rtnh_ifname,
-                    metric, rtnh->rtnh_hops+1, type, proto, table);
-            else if(nlh->nlmsg_type == RTM_DELROUTE)
-                rec_log("%s route deleted: %snexthop=%s interface=%s " 
-                    "%sweight=%d type=%s protocol=%s table=%s",
-                    ipv, msg, rtnh_nexthop, rtnh_ifname,
-                    metric, rtnh->rtnh_hops+1, type, proto, table);
+    if(flags & EVENT_F_OIF) {
+        mp = add_str(msg, mp, "interface=");
+        mp = add_str(msg, mp, if_indextoname_from_lists(ifindex, ifname));
+        mp = add_str(msg, mp, " ");
+    }
+
+    return(mp);
+}
+
+/*
+ * format routing event as text(the prefix is formatted once for all nexthops)
+ */
+int format_rt_event(const struct event *ev, char *msg)
+{
+    char ifname[IFNAMSIZ] = "";
+    const char *table;
+    char *mp = msg;
+    int i;
+
+    mp = add_str(msg, mp, (ev->family == AF_INET6) ? "ipv6 route " : "ipv4 route ");
+    mp = add_str(msg, mp, conv_event_action(ev->action));
+    mp = add_str(msg, mp, ": destination=");
+    mp = add_inet(msg, mp, ev->family, ev->addr);
+    mp = add_str(msg, mp, "/");
+    mp = add_u32(msg, mp, ev->prefixlen);
+    mp = add_str(msg, mp, " ");
+
+    if(ev->flags & EVENT_F_SRC) {
+        mp = add_str(msg, mp, "source=");
+        mp = add_inet(msg, mp, ev->family, ev->src);
+        mp = add_str(msg, mp, "/");
+        mp = add_u32(msg, mp, ev->src_len);
+        mp = add_str(msg, mp, " ");
+    }
+
+    if(ev->flags & EVENT_F_PREFSRC) {
+        mp = add_str(msg, mp, "preferred-source=");
+        mp = add_inet(msg, mp, ev->family, ev->prefsrc);
+        mp = add_str(msg, mp, " ");
+    }
+
+    if(ev->tos) {
+        mp = add_str(msg, mp, "tos=0x");
+        mp = add_hex(msg, mp, ev->tos, 2);
+        mp = add_str(msg, mp, " ");
+    }
+
+    if(ev->flags & EVENT_F_IIF) {
+        mp = add_str(msg, mp, "in=");
+        mp = add_str(msg, mp, if_indextoname_from_lists(ev->iifindex, ifname));
+        mp = add_str(msg, mp, " ");
+    }
+
+    if(ev->flags & EVENT_F_NHID) {
+        mp = add_str(msg, mp, "nexthop-id=");
+        mp = add_u32(msg, mp, ev->nhid);
+        mp = add_str(msg, mp, " ");
+    }
+
+    if(ev->flags & EVENT_F_MULTIPATH) {
+        for(i = 0; i < ev->nh_num; i++) {
+            mp = add_rt_nexthop(msg, mp, ev->family, ev->flags | ev->nh[i].flags,
+                ev->nh[i].gateway, ev->nh[i].ifindex);
+            mp = add_str(msg, mp, "weight=");
+            mp = add_u32(msg, mp, ev->nh[i].weight);
+            mp = add_str(msg, mp, " ");
         }
+    } else
+        mp = add_rt_nexthop(msg, mp, ev->family, ev->flags, ev->gateway, ev->ifindex);
 
-        return(0);
+    if(ev->flags & EVENT_F_METRIC) {
+        mp = add_str(msg, mp, "metric=");
+        mp = add_u32(msg, mp, ev->metric);
+        mp = add_str(msg, mp, " ");
     }
 
-    /* logging routing message */
-    if(nlh->nlmsg_type == RTM_NEWROUTE)
-        rec_log("%s route added: %s%stype=%s protocol=%s table=%s",
-            ipv, msg, metric, type, proto, table);
-    else if(nlh->nlmsg_type == RTM_DELROUTE)
-        rec_log("%s route deleted: %s%stype=%s proto=%s table=%s",
-            ipv, msg, metric, type, proto, table);
+    mp = add_str(msg, mp, "type=");
+    mp = add_str(msg, mp, conv_rtn_type(ev->rtn_type, 0));
+    mp = add_str(msg, mp, (ev->action == EVENT_DELETED &&
+        !(ev->flags & EVENT_F_MULTIPATH)) ? " proto=" : " protocol=");
+    mp = add_str(msg, mp, conv_rtprot(ev->protocol, 0));
 
-    return(0);
+    /* convert from table id to table name */
+    mp = add_str(msg, mp, " table=");
+    table = conv_rt_table(ev->table, 0);
+    if(!strcmp(table, "unknown"))
+        mp = add_u32(msg, mp, ev->table);
+    else
+        mp = add_str(msg, mp, table);
+
+    return(mp ? 0 : -1);
 }
 
 /*
@@ -352,6 +478,12 @@ void debug_rtmsg(int lev, struct rtmsg *rtm, struct rtattr *rta[], int rtm_len)
             "RTA_MARK", NULL);
 #endif
 
+#ifdef HAVE_LINUX_NEXTHOP_H
+    if(rta[RTA_NH_ID])
+        debug_rta_u32(lev+1, rta[RTA_NH_ID],
+            "RTA_NH_ID", NULL);
+#endif
+
     rec_dbg(lev, "");
 
     return;
@@ -463,18 +595,20 @@ void debug_rta_cacheinfo(int lev, struct rtattr *rta, const char *name)
  */
 const char *conv_rt_table(int table, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _RT_TABLE(s1, s2) \
-    if(table == RT_TABLE_##s1) \
-        return(debug ? #s1 : #s2);
-    _RT_TABLE(UNSPEC, none);
+        [RT_TABLE_##s1] = { #s2, #s1 },
+        _RT_TABLE(UNSPEC, none)
 #if HAVE_DECL_RT_TABLE_COMPAT
-    _RT_TABLE(COMPAT, compat);
+        _RT_TABLE(COMPAT, compat)
 #endif
-    _RT_TABLE(DEFAULT, default);
-    _RT_TABLE(MAIN, main);
-    _RT_TABLE(LOCAL, local);
+        _RT_TABLE(DEFAULT, default)
+        _RT_TABLE(MAIN, main)
+        _RT_TABLE(LOCAL, local)
 #undef _RT_TABLE
-    return(debug ? "UNKNOWN" : "unknown");
+    };
+
+    return(CONV_NAME(names, table, debug, debug ? "UNKNOWN" : "unknown"));
 }
 
 /*
@@ -482,27 +616,29 @@ const char *conv_rt_table(int table, unsigned char debug)
  */
 const char *conv_rtprot(int protocol, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _RTM_PROTOCOL(s1, s2) \
-    if(protocol == RTPROT_##s1) \
-        return(debug ? #s1: #s2);
-    _RTM_PROTOCOL(UNSPEC, none);
-    _RTM_PROTOCOL(REDIRECT, redirect);
-    _RTM_PROTOCOL(KERNEL, kernel);
-    _RTM_PROTOCOL(BOOT, boot);
-    _RTM_PROTOCOL(STATIC, static);
-    _RTM_PROTOCOL(GATED, gated);
-    _RTM_PROTOCOL(RA, ra);
-    _RTM_PROTOCOL(MRT, ra);
-    _RTM_PROTOCOL(ZEBRA, zebra);
-    _RTM_PROTOCOL(BIRD, bird);
-    _RTM_PROTOCOL(DNROUTED, dnrouted);
-    _RTM_PROTOCOL(XORP, xorp);
-    _RTM_PROTOCOL(NTK, ntk);
+        [RTPROT_##s1] = { #s2, #s1 },
+        _RTM_PROTOCOL(UNSPEC, none)
+        _RTM_PROTOCOL(REDIRECT, redirect)
+        _RTM_PROTOCOL(KERNEL, kernel)
+        _RTM_PROTOCOL(BOOT, boot)
+        _RTM_PROTOCOL(STATIC, static)
+        _RTM_PROTOCOL(GATED, gated)
+        _RTM_PROTOCOL(RA, ra)
+        _RTM_PROTOCOL(MRT, ra)
+        _RTM_PROTOCOL(ZEBRA, zebra)
+        _RTM_PROTOCOL(BIRD, bird)
+        _RTM_PROTOCOL(DNROUTED, dnrouted)
+        _RTM_PROTOCOL(XORP, xorp)
+        _RTM_PROTOCOL(NTK, ntk)
 #if HAVE_DECL_RTPROT_DHCP
-    _RTM_PROTOCOL(DHCP, dhcp);
+        _RTM_PROTOCOL(DHCP, dhcp)
 #endif
 #undef _RTM_PROTOCOL
-    return(debug ? "UNKNOWN" : "unknown");
+    };
+
+    return(CONV_NAME(names, protocol, debug, debug ? "UNKNOWN" : "unknown"));
 }
 
 /*
@@ -510,16 +646,18 @@ const char *conv_rtprot(int protocol, unsigned char debug)
  */
 const char *conv_rt_scope(int scope)
 {
+    static const char *const names[][2] = {
 #define _RT_SCOPE(s) \
-    if(scope == RT_SCOPE_##s) \
-        return(#s);
-    _RT_SCOPE(UNIVERSE);
-    _RT_SCOPE(SITE);
-    _RT_SCOPE(LINK);
-    _RT_SCOPE(HOST);
-    _RT_SCOPE(NOWHERE);
+        [RT_SCOPE_##s] = { #s, #s },
+        _RT_SCOPE(UNIVERSE)
+        _RT_SCOPE(SITE)
+        _RT_SCOPE(LINK)
+        _RT_SCOPE(HOST)
+        _RT_SCOPE(NOWHERE)
 #undef _RT_SCOPE
-    return("UNKNOWN");
+    };
+
+    return(CONV_NAME(names, scope, 0, "UNKNOWN"));
 }
 
 /*
@@ -527,23 +665,25 @@ const char *conv_rt_scope(int scope)
  */
 const char *conv_rtn_type(int type, unsigned char debug)
 {
+    static const char *const names[][2] = {
 #define _RTN_TYPE(s1, s2) \
-    if(type == RTN_##s1) \
-        return(debug ? #s1 : #s2);
-    _RTN_TYPE(UNSPEC, none);
-    _RTN_TYPE(UNICAST, unicast);
-    _RTN_TYPE(LOCAL, local);
-    _RTN_TYPE(BROADCAST, broadcast);
-    _RTN_TYPE(ANYCAST, anycast);
-    _RTN_TYPE(MULTICAST, multicast);
-    _RTN_TYPE(BLACKHOLE, blackhole);
-    _RTN_TYPE(UNREACHABLE, unreachable);
-    _RTN_TYPE(PROHIBIT, prohibit);
-    _RTN_TYPE(THROW, throw);
-    _RTN_TYPE(NAT, nat);
-    _RTN_TYPE(XRESOLVE, external);
+        [RTN_##s1] = { #s2, #s1 },
+        _RTN_TYPE(UNSPEC, none)
+        _RTN_TYPE(UNICAST, unicast)
+        _RTN_TYPE(LOCAL, local)
+        _RTN_TYPE(BROADCAST, broadcast)
+        _RTN_TYPE(ANYCAST, anycast)
+        _RTN_TYPE(MULTICAST, multicast)
+        _RTN_TYPE(BLACKHOLE, blackhole)
+        _RTN_TYPE(UNREACHABLE, unreachable)
+        _RTN_TYPE(PROHIBIT, prohibit)
+        _RTN_TYPE(THROW, throw)
+        _RTN_TYPE(NAT, nat)
+        _RTN_TYPE(XRESOLVE, external)
 #undef _RTN_TYPE
-    return(debug ? "UNKNOWN" : "unknown");
+    };
+
+    return(CONV_NAME(names, type, debug, debug ? "UNKNOWN" : "unknown"));
 }
 
 /*
@@ -551,22 +691,18 @@ const char *conv_rtn_type(int type, unsigned char debug)
  */
 void conv_rtm_flags(int flags, char *flags_list, int len)
 {
-    if(!flags) {
-        strncpy(flags_list, "NONE", len);
-        return;
-    }
+    static const struct flag_name names[] = {
 #define _RTM_FLAGS(s) \
-    if((flags & RTM_F_##s) && (len - strlen(flags_list) - 1 > 0)) \
-        (flags &= ~RTM_F_##s) ? \
-            strncat(flags_list, #s ", ", len - strlen(flags_list) - 1) : \
-            strncat(flags_list, #s, len - strlen(flags_list) - 1);
-    _RTM_FLAGS(NOTIFY);
-    _RTM_FLAGS(CLONED);
-    _RTM_FLAGS(EQUALIZE);
-    _RTM_FLAGS(PREFIX);
+        { RTM_F_##s, #s },
+        _RTM_FLAGS(NOTIFY)
+        _RTM_FLAGS(CLONED)
+        _RTM_FLAGS(EQUALIZE)
+        _RTM_FLAGS(PREFIX)
 #undef _RTM_FLAGS
-    if(!strlen(flags_list))
-        strncpy(flags_list, "UNKNOWN", len);
+    };
+    static struct flag_table ft = FLAG_TABLE(names, ", ");
+
+    conv_flags(&ft, flags, flags_list, len);
 }
 
 /*
@@ -574,19 +710,15 @@ void conv_rtm_flags(int flags, char *flags_list, int len)
  */
 void conv_rtnh_flags(int flags, char *flags_list, int len)
 {
-    if(!flags) {
-        strncpy(flags_list, "NONE", len);
-        return;
-    }
+    static const struct flag_name names[] = {
 #define _RTNH_FLAGS(s) \
-    if((flags & RTNH_F_##s) && (len - strlen(flags_list) - 1 > 0)) \
-        (flags &= ~RTNH_F_##s) ? \
-            strncat(flags_list, #s ", ", len - strlen(flags_list) - 1) : \
-            strncat(flags_list, #s, len - strlen(flags_list) - 1);
-    _RTNH_FLAGS(DEAD);
-    _RTNH_FLAGS(PERVASIVE);
-    _RTNH_FLAGS(ONLINK);
+        { RTNH_F_##s, #s },
+        _RTNH_FLAGS(DEAD)
+        _RTNH_FLAGS(PERVASIVE)
+        _RTNH_FLAGS(ONLINK)
 #undef _RTNH_FLAGS
-    if(!strlen(flags_list))
-        strncpy(flags_list, "UNKNOWN", len);
+    };
+    static struct flag_table ft = FLAG_TABLE(names, ", ");
+
+    conv_flags(&ft, flags, flags_list, len);
 }
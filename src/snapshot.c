@@ -0,0 +1,162 @@
+/*
+ * snapshot.c - snapshot of lists written by a child process
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+#include <sys/wait.h>
+
+/* snapshot statistics */
+static struct {
+    pid_t pid;
+    unsigned long long started;
+    unsigned long long skipped;
+    unsigned long long failed;
+} snapshot_stats;
+
+/*
+ * write a snapshot in a child process with a copy-on-write image of lists
+ */
+int fork_snapshot(void (*dump)(void))
+{
+    pid_t pid;
+
+    /* a previous snapshot is still being written */
+    if(snapshot_stats.pid) {
+        rec_log("info: snapshot skipped while writing a previous one");
+        snapshot_stats.skipped++;
+        return(1);
+    }
+
+    pid = fork();
+    if(pid < 0) {
+        rec_log("error: %s: fork(): %s", __func__, strerror(errno));
+        return(-1);
+    }
+
+    if(!pid) {
+        /* no writer thread exists in a child */
+        detach_log_writer();
+        detach_iflist_requests();
+        dump();
+        _exit(0);
+    }
+    snapshot_stats.pid = pid;
+    snapshot_stats.started++;
+
+    return(0);
+}
+
+/*
+ * reap a child process which finished writing a snapshot
+ */
+void reap_snapshot(void)
+{
+    pid_t pid;
+    int status;
+
+    while((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        if(pid != snapshot_stats.pid)
+            continue;
+
+        snapshot_stats.pid = 0;
+        if(!WIFEXITED(status) || WEXITSTATUS(status)) {
+            rec_log("error: %s: snapshot process(PID: %ld) failed",
+                __func__, (long)pid);
+            snapshot_stats.failed++;
+        }
+    }
+}
+
+/*
+ * open a temporary file of a snapshot
+ */
+FILE *open_snapshot(const char *fname, char *tmp, int len)
+{
+    FILE *fp;
+
+    snprintf(tmp, len, "%s.%ld", fname, (long)getpid());
+    fp = fopen(tmp, "w");
+    if(fp == NULL)
+        rec_log("error: %s: can't open snapshot file(%s)", __func__, tmp);
+
+    return(fp);
+}
+
+/*
+ * close a temporary file and replace a snapshot with it atomically
+ */
+int close_snapshot(FILE *fp, const char *tmp, const char *fname)
+{
+    int err;
+
+    err = fflush(fp) || ferror(fp);
+    if(fclose(fp) || err) {
+        rec_log("error: %s: can't write snapshot file(%s)", __func__, tmp);
+        unlink(tmp);
+        return(-1);
+    }
+
+    if(rename(tmp, fname) < 0) {
+        rec_log("error: %s: rename(): %s", __func__, strerror(errno));
+        unlink(tmp);
+        return(-1);
+    }
+
+    return(0);
+}
+
+/*
+ * write a header line of a JSON lines snapshot
+ */
+void write_snapshot_header(FILE *fp, const char *table, unsigned entries)
+{
+    fprintf(fp, "{\"version\":%d,\"table\":\"%s\",\"time\":%ld,\"entries\":%u}\n",
+        SNAPSHOT_VERSION, table, (long)time(NULL), entries);
+}
+
+/*
+ * write a JSON string with escapes
+ */
+void write_json_str(FILE *fp, const char *str)
+{
+    const unsigned char *p;
+
+    fputc('"', fp);
+    for(p = (const unsigned char *)str; *p; p++) {
+        if(*p == '"' || *p == '\\')
+            fprintf(fp, "\\%c", *p);
+        else if(*p < 0x20)
+            fprintf(fp, "\\u%04x", *p);
+        else
+            fputc(*p, fp);
+    }
+    fputc('"', fp);
+}
+
+/*
+ * print statistics of snapshots
+ */
+void print_snapshot_stats(FILE *stats)
+{
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ snapshot statistics ]\n");
+    fprintf(stats, "started: %llu\n", snapshot_stats.started);
+    fprintf(stats, "skipped: %llu\n", snapshot_stats.skipped);
+    fprintf(stats, "failed: %llu\n", snapshot_stats.failed);
+    fprintf(stats, "in progress: %s\n", snapshot_stats.pid ? "yes" : "no");
+}
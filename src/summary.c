@@ -0,0 +1,256 @@
+/*
+ * summary.c - summaries of bursts of route events
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/* a group of route events summarized in a window */
+struct summary_group {
+    struct list_head list;
+    unsigned hash;
+    /* members below are compared to find a group */
+    unsigned char family;
+    unsigned char action;
+    unsigned char protocol;
+    unsigned char missed;
+    unsigned flags;
+    unsigned table;
+    int ifindex;
+    unsigned char gateway[16];
+    /* counters in a window */
+    unsigned events;
+    unsigned summarized;
+    int sample_num;
+    unsigned char sample_len[SUMMARY_SAMPLE_MAX];
+    unsigned char sample[SUMMARY_SAMPLE_MAX][16];
+};
+
+/* offset and size of members of a group compared to find it */
+#define SUMMARY_KEY offsetof(struct summary_group, family)
+#define SUMMARY_KEY_SIZE (offsetof(struct summary_group, events) - SUMMARY_KEY)
+
+/* length of a window in seconds(summaries are disabled with 0) */
+static int summary_window;
+
+/* number of events of a group logged individually in a window */
+static unsigned summary_threshold = SUMMARY_THRESHOLD_DEFAULT;
+
+/* groups in a current window */
+static struct list_head ghead = {&ghead, &ghead};
+static struct pool group_pool = POOL_INIT("route summary group", struct summary_group);
+
+/* summary statistics */
+static struct {
+    unsigned long long windows;
+    unsigned long long summaries;
+    unsigned long long summarized;
+} summary_stats;
+
+/*
+ * match a group with a key group
+ */
+static int match_summary_group(const void *entry, const void *key)
+{
+    return(!memcmp((const char *)entry + SUMMARY_KEY,
+        (const char *)key + SUMMARY_KEY, SUMMARY_KEY_SIZE));
+}
+
+/* index of groups in a current window */
+static struct hash_table group_hash = HASH_TABLE_INIT(match_summary_group);
+
+/*
+ * set a window and a threshold of summaries("window[:threshold]")
+ */
+int set_summary_option(char *arg)
+{
+    char *p = strchr(arg, ':');
+
+    summary_window = atoi(arg);
+    if(summary_window < 1)
+        return(-1);
+
+    if(p) {
+        if(atoi(p + 1) < 0)
+            return(-1);
+        summary_threshold = atoi(p + 1);
+    }
+
+    return(0);
+}
+
+/*
+ * start writing summaries at the end of every window
+ */
+int start_summary(void)
+{
+    if(!summary_window)
+        return(0);
+
+    return(add_loop_timer(summary_window, flush_summary));
+}
+
+/*
+ * count a route event in a group, and check whether it is summarized
+ */
+int summarize_event(const struct event *ev)
+{
+    struct summary_group key, *g;
+
+    if(!summary_window || ev->type != EVENT_ROUTE ||
+        (ev->action != EVENT_ADDED && ev->action != EVENT_DELETED &&
+        ev->action != EVENT_CHANGED))
+        return(0);
+
+    /* events are grouped by attributes shared by a burst of routes */
+    memset(&key, 0, sizeof(key));
+    key.family = ev->family;
+    key.action = ev->action;
+    key.protocol = ev->protocol;
+    key.missed = (ev->flags & EVENT_F_MISSED) ? 1 : 0;
+    /* multipath is grouped regardless of its nexthops */
+    key.flags = ev->flags & (EVENT_F_GATEWAY | EVENT_F_OIF | EVENT_F_MULTIPATH);
+    key.table = ev->table;
+    if(ev->flags & EVENT_F_MULTIPATH)
+        key.flags &= ~EVENT_F_OIF;
+    else if(ev->flags & EVENT_F_OIF)
+        key.ifindex = ev->ifindex;
+    if(ev->flags & EVENT_F_GATEWAY)
+        memcpy(key.gateway, ev->gateway, sizeof(key.gateway));
+    key.hash = hash_bytes((char *)&key + SUMMARY_KEY, SUMMARY_KEY_SIZE, 0);
+
+    g = hash_search(&group_hash, key.hash, &key);
+    if(!g) {
+        g = pool_alloc(&group_pool);
+        if(!g)
+            return(0);
+        memcpy(g, &key, sizeof(key));
+        if(hash_insert(&group_hash, g->hash, g) < 0) {
+            pool_free(&group_pool, g);
+            return(0);
+        }
+        list_init(&(g->list));
+        list_add(&(g->list), &ghead);
+    }
+
+    /* events below a threshold are logged individually */
+    if(++g->events <= summary_threshold)
+        return(0);
+
+    if(g->sample_num < SUMMARY_SAMPLE_MAX) {
+        memcpy(g->sample[g->sample_num], ev->addr, sizeof(g->sample[0]));
+        g->sample_len[g->sample_num] = ev->prefixlen;
+        g->sample_num++;
+    }
+    g->summarized++;
+    summary_stats.summarized++;
+
+    return(1);
+}
+
+/*
+ * write a summary of a group
+ */
+static void write_summary(struct summary_group *g)
+{
+    char msg[MAX_MSG_SIZE], ifname[IFNAMSIZ] = "";
+    const char *table;
+    char *mp = msg;
+    int i;
+
+    if(g->missed)
+        mp = add_str(msg, mp, "missed change: ");
+    mp = add_str(msg, mp, (g->family == AF_INET6) ? "ipv6 routes " : "ipv4 routes ");
+    mp = add_str(msg, mp, conv_event_action(g->action));
+    mp = add_str(msg, mp, " in summary: count=");
+    mp = add_u32(msg, mp, g->summarized);
+    mp = add_str(msg, mp, " ");
+
+    if(g->flags & EVENT_F_GATEWAY) {
+        mp = add_str(msg, mp, "nexthop=");
+        mp = add_inet(msg, mp, g->family, g->gateway);
+        mp = add_str(msg, mp, " ");
+    }
+
+    if(g->flags & EVENT_F_OIF) {
+        mp = add_str(msg, mp, "interface=");
+        mp = add_str(msg, mp, if_indextoname_from_lists(g->ifindex, ifname));
+        mp = add_str(msg, mp, " ");
+    }
+
+    if(g->flags & EVENT_F_MULTIPATH)
+        mp = add_str(msg, mp, "nexthop=multipath ");
+
+    mp = add_str(msg, mp, "protocol=");
+    mp = add_str(msg, mp, conv_rtprot(g->protocol, 0));
+
+    mp = add_str(msg, mp, " table=");
+    table = conv_rt_table(g->table, 0);
+    if(!strcmp(table, "unknown"))
+        mp = add_u32(msg, mp, g->table);
+    else
+        mp = add_str(msg, mp, table);
+
+    for(i = 0; i < g->sample_num; i++) {
+        mp = add_str(msg, mp, i ? "," : " samples=");
+        mp = add_inet(msg, mp, g->family, g->sample[i]);
+        mp = add_str(msg, mp, "/");
+        mp = add_u32(msg, mp, g->sample_len[i]);
+    }
+
+    rec_log("%s", msg);
+    summary_stats.summaries++;
+}
+
+/*
+ * write summaries of groups in a current window, and start a next window
+ */
+void flush_summary(void)
+{
+    struct list_head *l, *n;
+    struct summary_group *g;
+
+    list_for_each_safe(l, n, &ghead) {
+        g = list_entry(l, struct summary_group, list);
+        if(g->summarized)
+            write_summary(g);
+        hash_delete(&group_hash, g->hash, g);
+        list_del(&(g->list));
+        pool_free(&group_pool, g);
+    }
+    summary_stats.windows++;
+}
+
+/*
+ * print statistics of summaries
+ */
+void print_summary_stats(FILE *stats)
+{
+    if(!summary_window)
+        return;
+
+    fprintf(stats, "\n");
+    fprintf(stats, "*********************************************************************\n");
+    fprintf(stats, "[ route summary statistics ]\n");
+    fprintf(stats, "window: %d second\n", summary_window);
+    fprintf(stats, "threshold: %u events\n", summary_threshold);
+    fprintf(stats, "windows: %llu\n", summary_stats.windows);
+    fprintf(stats, "groups in a current window: %u\n", group_hash.count);
+    fprintf(stats, "summaries: %llu\n", summary_stats.summaries);
+    fprintf(stats, "summarized events: %llu\n", summary_stats.summarized);
+    print_hash_stats(stats, "route summary group table", &group_hash);
+    print_pool_stats(stats, &group_pool);
+}
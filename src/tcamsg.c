@@ -27,7 +27,7 @@ int parse_tcamsg(struct nlmsghdr *nlh)
     struct tcamsg *tcam;
     int tcam_len;
     struct rtattr *tcaa[TCAA_MAX+1];
-    char msg[MAX_MSG_SIZE] = "";
+    char msg[MAX_MSG_SIZE];
     char *mp = msg;
     int log_opts = get_log_opts();
 
@@ -53,10 +53,10 @@ int parse_tcamsg(struct nlmsghdr *nlh)
     /* kind of message */
     switch(nlh->nlmsg_type) {
         case RTM_NEWACTION:
-            mp = add_log(msg, mp, "tc action added: ");
+            mp = add_str(msg, mp, "tc action added: ");
             break;
         case RTM_DELACTION:
-            mp = add_log(msg, mp, "tc action deleted: ");
+            mp = add_str(msg, mp, "tc action deleted: ");
             break;
         default:
             return(1);
@@ -95,52 +95,26 @@ int parse_tca_act(char *msg, char *mp, struct rtattr *acts)
 {
     struct rtattr *act[__TCA_ACT_MAX];
     char kind[IFNAMSIZ] = "";
+    const struct act_kind *ak;
 
-    mp = add_log(msg, mp, "order=%d ", acts->rta_type);
+    mp = add_str(msg, mp, "order=");
+    mp = add_s32(msg, mp, acts->rta_type);
+    mp = add_str(msg, mp, " ");
 
     parse_nested_rtattr(act, __TCA_ACT_MAX-1, acts);
 
     if(act[TCA_ACT_KIND]) {
         strncpy(kind, (char *)RTA_DATA(act[TCA_ACT_KIND]), sizeof(kind));
-        mp = add_log(msg, mp, "action=%s ", kind);
+        mp = add_str(msg, mp, "action=");
+        mp = add_str(msg, mp, kind);
+        mp = add_str(msg, mp, " ");
     }
 
-    if(act[TCA_ACT_OPTIONS]) {
-        if(!strncmp(kind, "police", sizeof(kind))) {
-            if(parse_tca_act_options_police(msg, mp, act[TCA_ACT_OPTIONS]))
-                return(1);
-            return(0);
-        } else if(!strncmp(kind, "gact", sizeof(kind))) {
-            if(parse_tca_act_options_gact(msg, mp, act[TCA_ACT_OPTIONS]))
-                return(1);
-            return(0);
-        } else if(!strncmp(kind, "pedit", sizeof(kind))) {
-            if(parse_tca_act_options_pedit(msg, mp, act[TCA_ACT_OPTIONS]))
-                return(1);
-            return(0);
-        } else if(!strncmp(kind, "mirred", sizeof(kind))) {
-            if(parse_tca_act_options_mirred(msg, mp, act[TCA_ACT_OPTIONS]))
-                return(1);
-            return(0);
-#ifdef HAVE_LINUX_TC_ACT_TC_NAT_H
-        } else if(!strncmp(kind, "nat", sizeof(kind))) {
-            if(parse_tca_act_options_nat(msg, mp, act[TCA_ACT_OPTIONS]))
-                return(1);
-            return(0);
-#endif
-#ifdef HAVE_LINUX_TC_ACT_TC_SKBEDIT_H
-        } else if(!strncmp(kind, "skbedit", sizeof(kind))) {
-            if(parse_tca_act_options_skbedit(msg, mp, act[TCA_ACT_OPTIONS]))
-                return(1);
-            return(0);
-#endif
-#ifdef HAVE_LINUX_TC_ACT_TC_CSUM_H
-        } else if(!strncmp(kind, "csum", sizeof(kind))) {
-            if(parse_tca_act_options_csum(msg, mp, act[TCA_ACT_OPTIONS]))
-                return(1);
-            return(0);
-#endif
-        }
+    ak = find_act_kind(kind, sizeof(kind));
+    if(act[TCA_ACT_OPTIONS] && ak) {
+        if(ak->parse(msg, mp, act[TCA_ACT_OPTIONS]))
+            return(1);
+        return(0);
     }
 
     rec_log("%s", msg);
@@ -230,28 +204,13 @@ void debug_tca_act(int lev, struct rtattr *acts)
 void debug_tca_act_options(int lev, struct rtattr *act,
     const char *name, char *kind, int len)
 {
+    const struct act_kind *ak;
+
     rec_dbg(lev, "%s(%hu):", name, RTA_ALIGN(act->rta_len));
 
-    if(!strncmp(kind, "police", len))
-        debug_tca_act_options_police(lev, act, NULL);
-    else if(!strncmp(kind, "gact", len))
-        debug_tca_act_options_gact(lev, act);
-    else if(!strncmp(kind, "pedit", len))
-        debug_tca_act_options_pedit(lev, act);
-    else if(!strncmp(kind, "mirred", len))
-        debug_tca_act_options_mirred(lev, act);
-#ifdef HAVE_LINUX_TC_ACT_TC_NAT_H
-    else if(!strncmp(kind, "nat", len))
-        debug_tca_act_options_nat(lev, act);
-#endif
-#ifdef HAVE_LINUX_TC_ACT_TC_SKBEDIT_H
-    else if(!strncmp(kind, "skbedit", len))
-        debug_tca_act_options_skbedit(lev, act);
-#endif
-#ifdef HAVE_LINUX_TC_ACT_TC_CSUM_H
-    else if(!strncmp(kind, "csum", len))
-        debug_tca_act_options_csum(lev, act);
-#endif
+    ak = find_act_kind(kind, len);
+    if(ak)
+        ak->debug(lev, act);
     else
         rec_dbg(lev, "    -- unknown action %s --", kind);
 }
@@ -41,9 +41,13 @@ int parse_tca_act_options_csum(char *msg, char *mp, struct rtattr *act)
         conv_tca_csum_update_flags(parms->update_flags,
             flags_list, sizeof(flags_list), 0);
     
-        mp = add_log(msg, mp, "index=%d protocol=%s next=%s ",
-            parms->index, flags_list,
-            conv_tc_action(parms->action, 0));
+        mp = add_str(msg, mp, "index=");
+        mp = add_s32(msg, mp, parms->index);
+        mp = add_str(msg, mp, " protocol=");
+        mp = add_str(msg, mp, flags_list);
+        mp = add_str(msg, mp, " next=");
+        mp = add_str(msg, mp, conv_tc_action(parms->action, 0));
+        mp = add_str(msg, mp, " ");
     }
 
     rec_log("%s", msg);
@@ -37,8 +37,11 @@ int parse_tca_act_options_gact(char *msg, char *mp, struct rtattr *act)
         }
         parms = (struct tc_gact *)RTA_DATA(gact[TCA_GACT_PARMS]);
 
-        mp = add_log(msg, mp, "index=%d kind=%s ",
-            parms->index, conv_tc_action(parms->action, 0));
+        mp = add_str(msg, mp, "index=");
+        mp = add_s32(msg, mp, parms->index);
+        mp = add_str(msg, mp, " kind=");
+        mp = add_str(msg, mp, conv_tc_action(parms->action, 0));
+        mp = add_str(msg, mp, " ");
     }
 
     if(gact[TCA_GACT_PROB]) {
@@ -50,9 +53,13 @@ int parse_tca_act_options_gact(char *msg, char *mp, struct rtattr *act)
         }
         prob = (struct tc_gact_p *)RTA_DATA(gact);
 
-        mp = add_log(msg, mp, "random(type/value/action)=%s/%d/%s ",
-            conv_pgact(prob->ptype, 0), prob->pval,
-            conv_tc_action(prob->paction, 0));
+        mp = add_str(msg, mp, "random(type/value/action)=");
+        mp = add_str(msg, mp, conv_pgact(prob->ptype, 0));
+        mp = add_str(msg, mp, "/");
+        mp = add_s32(msg, mp, prob->pval);
+        mp = add_str(msg, mp, "/");
+        mp = add_str(msg, mp, conv_tc_action(prob->paction, 0));
+        mp = add_str(msg, mp, " ");
     }
 
     rec_log("%s", msg);
@@ -39,9 +39,15 @@ int parse_tca_act_options_mirred(char *msg, char *mp, struct rtattr *act)
         parms = (struct tc_mirred *)RTA_DATA(mirred[TCA_MIRRED_PARMS]);
         if_indextoname_from_lists(parms->ifindex, ifname);
     
-        mp = add_log(msg, mp, "index=%d %s to=%s next=%s ",
-            parms->index, conv_tca_mirred_action(parms->eaction, 0),
-            ifname, conv_tc_action(parms->action, 0));
+        mp = add_str(msg, mp, "index=");
+        mp = add_s32(msg, mp, parms->index);
+        mp = add_str(msg, mp, " ");
+        mp = add_str(msg, mp, conv_tca_mirred_action(parms->eaction, 0));
+        mp = add_str(msg, mp, " to=");
+        mp = add_str(msg, mp, ifname);
+        mp = add_str(msg, mp, " next=");
+        mp = add_str(msg, mp, conv_tc_action(parms->action, 0));
+        mp = add_str(msg, mp, " ");
     }
 
     rec_log("%s", msg);
@@ -48,9 +48,17 @@ int parse_tca_act_options_nat(char *msg, char *mp, struct rtattr *act)
             if(parms->mask & (1 << i))
                 ++mask;
     
-        mp = add_log(msg, mp, "index=%d from=%s/%d to=%s direction=%s ",
-            parms->index, old, mask, new,
-            (parms->flags & TCA_NAT_FLAG_EGRESS) ? "egress" : "ingress");
+        mp = add_str(msg, mp, "index=");
+        mp = add_s32(msg, mp, parms->index);
+        mp = add_str(msg, mp, " from=");
+        mp = add_str(msg, mp, old);
+        mp = add_str(msg, mp, "/");
+        mp = add_s32(msg, mp, mask);
+        mp = add_str(msg, mp, " to=");
+        mp = add_str(msg, mp, new);
+        mp = add_str(msg, mp, " direction=");
+        mp = add_str(msg, mp, (parms->flags & TCA_NAT_FLAG_EGRESS) ? "egress" : "ingress");
+        mp = add_str(msg, mp, " ");
     }
 
     rec_log("%s", msg);
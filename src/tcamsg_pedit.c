@@ -46,7 +46,9 @@ int parse_tca_act_options_pedit(char *msg, char *mp, struct rtattr *act)
             return(1);
         }
 
-        mp = add_log(msg, mp, "index=%d ", parms->index);
+        mp = add_str(msg, mp, "index=");
+        mp = add_s32(msg, mp, parms->index);
+        mp = add_str(msg, mp, " ");
         mp_tmp = mp;
     
         keys = parms->keys;
@@ -56,11 +58,23 @@ int parse_tca_act_options_pedit(char *msg, char *mp, struct rtattr *act)
         }
     
         for(i = 0; i < parms->nkeys; i++, keys++, mp = mp_tmp) {
-            mp = add_log(msg, mp, "key=%d value=0x%08x/0x%08x offset=%d "
-                "at=%d offmask=0x%08x shift=%d next=%s ",
-                i+1, ntohl(keys->val), ntohl(keys->mask), keys->off,
-                keys->at, ntohl(keys->offmask), keys->shift,
-                conv_tc_action(parms->action, 0));
+            mp = add_str(msg, mp, "key=");
+            mp = add_s32(msg, mp, i+1);
+            mp = add_str(msg, mp, " value=0x");
+            mp = add_hex(msg, mp, ntohl(keys->val), 8);
+            mp = add_str(msg, mp, "/0x");
+            mp = add_hex(msg, mp, ntohl(keys->mask), 8);
+            mp = add_str(msg, mp, " offset=");
+            mp = add_s32(msg, mp, keys->off);
+            mp = add_str(msg, mp, " at=");
+            mp = add_s32(msg, mp, keys->at);
+            mp = add_str(msg, mp, " offmask=0x");
+            mp = add_hex(msg, mp, ntohl(keys->offmask), 8);
+            mp = add_str(msg, mp, " shift=");
+            mp = add_s32(msg, mp, keys->shift);
+            mp = add_str(msg, mp, " next=");
+            mp = add_str(msg, mp, conv_tc_action(parms->action, 0));
+            mp = add_str(msg, mp, " ");
             rec_log("%s", msg);
         }
 
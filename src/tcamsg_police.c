@@ -44,7 +44,9 @@ int parse_tca_act_options_police(char *msg, char *mp, struct rtattr *act)
         }
         tc_police = (struct tc_police *)RTA_DATA(police[TCA_POLICE_TBF]);
     
-        mp = add_log(msg, mp, "index=%d ", tc_police->index);
+        mp = add_str(msg, mp, "index=");
+        mp = add_s32(msg, mp, tc_police->index);
+        mp = add_str(msg, mp, " ");
     
         get_us2tick();
         conv_unit_rate(rate, sizeof(rate), tc_police->rate.rate);
@@ -53,7 +55,11 @@ int parse_tca_act_options_police(char *msg, char *mp, struct rtattr *act)
         rate_latency = get_latency(tc_police->rate.rate,
             tc_police->burst, tc_police->limit);
     
-        mp = add_log(msg, mp, "rate=%s burst=%s ", rate, burst);
+        mp = add_str(msg, mp, "rate=");
+        mp = add_str(msg, mp, rate);
+        mp = add_str(msg, mp, " burst=");
+        mp = add_str(msg, mp, burst);
+        mp = add_str(msg, mp, " ");
     
         if(tc_police->peakrate.rate) {
             conv_unit_rate(peakrate, sizeof(peakrate), tc_police->peakrate.rate);
@@ -63,7 +69,11 @@ int parse_tca_act_options_police(char *msg, char *mp, struct rtattr *act)
                 get_latency(tc_police->peakrate.rate,
                     tc_police->mtu, tc_police->limit);
 
-            mp = add_log(msg, mp, "peakrate=%s minburst=%s ", peakrate, mtu);
+            mp = add_str(msg, mp, "peakrate=");
+            mp = add_str(msg, mp, peakrate);
+            mp = add_str(msg, mp, " minburst=");
+            mp = add_str(msg, mp, mtu);
+            mp = add_str(msg, mp, " ");
         }
     
         if(rate_latency < peakrate_latency)
@@ -71,8 +81,11 @@ int parse_tca_act_options_police(char *msg, char *mp, struct rtattr *act)
         else
             conv_unit_usec(latency, sizeof(latency), rate_latency);
     
-        mp = add_log(msg, mp, "latency=%s exceed=%s ",
-            latency, conv_tc_police_action(tc_police->action, 0));
+        mp = add_str(msg, mp, "latency=");
+        mp = add_str(msg, mp, latency);
+        mp = add_str(msg, mp, " exceed=");
+        mp = add_str(msg, mp, conv_tc_police_action(tc_police->action, 0));
+        mp = add_str(msg, mp, " ");
     }
 
     rec_log("%s", msg);
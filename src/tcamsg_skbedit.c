@@ -36,7 +36,9 @@ int parse_tca_act_options_skbedit(char *msg, char *mp, struct rtattr *act)
             return(1);
         }
         parms = (struct tc_skbedit *)RTA_DATA(skb[TCA_SKBEDIT_PARMS]);
-        mp = add_log(msg, mp, "index=%d ", parms->index);
+        mp = add_str(msg, mp, "index=");
+        mp = add_s32(msg, mp, parms->index);
+        mp = add_str(msg, mp, " ");
     }
 
     if(skb[TCA_SKBEDIT_PRIORITY]) {
@@ -44,8 +46,9 @@ int parse_tca_act_options_skbedit(char *msg, char *mp, struct rtattr *act)
             rec_log("error: %s: TCA_SKBEDIT_PRIORITY: payload too short", __func__);
             return(1);
         }
-        mp = add_log(msg, mp, "priority=0x%x ",
-            *(unsigned *)RTA_DATA(skb[TCA_SKBEDIT_PRIORITY]));
+        mp = add_str(msg, mp, "priority=0x");
+        mp = add_hex(msg, mp, *(unsigned *)RTA_DATA(skb[TCA_SKBEDIT_PRIORITY]), 0);
+        mp = add_str(msg, mp, " ");
     }
 
     if(skb[TCA_SKBEDIT_QUEUE_MAPPING]) {
@@ -53,8 +56,9 @@ int parse_tca_act_options_skbedit(char *msg, char *mp, struct rtattr *act)
             rec_log("error: %s: TCA_SKBEDIT_QUEUE_MAPPING: payload too short", __func__);
             return(1);
         }
-        mp = add_log(msg, mp, "queue-mapping=%u ",
-            *(unsigned *)RTA_DATA(skb[TCA_SKBEDIT_QUEUE_MAPPING]));
+        mp = add_str(msg, mp, "queue-mapping=");
+        mp = add_u32(msg, mp, *(unsigned *)RTA_DATA(skb[TCA_SKBEDIT_QUEUE_MAPPING]));
+        mp = add_str(msg, mp, " ");
     }
 
 #if HAVE_DECL_TCA_SKBEDIT_MARK
@@ -63,13 +67,17 @@ int parse_tca_act_options_skbedit(char *msg, char *mp, struct rtattr *act)
             rec_log("error: %s: TCA_SKBEDIT_MARK: payload too short", __func__);
             return(1);
         }
-        mp = add_log(msg, mp, "mark=%u ",
-            *(unsigned *)RTA_DATA(skb[TCA_SKBEDIT_MARK]));
+        mp = add_str(msg, mp, "mark=");
+        mp = add_u32(msg, mp, *(unsigned *)RTA_DATA(skb[TCA_SKBEDIT_MARK]));
+        mp = add_str(msg, mp, " ");
     }
 #endif
 
-    if(parms)
-        mp = add_log(msg, mp, "next=%s ", conv_tc_action(parms->action, 0));
+    if(parms) {
+        mp = add_str(msg, mp, "next=");
+        mp = add_str(msg, mp, conv_tc_action(parms->action, 0));
+        mp = add_str(msg, mp, " ");
+    }
 
     rec_log("%s", msg);
 
@@ -27,12 +27,13 @@ int parse_tcmsg_filter(struct nlmsghdr *nlh)
     struct tcmsg *tcm;
     int tcm_len;
     struct rtattr *tca[__TCA_MAX];
-    char msg[MAX_MSG_SIZE] = "";
+    char msg[MAX_MSG_SIZE];
     char *mp = msg;
     char ifname[IFNAMSIZ];
     char handle[MAX_STR_SIZE] = "";
     char kind[IFNAMSIZ] = "(unknown)";
     char proto[MAX_STR_SIZE];
+    const struct tc_kind *tk;
     int log_opts = get_log_opts();
 
     /* debug nlmsghdr */
@@ -57,10 +58,10 @@ int parse_tcmsg_filter(struct nlmsghdr *nlh)
     /* kind of message */
     switch(nlh->nlmsg_type) {
         case RTM_NEWTFILTER:
-            mp = add_log(msg, mp, "tc filter added: ");
+            mp = add_str(msg, mp, "tc filter added: ");
             break;
         case RTM_DELTFILTER:
-            mp = add_log(msg, mp, "tc filter deleted: ");
+            mp = add_str(msg, mp, "tc filter deleted: ");
             break;
         default:
             rec_log("error: %s: nlmsg_type: unknown message", __func__);
@@ -70,75 +71,48 @@ int parse_tcmsg_filter(struct nlmsghdr *nlh)
     /* get interface name */
     if_indextoname_from_lists(tcm->tcm_ifindex, ifname);
 
-    mp = add_log(msg, mp, "interface=%s ", ifname); 
+    mp = add_str(msg, mp, "interface=");
+    mp = add_str(msg, mp, ifname);
 
     /* get qdisc kind */
     if(tca[TCA_KIND])
         strncpy(kind, (char *)RTA_DATA(tca[TCA_KIND]), sizeof(kind));
 
     /* get filter handle */
-    if(!strncmp(kind, "u32", sizeof(kind)))
+    mp = add_str(msg, mp, " handle=");
+    if(!strncmp(kind, "u32", sizeof(kind))) {
         parse_u32_handle(handle, sizeof(handle), tcm->tcm_handle);
-    else
-        snprintf(handle, sizeof(handle), "0x%x", tcm->tcm_handle);
-
-    mp = add_log(msg, mp, "handle=%s ", handle);
+        mp = add_str(msg, mp, handle);
+    } else {
+        mp = add_str(msg, mp, "0x");
+        mp = add_hex(msg, mp, tcm->tcm_handle, 0);
+    }
 
     /* get priority */
-    mp = add_log(msg, mp, "priority=%u ", TC_H_MAJ(tcm->tcm_info)>>16);
+    mp = add_str(msg, mp, " priority=");
+    mp = add_u32(msg, mp, TC_H_MAJ(tcm->tcm_info)>>16);
 
     /* get priority */
     strncpy(proto, conv_eth_p(ntohs(TC_H_MIN(tcm->tcm_info)), 0), sizeof(proto));
+    mp = add_str(msg, mp, " protocol=");
     if(strlen(proto))
-        mp = add_log(msg, mp, "protocol=%s ", proto);
-    else
-        mp = add_log(msg, mp, "protocol=0x%04x ", ntohs(TC_H_MIN(tcm->tcm_info)));
+        mp = add_str(msg, mp, proto);
+    else {
+        mp = add_str(msg, mp, "0x");
+        mp = add_hex(msg, mp, ntohs(TC_H_MIN(tcm->tcm_info)), 4);
+    }
 
     /* get filter options */
-    mp = add_log(msg, mp, "filter=%s ", kind);
+    mp = add_str(msg, mp, " filter=");
+    mp = add_str(msg, mp, kind);
+    mp = add_str(msg, mp, " ");
 
-    if(tca[TCA_OPTIONS]) {
-        if(!strncmp(kind, "u32", sizeof(kind))) {
-            if(parse_tca_options_u32(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-            return(0);
-#if HAVE_DECL_TCA_RSVP_UNSPEC
-        } else if(!strncmp(kind, "rsvp", sizeof(kind))) {
-            if(parse_tca_options_rsvp(msg, &mp, tcm, tca[TCA_OPTIONS]))
-                return(1);
-            return(0);
-#endif
-        } else if(!strncmp(kind, "route", sizeof(kind))) {
-            if(parse_tca_options_route(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-            return(0);
-        } else if(!strncmp(kind, "fw", sizeof(kind))) {
-            if(parse_tca_options_fw(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-            return(0);
-#if HAVE_DECL_TCA_TCINDEX_UNSPEC
-        } else if(!strncmp(kind, "tcindex", sizeof(kind))) {
-            if(parse_tca_options_tcindex(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-            return(0);
-#endif
-#if HAVE_DECL_TCA_FLOW_UNSPEC
-        } else if(!strncmp(kind, "flow", sizeof(kind))) {
-            if(parse_tca_options_flow(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-            return(0);
-#endif
-        } else if(!strncmp(kind, "basic", sizeof(kind))) {
-            if(parse_tca_options_basic(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-            return(0);
-#if HAVE_DECL_TCA_CGROUP_UNSPEC
-        } else if(!strncmp(kind, "cgroup", sizeof(kind))) {
-            if(parse_tca_options_cgroup(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
+    tk = find_tc_kind(kind, sizeof(kind));
+    if(tca[TCA_OPTIONS] && tk && (tk->flags & TC_KIND_FILTER) && tk->parse) {
+        if(tk->parse(msg, &mp, tcm, tca[TCA_OPTIONS]))
+            return(1);
+        if(tk->flags & TC_KIND_F_LOG)
             return(0);
-#endif
-        }
     }
 
     rec_log("%s", msg);
@@ -158,7 +132,9 @@ int parse_tca_classid(char *msg, char **mp, struct rtattr *tca)
         return(1);
     }
     parse_tc_handle(classid, sizeof(classid), *(unsigned *)RTA_DATA(tca));
-    *mp = add_log(msg, *mp, "classid=%s ", classid);
+    *mp = add_str(msg, *mp, "classid=");
+    *mp = add_str(msg, *mp, classid);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -178,7 +154,9 @@ int parse_tca_indev(char *msg, char **mp, struct rtattr *tca)
         return(1);
     }
     strncpy(name, (char *)RTA_DATA(tca), sizeof(name));
-    *mp = add_log(msg, *mp, "in=%s ", name);
+    *mp = add_str(msg, *mp, "in=");
+    *mp = add_str(msg, *mp, name);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -192,7 +170,9 @@ int parse_tca_mask(char *msg, char **mp, struct rtattr *tca)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "mask=0x%08x ", *(unsigned *)RTA_DATA(tca));
+    *mp = add_str(msg, *mp, "mask=0x");
+    *mp = add_hex(msg, *mp, *(unsigned *)RTA_DATA(tca), 8);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -276,7 +256,9 @@ int parse_tca_ematch_tree_list(char *msg, char *mp, struct rtattr *em_tree, int
             return(1);
         }
         hdr = (struct tcf_ematch_hdr *)RTA_DATA(em_list[i]);
-        mp = add_log(msg, mp, "ematch=%s ", conv_tcf_em_kind(hdr->kind, 0));
+        mp = add_str(msg, mp, "ematch=");
+        mp = add_str(msg, mp, conv_tcf_em_kind(hdr->kind, 0));
+        mp = add_str(msg, mp, " ");
 
         /* use (char*)hdr in order to count by one byte */
         switch(hdr->kind) {
@@ -334,11 +316,21 @@ int parse_ematch_cmp(char *msg, char *mp, void *p, int len)
     }
     cmp = (struct tcf_em_cmp *)p;
 
-    mp = add_log(msg, mp,
-        "layer=%d align=%s flag=%s operand=%s value=0x%08x mask=0x%08x offset=%hu ",
-        cmp->layer, conv_tcf_em_align(cmp->align, 0),
-        cmp->flags ? "trans" : "none", conv_tcf_em_opnd(cmp->opnd, 0),
-        cmp->val, cmp->mask, cmp->off);
+    mp = add_str(msg, mp, "layer=");
+    mp = add_s32(msg, mp, cmp->layer);
+    mp = add_str(msg, mp, " align=");
+    mp = add_str(msg, mp, conv_tcf_em_align(cmp->align, 0));
+    mp = add_str(msg, mp, " flag=");
+    mp = add_str(msg, mp, cmp->flags ? "trans" : "none");
+    mp = add_str(msg, mp, " operand=");
+    mp = add_str(msg, mp, conv_tcf_em_opnd(cmp->opnd, 0));
+    mp = add_str(msg, mp, " value=0x");
+    mp = add_hex(msg, mp, cmp->val, 8);
+    mp = add_str(msg, mp, " mask=0x");
+    mp = add_hex(msg, mp, cmp->mask, 8);
+    mp = add_str(msg, mp, " offset=");
+    mp = add_u32(msg, mp, cmp->off);
+    mp = add_str(msg, mp, " ");
 
     rec_log("%s", msg);
 
@@ -354,7 +346,7 @@ int parse_ematch_nbyte(char *msg, char *mp, void *p, int len)
 {
     struct tcf_em_nbyte *nbyte;
     int i;
-    char *data;
+    char *data, c[2] = "";
 
     if(len < sizeof(struct tcf_em_nbyte)) {
         rec_log("error: %s: tcf_em_nbyte: payload too short", __func__);
@@ -369,19 +361,24 @@ int parse_ematch_nbyte(char *msg, char *mp, void *p, int len)
 
     data = (char *)nbyte + sizeof(*nbyte);
 
-    mp = add_log(msg, mp, "layer=%d ", nbyte->layer);
+    mp = add_str(msg, mp, "layer=");
+    mp = add_s32(msg, mp, nbyte->layer);
+    mp = add_str(msg, mp, " ");
 
     for(i = 0; i < nbyte->len; i++) {
         if(!i)
-            mp = add_log(msg, mp, "value=\"");
+            mp = add_str(msg, mp, "value=\"");
 
-        mp = add_log(msg, mp, "%c", isprint(data[i]) ? data[i] : '.');
+        c[0] = isprint(data[i]) ? data[i] : '.';
+        mp = add_str(msg, mp, c);
 
         if(nbyte->len - i == 1)
-            mp = add_log(msg, mp, "\"");
+            mp = add_str(msg, mp, "\"");
     }
 
-    mp = add_log(msg, mp, " offset=%hu ", nbyte->off);
+    mp = add_str(msg, mp, " offset=");
+    mp = add_u32(msg, mp, nbyte->off);
+    mp = add_str(msg, mp, " ");
 
     rec_log("%s", msg);
 
@@ -402,8 +399,14 @@ int parse_ematch_u32(char *msg, char *mp, void *p, int len)
     }
     key = (struct tc_u32_key *)p;
 
-    mp = add_log(msg, mp, "value=0x%08x mask=0x%08x offset=%d offmask=0x%08x",
-        ntohl(key->val), ntohl(key->mask), key->off, key->offmask);
+    mp = add_str(msg, mp, "value=0x");
+    mp = add_hex(msg, mp, ntohl(key->val), 8);
+    mp = add_str(msg, mp, " mask=0x");
+    mp = add_hex(msg, mp, ntohl(key->mask), 8);
+    mp = add_str(msg, mp, " offset=");
+    mp = add_s32(msg, mp, key->off);
+    mp = add_str(msg, mp, " offmask=0x");
+    mp = add_hex(msg, mp, key->offmask, 8);
 
     rec_log("%s", msg);
 
@@ -435,7 +438,7 @@ int parse_ematch_meta(char *msg, char *mp, void *p, int len)
         return(1);
     }
 
-    mp = add_log(msg, mp, "match=(");
+    mp = add_str(msg, mp, "match=(");
 
     if(meta[TCA_EM_META_LVALUE]) {
         if(parse_tca_em_meta_value(msg, &mp, left, meta[TCA_EM_META_LVALUE]))
@@ -445,7 +448,8 @@ int parse_ematch_meta(char *msg, char *mp, void *p, int len)
         return(1);
     }
 
-    mp = add_log(msg, mp, "%s ", conv_tcf_em_opnd(left->op, 0));
+    mp = add_str(msg, mp, conv_tcf_em_opnd(left->op, 0));
+    mp = add_str(msg, mp, " ");
 
     if(meta[TCA_EM_META_RVALUE]) {
         if(parse_tca_em_meta_value(msg, &mp, right, meta[TCA_EM_META_RVALUE]))
@@ -454,7 +458,7 @@ int parse_ematch_meta(char *msg, char *mp, void *p, int len)
         rec_log("error: %s: TCA_EM_META_RVALUE: no attribute", __func__);
         return(1);
     }
-    mp = add_log(msg, mp, ") ");
+    mp = add_str(msg, mp, ") ");
 
     rec_log("%s", msg);
 
@@ -469,18 +473,25 @@ int parse_tca_em_meta_value(char *msg, char **mp, struct tcf_meta_val *val, stru
     int id = TCF_META_ID(val->kind);
     int type = TCF_META_TYPE(val->kind);
     char *data = (char *)RTA_DATA(meta);
+    char c[2] = "";
     int i;
 
     if(id != TCF_META_ID_VALUE) {
-        *mp = add_log(msg, *mp, "%s ", conv_tcf_meta_id(id, 0));
-        if(val->shift)
-            *mp = add_log(msg, *mp, "shift %d ", val->shift);
+        *mp = add_str(msg, *mp, conv_tcf_meta_id(id, 0));
+        *mp = add_str(msg, *mp, " ");
+        if(val->shift) {
+            *mp = add_str(msg, *mp, "shift ");
+            *mp = add_s32(msg, *mp, val->shift);
+            *mp = add_str(msg, *mp, " ");
+        }
         if(type == TCF_META_TYPE_INT && *(unsigned *)RTA_DATA(meta)) {
             if(RTA_PAYLOAD(meta) < sizeof(__u32)) {
                 rec_log("error: %s: payload too short", __func__);
                 return(1);
             }
-            *mp = add_log(msg, *mp, "mask 0x%08x ", *(unsigned *)RTA_DATA(meta));
+            *mp = add_str(msg, *mp, "mask 0x");
+            *mp = add_hex(msg, *mp, *(unsigned *)RTA_DATA(meta), 8);
+            *mp = add_str(msg, *mp, " ");
         }
 
         return(0);
@@ -488,15 +499,17 @@ int parse_tca_em_meta_value(char *msg, char **mp, struct tcf_meta_val *val, stru
 
     switch(type) {
         case TCF_META_TYPE_VAR:
-            for(i = 0; i < RTA_PAYLOAD(meta); i++)
-                *mp = add_log(msg, *mp, "%c", isprint(data[i]) ? data[i] : '.');
+            for(i = 0; i < RTA_PAYLOAD(meta); i++) {
+                c[0] = isprint(data[i]) ? data[i] : '.';
+                *mp = add_str(msg, *mp, c);
+            }
             break;
         case TCF_META_TYPE_INT:
             if(RTA_PAYLOAD(meta) < sizeof(__u32)) {
                 rec_log("error: %s: payload too short", __func__);
                 return(1);
             }
-            *mp = add_log(msg, *mp, "%d", *(int *)RTA_DATA(meta));
+            *mp = add_s32(msg, *mp, *(int *)RTA_DATA(meta));
             break;
         default:
             rec_log("error: %s: unknown type(%d)", __func__, type);
@@ -838,130 +851,158 @@ void conv_tc_u32_flags(int flags, char *flags_list, int len, unsigned char debug
         strncpy(flags_list, debug ? "UNKNOWN" : "unknown", len);
 }
 
+/* hash of ETH_P_* protocol to a slot of names */
+#define ETH_P_HASH(proto) ((((proto) * 0x9e37u) >> 8) & 0xff)
+
 /*
  * convert ETH_P_* protocol from number to string
  */
 const char *conv_eth_p(unsigned short proto, unsigned char debug)
 {
+    static const struct {
+        unsigned short proto;
+        const char *name[2];
+    } names[] = {
 #define _ETH_P(s1, s2) \
-    if(proto == ETH_P_##s1) \
-        return(debug ? #s1 : #s2);
-    _ETH_P(LOOP, loop)
-    _ETH_P(PUP, pup)
-    _ETH_P(PUPAT, PUPAT)
-    _ETH_P(IP, ip)
-    _ETH_P(X25, x25)
-    _ETH_P(ARP, arp)
-    _ETH_P(BPQ, bpq)
-    _ETH_P(IEEEPUP, ieeepup)
-    _ETH_P(IEEEPUPAT, ieeeupat)
-    _ETH_P(DEC, dec)
-    _ETH_P(DNA_DL, dna_dl)
-    _ETH_P(DNA_RC, dna_rc)
-    _ETH_P(DNA_RT, dna_rt)
-    _ETH_P(LAT, lat)
-    _ETH_P(DIAG, diag)
-    _ETH_P(CUST, cust)
-    _ETH_P(SCA, sca)
+        { ETH_P_##s1, { #s2, #s1 } },
+        _ETH_P(LOOP, loop)
+        _ETH_P(PUP, pup)
+        _ETH_P(PUPAT, PUPAT)
+        _ETH_P(IP, ip)
+        _ETH_P(X25, x25)
+        _ETH_P(ARP, arp)
+        _ETH_P(BPQ, bpq)
+        _ETH_P(IEEEPUP, ieeepup)
+        _ETH_P(IEEEPUPAT, ieeeupat)
+        _ETH_P(DEC, dec)
+        _ETH_P(DNA_DL, dna_dl)
+        _ETH_P(DNA_RC, dna_rc)
+        _ETH_P(DNA_RT, dna_rt)
+        _ETH_P(LAT, lat)
+        _ETH_P(DIAG, diag)
+        _ETH_P(CUST, cust)
+        _ETH_P(SCA, sca)
 #ifdef ETH_P_TEB
-    _ETH_P(TEB, teb)
+        _ETH_P(TEB, teb)
 #endif
-    _ETH_P(RARP, rarp)
-    _ETH_P(ATALK, atalk)
-    _ETH_P(AARP, aarp)
-    _ETH_P(8021Q, 802.1q)
-    _ETH_P(IPX, ipx)
-    _ETH_P(IPV6, ipv6)
+        _ETH_P(RARP, rarp)
+        _ETH_P(ATALK, atalk)
+        _ETH_P(AARP, aarp)
+        _ETH_P(8021Q, 802.1q)
+        _ETH_P(IPX, ipx)
+        _ETH_P(IPV6, ipv6)
 #ifdef ETH_P_PAUSE
-    _ETH_P(PAUSE, pause)
+        _ETH_P(PAUSE, pause)
 #endif
-    _ETH_P(SLOW, slow)
-    _ETH_P(WCCP, wccp)
-    _ETH_P(PPP_DISC, ppp_disc)
-    _ETH_P(PPP_SES, ppp_ses)
-    _ETH_P(MPLS_UC, mpls_uc)
-    _ETH_P(MPLS_MC, mpls_mc)
-    _ETH_P(ATMMPOA, atmmpoa)
+        _ETH_P(SLOW, slow)
+        _ETH_P(WCCP, wccp)
+        _ETH_P(PPP_DISC, ppp_disc)
+        _ETH_P(PPP_SES, ppp_ses)
+        _ETH_P(MPLS_UC, mpls_uc)
+        _ETH_P(MPLS_MC, mpls_mc)
+        _ETH_P(ATMMPOA, atmmpoa)
 #ifdef ETH_P_LINK_CTL
-    _ETH_P(LINK_CTL, link_ctl)
+        _ETH_P(LINK_CTL, link_ctl)
 #endif
-    _ETH_P(ATMFATE, atmfate)
+        _ETH_P(ATMFATE, atmfate)
 #ifdef ETH_P_PAE
-    _ETH_P(PAE, pae)
+        _ETH_P(PAE, pae)
 #endif
-    _ETH_P(AOE, aoe)
+        _ETH_P(AOE, aoe)
 #ifdef ETH_P_8021AD
-    _ETH_P(8021AD, 802.1ad)
+        _ETH_P(8021AD, 802.1ad)
 #endif
 #ifdef ETH_P_802_EX1
-    _ETH_P(802_EX1, 802_ex1)
+        _ETH_P(802_EX1, 802_ex1)
 #endif
-    _ETH_P(TIPC, tipc)
+        _ETH_P(TIPC, tipc)
 #ifdef ETH_P_8021AH
-    _ETH_P(8021AH, 802.1ah)
+        _ETH_P(8021AH, 802.1ah)
 #endif
 #ifdef ETH_P_1588
-    _ETH_P(1588, 1588)
+        _ETH_P(1588, 1588)
 #endif
-    _ETH_P(FCOE, fcoe)
+        _ETH_P(FCOE, fcoe)
 #ifdef ETH_P_TDLS
-    _ETH_P(TDLS, tdls)
+        _ETH_P(TDLS, tdls)
 #endif
-    _ETH_P(FIP, fip)
+        _ETH_P(FIP, fip)
 #ifdef ETH_P_QINQ1
-    _ETH_P(QINQ1, q-in-q1)
+        _ETH_P(QINQ1, q-in-q1)
 #endif
 #ifdef ETH_P_QINQ2
-    _ETH_P(QINQ2, q-in-q2)
+        _ETH_P(QINQ2, q-in-q2)
 #endif
 #ifdef ETH_P_QINQ3
-    _ETH_P(QINQ3, q-in-q3)
+        _ETH_P(QINQ3, q-in-q3)
 #endif
 #ifdef ETH_P_EDSA
-    _ETH_P(EDSA, edsa)
+        _ETH_P(EDSA, edsa)
 #endif
 #ifdef ETH_P_AF_IUCV
-    _ETH_P(AF_IUCV, af_iucv)
+        _ETH_P(AF_IUCV, af_iucv)
 #endif
-    _ETH_P(802_3, 802_3)
-    _ETH_P(AX25, ax25)
-    _ETH_P(ALL, all)
-    _ETH_P(802_2, 802_2)
-    _ETH_P(SNAP, snap)
-    _ETH_P(DDCMP, ddcmp)
-    _ETH_P(WAN_PPP, wan_ppp)
-    _ETH_P(PPP_MP, ppp_mp)
-    _ETH_P(LOCALTALK, localtalk)
+        _ETH_P(802_3, 802_3)
+        _ETH_P(AX25, ax25)
+        _ETH_P(ALL, all)
+        _ETH_P(802_2, 802_2)
+        _ETH_P(SNAP, snap)
+        _ETH_P(DDCMP, ddcmp)
+        _ETH_P(WAN_PPP, wan_ppp)
+        _ETH_P(PPP_MP, ppp_mp)
+        _ETH_P(LOCALTALK, localtalk)
 #ifdef ETH_P_CAN
-    _ETH_P(CAN, can)
+        _ETH_P(CAN, can)
 #endif
 #ifdef ETH_P_CANFD
-    _ETH_P(CANFD, canfd)
+        _ETH_P(CANFD, canfd)
 #endif
-    _ETH_P(PPPTALK, ppptalk)
-    _ETH_P(TR_802_2, tr_802_2)
-    _ETH_P(MOBITEX, mobitex)
-    _ETH_P(CONTROL, control)
-    _ETH_P(IRDA, irda)
-    _ETH_P(ECONET, econet)
-    _ETH_P(HDLC, hdlc)
-    _ETH_P(ARCNET, arcnet)
+        _ETH_P(PPPTALK, ppptalk)
+        _ETH_P(TR_802_2, tr_802_2)
+        _ETH_P(MOBITEX, mobitex)
+        _ETH_P(CONTROL, control)
+        _ETH_P(IRDA, irda)
+        _ETH_P(ECONET, econet)
+        _ETH_P(HDLC, hdlc)
+        _ETH_P(ARCNET, arcnet)
 #ifdef ETH_P_DSA
-    _ETH_P(DSA, dsa)
+        _ETH_P(DSA, dsa)
 #endif
 #ifdef ETH_P_TRAILER
-    _ETH_P(TRAILER, trailer)
+        _ETH_P(TRAILER, trailer)
 #endif
 #ifdef ETH_P_PHONET
-    _ETH_P(PHONET, phonet)
+        _ETH_P(PHONET, phonet)
 #endif
 #ifdef ETH_P_IEEE802154
-    _ETH_P(IEEE802154, ieee802154)
+        _ETH_P(IEEE802154, ieee802154)
 #endif
 #ifdef ETH_P_CAIF
-    _ETH_P(CAIF, caif)
+        _ETH_P(CAIF, caif)
 #endif
 #undef _ETH_P
+    };
+    /* open addressing slots of names hashed by protocol(0 is empty) */
+    static unsigned char slots[256];
+    static int slots_num;
+    unsigned i;
+    int n;
+
+    if(!slots_num) {
+        for(n = 0; n < sizeof(names) / sizeof(names[0]); n++) {
+            for(i = ETH_P_HASH(names[n].proto); slots[i]; i = (i + 1) & 0xff)
+                if(names[slots[i] - 1].proto == names[n].proto)
+                    break;
+            if(!slots[i])
+                slots[i] = n + 1;
+        }
+        slots_num = n;
+    }
+
+    for(i = ETH_P_HASH(proto); slots[i]; i = (i + 1) & 0xff)
+        if(names[slots[i] - 1].proto == proto)
+            return(names[slots[i] - 1].name[debug ? 1 : 0]);
+
     return((const char *)(debug ? "UNKNOWN" : "unknown"));
 }
 
@@ -22,7 +22,7 @@
 /*
  * parse basic options
  */
-int parse_tca_options_basic(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_basic(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *basic[__TCA_BASIC_MAX];
     char *mp_tmp = *mp;
@@ -58,7 +58,7 @@ int parse_tca_options_basic(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug basic options
  */
-void debug_tca_options_basic(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_basic(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *basic[__TCA_BASIC_MAX];
 
@@ -23,7 +23,7 @@
 /*
  * parse cgroup options
  */
-int parse_tca_options_cgroup(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_cgroup(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *cgroup[__TCA_CGROUP_MAX];
 
@@ -48,7 +48,7 @@ int parse_tca_options_cgroup(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug cgroup options
  */
-void debug_tca_options_cgroup(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_cgroup(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *cgroup[__TCA_CGROUP_MAX];
 
@@ -23,7 +23,7 @@
 /*
  * parse flow options
  */
-int parse_tca_options_flow(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_flow(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *flow[__TCA_FLOW_MAX];
     char *mp_tmp = *mp;
@@ -97,7 +97,9 @@ int parse_tca_flow_keys(char *msg, char **mp, struct rtattr *flow)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "keys=%s ", conv_flow_key(*(unsigned *)RTA_DATA(flow), 0));
+    *mp = add_str(msg, *mp, "keys=");
+    *mp = add_str(msg, *mp, conv_flow_key(*(unsigned *)RTA_DATA(flow), 0));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -111,8 +113,9 @@ int parse_tca_flow_mode(char *msg, char **mp, struct rtattr *flow)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "mode=%s ",
-        conv_flow_mode(*(unsigned *)RTA_DATA(flow), 0));
+    *mp = add_str(msg, *mp, "mode=");
+    *mp = add_str(msg, *mp, conv_flow_mode(*(unsigned *)RTA_DATA(flow), 0));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -126,7 +129,9 @@ int parse_tca_flow_xor(char *msg, char **mp, struct rtattr *flow)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "xor=0x%08x ", *(unsigned *)RTA_DATA(flow));
+    *mp = add_str(msg, *mp, "xor=0x");
+    *mp = add_hex(msg, *mp, *(unsigned *)RTA_DATA(flow), 8);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -140,7 +145,9 @@ int parse_tca_flow_rshift(char *msg, char **mp, struct rtattr *flow)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "rshift=%u ", *(unsigned *)RTA_DATA(flow));
+    *mp = add_str(msg, *mp, "rshift=");
+    *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(flow));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -154,7 +161,9 @@ int parse_tca_flow_addend(char *msg, char **mp, struct rtattr *flow)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "addend=0x%x ", *(unsigned *)RTA_DATA(flow));
+    *mp = add_str(msg, *mp, "addend=0x");
+    *mp = add_hex(msg, *mp, *(unsigned *)RTA_DATA(flow), 0);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -168,7 +177,9 @@ int parse_tca_flow_divisor(char *msg, char **mp, struct rtattr *flow)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "divisor=%u ", *(unsigned *)RTA_DATA(flow));
+    *mp = add_str(msg, *mp, "divisor=");
+    *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(flow));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -182,7 +193,9 @@ int parse_tca_flow_perturb(char *msg, char **mp, struct rtattr *flow)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "perturb=%u(sec) ", *(unsigned *)RTA_DATA(flow));
+    *mp = add_str(msg, *mp, "perturb=");
+    *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(flow));
+    *mp = add_str(msg, *mp, "(sec) ");
 
     return(0);
 }
@@ -190,7 +203,7 @@ int parse_tca_flow_perturb(char *msg, char **mp, struct rtattr *flow)
 /*
  * debug flow options
  */
-void debug_tca_options_flow(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_flow(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *flow[__TCA_FLOW_MAX];
 
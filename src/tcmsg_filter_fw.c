@@ -22,7 +22,7 @@
 /*
  * parse fw options
  */
-int parse_tca_options_fw(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_fw(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *fw[__TCA_FW_MAX];
     char *mp_tmp = *mp;
@@ -64,7 +64,7 @@ int parse_tca_options_fw(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug fw options
  */
-void debug_tca_options_fw(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_fw(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *fw[__TCA_FW_MAX];
 
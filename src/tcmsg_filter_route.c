@@ -22,7 +22,7 @@
 /*
  * parse route options
  */
-int parse_tca_options_route(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_route(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *route[__TCA_ROUTE4_MAX];
 #if HAVE_DECL_TCA_RSVP_UNSPEC
@@ -76,7 +76,9 @@ int parse_tca_route4_from(char *msg, char **mp, struct rtattr *route)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "from(realm)=%u ", *(unsigned *)RTA_DATA(route));
+    *mp = add_str(msg, *mp, "from(realm)=");
+    *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(route));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -96,7 +98,9 @@ int parse_tca_route4_iif(char *msg, char **mp, struct rtattr *route)
     ifindex = *(int *)RTA_DATA(route);
     if_indextoname_from_lists(ifindex, ifname);
 
-    *mp = add_log(msg, *mp, "from(interface)=%s ", ifname);
+    *mp = add_str(msg, *mp, "from(interface)=");
+    *mp = add_str(msg, *mp, ifname);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -110,7 +114,9 @@ int parse_tca_route4_to(char *msg, char **mp, struct rtattr *route)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "to(realm)=%u ", *(unsigned *)RTA_DATA(route));
+    *mp = add_str(msg, *mp, "to(realm)=");
+    *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(route));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -118,7 +124,7 @@ int parse_tca_route4_to(char *msg, char **mp, struct rtattr *route)
 /*
  * debug route options
  */
-void debug_tca_options_route(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_route(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *route[__TCA_ROUTE4_MAX];
 
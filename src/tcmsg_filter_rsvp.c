@@ -78,7 +78,9 @@ int parse_tca_rsvp_dst(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *r
             (res == 1) ? strerror(errno) : "payload too short");
         return(1);
     }
-    *mp = add_log(msg, *mp, "destination=%s ", addr);
+    *mp = add_str(msg, *mp, "destination=");
+    *mp = add_str(msg, *mp, addr);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -97,7 +99,9 @@ int parse_tca_rsvp_src(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *r
             (res == 1) ? strerror(errno) : "payload too short");
         return(1);
     }
-    *mp = add_log(msg, *mp, "source=%s ", addr);
+    *mp = add_str(msg, *mp, "source=");
+    *mp = add_str(msg, *mp, addr);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -120,13 +124,29 @@ int parse_tca_rsvp_pinfo(char *msg, char **mp, struct rtattr *rsvp)
     spi = &(pinfo->spi);
     proto = getprotobynumber(pinfo->protocol);
 
-    *mp = add_log(msg, *mp, "dpi(key/mask/offset)=0x%08x/0x%08x/%d ",
-        htonl(dpi->key), htonl(dpi->mask), dpi->offset);
-    *mp = add_log(msg, *mp, "spi(key/mask/offset)=0x%08x/0x%08x/%d ",
-        htonl(spi->key), htonl(spi->mask), spi->offset);
-    *mp = add_log(msg, *mp, "tunnel(protocol/id/hdr)=%d(%s)/%d/%d ",
-        pinfo->protocol, proto ? proto->p_name : "unknown",
-        pinfo->tunnelid, pinfo->tunnelhdr);
+    *mp = add_str(msg, *mp, "dpi(key/mask/offset)=0x");
+    *mp = add_hex(msg, *mp, htonl(dpi->key), 8);
+    *mp = add_str(msg, *mp, "/0x");
+    *mp = add_hex(msg, *mp, htonl(dpi->mask), 8);
+    *mp = add_str(msg, *mp, "/");
+    *mp = add_s32(msg, *mp, dpi->offset);
+    *mp = add_str(msg, *mp, " ");
+    *mp = add_str(msg, *mp, "spi(key/mask/offset)=0x");
+    *mp = add_hex(msg, *mp, htonl(spi->key), 8);
+    *mp = add_str(msg, *mp, "/0x");
+    *mp = add_hex(msg, *mp, htonl(spi->mask), 8);
+    *mp = add_str(msg, *mp, "/");
+    *mp = add_s32(msg, *mp, spi->offset);
+    *mp = add_str(msg, *mp, " ");
+    *mp = add_str(msg, *mp, "tunnel(protocol/id/hdr)=");
+    *mp = add_s32(msg, *mp, pinfo->protocol);
+    *mp = add_str(msg, *mp, "(");
+    *mp = add_str(msg, *mp, proto ? proto->p_name : "unknown");
+    *mp = add_str(msg, *mp, ")/");
+    *mp = add_s32(msg, *mp, pinfo->tunnelid);
+    *mp = add_str(msg, *mp, "/");
+    *mp = add_s32(msg, *mp, pinfo->tunnelhdr);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
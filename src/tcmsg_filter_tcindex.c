@@ -23,7 +23,7 @@
 /*
  * parse tcindex options
  */
-int parse_tca_options_tcindex(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_tcindex(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *tcindex[__TCA_TCINDEX_MAX];
     char *mp_tmp = *mp;
@@ -77,7 +77,9 @@ int parse_tca_tcindex_hash(char *msg, char **mp, struct rtattr *tcindex)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "hash=%hu ", *(unsigned short *)RTA_DATA(tcindex));
+    *mp = add_str(msg, *mp, "hash=");
+    *mp = add_u32(msg, *mp, *(unsigned short *)RTA_DATA(tcindex));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -91,7 +93,9 @@ int parse_tca_tcindex_mask(char *msg, char **mp, struct rtattr *tcindex)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "mask=0x%04x ", *(unsigned short *)RTA_DATA(tcindex));
+    *mp = add_str(msg, *mp, "mask=0x");
+    *mp = add_hex(msg, *mp, *(unsigned short *)RTA_DATA(tcindex), 4);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -105,7 +109,9 @@ int parse_tca_tcindex_shift(char *msg, char **mp, struct rtattr *tcindex)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "shift=%d ", *(int *)RTA_DATA(tcindex));
+    *mp = add_str(msg, *mp, "shift=");
+    *mp = add_s32(msg, *mp, *(int *)RTA_DATA(tcindex));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -119,8 +125,9 @@ int parse_tca_tcindex_fall_through(char *msg, char **mp, struct rtattr *tcindex)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "flag=%s ",
-        *(int *)RTA_DATA(tcindex) ? "fall_through" : "pass_on");
+    *mp = add_str(msg, *mp, "flag=");
+    *mp = add_str(msg, *mp, *(int *)RTA_DATA(tcindex) ? "fall_through" : "pass_on");
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -128,7 +135,7 @@ int parse_tca_tcindex_fall_through(char *msg, char **mp, struct rtattr *tcindex)
 /*
  * debug tcindex options
  */
-void debug_tca_options_tcindex(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_tcindex(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *tcindex[__TCA_TCINDEX_MAX];
 
@@ -22,7 +22,7 @@
 /*
  * parse u32 options
  */
-int parse_tca_options_u32(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_u32(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *u32[__TCA_U32_MAX];
     char *mp_tmp = *mp;
@@ -88,8 +88,11 @@ int parse_tca_u32_hash(char *msg, char **mp, struct rtattr *u32)
     }
     htid = *(unsigned *)RTA_DATA(u32);
 
-    *mp = add_log(msg, *mp, "hash(table/bucket)=0x%x/0x%x ",
-        TC_U32_USERHTID(htid), TC_U32_HASH(htid));
+    *mp = add_str(msg, *mp, "hash(table/bucket)=0x");
+    *mp = add_hex(msg, *mp, TC_U32_USERHTID(htid), 0);
+    *mp = add_str(msg, *mp, "/0x");
+    *mp = add_hex(msg, *mp, TC_U32_HASH(htid), 0);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -106,7 +109,9 @@ int parse_tca_u32_link(char *msg, char **mp, struct rtattr *u32)
         return(1);
     }
     parse_u32_handle(handle, sizeof(handle), *(unsigned *)RTA_DATA(u32));
-    *mp = add_log(msg, *mp, "link=%s ", handle);
+    *mp = add_str(msg, *mp, "link=");
+    *mp = add_str(msg, *mp, handle);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -120,7 +125,9 @@ int parse_tca_u32_divisor(char *msg, char **mp, struct rtattr *u32)
         rec_log("error: %s: payload too short", __func__);
         return(1);
     }
-    *mp = add_log(msg, *mp, "divisor=%d ", *(unsigned *)RTA_DATA(u32));
+    *mp = add_str(msg, *mp, "divisor=");
+    *mp = add_s32(msg, *mp, *(unsigned *)RTA_DATA(u32));
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -137,7 +144,11 @@ int parse_tca_u32_mark(char *msg, char **mp, struct rtattr *u32)
         return(1);
     }
     mark = (struct tc_u32_mark *)RTA_DATA(u32);
-    *mp = add_log(msg, *mp, "mark(value/mask)=0x%04x/0x%04x ", mark->val, mark->mask);
+    *mp = add_str(msg, *mp, "mark(value/mask)=0x");
+    *mp = add_hex(msg, *mp, mark->val, 4);
+    *mp = add_str(msg, *mp, "/0x");
+    *mp = add_hex(msg, *mp, mark->mask, 4);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -156,11 +167,24 @@ int parse_tca_u32_sel(char *msg, char *mp, struct rtattr *u32)
         return(1);
     }
     sel = (struct tc_u32_sel *)RTA_DATA(u32);
-    conv_tc_u32_flags(sel->flags, flags_list, sizeof(flags_list),  0),
-    add_log(msg, mp, "flags=%s offshift=%d nkeys=%d offmask=0x%04x "
-        "off=%hu offoff=%hd hoff=%hd hmask=0x%08x ",
-        flags_list, sel->offshift, sel->nkeys, ntohs(sel->offmask),
-        sel->off, sel->offoff, sel->hoff, ntohl(sel->hmask));
+    conv_tc_u32_flags(sel->flags, flags_list, sizeof(flags_list),  0);
+    mp = add_str(msg, mp, "flags=");
+    mp = add_str(msg, mp, flags_list);
+    mp = add_str(msg, mp, " offshift=");
+    mp = add_s32(msg, mp, sel->offshift);
+    mp = add_str(msg, mp, " nkeys=");
+    mp = add_s32(msg, mp, sel->nkeys);
+    mp = add_str(msg, mp, " offmask=0x");
+    mp = add_hex(msg, mp, ntohs(sel->offmask), 4);
+    mp = add_str(msg, mp, " off=");
+    mp = add_u32(msg, mp, sel->off);
+    mp = add_str(msg, mp, " offoff=");
+    mp = add_s32(msg, mp, sel->offoff);
+    mp = add_str(msg, mp, " hoff=");
+    mp = add_s32(msg, mp, sel->hoff);
+    mp = add_str(msg, mp, " hmask=0x");
+    mp = add_hex(msg, mp, ntohl(sel->hmask), 8);
+    mp = add_str(msg, mp, " ");
     rec_log("%s", msg);
 
     /* rollback pointer */
@@ -175,10 +199,18 @@ int parse_tca_u32_sel(char *msg, char *mp, struct rtattr *u32)
         return(1);
     }
 
-    for(i = 0; i < sel->nkeys; i++, keys++) {
-        add_log(msg, mp, "key=%d value=0x%08x mask=0x%08x offset=%d offmask=0x%08x ",
-            i + 1, ntohl(keys->val), ntohl(keys->mask),
-            keys->off, ntohl(keys->offmask));
+    for(i = 0; i < sel->nkeys; i++, keys++, mp = mp_tmp) {
+        mp = add_str(msg, mp, "key=");
+        mp = add_s32(msg, mp, i + 1);
+        mp = add_str(msg, mp, " value=0x");
+        mp = add_hex(msg, mp, ntohl(keys->val), 8);
+        mp = add_str(msg, mp, " mask=0x");
+        mp = add_hex(msg, mp, ntohl(keys->mask), 8);
+        mp = add_str(msg, mp, " offset=");
+        mp = add_s32(msg, mp, keys->off);
+        mp = add_str(msg, mp, " offmask=0x");
+        mp = add_hex(msg, mp, ntohl(keys->offmask), 8);
+        mp = add_str(msg, mp, " ");
         rec_log("%s", msg);
     }
 
@@ -188,7 +220,7 @@ int parse_tca_u32_sel(char *msg, char *mp, struct rtattr *u32)
 /*
  * debug u32 options
  */
-void debug_tca_options_u32(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_u32(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *u32[__TCA_U32_MAX];
 
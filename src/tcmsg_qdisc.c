@@ -32,12 +32,11 @@ int parse_tcmsg_qdisc(struct nlmsghdr *nlh)
     struct tcmsg *tcm;
     int tcm_len;
     struct rtattr *tca[__TCA_MAX];
-    char msg[MAX_MSG_SIZE] = "";
+    char msg[MAX_MSG_SIZE];
     char *mp = msg;
     char ifname[IFNAMSIZ];
-    char parent[MAX_STR_SIZE] = "";
-    char handle[MAX_STR_SIZE] = "";
     char kind[IFNAMSIZ] = "(unknown)";
+    const struct tc_kind *tk;
     int log_opts = get_log_opts();
 
     /* debug nlmsghdr */
@@ -62,16 +61,16 @@ int parse_tcmsg_qdisc(struct nlmsghdr *nlh)
     /* kind of message */
     switch(nlh->nlmsg_type) {
         case RTM_NEWQDISC:
-            mp = add_log(msg, mp, "tc qdisc added: ");
+            mp = add_str(msg, mp, "tc qdisc added: ");
             break;
         case RTM_DELQDISC:
-            mp = add_log(msg, mp, "tc qdisc deleted: ");
+            mp = add_str(msg, mp, "tc qdisc deleted: ");
             break;
         case RTM_NEWTCLASS:
-            mp = add_log(msg, mp, "tc class added: ");
+            mp = add_str(msg, mp, "tc class added: ");
             break;
         case RTM_DELTCLASS:
-            mp = add_log(msg, mp, "tc class deleted: ");
+            mp = add_str(msg, mp, "tc class deleted: ");
             break;
         default:
             rec_log("error: %s: nlmsg_type: unknown message", __func__);
@@ -81,109 +80,32 @@ int parse_tcmsg_qdisc(struct nlmsghdr *nlh)
     /* get interface name */
     if_indextoname_from_lists(tcm->tcm_ifindex, ifname);
 
-    mp = add_log(msg, mp, "interface=%s ", ifname); 
+    mp = add_str(msg, mp, "interface=");
+    mp = add_str(msg, mp, ifname);
 
     /* get parent qdisc handle */
-    parse_tc_handle(parent, sizeof(parent), tcm->tcm_parent);
-    mp = add_log(msg, mp, "parent=%s ", parent);
+    mp = add_str(msg, mp, " parent=");
+    mp = add_tc_handle(msg, mp, tcm->tcm_parent);
 
     /* get qdisc handle */
-    parse_tc_handle(handle, sizeof(handle), tcm->tcm_handle);
-    mp = add_log(msg, mp, "classid=%s ", handle);
+    mp = add_str(msg, mp, " classid=");
+    mp = add_tc_handle(msg, mp, tcm->tcm_handle);
 
     /* get qdisc kind */
     if(tca[TCA_KIND])
         strncpy(kind, (char *)RTA_DATA(tca[TCA_KIND]), sizeof(kind));
 
-    mp = add_log(msg, mp, "qdisc=%s ", kind);
+    mp = add_str(msg, mp, " qdisc=");
+    mp = add_str(msg, mp, kind);
+    mp = add_str(msg, mp, " ");
 
     /* get qdisc options */
-    if(tca[TCA_OPTIONS]) {
-        if(!strncmp(kind, "pfifo_fast", sizeof(kind))) {
-            if(parse_tca_options_prio(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-        } else if(!strncmp(kind, "pfifo", sizeof(kind))) {
-            if(parse_tca_options_pfifo(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-        } else if(!strncmp(kind, "bfifo", sizeof(kind))) {
-            if(parse_tca_options_bfifo(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-        } else if(!strncmp(kind, "prio", sizeof(kind))) {
-            if(parse_tca_options_prio(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#ifdef HAVE_STRUCT_TC_MULTIQ_QOPT_BANDS
-        } else if(!strncmp(kind, "multiq", sizeof(kind))) {
-            if(parse_tca_options_multiq(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-#ifdef HAVE_STRUCT_TC_PLUG_QOPT_ACTION
-        } else if(!strncmp(kind, "plug", sizeof(kind))) {
-            if(parse_tca_options_plug(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-        } else if(!strncmp(kind, "sfq", sizeof(kind))) {
-            if(parse_tca_options_sfq(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-        } else if(!strncmp(kind, "tbf", sizeof(kind))) {
-            if(parse_tca_options_tbf(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-        } else if(!strncmp(kind, "red", sizeof(kind))) {
-            if(parse_tca_options_red(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-        } else if(!strncmp(kind, "gred", sizeof(kind))) {
-            if(parse_tca_options_gred(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
+    tk = find_tc_kind(kind, sizeof(kind));
+    if(tca[TCA_OPTIONS] && tk && (tk->flags & TC_KIND_QDISC) && tk->parse) {
+        if(tk->parse(msg, &mp, tcm, tca[TCA_OPTIONS]))
+            return(1);
+        if(tk->flags & TC_KIND_F_LOG)
             return(0);
-#if HAVE_DECL_TCA_CHOKE_UNSPEC
-        } else if(!strncmp(kind, "choke", sizeof(kind))) {
-            if(parse_tca_options_choke(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-        } else if(!strncmp(kind, "htb", sizeof(kind))) {
-            if(parse_tca_options_htb(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-        } else if(!strncmp(kind, "hfsc", sizeof(kind))) {
-            if(parse_tca_options_hfsc(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#if HAVE_DECL_TCA_CBQ_UNSPEC
-        } else if(!strncmp(kind, "cbq", sizeof(kind))) {
-            if(parse_tca_options_cbq(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-#if HAVE_DECL_TCA_DSMARK_UNSPEC
-        } else if(!strncmp(kind, "dsmark", sizeof(kind))) {
-            if(parse_tca_options_dsmark(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-        } else if(!strncmp(kind, "netem", sizeof(kind))) {
-            if(parse_tca_options_netem(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#if HAVE_DECL_TCA_DRR_UNSPEC
-        } else if(!strncmp(kind, "drr", sizeof(kind))) {
-            if(parse_tca_options_drr(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-#if HAVE_DECL_TCA_SFB_UNSPEC
-        } else if(!strncmp(kind, "sfb", sizeof(kind))) {
-            if(parse_tca_options_sfb(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-#if HAVE_DECL_TCA_QFQ_UNSPEC
-        } else if(!strncmp(kind, "qfq", sizeof(kind))) {
-            if(parse_tca_options_qfq(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-#if HAVE_DECL_TCA_CODEL_UNSPEC
-        } else if(!strncmp(kind, "codel", sizeof(kind))) {
-            if(parse_tca_options_codel(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-#if HAVE_DECL_TCA_FQ_CODEL_UNSPEC
-        } else if(!strncmp(kind, "fq_codel", sizeof(kind))) {
-            if(parse_tca_options_fq_codel(msg, &mp, tca[TCA_OPTIONS]))
-                return(1);
-#endif
-        }
     }
 
     /* write log */
@@ -385,96 +307,10 @@ void debug_tcmsg(int lev, struct nlmsghdr *nlh, struct tcmsg *tcm, struct rtattr
 void debug_tca_options(int lev, struct tcmsg *tcm, struct rtattr *tca,
     const char *name, char *kind, int len)
 {
-    /* kinds of qdisc */
-    if(!strncmp(kind, "pfifo_fast", len))
-        debug_tca_options_prio(lev, tca, name);
-    else if(!strncmp(kind, "pfifo", len))
-        debug_tca_options_fifo(lev, tca, name);
-    else if(!strncmp(kind, "bfifo", len))
-        debug_tca_options_fifo(lev, tca, name);
-    else if(!strncmp(kind, "prio", len))
-        debug_tca_options_prio(lev, tca, name);
-#ifdef HAVE_STRUCT_TC_MULTIQ_QOPT_BANDS
-    else if(!strncmp(kind, "multiq", len))
-        debug_tca_options_multiq(lev, tca, name);
-#endif
-#ifdef HAVE_STRUCT_TC_PLUG_QOPT_ACTION
-    else if(!strncmp(kind, "plug", len))
-        debug_tca_options_plug(lev, tca, name);
-#endif
-    else if(!strncmp(kind, "sfq", len))
-        debug_tca_options_sfq(lev, tca, name);
-    else if(!strncmp(kind, "tbf", len))
-        debug_tca_options_tbf(lev, tca, name);
-    else if(!strncmp(kind, "red", len))
-        debug_tca_options_red(lev, tca, name);
-    else if(!strncmp(kind, "gred", len))
-        debug_tca_options_gred(lev, tca, name);
-#if HAVE_DECL_TCA_CHOKE_UNSPEC
-    else if(!strncmp(kind, "choke", len))
-        debug_tca_options_choke(lev, tca, name);
-#endif
-    else if(!strncmp(kind, "htb", len))
-        debug_tca_options_htb(lev, tca, name);
-    else if(!strncmp(kind, "hfsc", len))
-        debug_tca_options_hfsc(lev, tca, name);
-#if HAVE_DECL_TCA_CBQ_UNSPEC
-    else if(!strncmp(kind, "cbq", len))
-        debug_tca_options_cbq(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_DSMARK_UNSPEC
-    else if(!strncmp(kind, "dsmark", len))
-        debug_tca_options_dsmark(lev, tca, name);
-#endif
-    else if(!strncmp(kind, "netem", len))
-        debug_tca_options_netem(lev, tca, name);
-#if HAVE_DECL_TCA_DRR_UNSPEC
-    else if(!strncmp(kind, "drr", len))
-        debug_tca_options_drr(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_SFB_UNSPEC
-    else if(!strncmp(kind, "sfb", len))
-        debug_tca_options_sfb(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_QFQ_UNSPEC
-    else if(!strncmp(kind, "qfq", len))
-        debug_tca_options_qfq(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_CODEL_UNSPEC
-    else if(!strncmp(kind, "codel", len))
-        debug_tca_options_codel(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_FQ_CODEL_UNSPEC
-    else if(!strncmp(kind, "fq_codel", len))
-        debug_tca_options_fq_codel(lev, tca, name);
-#endif
-    else if(!strncmp(kind, "ingress", len))
-        return;
-    /* kinds of filter */
-    else if(!strncmp(kind, "u32", len))
-        debug_tca_options_u32(lev, tca, name);
-#if HAVE_DECL_TCA_RSVP_UNSPEC
-    else if(!strncmp(kind, "rsvp", len))
-        debug_tca_options_rsvp(lev, tcm, tca, name);
-#endif
-    else if(!strncmp(kind, "route", len))
-        debug_tca_options_route(lev, tca, name);
-    else if(!strncmp(kind, "fw", len))
-        debug_tca_options_fw(lev, tca, name);
-#if HAVE_DECL_TCA_TCINDEX_UNSPEC
-    else if(!strncmp(kind, "tcindex", len))
-        debug_tca_options_tcindex(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_FLOW_UNSPEC
-    else if(!strncmp(kind, "flow", len))
-        debug_tca_options_flow(lev, tca, name);
-#endif
-    else if(!strncmp(kind, "basic", len))
-        debug_tca_options_basic(lev, tca, name);
-#if HAVE_DECL_TCA_CGROUP_UNSPEC
-    else if(!strncmp(kind, "cgroup", len))
-        debug_tca_options_cgroup(lev, tca, name);
-#endif
+    const struct tc_kind *tk = find_tc_kind(kind, len);
+
+    if(tk && tk->debug)
+        tk->debug(lev, tcm, tca, name);
     else
         rec_dbg(lev, "%s(%hu): -- unknown option %s --",
             name, RTA_ALIGN(tca->rta_len), kind);
@@ -510,47 +346,10 @@ void debug_tca_stats(int lev, struct rtattr *tca, const char *name)
 void debug_tca_xstats(int lev, struct rtattr *tca,
     const char *name, char *kind, int len)
 {
-    /* if(0) is dummy */
-    if(0)
-        return;
-#ifdef HAVE_STRUCT_TC_SFQ_XSTATS_ALLOT
-    else if(!strncmp(kind, "sfq", len))
-        debug_tc_sfq_xstats(lev, tca, name);
-#endif
-    else if(!strncmp(kind, "red", len))
-        debug_tc_red_xstats(lev, tca, name);
-#if HAVE_DECL_TCA_CHOKE_UNSPEC
-    else if(!strncmp(kind, "choke", len))
-        debug_tc_choke_xstats(lev, tca, name);
-#endif
-    else if(!strncmp(kind, "htb", len))
-        debug_tc_htb_xstats(lev, tca, name);
-#if HAVE_DECL_TCA_CBQ_UNSPEC
-    else if(!strncmp(kind, "cbq", len))
-        debug_tc_cbq_xstats(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_DRR_UNSPEC
-    else if(!strncmp(kind, "drr", len))
-        debug_tc_drr_xstats(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_SFB_UNSPEC
-    else if(!strncmp(kind, "sfb", len))
-        debug_tc_sfb_xstats(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_QFQ_UNSPEC
-    else if(!strncmp(kind, "qfq", len))
-        debug_tc_qfq_xstats(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_CODEL_UNSPEC
-    else if(!strncmp(kind, "codel", len))
-        debug_tc_codel_xstats(lev, tca, name);
-#endif
-#if HAVE_DECL_TCA_FQ_CODEL_UNSPEC
-    else if(!strncmp(kind, "fq_codel", len))
-        debug_tc_fq_codel_xstats(lev, tca, name);
-#endif
-    else if(!strncmp(kind, "ingress", len))
-        return;
+    const struct tc_kind *tk = find_tc_kind(kind, len);
+
+    if(tk && tk->debug_xstats)
+        tk->debug_xstats(lev, tca, name);
     else
         rec_dbg(lev, "%s(%hu): -- unknown kind %s --",
             name, RTA_ALIGN(tca->rta_len), kind);
@@ -25,7 +25,7 @@ static double us2tick = 1;
 /*
  * parse cbq options
  */
-int parse_tca_options_cbq(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_cbq(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *cbq[__TCA_CBQ_MAX];
     struct tc_ratespec *rspec = NULL;
@@ -80,7 +80,9 @@ int parse_tca_options_cbq(char *msg, char **mp, struct rtattr *tca)
         char rate[MAX_STR_SIZE];
 
         conv_unit_rate(rate, sizeof(rate), rspec->rate);
-        *mp = add_log(msg, *mp, "rate=%s ", rate);
+        *mp = add_str(msg, *mp, "rate=");
+        *mp = add_str(msg, *mp, rate);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(lss) {
@@ -90,22 +92,35 @@ int parse_tca_options_cbq(char *msg, char **mp, struct rtattr *tca)
         get_us2tick();
         conv_unit_usec(maxidle, sizeof(maxidle),
             (lss->maxidle >> lss->ewma_log) / us2tick);
-        *mp = add_log(msg, *mp, "maxidle=%s ", maxidle);
+        *mp = add_str(msg, *mp, "maxidle=");
+        *mp = add_str(msg, *mp, maxidle);
+        *mp = add_str(msg, *mp, " ");
 
         if(lss->minidle != 0x7fffffff) {
             conv_unit_usec(minidle, sizeof(minidle),
                 (lss->minidle >> lss->ewma_log) / us2tick);
-            *mp = add_log(msg, *mp, "minidle=%s ", minidle);
+            *mp = add_str(msg, *mp, "minidle=");
+            *mp = add_str(msg, *mp, minidle);
+            *mp = add_str(msg, *mp, " ");
         }
 
-        *mp = add_log(msg, *mp, "level=%u avpkt=%u(byte) ", lss->level, lss->avpkt);
+        *mp = add_str(msg, *mp, "level=");
+        *mp = add_u32(msg, *mp, lss->level);
+        *mp = add_str(msg, *mp, " avpkt=");
+        *mp = add_u32(msg, *mp, lss->avpkt);
+        *mp = add_str(msg, *mp, "(byte) ");
     }
 
     if(wrr) {
-        if(wrr->priority != TC_CBQ_MAXPRIO)
-            *mp = add_log(msg, *mp, "prio=%u ", wrr->priority);
-        else
-            *mp = add_log(msg, *mp, "prio=%u(no-transmit) ", wrr->priority);
+        if(wrr->priority != TC_CBQ_MAXPRIO) {
+            *mp = add_str(msg, *mp, "prio=");
+            *mp = add_u32(msg, *mp, wrr->priority);
+            *mp = add_str(msg, *mp, " ");
+        } else {
+            *mp = add_str(msg, *mp, "prio=");
+            *mp = add_u32(msg, *mp, wrr->priority);
+            *mp = add_str(msg, *mp, "(no-transmit) ");
+        }
     }
 
     return(0);
@@ -114,7 +129,7 @@ int parse_tca_options_cbq(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug cbq options
  */
-void debug_tca_options_cbq(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_cbq(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *cbq[__TCA_CBQ_MAX];
 
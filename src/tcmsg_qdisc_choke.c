@@ -23,7 +23,7 @@
 /*
  * parse choke options
  */
-int parse_tca_options_choke(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_choke(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *choke[__TCA_CHOKE_MAX];
 
@@ -39,11 +39,18 @@ int parse_tca_options_choke(char *msg, char **mp, struct rtattr *tca)
         }
         qopt = (struct tc_choke_qopt *)RTA_DATA(choke[TCA_CHOKE_PARMS]);
 
-        *mp = add_log(msg, *mp, "limit=%u(packet) min=%u(packet) max=%u(packet) ",
-            qopt->limit, qopt->qth_min, qopt->qth_max);
+        *mp = add_str(msg, *mp, "limit=");
+        *mp = add_u32(msg, *mp, qopt->limit);
+        *mp = add_str(msg, *mp, "(packet) min=");
+        *mp = add_u32(msg, *mp, qopt->qth_min);
+        *mp = add_str(msg, *mp, "(packet) max=");
+        *mp = add_u32(msg, *mp, qopt->qth_max);
+        *mp = add_str(msg, *mp, "(packet) ");
         if(qopt->flags) {
             conv_tc_red_flags(qopt->flags, list, sizeof(list), 0);
-            *mp = add_log(msg, *mp, "flag=%s ", list);
+            *mp = add_str(msg, *mp, "flag=");
+            *mp = add_str(msg, *mp, list);
+            *mp = add_str(msg, *mp, " ");
         }
     }
 
@@ -64,7 +71,7 @@ int parse_tca_options_choke(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug choke options
  */
-void debug_tca_options_choke(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_choke(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *choke[__TCA_CHOKE_MAX];
 
@@ -23,7 +23,7 @@
 /*
  * parse codel options
  */
-int parse_tca_options_codel(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_codel(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *codel[__TCA_CODEL_MAX];
 
@@ -34,8 +34,9 @@ int parse_tca_options_codel(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_CODEL_LIMIT: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "limit=%u(packet) ",
-            *(unsigned *)RTA_DATA(codel[TCA_CODEL_LIMIT]));
+        *mp = add_str(msg, *mp, "limit=");
+        *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(codel[TCA_CODEL_LIMIT]));
+        *mp = add_str(msg, *mp, "(packet) ");
     }
 
     if(codel[TCA_CODEL_TARGET]) {
@@ -47,7 +48,9 @@ int parse_tca_options_codel(char *msg, char **mp, struct rtattr *tca)
         }
         conv_unit_usec(target, sizeof(target),
             (double)*(unsigned *)RTA_DATA(codel[TCA_CODEL_TARGET]));
-        *mp = add_log(msg, *mp, "target=%s ", target);
+        *mp = add_str(msg, *mp, "target=");
+        *mp = add_str(msg, *mp, target);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(codel[TCA_CODEL_INTERVAL]) {
@@ -59,7 +62,9 @@ int parse_tca_options_codel(char *msg, char **mp, struct rtattr *tca)
         }
         conv_unit_usec(interval, sizeof(interval),
             (double)*(unsigned *)RTA_DATA(codel[TCA_CODEL_INTERVAL]));
-        *mp = add_log(msg, *mp, "interval=%s ", interval);
+        *mp = add_str(msg, *mp, "interval=");
+        *mp = add_str(msg, *mp, interval);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(codel[TCA_CODEL_ECN]) {
@@ -68,7 +73,7 @@ int parse_tca_options_codel(char *msg, char **mp, struct rtattr *tca)
             return(1);
         }
         if(*(unsigned *)RTA_DATA(codel[TCA_CODEL_ECN]))
-            *mp = add_log(msg, *mp, "ecn=on ");
+            *mp = add_str(msg, *mp, "ecn=on ");
     }
 
     return(0);
@@ -77,7 +82,7 @@ int parse_tca_options_codel(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug codel options
  */
-void debug_tca_options_codel(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_codel(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *codel[__TCA_CODEL_MAX];
 
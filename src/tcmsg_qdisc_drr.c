@@ -23,7 +23,7 @@
 /*
  * parse drr options
  */
-int parse_tca_options_drr(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_drr(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *drr[__TCA_NETEM_MAX];
     char quantum[MAX_STR_SIZE];
@@ -37,7 +37,9 @@ int parse_tca_options_drr(char *msg, char **mp, struct rtattr *tca)
         }
         conv_unit_size(quantum, sizeof(quantum),
             (double)*(unsigned *)RTA_DATA(drr[TCA_DRR_QUANTUM]));
-        *mp = add_log(msg, *mp, "quantum=%s ", quantum);
+        *mp = add_str(msg, *mp, "quantum=");
+        *mp = add_str(msg, *mp, quantum);
+        *mp = add_str(msg, *mp, " ");
     }
 
     return(0);
@@ -46,7 +48,7 @@ int parse_tca_options_drr(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug drr options
  */
-void debug_tca_options_drr(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_drr(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *drr[__TCA_DRR_MAX];
 
@@ -23,7 +23,7 @@
 /*
  * parse dsmark options
  */
-int parse_tca_options_dsmark(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_dsmark(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *dsmark[__TCA_DSMARK_MAX];
 
@@ -34,8 +34,9 @@ int parse_tca_options_dsmark(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_DSMARK_INDICES: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "indices=0x%04x ",
-            *(unsigned short *)RTA_DATA(dsmark[TCA_DSMARK_INDICES]));
+        *mp = add_str(msg, *mp, "indices=0x");
+        *mp = add_hex(msg, *mp, *(unsigned short *)RTA_DATA(dsmark[TCA_DSMARK_INDICES]), 4);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(dsmark[TCA_DSMARK_DEFAULT_INDEX]) {
@@ -43,20 +44,22 @@ int parse_tca_options_dsmark(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_DSMARK_DEFAULT_INDEX: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "default_index=0x%04x ",
-            *(unsigned short *)RTA_DATA(dsmark[TCA_DSMARK_DEFAULT_INDEX]));
+        *mp = add_str(msg, *mp, "default_index=0x");
+        *mp = add_hex(msg, *mp, *(unsigned short *)RTA_DATA(dsmark[TCA_DSMARK_DEFAULT_INDEX]), 4);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(dsmark[TCA_DSMARK_SET_TC_INDEX])
-        *mp = add_log(msg, *mp, "set_tc_index=on ");
+        *mp = add_str(msg, *mp, "set_tc_index=on ");
 
     if(dsmark[TCA_DSMARK_VALUE]) {
         if(RTA_PAYLOAD(dsmark[TCA_DSMARK_VALUE]) < sizeof(unsigned char)) {
             rec_log("error: %s: TCA_DSMARK_VALUE: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "value=0x%02x ",
-            *(unsigned char *)RTA_DATA(dsmark[TCA_DSMARK_VALUE]));
+        *mp = add_str(msg, *mp, "value=0x");
+        *mp = add_hex(msg, *mp, *(unsigned char *)RTA_DATA(dsmark[TCA_DSMARK_VALUE]), 2);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(dsmark[TCA_DSMARK_MASK]) {
@@ -64,8 +67,9 @@ int parse_tca_options_dsmark(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_DSMARK_MASK: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "mask=0x%02x ",
-            *(unsigned char *)RTA_DATA(dsmark[TCA_DSMARK_MASK]));
+        *mp = add_str(msg, *mp, "mask=0x");
+        *mp = add_hex(msg, *mp, *(unsigned char *)RTA_DATA(dsmark[TCA_DSMARK_MASK]), 2);
+        *mp = add_str(msg, *mp, " ");
     }
 
     return(0);
@@ -74,7 +78,7 @@ int parse_tca_options_dsmark(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug dsmark options
  */
-void debug_tca_options_dsmark(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_dsmark(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *dsmark[__TCA_DSMARK_MAX];
 
@@ -22,7 +22,7 @@
 /*
  * parse pfifo options
  */
-int parse_tca_options_pfifo(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_pfifo(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct tc_fifo_qopt *qopt;
 
@@ -33,7 +33,9 @@ int parse_tca_options_pfifo(char *msg, char **mp, struct rtattr *tca)
 
     qopt = (struct tc_fifo_qopt *)RTA_DATA(tca);
 
-    *mp = add_log(msg, *mp, "limit=%d(packet) ", qopt->limit);
+    *mp = add_str(msg, *mp, "limit=");
+    *mp = add_s32(msg, *mp, qopt->limit);
+    *mp = add_str(msg, *mp, "(packet) ");
 
     return(0);
 }
@@ -41,7 +43,7 @@ int parse_tca_options_pfifo(char *msg, char **mp, struct rtattr *tca)
 /*
  * parse bfifo options
  */
-int parse_tca_options_bfifo(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_bfifo(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct tc_fifo_qopt *qopt;
     char limit[MAX_STR_SIZE];
@@ -54,7 +56,8 @@ int parse_tca_options_bfifo(char *msg, char **mp, struct rtattr *tca)
     qopt = (struct tc_fifo_qopt *)RTA_DATA(tca);
 
     conv_unit_size(limit, sizeof(limit), qopt->limit);
-    *mp = add_log(msg, *mp, "limit=%s", limit);
+    *mp = add_str(msg, *mp, "limit=");
+    *mp = add_str(msg, *mp, limit);
 
     return(0);
 }
@@ -62,7 +65,7 @@ int parse_tca_options_bfifo(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug fifo options
  */
-void debug_tca_options_fifo(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_fifo(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct tc_fifo_qopt *qopt;
 
@@ -23,7 +23,7 @@
 /*
  * parse fq_codel options
  */
-int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_fq_codel(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *fq_codel[__TCA_FQ_CODEL_MAX];
 
@@ -34,8 +34,9 @@ int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_FQ_CODEL_LIMIT: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "limit=%u(packet) ",
-            *(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_LIMIT]));
+        *mp = add_str(msg, *mp, "limit=");
+        *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_LIMIT]));
+        *mp = add_str(msg, *mp, "(packet) ");
     }
 
     if(fq_codel[TCA_FQ_CODEL_FLOWS]) {
@@ -43,8 +44,9 @@ int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_FQ_CODEL_FLOWS: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "flows=%u ",
-            *(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_FLOWS]));
+        *mp = add_str(msg, *mp, "flows=");
+        *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_FLOWS]));
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(fq_codel[TCA_FQ_CODEL_QUANTUM]) {
@@ -52,8 +54,9 @@ int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_FQ_CODEL_QUANTUM: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "quantum=%u(byte) ",
-            *(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_QUANTUM]));
+        *mp = add_str(msg, *mp, "quantum=");
+        *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_QUANTUM]));
+        *mp = add_str(msg, *mp, "(byte) ");
     }
 
     if(fq_codel[TCA_FQ_CODEL_TARGET]) {
@@ -65,7 +68,9 @@ int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca)
         }
         conv_unit_usec(target, sizeof(target),
             (double)*(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_TARGET]));
-        *mp = add_log(msg, *mp, "target=%s ", target);
+        *mp = add_str(msg, *mp, "target=");
+        *mp = add_str(msg, *mp, target);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(fq_codel[TCA_FQ_CODEL_INTERVAL]) {
@@ -77,7 +82,9 @@ int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca)
         }
         conv_unit_usec(interval, sizeof(interval),
             (double)*(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_INTERVAL]));
-        *mp = add_log(msg, *mp, "interval=%s ", interval);
+        *mp = add_str(msg, *mp, "interval=");
+        *mp = add_str(msg, *mp, interval);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(fq_codel[TCA_FQ_CODEL_ECN]) {
@@ -86,7 +93,7 @@ int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca)
             return(1);
         }
         if(*(unsigned *)RTA_DATA(fq_codel[TCA_FQ_CODEL_ECN]))
-            *mp = add_log(msg, *mp, "ecn=on ");
+            *mp = add_str(msg, *mp, "ecn=on ");
     }
 
     return(0);
@@ -95,7 +102,7 @@ int parse_tca_options_fq_codel(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug fq_codel options
  */
-void debug_tca_options_fq_codel(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_fq_codel(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *fq_codel[__TCA_FQ_CODEL_MAX];
 
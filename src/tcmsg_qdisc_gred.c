@@ -22,7 +22,7 @@
 /*
  * parse gred options
  */
-int parse_tca_options_gred(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_gred(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *gred[__TCA_GRED_MAX];
     struct tc_gred_sopt *sopt = NULL;
@@ -75,8 +75,17 @@ int parse_tca_options_gred(char *msg, char **mp, struct rtattr *tca)
         conv_unit_size(min, sizeof(min), qopt->qth_min);
         conv_unit_size(max, sizeof(max), qopt->qth_max);
 
-        *mp = add_log(msg, *mp, "DP=%u limit=%s min=%s max=%s prio=%d ",
-            qopt->DP, limit, min, max, qopt->prio);
+        *mp = add_str(msg, *mp, "DP=");
+        *mp = add_u32(msg, *mp, qopt->DP);
+        *mp = add_str(msg, *mp, " limit=");
+        *mp = add_str(msg, *mp, limit);
+        *mp = add_str(msg, *mp, " min=");
+        *mp = add_str(msg, *mp, min);
+        *mp = add_str(msg, *mp, " max=");
+        *mp = add_str(msg, *mp, max);
+        *mp = add_str(msg, *mp, " prio=");
+        *mp = add_s32(msg, *mp, qopt->prio);
+        *mp = add_str(msg, *mp, " ");
         if(max_p)
             *mp = add_log(msg, *mp, "probability=%g(%%) ", max_p[i] / pow(2, 32) * 100);
         rec_log("%s", msg);
@@ -85,7 +94,11 @@ int parse_tca_options_gred(char *msg, char **mp, struct rtattr *tca)
     }
 
     if(!flag || strstr(msg, "qdisc deleted")) {
-        *mp = add_log(msg, *mp, "DPs=%u default-DP=%u ", sopt->DPs, sopt->def_DP);
+        *mp = add_str(msg, *mp, "DPs=");
+        *mp = add_u32(msg, *mp, sopt->DPs);
+        *mp = add_str(msg, *mp, " default-DP=");
+        *mp = add_u32(msg, *mp, sopt->def_DP);
+        *mp = add_str(msg, *mp, " ");
         rec_log("%s", msg);
     }
 
@@ -95,7 +108,7 @@ int parse_tca_options_gred(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug gred options
  */
-void debug_tca_options_gred(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_gred(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *gred[__TCA_GRED_MAX];
 
@@ -28,7 +28,7 @@
  * ul : upperlimit service curve
  *
  */
-int parse_tca_options_hfsc(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_hfsc(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *hfsc[__TCA_HFSC_MAX];
     struct tc_hfsc_qopt *qopt;
@@ -36,7 +36,9 @@ int parse_tca_options_hfsc(char *msg, char **mp, struct rtattr *tca)
 
     if(RTA_PAYLOAD(tca) == sizeof(*qopt)) {
         qopt = (struct tc_hfsc_qopt *)RTA_DATA(tca);
-        *mp = add_log(msg, *mp, "default-class=0x%x ", qopt->defcls);
+        *mp = add_str(msg, *mp, "default-class=0x");
+        *mp = add_hex(msg, *mp, qopt->defcls, 0);
+        *mp = add_str(msg, *mp, " ");
 
         return(0);
     }
@@ -93,7 +95,14 @@ int print_hfsc_sc(char *msg, char **mp, char *name, struct tc_service_curve *sc)
     conv_unit_rate(m2, sizeof(m2), sc->m2);
     conv_unit_usec(d, sizeof(d), sc->d);
 
-    *mp = add_log(msg, *mp, "%s(m1/d/m2)=%s/%s/%s ", name, m1, d, m2);
+    *mp = add_str(msg, *mp, name);
+    *mp = add_str(msg, *mp, "(m1/d/m2)=");
+    *mp = add_str(msg, *mp, m1);
+    *mp = add_str(msg, *mp, "/");
+    *mp = add_str(msg, *mp, d);
+    *mp = add_str(msg, *mp, "/");
+    *mp = add_str(msg, *mp, m2);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -101,7 +110,7 @@ int print_hfsc_sc(char *msg, char **mp, char *name, struct tc_service_curve *sc)
 /*
  * debug hfsc options
  */
-void debug_tca_options_hfsc(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_hfsc(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct tc_hfsc_qopt *qopt;
     struct rtattr *hfsc[__TCA_HFSC_MAX];
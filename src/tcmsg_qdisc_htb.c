@@ -22,7 +22,7 @@
 /*
  * parse htb options
  */
-int parse_tca_options_htb(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_htb(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *htb[__TCA_HTB_MAX];
 
@@ -37,8 +37,12 @@ int parse_tca_options_htb(char *msg, char **mp, struct rtattr *tca)
         }
         glob = (struct tc_htb_glob *)RTA_DATA(htb[TCA_HTB_INIT]);
 
-        *mp = add_log(msg, *mp, "rate2quantum=%u ", glob->rate2quantum);
-        *mp = add_log(msg, *mp, "default-class=0x%x ", glob->defcls);
+        *mp = add_str(msg, *mp, "rate2quantum=");
+        *mp = add_u32(msg, *mp, glob->rate2quantum);
+        *mp = add_str(msg, *mp, " ");
+        *mp = add_str(msg, *mp, "default-class=0x");
+        *mp = add_hex(msg, *mp, glob->defcls, 0);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(htb[TCA_HTB_PARMS]) {
@@ -62,8 +66,19 @@ int parse_tca_options_htb(char *msg, char **mp, struct rtattr *tca)
         conv_unit_size(cburst, sizeof(cburst),
             get_burst_size(opt->ceil.rate, opt->cbuffer));
 
-        *mp = add_log(msg, *mp, "rate=%s burst=%s ceil=%s cburst=%s level=%u prio=%u ",
-            rate, burst, ceil, cburst, opt->level, opt->prio);
+        *mp = add_str(msg, *mp, "rate=");
+        *mp = add_str(msg, *mp, rate);
+        *mp = add_str(msg, *mp, " burst=");
+        *mp = add_str(msg, *mp, burst);
+        *mp = add_str(msg, *mp, " ceil=");
+        *mp = add_str(msg, *mp, ceil);
+        *mp = add_str(msg, *mp, " cburst=");
+        *mp = add_str(msg, *mp, cburst);
+        *mp = add_str(msg, *mp, " level=");
+        *mp = add_u32(msg, *mp, opt->level);
+        *mp = add_str(msg, *mp, " prio=");
+        *mp = add_u32(msg, *mp, opt->prio);
+        *mp = add_str(msg, *mp, " ");
     }
 
     return(0);
@@ -72,7 +87,7 @@ int parse_tca_options_htb(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug htb options
  */
-void debug_tca_options_htb(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_htb(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *htb[__TCA_HTB_MAX];
 
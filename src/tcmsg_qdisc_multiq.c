@@ -23,7 +23,7 @@
 /*
  * parse multiq options
  */
-int parse_tca_options_multiq(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_multiq(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct tc_multiq_qopt *qopt;
 
@@ -33,7 +33,11 @@ int parse_tca_options_multiq(char *msg, char **mp, struct rtattr *tca)
     }
     qopt = (struct tc_multiq_qopt *)RTA_DATA(tca);
 
-    *mp = add_log(msg, *mp, "bands=%d max=%d ", qopt->bands, qopt->max_bands);
+    *mp = add_str(msg, *mp, "bands=");
+    *mp = add_s32(msg, *mp, qopt->bands);
+    *mp = add_str(msg, *mp, " max=");
+    *mp = add_s32(msg, *mp, qopt->max_bands);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -41,7 +45,7 @@ int parse_tca_options_multiq(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug multiq options
  */
-void debug_tca_options_multiq(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_multiq(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct tc_multiq_qopt *qopt;
 
@@ -24,7 +24,7 @@ static double us2tick = 1;
 /*
  * parse netem options
  */
-int parse_tca_options_netem(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_netem(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *netem[__TCA_NETEM_MAX];
     struct tc_netem_qopt *qopt;
@@ -108,15 +108,20 @@ int parse_tca_options_netem(char *msg, char **mp, struct rtattr *tca)
     }
 #endif
 
-    if(qopt->limit)
-        *mp = add_log(msg, *mp, "limit=%u(packet) ", qopt->limit);
+    if(qopt->limit) {
+        *mp = add_str(msg, *mp, "limit=");
+        *mp = add_u32(msg, *mp, qopt->limit);
+        *mp = add_str(msg, *mp, "(packet) ");
+    }
 
     if(qopt->latency) {
         char latency[MAX_STR_SIZE];
 
         get_us2tick();
         conv_unit_usec(latency, sizeof(latency), qopt->latency / us2tick);
-        *mp = add_log(msg, *mp, "delay=%s ", latency);
+        *mp = add_str(msg, *mp, "delay=");
+        *mp = add_str(msg, *mp, latency);
+        *mp = add_str(msg, *mp, " ");
         if(corr && corr->delay_corr)
             *mp = add_log(msg, *mp, "delay-correlation=%g(%%) ",
                 (double)corr->delay_corr / max_percent_value * 100.);
@@ -127,7 +132,9 @@ int parse_tca_options_netem(char *msg, char **mp, struct rtattr *tca)
 
         get_us2tick();
         conv_unit_usec(jitter, sizeof(jitter), qopt->jitter / us2tick);
-        *mp = add_log(msg, *mp, "jitter=%s ", jitter);
+        *mp = add_str(msg, *mp, "jitter=");
+        *mp = add_str(msg, *mp, jitter);
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(qopt->loss) {
@@ -186,24 +193,39 @@ int parse_tca_options_netem(char *msg, char **mp, struct rtattr *tca)
         char netem_rate[MAX_STR_SIZE];
 
         conv_unit_rate(netem_rate, sizeof(netem_rate), rate->rate);
-        *mp = add_log(msg, *mp, "rate=%s ", netem_rate);
-                if(rate->packet_overhead)
-            *mp = add_log(msg, *mp, "packet-overhead=%u(byte) ", rate->packet_overhead);
+        *mp = add_str(msg, *mp, "rate=");
+        *mp = add_str(msg, *mp, netem_rate);
+        *mp = add_str(msg, *mp, " ");
+
+        if(rate->packet_overhead) {
+            *mp = add_str(msg, *mp, "packet-overhead=");
+            *mp = add_u32(msg, *mp, rate->packet_overhead);
+            *mp = add_str(msg, *mp, "(byte) ");
+        }
 
-                if(rate->cell_size)
-            *mp = add_log(msg, *mp, "cell-size=%u(byte) ", rate->cell_size);
+        if(rate->cell_size) {
+            *mp = add_str(msg, *mp, "cell-size=");
+            *mp = add_u32(msg, *mp, rate->cell_size);
+            *mp = add_str(msg, *mp, "(byte) ");
+        }
 
-                if(rate->cell_overhead)
-            *mp = add_log(msg, *mp, "cell-overhead=%u(byte) ", rate->cell_overhead);
+        if(rate->cell_overhead) {
+            *mp = add_str(msg, *mp, "cell-overhead=");
+            *mp = add_u32(msg, *mp, rate->cell_overhead);
+            *mp = add_str(msg, *mp, "(byte) ");
+        }
     }
 #endif
 
-    if(qopt->gap)
-        *mp = add_log(msg, *mp, "gap=%u(packet) ", qopt->gap);
+    if(qopt->gap) {
+        *mp = add_str(msg, *mp, "gap=");
+        *mp = add_u32(msg, *mp, qopt->gap);
+        *mp = add_str(msg, *mp, "(packet) ");
+    }
 
 #if HAVE_DECL_TCA_NETEM_ECN
     if(netem[TCA_NETEM_ECN] && *(unsigned *)RTA_DATA(netem[TCA_NETEM_ECN]))
-        *mp = add_log(msg, *mp, "ecn=on ");
+        *mp = add_str(msg, *mp, "ecn=on ");
 #endif
 
     return(0);
@@ -212,7 +234,7 @@ int parse_tca_options_netem(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug netem options
  */
-void debug_tca_options_netem(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_netem(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *netem[__TCA_NETEM_MAX];
     struct tc_netem_qopt *qopt;
@@ -23,7 +23,7 @@
 /*
  * parse plug options
  */
-int parse_tca_options_plug(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_plug(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct tc_plug_qopt *qopt;
     char action[MAX_STR_SIZE] = "";
@@ -41,7 +41,11 @@ int parse_tca_options_plug(char *msg, char **mp, struct rtattr *tca)
     else if(qopt->action == TCQ_PLUG_RELEASE_INDEFINITE)
         strncpy(action, "release_indefinite", sizeof(action));
 
-    *mp = add_log(msg, *mp, "action=%s limit=%u ", action, qopt->limit);
+    *mp = add_str(msg, *mp, "action=");
+    *mp = add_str(msg, *mp, action);
+    *mp = add_str(msg, *mp, " limit=");
+    *mp = add_u32(msg, *mp, qopt->limit);
+    *mp = add_str(msg, *mp, " ");
 
     return(0);
 }
@@ -49,7 +53,7 @@ int parse_tca_options_plug(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug plug options
  */
-void debug_tca_options_plug(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_plug(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct tc_plug_qopt *qopt;
 
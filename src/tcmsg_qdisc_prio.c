@@ -22,7 +22,7 @@
 /*
  * parse prio options
  */
-int parse_tca_options_prio(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_prio(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct tc_prio_qopt *qopt;
     int i;
@@ -32,13 +32,18 @@ int parse_tca_options_prio(char *msg, char **mp, struct rtattr *tca)
         return(1);
     }
     qopt = (struct tc_prio_qopt *)RTA_DATA(tca);
-    *mp = add_log(msg, *mp, "bands=%d priomap=", qopt->bands);
+    *mp = add_str(msg, *mp, "bands=");
+    *mp = add_s32(msg, *mp, qopt->bands);
+    *mp = add_str(msg, *mp, " priomap=");
 
     for(i = 0; i < TC_PRIO_MAX + 1; i++)
-        if(i == TC_PRIO_MAX)
-            *mp = add_log(msg, *mp, "%d ", qopt->priomap[i]);
-        else
-            *mp = add_log(msg, *mp, "%d-", qopt->priomap[i]);
+        if(i == TC_PRIO_MAX) {
+            *mp = add_s32(msg, *mp, qopt->priomap[i]);
+            *mp = add_str(msg, *mp, " ");
+        } else {
+            *mp = add_s32(msg, *mp, qopt->priomap[i]);
+            *mp = add_str(msg, *mp, "-");
+        }
 
     return(0);
 }
@@ -46,7 +51,7 @@ int parse_tca_options_prio(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug prio options
  */
-void debug_tca_options_prio(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_prio(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct tc_prio_qopt *qopt;
     char prio[MAX_STR_SIZE] = "";
@@ -23,7 +23,7 @@
 /*
  * parse qfq options
  */
-int parse_tca_options_qfq(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_qfq(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *qfq[__TCA_QFQ_MAX];
 
@@ -34,8 +34,9 @@ int parse_tca_options_qfq(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_QFQ_WEIGHT: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "weight=%u ",
-            *(unsigned *)RTA_DATA(qfq[TCA_QFQ_WEIGHT]));
+        *mp = add_str(msg, *mp, "weight=");
+        *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(qfq[TCA_QFQ_WEIGHT]));
+        *mp = add_str(msg, *mp, " ");
     }
 
     if(qfq[TCA_QFQ_LMAX]) {
@@ -43,8 +44,9 @@ int parse_tca_options_qfq(char *msg, char **mp, struct rtattr *tca)
             rec_log("error: %s: TCA_QFQ_WEIGHT: payload too short", __func__);
             return(1);
         }
-        *mp = add_log(msg, *mp, "maxpkt=%u(byte) ",
-            *(unsigned *)RTA_DATA(qfq[TCA_QFQ_LMAX]));
+        *mp = add_str(msg, *mp, "maxpkt=");
+        *mp = add_u32(msg, *mp, *(unsigned *)RTA_DATA(qfq[TCA_QFQ_LMAX]));
+        *mp = add_str(msg, *mp, "(byte) ");
     }
 
     return(0);
@@ -53,7 +55,7 @@ int parse_tca_options_qfq(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug qfq options
  */
-void debug_tca_options_qfq(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_qfq(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *qfq[__TCA_QFQ_MAX];
 
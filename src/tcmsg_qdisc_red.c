@@ -22,7 +22,7 @@
 /*
  * parse red options
  */
-int parse_tca_options_red(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_red(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *red[__TCA_RED_MAX];
 
@@ -45,10 +45,18 @@ int parse_tca_options_red(char *msg, char **mp, struct rtattr *tca)
         conv_unit_size(min, sizeof(min), qopt->qth_min);
         conv_unit_size(max, sizeof(max), qopt->qth_max);
 
-        *mp = add_log(msg, *mp, "limit=%s min=%s max=%s ", limit, min, max);
+        *mp = add_str(msg, *mp, "limit=");
+        *mp = add_str(msg, *mp, limit);
+        *mp = add_str(msg, *mp, " min=");
+        *mp = add_str(msg, *mp, min);
+        *mp = add_str(msg, *mp, " max=");
+        *mp = add_str(msg, *mp, max);
+        *mp = add_str(msg, *mp, " ");
         if(qopt->flags) {
             conv_tc_red_flags(qopt->flags, list, sizeof(list), 0);
-            *mp = add_log(msg, *mp, "flag=%s ", list);
+            *mp = add_str(msg, *mp, "flag=");
+            *mp = add_str(msg, *mp, list);
+            *mp = add_str(msg, *mp, " ");
         }
     }
 
@@ -69,7 +77,7 @@ int parse_tca_options_red(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug red options
  */
-void debug_tca_options_red(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_red(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *red[__TCA_RED_MAX];
 
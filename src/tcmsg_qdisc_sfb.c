@@ -23,7 +23,7 @@
 /*
  * parse sfb options
  */
-int parse_tca_options_sfb(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_sfb(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *sfb[__TCA_NETEM_MAX];
 
@@ -43,15 +43,25 @@ int parse_tca_options_sfb(char *msg, char **mp, struct rtattr *tca)
         conv_unit_usec(rehash, sizeof(rehash), qopt->rehash_interval * 1000);
         conv_unit_usec(warmup, sizeof(warmup), qopt->warmup_time * 1000);
 
-        *mp = add_log(msg, *mp, "limit=%u(packet) max=%u(packet) "
-            "target=%u(packet) increment=%.5f decrement=%.5f "
-            "penalty-rate=%u(packet/s) penalty-burst=%u(packet) "
-            "rehash=%s warmup=%s ",
-            qopt->limit, qopt->max, qopt->bin_size,
+        *mp = add_str(msg, *mp, "limit=");
+        *mp = add_u32(msg, *mp, qopt->limit);
+        *mp = add_str(msg, *mp, "(packet) max=");
+        *mp = add_u32(msg, *mp, qopt->max);
+        *mp = add_str(msg, *mp, "(packet) target=");
+        *mp = add_u32(msg, *mp, qopt->bin_size);
+        *mp = add_str(msg, *mp, "(packet) ");
+        *mp = add_log(msg, *mp, "increment=%.5f decrement=%.5f ",
             (double)qopt->increment / SFB_MAX_PROB,
-            (double)qopt->decrement / SFB_MAX_PROB,
-            qopt->penalty_rate, qopt->penalty_burst,
-            rehash, warmup);
+            (double)qopt->decrement / SFB_MAX_PROB);
+        *mp = add_str(msg, *mp, "penalty-rate=");
+        *mp = add_u32(msg, *mp, qopt->penalty_rate);
+        *mp = add_str(msg, *mp, "(packet/s) penalty-burst=");
+        *mp = add_u32(msg, *mp, qopt->penalty_burst);
+        *mp = add_str(msg, *mp, "(packet) rehash=");
+        *mp = add_str(msg, *mp, rehash);
+        *mp = add_str(msg, *mp, " warmup=");
+        *mp = add_str(msg, *mp, warmup);
+        *mp = add_str(msg, *mp, " ");
     }
 
     return(0);
@@ -60,7 +70,7 @@ int parse_tca_options_sfb(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug sfb options
  */
-void debug_tca_options_sfb(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_sfb(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *sfb[__TCA_SFB_MAX];
 
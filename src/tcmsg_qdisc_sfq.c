@@ -22,7 +22,7 @@
 /*
  * parse sfq options
  */
-int parse_tca_options_sfq(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_sfq(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct tc_sfq_qopt *qopt;
 
@@ -32,9 +32,17 @@ int parse_tca_options_sfq(char *msg, char **mp, struct rtattr *tca)
     }
     qopt = (struct tc_sfq_qopt *)RTA_DATA(tca);
 
-    *mp = add_log(msg, *mp,
-        "quantum=%u(byte) perturb=%d(second) limit=%u(packet) divisor=%u flows=%u ",
-        qopt->quantum, qopt->perturb_period, qopt->limit, qopt->divisor, qopt->flows);
+    *mp = add_str(msg, *mp, "quantum=");
+    *mp = add_u32(msg, *mp, qopt->quantum);
+    *mp = add_str(msg, *mp, "(byte) perturb=");
+    *mp = add_s32(msg, *mp, qopt->perturb_period);
+    *mp = add_str(msg, *mp, "(second) limit=");
+    *mp = add_u32(msg, *mp, qopt->limit);
+    *mp = add_str(msg, *mp, "(packet) divisor=");
+    *mp = add_u32(msg, *mp, qopt->divisor);
+    *mp = add_str(msg, *mp, " flows=");
+    *mp = add_u32(msg, *mp, qopt->flows);
+    *mp = add_str(msg, *mp, " ");
 
 #ifdef HAVE_STRUCT_TC_SFQ_QOPT_V1_V0
     struct tc_sfq_qopt_v1 *qopt_v1 = NULL;
@@ -50,12 +58,21 @@ int parse_tca_options_sfq(char *msg, char **mp, struct rtattr *tca)
         conv_unit_size(min, sizeof(min), qopt_v1->qth_min);
         conv_unit_size(max, sizeof(max), qopt_v1->qth_max);
 
-        *mp = add_log(msg, *mp, "depth=%u(packet) headdrop=%s min=%s max=%s ",
-            qopt_v1->depth, qopt_v1->headdrop ? "on" : "off", min, max);
+        *mp = add_str(msg, *mp, "depth=");
+        *mp = add_u32(msg, *mp, qopt_v1->depth);
+        *mp = add_str(msg, *mp, "(packet) headdrop=");
+        *mp = add_str(msg, *mp, qopt_v1->headdrop ? "on" : "off");
+        *mp = add_str(msg, *mp, " min=");
+        *mp = add_str(msg, *mp, min);
+        *mp = add_str(msg, *mp, " max=");
+        *mp = add_str(msg, *mp, max);
+        *mp = add_str(msg, *mp, " ");
 
         if(qopt_v1->flags) {
             conv_tc_red_flags(qopt_v1->flags, list, sizeof(list), 0);
-            *mp = add_log(msg, *mp, "flag=%s ", list);
+            *mp = add_str(msg, *mp, "flag=");
+            *mp = add_str(msg, *mp, list);
+            *mp = add_str(msg, *mp, " ");
         }
         *mp = add_log(msg, *mp, "probability=%g(%%) ", qopt_v1->max_P / pow(2, 32) * 100);
     }
@@ -67,7 +84,7 @@ int parse_tca_options_sfq(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug sfq options
  */
-void debug_tca_options_sfq(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_sfq(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct tc_sfq_qopt *qopt;
     struct tc_sfqred_stats *stats = NULL;
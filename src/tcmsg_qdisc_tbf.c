@@ -22,7 +22,7 @@
 /*
  * parse tbf options
  */
-int parse_tca_options_tbf(char *msg, char **mp, struct rtattr *tca)
+int parse_tca_options_tbf(char *msg, char **mp, struct tcmsg *tcm, struct rtattr *tca)
 {
     struct rtattr *tbf[__TCA_TBF_MAX];
 
@@ -50,7 +50,11 @@ int parse_tca_options_tbf(char *msg, char **mp, struct rtattr *tca)
             get_burst_size(qopt->rate.rate, qopt->buffer));
         rate_latency = get_latency(qopt->rate.rate, qopt->buffer, qopt->limit);
 
-        *mp = add_log(msg, *mp, "rate=%s burst=%s ", rate, burst);
+        *mp = add_str(msg, *mp, "rate=");
+        *mp = add_str(msg, *mp, rate);
+        *mp = add_str(msg, *mp, " burst=");
+        *mp = add_str(msg, *mp, burst);
+        *mp = add_str(msg, *mp, " ");
 
         if(qopt->peakrate.rate) {
             conv_unit_rate(peakrate, sizeof(peakrate), qopt->peakrate.rate);
@@ -58,7 +62,11 @@ int parse_tca_options_tbf(char *msg, char **mp, struct rtattr *tca)
                 get_burst_size(qopt->peakrate.rate, qopt->mtu));
             peakrate_latency = get_latency(qopt->peakrate.rate, qopt->mtu, qopt->limit);
 
-            *mp = add_log(msg, *mp, "peakrate=%s minburst=%s ", peakrate, mtu);
+            *mp = add_str(msg, *mp, "peakrate=");
+            *mp = add_str(msg, *mp, peakrate);
+            *mp = add_str(msg, *mp, " minburst=");
+            *mp = add_str(msg, *mp, mtu);
+            *mp = add_str(msg, *mp, " ");
         }
 
         if(rate_latency < peakrate_latency)
@@ -66,7 +74,9 @@ int parse_tca_options_tbf(char *msg, char **mp, struct rtattr *tca)
         else
             conv_unit_usec(latency, sizeof(latency), rate_latency);
 
-        *mp = add_log(msg, *mp, "latency=%s ", latency);
+        *mp = add_str(msg, *mp, "latency=");
+        *mp = add_str(msg, *mp, latency);
+        *mp = add_str(msg, *mp, " ");
     }
 
     return(0);
@@ -75,7 +85,7 @@ int parse_tca_options_tbf(char *msg, char **mp, struct rtattr *tca)
 /*
  * debug tbf options
  */
-void debug_tca_options_tbf(int lev, struct rtattr *tca, const char *name)
+void debug_tca_options_tbf(int lev, struct tcmsg *tcm, struct rtattr *tca, const char *name)
 {
     struct rtattr *tbf[__TCA_TBF_MAX];
 
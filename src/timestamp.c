@@ -0,0 +1,84 @@
+/*
+ * timestamp.c - timestamp of log and debug records
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/*
+ * get a current timestamp
+ */
+void get_timestamp(struct timestamp *ts)
+{
+    clock_gettime(CLOCK_REALTIME, &ts->real);
+
+    if(get_log_opts() & L_MONO)
+        clock_gettime(CLOCK_MONOTONIC, &ts->mono);
+}
+
+/*
+ * append a number of fixed digits
+ */
+static inline char *append_digits(char *p, unsigned long val, int digits)
+{
+    int i;
+
+    for(i = digits - 1; i >= 0; i--) {
+        p[i] = '0' + val % 10;
+        val /= 10;
+    }
+
+    return(p + digits);
+}
+
+/*
+ * format a timestamp as "[YYYY-MM-DD HH:MM:SS.uuuuuu] "
+ */
+int format_timestamp(struct timestamp_cache *c, const struct timestamp *ts,
+    char *buf, int size)
+{
+    char *p = buf;
+
+    if(size < TIMESTAMP_STRLEN)
+        return(0);
+
+    /* format a date only when a second changes */
+    if(!c->len || c->sec != ts->real.tv_sec) {
+        struct tm tm;
+
+        localtime_r(&ts->real.tv_sec, &tm);
+        c->len = snprintf(c->date, sizeof(c->date), "[%04d-%02d-%02d %02d:%02d:%02d.",
+            tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+            tm.tm_hour, tm.tm_min, tm.tm_sec);
+        c->sec = ts->real.tv_sec;
+    }
+
+    memcpy(p, c->date, c->len);
+    p = append_digits(p + c->len, ts->real.tv_nsec / 1000, 6);
+
+    /* seconds since boot for latency analysis */
+    if(get_log_opts() & L_MONO) {
+        *p++ = ' ';
+        p += snprintf(p, size - (p - buf) - 3, "%ld.", (long)ts->mono.tv_sec);
+        p = append_digits(p, ts->mono.tv_nsec / 1000, 6);
+    }
+
+    *p++ = ']';
+    *p++ = ' ';
+    *p = '\0';
+
+    return(p - buf);
+}
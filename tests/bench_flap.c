@@ -0,0 +1,75 @@
+/*
+ * bench_flap.c - benchmark of flapping route tracking
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+#define BENCH_LOOP 2000000
+
+/*
+ * get monotonic time in nanoseconds
+ */
+static double get_nsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return(ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+/*
+ * count events of a number of prefixes and print a time per event
+ */
+static void run_bench(const char *name, unsigned prefixes)
+{
+    struct event ev;
+    double start;
+    unsigned i, n;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = EVENT_ROUTE;
+    ev.family = AF_INET;
+    ev.prefixlen = 24;
+    ev.table = RT_TABLE_MAIN;
+    ev.addr[0] = 10;
+
+    /* a quarter of events hit a few prefixes as flapping routes do */
+    start = get_nsec();
+    for(i = 0; i < BENCH_LOOP; i++) {
+        n = (i & 3) ? (i * 2654435761u) % prefixes : i % 16;
+        ev.addr[1] = n >> 8;
+        ev.addr[2] = n;
+        count_flap(&ev);
+    }
+
+    printf("%-32s %7.1f ns/event\n", name, (get_nsec() - start) / BENCH_LOOP);
+}
+
+int main(void)
+{
+    open_log("/dev/null");
+    if(set_flap_option("1:10:300") < 0 || start_flap() < 0)
+        return(1);
+
+    run_bench("prefixes within a table", FLAP_TRACK_MAX / 2);
+    run_bench("prefixes over a table", FLAP_TRACK_MAX * 16);
+
+    print_flap_stats(stdout);
+
+    return(0);
+}
@@ -0,0 +1,104 @@
+/*
+ * bench_log.c - benchmark of formatting a logging message
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+#define BENCH_LOOP 2000000
+
+/*
+ * get monotonic time in nanoseconds
+ */
+static double get_nsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return(ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+/*
+ * format a route event with format strings as parsers did before appenders
+ */
+static int format_rt_event_printf(const struct event *ev, char *msg)
+{
+    char dst[INET6_ADDRSTRLEN], gw[INET6_ADDRSTRLEN], ifname[IFNAMSIZ] = "";
+    char *mp = msg;
+
+    inet_ntop(ev->family, ev->addr, dst, sizeof(dst));
+    inet_ntop(ev->family, ev->gateway, gw, sizeof(gw));
+
+    mp = add_log(msg, mp, "%s route %s: destination=%s/%d ",
+        (ev->family == AF_INET6) ? "ipv6" : "ipv4",
+        conv_event_action(ev->action), dst, ev->prefixlen);
+    mp = add_log(msg, mp, "nexthop=%s ", gw);
+    mp = add_log(msg, mp, "interface=%s ",
+        if_indextoname_from_lists(ev->ifindex, ifname));
+    mp = add_log(msg, mp, "metric=%u ", ev->metric);
+    mp = add_log(msg, mp, "type=%s protocol=%s table=%s",
+        conv_rtn_type(ev->rtn_type, 0), conv_rtprot(ev->protocol, 0),
+        conv_rt_table(ev->table, 0));
+
+    return(mp ? 0 : -1);
+}
+
+/*
+ * run a formatter and print a time per message
+ */
+static void run_bench(const char *name, int (*format)(const struct event *ev, char *msg),
+    struct event *ev)
+{
+    char msg[MAX_MSG_SIZE];
+    double start;
+    int i;
+
+    start = get_nsec();
+    for(i = 0; i < BENCH_LOOP; i++) {
+        ev->addr[2] = i;
+        format(ev, msg);
+    }
+
+    printf("%-32s %7.1f ns/message\n", name, (get_nsec() - start) / BENCH_LOOP);
+    printf("    %s\n", msg);
+}
+
+int main(void)
+{
+    struct event ev;
+
+    open_log("/dev/null");
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = EVENT_ROUTE;
+    ev.action = EVENT_ADDED;
+    ev.family = AF_INET6;
+    ev.flags = EVENT_F_GATEWAY | EVENT_F_OIF | EVENT_F_METRIC;
+    ev.ifindex = 2;
+    ev.prefixlen = 48;
+    ev.rtn_type = RTN_UNICAST;
+    ev.protocol = RTPROT_BOOT;
+    ev.table = RT_TABLE_MAIN;
+    ev.metric = 1024;
+    inet_pton(AF_INET6, "2001:db8:1::", ev.addr);
+    inet_pton(AF_INET6, "2001:db8::2", ev.gateway);
+
+    run_bench("add_log() and inet_ntop()", format_rt_event_printf, &ev);
+    run_bench("typed appenders", format_rt_event, &ev);
+
+    return(0);
+}
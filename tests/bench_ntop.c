@@ -0,0 +1,97 @@
+/*
+ * bench_ntop.c - benchmark of address formatters
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+#define BENCH_LOOP 4000000
+
+/*
+ * get monotonic time in nanoseconds
+ */
+static double get_nsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return(ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+/*
+ * convert an address with inet_ntop()
+ */
+static int libc_ntop(int family, const unsigned char *src, char *dst)
+{
+    return(inet_ntop(family, src, dst, INET6_ADDRSTRLEN) ? 0 : -1);
+}
+
+/*
+ * convert an address with ntop_ipv4() or ntop_ipv6()
+ */
+static int nield_ntop(int family, const unsigned char *src, char *dst)
+{
+    if(family == AF_INET)
+        return(ntop_ipv4(src, dst));
+
+    return(ntop_ipv6(src, dst));
+}
+
+/*
+ * run a formatter over an address changing its last octets
+ */
+static void run_bench(const char *name, int (*ntop)(int family,
+    const unsigned char *src, char *dst), int family, const char *addr)
+{
+    unsigned char src[16];
+    char dst[INET6_ADDRSTRLEN];
+    int i, last = (family == AF_INET) ? 3 : 15;
+    double start;
+
+    inet_pton(family, addr, src);
+
+    start = get_nsec();
+    for(i = 0; i < BENCH_LOOP; i++) {
+        src[last] = i;
+        src[last - 1] = i >> 8;
+        ntop(family, src, dst);
+    }
+
+    printf("%-12s %-38s %6.1f ns/address\n", name, addr,
+        (get_nsec() - start) / BENCH_LOOP);
+}
+
+int main(void)
+{
+    static const char *addrs[][2] = {
+        { "ipv4", "192.168.10.1" },
+        { "ipv6", "2001:db8::1" },
+        { "ipv6", "2001:db8:85a3:8d3:1319:8a2e:370:7348" },
+        { "ipv6", "::ffff:192.0.2.1" },
+        { "ipv6", "fe80::21b:21ff:fe0c:1" },
+    };
+    unsigned i;
+    int family;
+
+    for(i = 0; i < sizeof(addrs) / sizeof(addrs[0]); i++) {
+        family = strcmp(addrs[i][0], "ipv4") ? AF_INET6 : AF_INET;
+        run_bench("inet_ntop()", libc_ntop, family, addrs[i][1]);
+        run_bench("ntop.c", nield_ntop, family, addrs[i][1]);
+    }
+
+    return(0);
+}
@@ -0,0 +1,63 @@
+/*
+ * stub.c - stubs of nield.c functions for tests and benchmarks
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+/* options of a daemon which tests may change */
+int stub_log_opts = L_LOCAL;
+int stub_msg_opts;
+
+/*
+ * get logging options
+ */
+int get_log_opts(void)
+{
+    return(stub_log_opts);
+}
+
+/*
+ * get message options
+ */
+int get_msg_opts(void)
+{
+    return(stub_msg_opts);
+}
+
+/*
+ * get a syslog facility
+ */
+int get_facility(void)
+{
+    return(LOG_DAEMON);
+}
+
+/*
+ * add a loop timer(timers are not run in tests)
+ */
+int add_loop_timer(int interval, void (*handler)(void))
+{
+    return(0);
+}
+
+/*
+ * request an interface to kernel(no kernel is requested in tests)
+ */
+int request_link(int index)
+{
+    return(1);
+}
@@ -0,0 +1,110 @@
+/*
+ * test_flap.c - test of flapping route tracking
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+#define HOT_EVENTS  200
+#define COLD_PREFIX (FLAP_TRACK_MAX + 100)
+
+static int failed;
+
+/*
+ * check a condition of a test
+ */
+static void check(int cond, const char *name)
+{
+    if(!cond) {
+        fprintf(stderr, "FAIL: %s\n", name);
+        failed++;
+    }
+}
+
+/*
+ * count an event of an IPv4 route
+ */
+static void flap_route(unsigned n, int prefixlen)
+{
+    struct event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = EVENT_ROUTE;
+    ev.family = AF_INET;
+    ev.prefixlen = prefixlen;
+    ev.table = RT_TABLE_MAIN;
+    ev.addr[0] = 10;
+    ev.addr[1] = n >> 8;
+    ev.addr[2] = n;
+
+    count_flap(&ev);
+}
+
+/*
+ * get a line of a prefix in flap statistics
+ */
+static int find_flap_line(const char *prefix, char *line, int len)
+{
+    FILE *stats = tmpfile();
+    int found = 0;
+
+    if(!stats)
+        return(0);
+    print_flap_stats(stats);
+    rewind(stats);
+    while(fgets(line, len, stats))
+        if(strstr(line, prefix)) {
+            found = 1;
+            break;
+        }
+    fclose(stats);
+
+    return(found);
+}
+
+/*
+ * a prefix flapped before a table fills survives prefixes flapped once
+ */
+static void test_hot_prefix(void)
+{
+    char line[MAX_MSG_SIZE];
+    unsigned i;
+
+    for(i = 0; i < HOT_EVENTS; i++)
+        flap_route(0, 16);
+    for(i = 1; i <= COLD_PREFIX; i++)
+        flap_route(i, 24);
+
+    check(find_flap_line("destination=10.0.0.0/16 ", line, sizeof(line)),
+        "hot prefix tracked");
+    check(strstr(line, "events=200 ") != NULL, "hot prefix keeps its events");
+}
+
+int main(void)
+{
+    open_log("/dev/null");
+    if(set_flap_option("1:1:300") < 0 || start_flap() < 0) {
+        fprintf(stderr, "FAIL: start flap tracking\n");
+        return(1);
+    }
+
+    test_hot_prefix();
+
+    if(failed)
+        fprintf(stderr, "%d failures\n", failed);
+
+    return(failed ? 1 : 0);
+}
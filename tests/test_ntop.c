@@ -0,0 +1,169 @@
+/*
+ * test_ntop.c - test of address formatters against inet_ntop()
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+static int failed;
+
+/* non-zero words covering every digit count */
+static const unsigned words_nonzero[] = {
+    0x1, 0xf, 0x10, 0xff, 0x100, 0xfff, 0x1000, 0xffff, 0xabcd,
+};
+#define WORDS_NONZERO (sizeof(words_nonzero) / sizeof(words_nonzero[0]))
+
+/*
+ * compare an address converted by ntop_ipv4() or ntop_ipv6() with inet_ntop()
+ */
+static void check_addr(int family, const unsigned char *src)
+{
+    char expect[INET6_ADDRSTRLEN], result[INET6_ADDRSTRLEN];
+    int len;
+
+    inet_ntop(family, src, expect, sizeof(expect));
+    if(family == AF_INET)
+        len = ntop_ipv4(src, result);
+    else
+        len = ntop_ipv6(src, result);
+
+    if(strcmp(expect, result) || len != (int)strlen(expect)) {
+        if(failed++ < 20)
+            fprintf(stderr, "FAIL: expect=%s result=%s(%d)\n", expect, result, len);
+    }
+}
+
+/*
+ * check every value of each octet and random IPv4 addresses
+ */
+static void test_ipv4(void)
+{
+    unsigned char src[4];
+    int i, v;
+
+    for(i = 0; i < 4; i++) {
+        for(v = 0; v < 256; v++) {
+            memset(src, (i & 1) ? 0 : 255, sizeof(src));
+            src[i] = v;
+            check_addr(AF_INET, src);
+        }
+    }
+
+    for(i = 0; i < 1000000; i++) {
+        v = random();
+        memcpy(src, &v, sizeof(src));
+        check_addr(AF_INET, src);
+    }
+}
+
+/*
+ * set a 16-bit word of an IPv6 address
+ */
+static void set_word(unsigned char *src, int i, unsigned w)
+{
+    src[i * 2] = w >> 8;
+    src[i * 2 + 1] = w & 0xff;
+}
+
+/*
+ * check every pattern of zero words with non-zero words of each digit count,
+ * which covers ties of zero runs, single zero words, and IPv4 compatible and
+ * mapped addresses
+ */
+static void test_ipv6(void)
+{
+    unsigned char src[16];
+    unsigned mask, n;
+    int i;
+
+    for(mask = 0; mask < 256; mask++) {
+        for(n = 0; n < WORDS_NONZERO; n++) {
+            for(i = 0; i < 8; i++)
+                set_word(src, i, (mask & (1 << i)) ?
+                    words_nonzero[(n + i) % WORDS_NONZERO] : 0);
+            check_addr(AF_INET6, src);
+
+            /* words 5 of IPv4 mapped and 6-7 of mapped or compatible */
+            if(mask & 0xe0)
+                continue;
+            for(i = 0; i < 256; i++) {
+                set_word(src, 5, (n & 1) ? 0xffff : 0);
+                src[12] = i;
+                src[13] = words_nonzero[n] & 0xff;
+                src[14] = (n & 2) ? i : 0;
+                src[15] = (n & 4) ? 255 - i : 0;
+                check_addr(AF_INET6, src);
+            }
+        }
+    }
+
+    for(i = 0; i < 1000000; i++) {
+        for(n = 0; n < 8; n++)
+            set_word(src, n, (random() & 1) ? 0 : random() & 0xffff);
+        check_addr(AF_INET6, src);
+    }
+}
+
+/*
+ * check hardware addresses of each length and a too short buffer
+ */
+static void test_hwaddr(void)
+{
+    unsigned char src[HWADDR_MAX];
+    char expect[HWADDR_STRLEN], result[HWADDR_STRLEN], *p;
+    int len, i;
+
+    for(i = 0; i < HWADDR_MAX; i++)
+        src[i] = i * 37 + 5;
+
+    for(len = 0; len <= HWADDR_MAX; len++) {
+        p = expect;
+        *p = '\0';
+        for(i = 0; i < len; i++)
+            p += sprintf(p, "%s%02x", i ? ":" : "", src[i]);
+
+        if(hwaddr_ntop(ARPHRD_ETHER, src, len, result, sizeof(result)) ||
+            strcmp(expect, result)) {
+            if(failed++ < 20)
+                fprintf(stderr, "FAIL: expect=%s result=%s\n", expect, result);
+        }
+    }
+
+    /* 6 octets need 18 characters with a terminator */
+    errno = 0;
+    if(hwaddr_ntop(ARPHRD_ETHER, src, 6, result, 17) != 1 || errno != ENOSPC) {
+        failed++;
+        fprintf(stderr, "FAIL: hardware address truncated to a short buffer\n");
+    }
+    if(hwaddr_ntop(ARPHRD_ETHER, src, 6, result, 18) || strlen(result) != 17) {
+        failed++;
+        fprintf(stderr, "FAIL: hardware address not fit in an exact buffer\n");
+    }
+}
+
+int main(void)
+{
+    srandom(1);
+
+    test_ipv4();
+    test_ipv6();
+    test_hwaddr();
+
+    if(failed)
+        fprintf(stderr, "%d failures\n", failed);
+
+    return(failed ? 1 : 0);
+}
@@ -0,0 +1,370 @@
+/*
+ * test_rib.c - test of a routing table mirror
+ * Copyright (C) 2011-2024 Tetsumune KISO <t2mune@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "nield.h"
+
+#define IFINDEX 2
+
+static int failed;
+
+/* route events received by a test sink */
+static struct event events[RIB_NEXTHOP_MAX * 2];
+static int event_num;
+static int nexthop_num;
+
+/*
+ * keep route events passed to sinks
+ */
+static void write_event_test(const struct event *ev)
+{
+    if(ev->type == EVENT_ROUTE && event_num < (int)(sizeof(events) / sizeof(events[0])))
+        events[event_num++] = *ev;
+    if(ev->type == EVENT_ROUTE)
+        nexthop_num += ev->nh_num;
+}
+
+/*
+ * check a condition of a test
+ */
+static void check(int cond, const char *name)
+{
+    if(!cond) {
+        fprintf(stderr, "FAIL: %s\n", name);
+        failed++;
+    }
+}
+
+/*
+ * append an attribute to a netlink message
+ */
+static void put_rta(struct nlmsghdr *nlh, unsigned short type, const void *data, int len)
+{
+    struct rtattr *rta = (struct rtattr *)((char *)nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+
+    rta->rta_type = type;
+    rta->rta_len = RTA_LENGTH(len);
+    memcpy(RTA_DATA(rta), data, len);
+    nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+}
+
+/*
+ * notify a state of an interface
+ */
+static void notify_link(unsigned flags)
+{
+    unsigned buf[256] = { 0 };
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    struct ifinfomsg *ifim = NLMSG_DATA(nlh);
+    unsigned mtu = 1500;
+
+    nlh->nlmsg_type = RTM_NEWLINK;
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(*ifim));
+    ifim->ifi_family = AF_UNSPEC;
+    ifim->ifi_type = ARPHRD_ETHER;
+    ifim->ifi_index = IFINDEX;
+    ifim->ifi_flags = flags;
+    put_rta(nlh, IFLA_IFNAME, "eth0", 5);
+    put_rta(nlh, IFLA_MTU, &mtu, sizeof(mtu));
+
+    parse_ifimsg(nlh);
+}
+
+/*
+ * notify an IPv4 address of an interface
+ */
+static void notify_addr(int type, const char *addr)
+{
+    unsigned buf[256] = { 0 };
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    struct ifaddrmsg *ifam = NLMSG_DATA(nlh);
+    unsigned char a[4];
+
+    inet_pton(AF_INET, addr, a);
+    nlh->nlmsg_type = type;
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(*ifam));
+    ifam->ifa_family = AF_INET;
+    ifam->ifa_prefixlen = 24;
+    ifam->ifa_index = IFINDEX;
+    put_rta(nlh, IFA_LOCAL, a, sizeof(a));
+    put_rta(nlh, IFA_ADDRESS, a, sizeof(a));
+
+    parse_ifamsg(nlh);
+}
+
+/*
+ * notify an IPv4 route through an interface(with nexthops of multipath if many)
+ */
+static void notify_route(int type, const char *dst, int protocol, const char *gateway,
+    const char *prefsrc, int nh_num)
+{
+    static unsigned buf[RIB_NEXTHOP_MAX * 8];
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    struct rtmsg *rtm = NLMSG_DATA(nlh);
+    struct rtattr *mp;
+    struct rtnexthop *rtnh;
+    unsigned char a[4];
+    unsigned oif = IFINDEX;
+    int i;
+
+    memset(buf, 0, sizeof(buf));
+    nlh->nlmsg_type = type;
+    nlh->nlmsg_flags = (type == RTM_NEWROUTE) ? NLM_F_CREATE | NLM_F_EXCL : 0;
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(*rtm));
+    rtm->rtm_family = AF_INET;
+    rtm->rtm_dst_len = 24;
+    rtm->rtm_table = RT_TABLE_MAIN;
+    rtm->rtm_protocol = protocol;
+    rtm->rtm_scope = gateway ? RT_SCOPE_UNIVERSE : RT_SCOPE_LINK;
+    rtm->rtm_type = RTN_UNICAST;
+
+    inet_pton(AF_INET, dst, a);
+    put_rta(nlh, RTA_DST, a, sizeof(a));
+    if(prefsrc) {
+        inet_pton(AF_INET, prefsrc, a);
+        put_rta(nlh, RTA_PREFSRC, a, sizeof(a));
+    }
+
+    if(nh_num) {
+        /* nexthops through a same interface with distinct gateways */
+        mp = (struct rtattr *)((char *)nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+        mp->rta_type = RTA_MULTIPATH;
+        rtnh = RTA_DATA(mp);
+        for(i = 0; i < nh_num; i++) {
+            rtnh->rtnh_len = sizeof(*rtnh) + RTA_LENGTH(4);
+            rtnh->rtnh_ifindex = IFINDEX;
+            ((struct rtattr *)RTNH_DATA(rtnh))->rta_type = RTA_GATEWAY;
+            ((struct rtattr *)RTNH_DATA(rtnh))->rta_len = RTA_LENGTH(4);
+            a[0] = 10; a[1] = 0; a[2] = i >> 8; a[3] = i & 0xff;
+            memcpy(RTA_DATA(RTNH_DATA(rtnh)), a, 4);
+            rtnh = RTNH_NEXT(rtnh);
+        }
+        mp->rta_len = (char *)rtnh - (char *)mp;
+        nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + RTA_ALIGN(mp->rta_len);
+    } else {
+        if(gateway) {
+            inet_pton(AF_INET, gateway, a);
+            put_rta(nlh, RTA_GATEWAY, a, sizeof(a));
+        }
+        put_rta(nlh, RTA_OIF, &oif, sizeof(oif));
+    }
+
+    event_num = 0;
+    nexthop_num = 0;
+    parse_rtmsg(nlh);
+}
+
+#ifdef HAVE_LINUX_NEXTHOP_H
+/*
+ * notify a nexthop object through an interface(or a group of members if any)
+ */
+static void notify_nexthop(int type, unsigned id, int ifindex, const unsigned *member,
+    int member_num)
+{
+    unsigned buf[256] = { 0 };
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    struct nhmsg *nhm = NLMSG_DATA(nlh);
+    struct nexthop_grp grp[8];
+    int i;
+
+    nlh->nlmsg_type = type;
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(*nhm));
+    nhm->nh_family = member_num ? AF_UNSPEC : AF_INET;
+    nhm->nh_protocol = RTPROT_ZEBRA;
+    put_rta(nlh, NHA_ID, &id, sizeof(id));
+
+    if(member_num) {
+        memset(grp, 0, sizeof(grp));
+        for(i = 0; i < member_num; i++)
+            grp[i].id = member[i];
+        put_rta(nlh, NHA_GROUP, grp, member_num * sizeof(grp[0]));
+    } else
+        put_rta(nlh, NHA_OIF, &ifindex, sizeof(ifindex));
+
+    parse_nhmsg(nlh);
+}
+
+/*
+ * notify an IPv4 route using a nexthop object
+ */
+static void notify_nhid_route(int type, const char *dst, unsigned nhid)
+{
+    unsigned buf[256] = { 0 };
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    struct rtmsg *rtm = NLMSG_DATA(nlh);
+    unsigned char a[4];
+
+    nlh->nlmsg_type = type;
+    nlh->nlmsg_flags = (type == RTM_NEWROUTE) ? NLM_F_CREATE | NLM_F_EXCL : 0;
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(*rtm));
+    rtm->rtm_family = AF_INET;
+    rtm->rtm_dst_len = 24;
+    rtm->rtm_table = RT_TABLE_MAIN;
+    rtm->rtm_protocol = RTPROT_ZEBRA;
+    rtm->rtm_type = RTN_UNICAST;
+
+    inet_pton(AF_INET, dst, a);
+    put_rta(nlh, RTA_DST, a, sizeof(a));
+    put_rta(nlh, RTA_NH_ID, &nhid, sizeof(nhid));
+
+    event_num = 0;
+    nexthop_num = 0;
+    parse_rtmsg(nlh);
+}
+#endif
+
+/*
+ * look up a route to an address in a main table
+ */
+static const struct rib_attr *lookup(const char *addr)
+{
+    unsigned char a[16] = { 0 };
+
+    inet_pton(AF_INET, addr, a);
+
+    return(lookup_rib(AF_INET, RT_TABLE_MAIN, a));
+}
+
+/*
+ * check that routes flushed silently by kernel with an interface down are
+ * logged when they are added again
+ */
+static void test_link_down(void)
+{
+    notify_link(IFF_UP | IFF_RUNNING);
+    notify_route(RTM_NEWROUTE, "10.0.0.0", RTPROT_KERNEL, NULL, NULL, 0);
+    notify_route(RTM_NEWROUTE, "192.0.2.0", RTPROT_BOOT, "10.0.0.1", NULL, 0);
+    check(event_num == 1 && events[0].action == EVENT_ADDED, "route added");
+
+    /* kernel deletes IPv4 routes through a disabled interface silently */
+    notify_link(0);
+    notify_link(IFF_UP | IFF_RUNNING);
+
+    notify_route(RTM_NEWROUTE, "10.0.0.0", RTPROT_KERNEL, NULL, NULL, 0);
+    check(event_num == 1 && events[0].action == EVENT_ADDED,
+        "connected route added again after link down and up");
+
+    notify_route(RTM_NEWROUTE, "192.0.2.0", RTPROT_BOOT, "10.0.0.2", NULL, 0);
+    check(event_num == 1 && events[0].action == EVENT_ADDED,
+        "route added again via another gateway");
+
+    /* a deleted route leaves no stale nexthop */
+    notify_route(RTM_DELROUTE, "192.0.2.0", RTPROT_BOOT, "10.0.0.2", NULL, 0);
+    check(event_num == 1 && events[0].action == EVENT_DELETED, "route deleted");
+    check(!lookup("192.0.2.1"), "no route left after deletion");
+}
+
+/*
+ * check that routes flushed silently by kernel with an address deleted are
+ * logged when they are added again
+ */
+static void test_addr_delete(void)
+{
+    notify_addr(RTM_NEWADDR, "10.0.0.5");
+    notify_addr(RTM_NEWADDR, "10.0.0.6");
+    notify_route(RTM_NEWROUTE, "198.51.100.0", RTPROT_BOOT, "10.0.0.1", "10.0.0.5", 0);
+    check(event_num == 1 && events[0].action == EVENT_ADDED, "route with source added");
+
+    /* a route using a deleted preferred source is deleted */
+    notify_addr(RTM_DELADDR, "10.0.0.5");
+    check(!lookup("198.51.100.1"), "route with deleted source flushed");
+    check(lookup("10.0.0.1") != NULL, "route kept with another address");
+
+    /* every route through an interface is deleted with its last address */
+    notify_addr(RTM_DELADDR, "10.0.0.6");
+    check(!lookup("10.0.0.1"), "routes flushed with a last address");
+}
+
+#ifdef HAVE_LINUX_NEXTHOP_H
+/*
+ * check that nexthop objects flushed silently by kernel with an interface
+ * down are deleted with routes using them
+ */
+static void test_nexthop_link_down(void)
+{
+    unsigned both[] = { 10, 11 }, mixed[] = { 10, 12 };
+
+    notify_link(IFF_UP | IFF_RUNNING);
+    notify_nexthop(RTM_NEWNEXTHOP, 10, IFINDEX, NULL, 0);
+    notify_nexthop(RTM_NEWNEXTHOP, 11, IFINDEX, NULL, 0);
+    notify_nexthop(RTM_NEWNEXTHOP, 12, IFINDEX + 1, NULL, 0);
+    notify_nexthop(RTM_NEWNEXTHOP, 20, 0, both, 2);
+    notify_nexthop(RTM_NEWNEXTHOP, 21, 0, mixed, 2);
+    notify_nhid_route(RTM_NEWROUTE, "192.0.2.0", 10);
+    notify_nhid_route(RTM_NEWROUTE, "198.51.100.0", 20);
+    notify_nhid_route(RTM_NEWROUTE, "203.0.113.0", 21);
+    check(event_num == 1 && events[0].action == EVENT_ADDED, "route of a nexthop object added");
+
+    /* kernel deletes nexthop objects through a disabled interface silently */
+    notify_link(0);
+    check(!lookup("192.0.2.1"), "route of a flushed nexthop object flushed");
+    check(!lookup("198.51.100.1"), "route of a group without a member flushed");
+    check(lookup("203.0.113.1") != NULL, "route of a group with a member kept");
+    notify_link(IFF_UP | IFF_RUNNING);
+
+    notify_nexthop(RTM_NEWNEXTHOP, 10, IFINDEX, NULL, 0);
+    notify_nhid_route(RTM_NEWROUTE, "192.0.2.0", 10);
+    check(event_num == 1 && events[0].action == EVENT_ADDED,
+        "route of a nexthop object added again after link down and up");
+
+    notify_nhid_route(RTM_DELROUTE, "192.0.2.0", 10);
+    notify_nhid_route(RTM_DELROUTE, "203.0.113.0", 21);
+    notify_nexthop(RTM_DELNEXTHOP, 21, 0, NULL, 0);
+    notify_nexthop(RTM_DELNEXTHOP, 12, IFINDEX + 1, NULL, 0);
+    notify_nexthop(RTM_DELNEXTHOP, 10, IFINDEX, NULL, 0);
+}
+#endif
+
+/*
+ * check that a route of too many nexthops to mirror is logged as notified
+ */
+static void test_many_nexthops(void)
+{
+    int chunks = (RIB_NEXTHOP_MAX + EVENT_NEXTHOP_MAX) / EVENT_NEXTHOP_MAX;
+
+    notify_route(RTM_NEWROUTE, "203.0.113.0", RTPROT_BOOT, NULL, NULL, RIB_NEXTHOP_MAX + 1);
+    check(event_num == chunks && nexthop_num == RIB_NEXTHOP_MAX + 1 &&
+        events[0].action == EVENT_ADDED, "route of too many nexthops logged as notified");
+    check(!lookup("203.0.113.1"), "route of too many nexthops not mirrored");
+
+    notify_route(RTM_NEWROUTE, "203.0.113.0", RTPROT_BOOT, NULL, NULL, 2);
+    check(event_num == 1 && nexthop_num == 2, "route of a few nexthops mirrored in an event");
+    check(lookup("203.0.113.1") != NULL, "route of a few nexthops found");
+
+    notify_route(RTM_DELROUTE, "203.0.113.0", RTPROT_BOOT, NULL, NULL, RIB_NEXTHOP_MAX + 1);
+    check(event_num == chunks && nexthop_num == RIB_NEXTHOP_MAX + 1 &&
+        events[0].action == EVENT_DELETED, "route of too many nexthops deleted as notified");
+    check(!lookup("203.0.113.1"), "mirrored route removed by too many nexthops");
+}
+
+int main(void)
+{
+    open_log("/dev/null");
+    add_event_sink("test", write_event_test);
+
+    test_link_down();
+    test_addr_delete();
+#ifdef HAVE_LINUX_NEXTHOP_H
+    test_nexthop_link_down();
+#endif
+    test_many_nexthops();
+
+    if(failed)
+        fprintf(stderr, "%d failures\n", failed);
+
+    return(failed ? 1 : 0);
+}